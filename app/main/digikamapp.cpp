@@ -216,6 +216,8 @@ DigikamApp::DigikamApp()
     DMetadataSettings::instance();
     ProgressManager::instance();
     ThumbnailLoadThread::setDisplayingWidget(this);
+    // let the icon view generate missing thumbnails on all available cores
+    ThumbnailLoadThread::defaultIconViewThread()->setPoolSize(0);
     DIO::instance();
 
     // creation of the engine on first use - when drawing -
@@ -64,6 +64,7 @@ extern "C"
 #include <QVBoxLayout>
 #include <QMessageBox>
 #include <QSet>
+#include <QStandardPaths>
 
 // KDE includes
 
@@ -96,6 +97,8 @@ extern "C"
 #include "tagscache.h"
 #include "thumbsdbaccess.h"
 #include "thumbnailloadthread.h"
+#include "thumbnailpackedstore.h"
+#include "thumbnailsize.h"
 #include "dnotificationwrapper.h"
 #include "dbjobinfo.h"
 #include "dbjobsmanager.h"
@@ -1018,6 +1021,22 @@ bool AlbumManager::setDatabase(const DbEngineParameters& params, bool priority,
     ThumbnailLoadThread::initializeThumbnailDatabase(CoreDbAccess::parameters().thumbnailParameters(),
                                                      new ThumbsDbInfoProvider());
 
+    if (ApplicationSettings::instance()->getUsePackedThumbnailStore())
+    {
+        // The packed store lives next to an SQLite thumbnails database, else in the cache directory.
+        DbEngineParameters params = CoreDbAccess::parameters();
+        QString storeDir          = params.isSQLite() ? params.getThumbsDatabaseNameOrDir()
+                                                      : QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+        QDir().mkpath(storeDir);
+
+        ThumbnailPackedStore::instance()->open(storeDir + QLatin1String("/thumbnails-digikam.pack"),
+                                               ThumbnailSize::Huge);
+    }
+    else
+    {
+        ThumbnailPackedStore::instance()->close();
+    }
+
     DbEngineGuiErrorHandler* const thumbnailsDBHandler = new DbEngineGuiErrorHandler(ThumbsDbAccess::parameters());
     ThumbsDbAccess::initDbEngineErrorHandler(thumbnailsDBHandler);
 
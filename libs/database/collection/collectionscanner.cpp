@@ -40,6 +40,7 @@
 #include <QReadLocker>
 #include <QStringList>
 #include <QSet>
+#include <QThread>
 #include <QTime>
 #include <QWriteLocker>
 
@@ -52,6 +53,7 @@
 #include "collectionlocation.h"
 #include "collectionscannerhints.h"
 #include "collectionscannerobserver.h"
+#include "collectionscannerpool.h"
 #include "coredbaccess.h"
 #include "coredbbackend.h"
 #include "coredbtransaction.h"
@@ -279,7 +281,13 @@ public:
         updatingHashHint(false),
         recordHistoryIds(false),
         deferredFileScanning(false),
-        observer(0)
+        observer(0),
+        parallelScanning(false),
+        scanningThreads(0),
+        uniqueHashV2(false),
+        pool(0),
+        batch(0),
+        batchCount(0)
     {
     }
 
@@ -318,6 +326,13 @@ public:
 
     void finishScanner(ImageScanner& scanner);
 
+    qlonglong scheduleJob(const CollectionScannerJob& job);
+    qlonglong commitJob(const CollectionScannerJob& job);
+    void      commitQueuedJob();
+    void      commitLoadedJobs();
+    void      commitAllJobs();
+    void      closeBatch();
+
 public:
 
     QSet<QString>                                 nameFilters;
@@ -342,8 +357,18 @@ public:
     QSet<QString>                                 deferredAlbumPaths;
 
     CollectionScannerObserver*                    observer;
+
+    bool                                          parallelScanning;
+    int                                           scanningThreads;
+    bool                                          uniqueHashV2;
+    CollectionScannerPool*                        pool;
+    CoreDbOperationGroup*                         batch;
+    int                                           batchCount;
 };
 
+/// Number of scanned files committed to the database in one transaction, when files are loaded in parallel
+static const int parallelScanBatchSize = 200;
+
 void CollectionScanner::Private::finishScanner(ImageScanner& scanner)
 {
     // Perform the actual write operation to the database
@@ -358,6 +383,152 @@ void CollectionScanner::Private::finishScanner(ImageScanner& scanner)
     }
 }
 
+qlonglong CollectionScanner::Private::scheduleJob(const CollectionScannerJob& job)
+{
+    if (!pool)
+    {
+        return commitJob(job);
+    }
+
+    // Back-pressure: commit the oldest job before loading more files
+    while (pool->isFull())
+    {
+        commitQueuedJob();
+    }
+
+    job.scanner->setUniqueHashV2(uniqueHashV2);
+    pool->enqueue(job);
+    commitLoadedJobs();
+
+    // the image id is not known until the job is committed
+    return -1;
+}
+
+qlonglong CollectionScanner::Private::commitJob(const CollectionScannerJob& job)
+{
+    ImageScanner* const scanner = job.scanner;
+
+    switch (job.operation)
+    {
+        case CollectionScannerJob::NewFile:
+            scanner->newFile(job.albumId);
+            break;
+
+        case CollectionScannerJob::NewFileFullScan:
+            scanner->newFileFullScan(job.albumId);
+            break;
+
+        case CollectionScannerJob::CopiedFrom:
+            scanner->copiedFrom(job.albumId, job.srcId);
+            break;
+
+        case CollectionScannerJob::ModifiedFile:
+            scanner->fileModified();
+            break;
+
+        case CollectionScannerJob::UpdateHashReuseThumbnail:
+        {
+            // same code as scanModifiedFile
+            scanner->fileModified();
+
+            QString newHash   = scanner->itemScanInfo().uniqueHash;
+            qlonglong newSize = scanner->itemScanInfo().fileSize;
+
+            if (ThumbsDbAccess::isInitialized())
+            {
+                if (job.fileWasEdited)
+                {
+                    // The file was edited in such a way that we know that the pixel content did not change, so we can reuse the thumbnail.
+                    // We need to add a link to the thumbnail data with the new hash/file size _and_ adjust
+                    // the file modification date in the data table.
+                    ThumbsDbInfo thumbDbInfo = ThumbsDbAccess().db()->findByHash(job.oldUniqueHash, job.oldFileSize);
+
+                    if (thumbDbInfo.id != -1)
+                    {
+                        ThumbsDbAccess().db()->insertUniqueHash(newHash, newSize, thumbDbInfo.id);
+                        ThumbsDbAccess().db()->updateModificationDate(thumbDbInfo.id, scanner->itemScanInfo().modificationDate);
+                        // TODO: also update details thumbnails (by file path and URL scheme)
+                    }
+                }
+                else
+                {
+                    ThumbsDbAccess().db()->replaceUniqueHash(job.oldUniqueHash, job.oldFileSize, newHash, newSize);
+                }
+            }
+
+            break;
+        }
+
+        case CollectionScannerJob::Rescan:
+            scanner->rescan();
+            break;
+    }
+
+    finishScanner(*scanner);
+
+    qlonglong id = scanner->id();
+    delete scanner;
+
+    return id;
+}
+
+void CollectionScanner::Private::commitQueuedJob()
+{
+    // The transaction of the batch is not kept open while waiting for the loading threads:
+    // other writers, and readers without write-ahead log, would wait as long.
+    if (batch && !pool->isFirstLoaded())
+    {
+        closeBatch();
+    }
+
+    const CollectionScannerJob job = pool->takeFirst();
+
+    // Write operations of queued jobs are grouped in larger transactions
+    if (!batch)
+    {
+        batch      = new CoreDbOperationGroup;
+        batchCount = 0;
+    }
+
+    commitJob(job);
+
+    if (++batchCount >= parallelScanBatchSize)
+    {
+        batch->lift();
+        batchCount = 0;
+    }
+}
+
+void CollectionScanner::Private::commitLoadedJobs()
+{
+    while (pool->isFirstLoaded())
+    {
+        commitQueuedJob();
+    }
+}
+
+void CollectionScanner::Private::commitAllJobs()
+{
+    if (!pool)
+    {
+        return;
+    }
+
+    while (!pool->isEmpty())
+    {
+        commitQueuedJob();
+    }
+
+    closeBatch();
+}
+
+void CollectionScanner::Private::closeBatch()
+{
+    delete batch;
+    batch      = 0;
+    batchCount = 0;
+}
+
 // --------------------------------------------------------------------------
 
 CollectionScanner::CollectionScanner()
@@ -419,6 +590,14 @@ void CollectionScanner::setObserver(CollectionScannerObserver* const observer)
     d->observer = observer;
 }
 
+void CollectionScanner::setParallelScanning(bool on, int threads)
+{
+    d->parallelScanning = on;
+    d->scanningThreads  = (threads > 0) ? threads
+                                        // scanning waits on the disk most of the time, use more threads than cores
+                                        : qMax(4, 2 * QThread::idealThreadCount());
+}
+
 void CollectionScanner::setDeferredFileScanning(bool defer)
 {
     d->deferredFileScanning = defer;
@@ -1034,6 +1213,17 @@ void CollectionScanner::scanAlbum(const CollectionLocation& location, const QStr
         emit startScanningAlbum(location.albumRootPath(), album);
     }
 
+    // In parallel scanning mode, the files of this album and of its subalbums are loaded from disk
+    // by a pool of threads, while this thread commits the loaded files to the database.
+    const bool ownsPool = (d->parallelScanning && !d->pool);
+
+    if (ownsPool)
+    {
+        // read the hash version once, the threads of the pool compute unique hashes without database access
+        d->uniqueHashV2 = CoreDbAccess().db()->isUniqueHashV2();
+        d->pool = new CollectionScannerPool(d->scanningThreads, 4 * d->scanningThreads);
+    }
+
     int albumID                   = checkAlbum(location, album);
     QList<ItemScanInfo> scanInfos = CoreDbAccess().db()->getItemScanInfos(albumID);
 
@@ -1058,6 +1248,14 @@ void CollectionScanner::scanAlbum(const CollectionLocation& location, const QStr
     {
         if (!d->checkObserver())
         {
+            if (ownsPool)
+            {
+                // files loaded but not committed will be scanned next time
+                delete d->pool;
+                d->pool = 0;
+                d->closeBatch();
+            }
+
             return; // return directly, do not go to cleanup code after loop!
         }
 
@@ -1147,6 +1345,15 @@ void CollectionScanner::scanAlbum(const CollectionLocation& location, const QStr
         emit scannedFiles(counter);
     }
 
+    // All files seen above must be in the database before stale items are removed
+    d->commitAllJobs();
+
+    if (ownsPool)
+    {
+        delete d->pool;
+        d->pool = 0;
+    }
+
     // Mark items in the db which we did not see on disk.
     if (!itemIdSet.isEmpty())
     {
@@ -1246,8 +1453,9 @@ qlonglong CollectionScanner::scanNewFile(const QFileInfo& info, int albumId)
         return -1;
     }
 
-    ImageScanner scanner(info);
-    scanner.setCategory(category(info));
+    CollectionScannerJob job(CollectionScannerJob::NewFile, new ImageScanner(info));
+    job.scanner->setCategory(category(info));
+    job.albumId = albumId;
 
     // Check copy/move hints for single items
     qlonglong srcId = 0;
@@ -1258,11 +1466,7 @@ qlonglong CollectionScanner::scanNewFile(const QFileInfo& info, int albumId)
         srcId = d->hints->itemHints.value(NewlyAppearedFile(albumId, info.fileName()));
     }
 
-    if (srcId != 0)
-    {
-        scanner.copiedFrom(albumId, srcId);
-    }
-    else
+    if (srcId == 0)
     {
         // Check copy/move hints for whole albums
         int srcAlbum = d->establishedSourceAlbums.value(albumId);
@@ -1272,21 +1476,17 @@ qlonglong CollectionScanner::scanNewFile(const QFileInfo& info, int albumId)
             // if we have one source album, find out if there is a file with the same name
             srcId = CoreDbAccess().db()->getImageId(srcAlbum, info.fileName());
         }
+    }
 
-        if (srcId != 0)
-        {
-            scanner.copiedFrom(albumId, srcId);
-        }
-        else
-        {
-            // Establishing identity with the unique hsah
-            scanner.newFile(albumId);
-        }
+    if (srcId != 0)
+    {
+        job.operation = CollectionScannerJob::CopiedFrom;
+        job.srcId     = srcId;
     }
 
-    d->finishScanner(scanner);
+    // Else, establishing identity with the unique hash in ImageScanner::newFile()
 
-    return scanner.id();
+    return d->scheduleJob(job);
 }
 
 qlonglong CollectionScanner::scanNewFileFullScan(const QFileInfo& info, int albumId)
@@ -1296,12 +1496,11 @@ qlonglong CollectionScanner::scanNewFileFullScan(const QFileInfo& info, int albu
         return -1;
     }
 
-    ImageScanner scanner(info);
-    scanner.setCategory(category(info));
-    scanner.newFileFullScan(albumId);
-    d->finishScanner(scanner);
+    CollectionScannerJob job(CollectionScannerJob::NewFileFullScan, new ImageScanner(info));
+    job.scanner->setCategory(category(info));
+    job.albumId = albumId;
 
-    return scanner.id();
+    return d->scheduleJob(job);
 }
 
 void CollectionScanner::scanModifiedFile(const QFileInfo& info, const ItemScanInfo& scanInfo)
@@ -1311,49 +1510,22 @@ void CollectionScanner::scanModifiedFile(const QFileInfo& info, const ItemScanIn
         return;
     }
 
-    ImageScanner scanner(info, scanInfo);
-    scanner.setCategory(category(info));
-    scanner.fileModified();
-    d->finishScanner(scanner);
+    CollectionScannerJob job(CollectionScannerJob::ModifiedFile, new ImageScanner(info, scanInfo));
+    job.scanner->setCategory(category(info));
+
+    d->scheduleJob(job);
 }
 
 void CollectionScanner::scanFileUpdateHashReuseThumbnail(const QFileInfo& info, const ItemScanInfo& scanInfo,
                                                          bool fileWasEdited)
 {
-    QString oldHash   = scanInfo.uniqueHash;
-    qlonglong oldSize = scanInfo.fileSize;
+    CollectionScannerJob job(CollectionScannerJob::UpdateHashReuseThumbnail, new ImageScanner(info, scanInfo));
+    job.scanner->setCategory(category(info));
+    job.oldUniqueHash = scanInfo.uniqueHash;
+    job.oldFileSize   = scanInfo.fileSize;
+    job.fileWasEdited = fileWasEdited;
 
-    // same code as scanModifiedFile
-    ImageScanner scanner(info, scanInfo);
-    scanner.setCategory(category(info));
-    scanner.fileModified();
-
-    QString newHash   = scanner.itemScanInfo().uniqueHash;
-    qlonglong newSize = scanner.itemScanInfo().fileSize;
-
-    if (ThumbsDbAccess::isInitialized())
-    {
-        if (fileWasEdited)
-        {
-            // The file was edited in such a way that we know that the pixel content did not change, so we can reuse the thumbnail.
-            // We need to add a link to the thumbnail data with the new hash/file size _and_ adjust
-            // the file modification date in the data table.
-            ThumbsDbInfo thumbDbInfo = ThumbsDbAccess().db()->findByHash(oldHash, oldSize);
-
-            if (thumbDbInfo.id != -1)
-            {
-                ThumbsDbAccess().db()->insertUniqueHash(newHash, newSize, thumbDbInfo.id);
-                ThumbsDbAccess().db()->updateModificationDate(thumbDbInfo.id, scanner.itemScanInfo().modificationDate);
-                // TODO: also update details thumbnails (by file path and URL scheme)
-            }
-        }
-        else
-        {
-            ThumbsDbAccess().db()->replaceUniqueHash(oldHash, oldSize, newHash, newSize);
-        }
-    }
-
-    d->finishScanner(scanner);
+    d->scheduleJob(job);
 }
 
 void CollectionScanner::rescanFile(const QFileInfo& info, const ItemScanInfo& scanInfo)
@@ -1363,10 +1535,10 @@ void CollectionScanner::rescanFile(const QFileInfo& info, const ItemScanInfo& sc
         return;
     }
 
-    ImageScanner scanner(info, scanInfo);
-    scanner.setCategory(category(info));
-    scanner.rescan();
-    d->finishScanner(scanner);
+    CollectionScannerJob job(CollectionScannerJob::Rescan, new ImageScanner(info, scanInfo));
+    job.scanner->setCategory(category(info));
+
+    d->scheduleJob(job);
 }
 
 void CollectionScanner::copyFileProperties(const ImageInfo& source, const ImageInfo& d)
@@ -187,6 +187,15 @@ public:
      */
     void setObserver(CollectionScannerObserver* const observer);
 
+    /**
+     * Call this to load the files of scanned albums from disk (metadata, image information,
+     * unique hash) in a pool of threads, while the database is written by the scanning thread
+     * in batched transactions. This helps a lot when scanning network or other slow storage.
+     * If threads is 0, the number of threads is chosen for disk latency rather than CPU cores.
+     * Default is off. Single files given to scanFile() are always scanned in the calling thread.
+     */
+    void setParallelScanning(bool on, int threads = 0);
+
     /**
      * When a file is derived from another file, typically through editing,
      * copy all relevant attributes from source file to the new file.
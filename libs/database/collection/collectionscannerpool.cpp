@@ -0,0 +1,188 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-03-22
+ * Description : pool of threads loading files from disk
+ *               for the collection scanner
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "collectionscannerpool.h"
+
+// Qt includes
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QQueue>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "imagescanner.h"
+
+namespace Digikam
+{
+
+class CollectionScannerPoolEntry
+{
+public:
+
+    explicit CollectionScannerPoolEntry(const CollectionScannerJob& job)
+        : job(job),
+          loaded(false)
+    {
+    }
+
+    CollectionScannerJob job;
+    bool                 loaded;
+};
+
+// ------------------------------------------------------------------------------
+
+class CollectionScannerPool::Private
+{
+public:
+
+    Private()
+        : maxPending(0)
+    {
+    }
+
+    int                                 maxPending;
+
+    QThreadPool                         threadPool;
+
+    /// Protects entries and the loaded flag of entries
+    mutable QMutex                      mutex;
+    QWaitCondition                      condVar;
+    QQueue<CollectionScannerPoolEntry*> entries;
+};
+
+// ------------------------------------------------------------------------------
+
+class CollectionScannerLoadTask : public QRunnable
+{
+public:
+
+    CollectionScannerLoadTask(CollectionScannerPool::Private* const d, CollectionScannerPoolEntry* const entry)
+        : d(d),
+          entry(entry)
+    {
+    }
+
+    void run()
+    {
+        entry->job.scanner->loadFromDisk();
+
+        QMutexLocker lock(&d->mutex);
+        entry->loaded = true;
+        d->condVar.wakeAll();
+    }
+
+private:
+
+    CollectionScannerPool::Private* const d;
+    CollectionScannerPoolEntry* const     entry;
+};
+
+// ------------------------------------------------------------------------------
+
+CollectionScannerPool::CollectionScannerPool(int threads, int maxPending)
+    : d(new Private)
+{
+    d->maxPending = qMax(1, maxPending);
+    d->threadPool.setMaxThreadCount(qMax(1, threads));
+}
+
+CollectionScannerPool::~CollectionScannerPool()
+{
+    clear();
+    delete d;
+}
+
+void CollectionScannerPool::enqueue(const CollectionScannerJob& job)
+{
+    CollectionScannerPoolEntry* const entry = new CollectionScannerPoolEntry(job);
+
+    {
+        QMutexLocker lock(&d->mutex);
+        d->entries.enqueue(entry);
+    }
+
+    d->threadPool.start(new CollectionScannerLoadTask(d, entry));
+}
+
+bool CollectionScannerPool::isEmpty() const
+{
+    QMutexLocker lock(&d->mutex);
+    return d->entries.isEmpty();
+}
+
+bool CollectionScannerPool::isFull() const
+{
+    QMutexLocker lock(&d->mutex);
+    return (d->entries.size() >= d->maxPending);
+}
+
+bool CollectionScannerPool::isFirstLoaded() const
+{
+    QMutexLocker lock(&d->mutex);
+    return (!d->entries.isEmpty() && d->entries.head()->loaded);
+}
+
+CollectionScannerJob CollectionScannerPool::takeFirst()
+{
+    QMutexLocker lock(&d->mutex);
+
+    while (!d->entries.head()->loaded)
+    {
+        d->condVar.wait(&d->mutex);
+    }
+
+    CollectionScannerPoolEntry* const entry = d->entries.dequeue();
+    CollectionScannerJob job                = entry->job;
+    delete entry;
+
+    return job;
+}
+
+void CollectionScannerPool::clear()
+{
+    // Tasks not yet started are removed, then wait for the running ones
+    d->threadPool.clear();
+    d->threadPool.waitForDone();
+
+    QMutexLocker lock(&d->mutex);
+
+    if (!d->entries.isEmpty())
+    {
+        qCDebug(DIGIKAM_DATABASE_LOG) << "Discarding" << d->entries.size() << "files loaded for scanning";
+    }
+
+    while (!d->entries.isEmpty())
+    {
+        CollectionScannerPoolEntry* const entry = d->entries.dequeue();
+        delete entry->job.scanner;
+        delete entry;
+    }
+}
+
+} // namespace Digikam
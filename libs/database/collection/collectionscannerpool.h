@@ -0,0 +1,134 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-03-22
+ * Description : pool of threads loading files from disk
+ *               for the collection scanner
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef COLLECTION_SCANNER_POOL_H
+#define COLLECTION_SCANNER_POOL_H
+
+// Qt includes
+
+#include <QString>
+
+namespace Digikam
+{
+
+class ImageScanner;
+
+class CollectionScannerJob
+{
+public:
+
+    /// The ImageScanner operation carried out when the job is committed
+    enum Operation
+    {
+        NewFile,
+        NewFileFullScan,
+        CopiedFrom,
+        ModifiedFile,
+        UpdateHashReuseThumbnail,
+        Rescan
+    };
+
+public:
+
+    explicit CollectionScannerJob(Operation op = NewFile, ImageScanner* const scanner = 0)
+        : operation(op),
+          scanner(scanner),
+          albumId(0),
+          srcId(0),
+          oldFileSize(0),
+          fileWasEdited(false)
+    {
+    }
+
+    Operation     operation;
+    ImageScanner* scanner;
+
+    int           albumId;
+    qlonglong     srcId;
+
+    /// Used by UpdateHashReuseThumbnail
+    QString       oldUniqueHash;
+    qlonglong     oldFileSize;
+    bool          fileWasEdited;
+};
+
+// ------------------------------------------------------------------------------
+
+/**
+ * Calls ImageScanner::loadFromDisk() for queued jobs in a pool of threads,
+ * and hands the jobs back in the order they were queued.
+ * This is the file I/O and metadata parsing part of scanning; the database
+ * is written only when the jobs are taken back, by the thread using this class.
+ * The pool owns the scanners of queued jobs until they are taken back.
+ */
+class CollectionScannerPool
+{
+public:
+
+    /**
+     * The pool uses the given number of threads. maxPending is the number of
+     * jobs after which the pool is full, see isFull().
+     */
+    CollectionScannerPool(int threads, int maxPending);
+    ~CollectionScannerPool();
+
+    void enqueue(const CollectionScannerJob& job);
+
+    bool isEmpty()         const;
+
+    /**
+     * Returns true if as many jobs as given in the constructor are queued
+     * and not taken back: the caller shall take a job before queuing more.
+     */
+    bool isFull()          const;
+
+    /**
+     * Returns true if the first queued job is loaded from disk.
+     */
+    bool isFirstLoaded()   const;
+
+    /**
+     * Takes the first queued job, waiting until it is loaded from disk.
+     * The caller takes ownership of the scanner. The pool must not be empty.
+     * Do not hold a CoreDbAccess or a database transaction while waiting.
+     */
+    CollectionScannerJob takeFirst();
+
+    /**
+     * Removes all queued jobs, waiting for the running threads,
+     * and deletes their scanners.
+     */
+    void clear();
+
+private:
+
+    class Private;
+    Private* const d;
+
+    friend class CollectionScannerLoadTask;
+};
+
+} // namespace Digikam
+
+#endif // COLLECTION_SCANNER_POOL_H
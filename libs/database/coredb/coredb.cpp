@@ -44,6 +44,7 @@ extern "C"
 #include <QFile>
 #include <QFileInfo>
 #include <QDir>
+#include <QHash>
 #include <QVariant>
 
 // KDE includes
@@ -87,6 +88,8 @@ public:
 
     QString constructRelatedImagesSQL(bool fromOrTo, DatabaseRelation::Type type, bool boolean);
     QList<qlonglong> execRelatedImagesQuery(DbEngineSqlQuery& query, qlonglong id, DatabaseRelation::Type type);
+    QVector<QVariantList> fieldsOfItems(const QList<qlonglong>& imageIds, const QString& table,
+                                        const QString& idColumn, const QStringList& fieldNames);
 };
 
 const QString CoreDB::Private::configGroupName(QLatin1String("CoreDB Settings"));
@@ -1604,6 +1607,88 @@ QVariantList CoreDB::getImagesFields(qlonglong imageID, DatabaseFields::Images f
     return values;
 }
 
+QVector<QVariantList> CoreDB::Private::fieldsOfItems(const QList<qlonglong>& imageIds, const QString& table,
+                                                     const QString& idColumn, const QStringList& fieldNames)
+{
+    QVector<QVariantList> results(imageIds.size());
+    QMultiHash<qlonglong, int> rows;
+    rows.reserve(imageIds.size());
+
+    for (int i = 0 ; i < imageIds.size() ; ++i)
+    {
+        rows.insert(imageIds.at(i), i);
+    }
+
+    // The chunks have the same size, apart from the last one: their statement is prepared once.
+    const int chunkSize = qMin(db->maximumBoundValues(), 500);
+    const int count     = fieldNames.size();
+
+    QString select      = QString::fromUtf8("SELECT %1, %2 FROM %3 WHERE %1 IN (")
+                          .arg(idColumn)
+                          .arg(fieldNames.join(QString::fromUtf8(", ")))
+                          .arg(table);
+
+    for (int start = 0 ; start < imageIds.size() ; start += chunkSize)
+    {
+        QVariantList boundValues;
+        const int    end = qMin(start + chunkSize, imageIds.size());
+
+        for (int i = start ; i < end ; ++i)
+        {
+            boundValues << imageIds.at(i);
+        }
+
+        QString query = select;
+        CoreDB::addBoundValuePlaceholders(query, boundValues.size());
+        query        += QString::fromUtf8(");");
+
+        QVariantList values;
+        db->execSql(query, boundValues, &values);
+
+        for (int row = 0 ; row + count < values.size() ; row += count + 1)
+        {
+            const QVariantList fields = values.mid(row + 1, count);
+
+            foreach(int index, rows.values(values.at(row).toLongLong()))
+            {
+                results[index] = fields;
+            }
+        }
+    }
+
+    return results;
+}
+
+QVector<QVariantList> CoreDB::getImagesFields(const QList<qlonglong>& imageIds, DatabaseFields::Images fields)
+{
+    if (imageIds.isEmpty() || fields == DatabaseFields::ImagesNone)
+    {
+        return QVector<QVariantList>(imageIds.size());
+    }
+
+    QStringList fieldNames        = imagesFieldList(fields);
+    QVector<QVariantList> results = d->fieldsOfItems(imageIds, QLatin1String("Images"), QLatin1String("id"), fieldNames);
+
+    // Convert date times to QDateTime, they come as QString
+    if (fields & DatabaseFields::ModificationDate)
+    {
+        int index = fieldNames.indexOf(QLatin1String("modificationDate"));
+
+        for (int i = 0 ; i < results.size() ; ++i)
+        {
+            QVariantList& values = results[i];
+
+            if (!values.isEmpty())
+            {
+                values[index] = (values.at(index).isNull() ? QDateTime()
+                                 : QDateTime::fromString(values.at(index).toString(), Qt::ISODate));
+            }
+        }
+    }
+
+    return results;
+}
+
 QVariantList CoreDB::getImageInformation(qlonglong imageID, DatabaseFields::ImageInformation fields)
 {
     QVariantList values;
@@ -1636,6 +1721,48 @@ QVariantList CoreDB::getImageInformation(qlonglong imageID, DatabaseFields::Imag
     return values;
 }
 
+QVector<QVariantList> CoreDB::getImageInformation(const QList<qlonglong>& imageIds, DatabaseFields::ImageInformation fields)
+{
+    if (imageIds.isEmpty() || fields == DatabaseFields::ImageInformationNone)
+    {
+        return QVector<QVariantList>(imageIds.size());
+    }
+
+    QStringList fieldNames        = imageInformationFieldList(fields);
+    QVector<QVariantList> results = d->fieldsOfItems(imageIds, QLatin1String("ImageInformation"), QLatin1String("imageid"), fieldNames);
+
+    // Convert date times to QDateTime, they come as QString
+    QList<int> dateIndexes;
+
+    if (fields & DatabaseFields::CreationDate)
+    {
+        dateIndexes << fieldNames.indexOf(QLatin1String("creationDate"));
+    }
+
+    if (fields & DatabaseFields::DigitizationDate)
+    {
+        dateIndexes << fieldNames.indexOf(QLatin1String("digitizationDate"));
+    }
+
+    for (int i = 0 ; !dateIndexes.isEmpty() && i < results.size() ; ++i)
+    {
+        QVariantList& values = results[i];
+
+        if (values.isEmpty())
+        {
+            continue;
+        }
+
+        foreach(int index, dateIndexes)
+        {
+            values[index] = (values.at(index).isNull() ? QDateTime()
+                                                       : QDateTime::fromString(values.at(index).toString(), Qt::ISODate));
+        }
+    }
+
+    return results;
+}
+
 QVariantList CoreDB::getImageMetadata(qlonglong imageID, DatabaseFields::ImageMetadata fields)
 {
     QVariantList values;
@@ -763,6 +763,13 @@ public:
      */
     QVariantList getImagesFields(qlonglong imageID, DatabaseFields::Images imagesFields);
 
+    /**
+     * For a list of items, return the given fields of the Images table, in the order above.
+     * Amounts to calling getImagesFields for each id in imageIds, but reads the items in
+     * chunks with one query each. The list of an item not found is empty.
+     */
+    QVector<QVariantList> getImagesFields(const QList<qlonglong>& imageIds, DatabaseFields::Images imagesFields);
+
     /**
      * Add (or replace) the ImageInformation of the specified item.
      * If there is already an entry, it will be discarded.
@@ -798,6 +805,13 @@ public:
     QVariantList getImageInformation(qlonglong imageID,
                                      DatabaseFields::ImageInformation infoFields = DatabaseFields::ImageInformationAll);
 
+    /**
+     * For a list of items, read image information as above, with one query for each chunk of items.
+     * The list of an item without image information is empty.
+     */
+    QVector<QVariantList> getImageInformation(const QList<qlonglong>& imageIds,
+                                              DatabaseFields::ImageInformation infoFields);
+
     /**
      * Add (or replace) the ImageMetadata of the specified item.
      * If there is already an entry, it will be discarded.
@@ -28,6 +28,7 @@
 
 #include <QEventLoop>
 #include <QMutex>
+#include <QReadWriteLock>
 #include <QSqlDatabase>
 #include <QUuid>
 
@@ -62,6 +63,7 @@ public:
         : backend(0),
           db(0),
           databaseWatch(0),
+          readers(QReadWriteLock::Recursive),
           initializing(false)
     {
         // Create a unique identifier for this application (as an application accessing a database
@@ -79,6 +81,10 @@ public:
     CoreDbWatch*        databaseWatch;
     DbEngineParameters  parameters;
     DbEngineLocking     lock;
+
+    /// Held for reading by the concurrent readers, and for writing when the backend is replaced
+    QReadWriteLock      readers;
+
     QString             lastError;
     QUuid               applicationIdentifier;
 
@@ -109,6 +115,49 @@ public:
 CoreDbAccessStaticPriv* CoreDbAccess::d = 0;
 
 CoreDbAccess::CoreDbAccess()
+    : exclusive(true)
+{
+    lockExclusive();
+}
+
+CoreDbAccess::CoreDbAccess(AccessMode mode)
+    : exclusive(true)
+{
+    if (mode == ReadOnly)
+    {
+        // You will want to call setParameters before constructing CoreDbAccess
+        Q_ASSERT(d);
+
+        // A thread which already holds the lock goes on with it. Waiting for the readers lock
+        // while holding the mutex would invert the order of setParameters(): readers, then mutex.
+        // The mutex is recursive, and the lock count is only above 0 while a thread holds it.
+        if (d->lock.mutex.tryLock())
+        {
+            if (d->lock.lockCount > 0)
+            {
+                d->lock.lockCount++;
+                return;
+            }
+
+            d->lock.mutex.unlock();
+        }
+
+        d->readers.lockForRead();
+
+        if (d->backend && d->backend->isReady() && d->backend->supportsConcurrentReads() && !d->initializing)
+        {
+            // Each thread has its own connection: the reader does not need the lock.
+            exclusive = false;
+            return;
+        }
+
+        d->readers.unlock();
+    }
+
+    lockExclusive();
+}
+
+void CoreDbAccess::lockExclusive()
 {
     // You will want to call setParameters before constructing CoreDbAccess
     Q_ASSERT(d);
@@ -131,11 +180,18 @@ CoreDbAccess::CoreDbAccess()
 
 CoreDbAccess::~CoreDbAccess()
 {
+    if (!exclusive)
+    {
+        d->readers.unlock();
+        return;
+    }
+
     d->lock.lockCount--;
     d->lock.mutex.unlock();
 }
 
 CoreDbAccess::CoreDbAccess(bool)
+    : exclusive(true)
 {
     // private constructor, when mutex is locked and
     // backend should not be checked
@@ -201,6 +257,8 @@ void CoreDbAccess::setParameters(const DbEngineParameters& parameters, Applicati
         d = new CoreDbAccessStaticPriv();
     }
 
+    // Wait for the concurrent readers before the lock, which they may take on errors.
+    QWriteLocker readersLock(&d->readers);
     CoreDbAccessMutexLocker lock(d);
 
     if (d->parameters == parameters)
@@ -342,6 +400,7 @@ void CoreDbAccess::cleanUpDatabase()
 {
     if (d)
     {
+        QWriteLocker readersLock(&d->readers);
         CoreDbAccessMutexLocker locker(d);
 
         if (d->backend)
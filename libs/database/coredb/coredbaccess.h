@@ -46,6 +46,11 @@ class CoreDbAccessStaticPriv;
  *  but _not_ for other processes. This is due to the fact that while databases allow
  *  concurrent access (of course), their client libs may not be thread-safe.
  *
+ *  Accessors which only read from the database can be created with the ReadOnly mode:
+ *  when the backend allows concurrent reads (MySQL, or SQLite with the write-ahead log),
+ *  they do not take the lock, and run in parallel with each other and with the holder
+ *  of the lock. Anything which writes, or uses the caches of CoreDB, needs the lock.
+ *
  *  When initializing your application, you need to call two methods:
  *  - in a not-yet-multithreaded context, you need to call setParameters
  *  - to make sure that the database is available and the schema
@@ -61,6 +66,12 @@ public:
         DatabaseSlave
     };
 
+    enum AccessMode
+    {
+        ReadWrite,
+        ReadOnly
+    };
+
 public:
 
     /**
@@ -72,6 +83,13 @@ public:
      * for a full opening process including schema update and error messages.
      */
     CoreDbAccess();
+
+    /**
+     * Create a CoreDbAccess object with the given mode. A ReadOnly object only runs
+     * queries which do not change the database. If the backend does not support
+     * concurrent reads, or is not ready yet, it locks the database as ReadWrite.
+     */
+    explicit CoreDbAccess(AccessMode mode);
     ~CoreDbAccess();
 
     /**
@@ -144,6 +162,13 @@ private:
 
     explicit CoreDbAccess(bool);
 
+    void lockExclusive();
+
+private:
+
+    /// True if this object holds the lock, false for a concurrent reader
+    bool exclusive;
+
     friend class CoreDbAccessUnlock;
     static CoreDbAccessStaticPriv* d;
 };
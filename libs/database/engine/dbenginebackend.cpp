@@ -36,7 +36,9 @@
 #include <QSqlDatabase>
 #include <QSqlDriver>
 #include <QSqlError>
+#include <QSqlQuery>
 #include <QSqlRecord>
+#include <QStorageInfo>
 #include <QThread>
 #include <QTime>
 
@@ -70,9 +72,14 @@ BdEngineBackendPrivate::ErrorLocker::ErrorLocker(BdEngineBackendPrivate* const d
 
 // -----------------------------------------------------------------------------------------
 
+/// The number of statements kept prepared by each connection
+static const int maxPreparedQueries = 100;
+
 DbEngineThreadData::DbEngineThreadData()
     : valid(0),
-      transactionCount(0)
+      transactionCount(0),
+      preparedQueries(maxPreparedQueries),
+      queryCacheGeneration(0)
 {
 }
 
@@ -95,6 +102,9 @@ void DbEngineThreadData::closeDatabase()
         connectionToRemove = database.connectionName();
     }
 
+    // The statements belong to the connection
+    preparedQueries.clear();
+
     // Destroy object
     database         = QSqlDatabase();
 
@@ -112,6 +122,10 @@ void DbEngineThreadData::closeDatabase()
 BdEngineBackendPrivate::BdEngineBackendPrivate(BdEngineBackend* const backend)
     : currentValidity(0),
       isInTransaction(false),
+      writeAheadLog(false),
+      queryCacheGeneration(0),
+      queryCacheHits(0),
+      queryCacheMisses(0),
       status(BdEngineBackend::Unavailable),
       lock(0),
       operationStatus(BdEngineBackend::ExecuteNormal),
@@ -188,8 +202,14 @@ QSqlDatabase BdEngineBackendPrivate::createDatabaseConnection()
     if (parameters.isSQLite())
     {
         QStringList toAdd;
-        // enable shared cache, especially useful with SQLite >= 3.5.0
-        toAdd << QLatin1String("QSQLITE_ENABLE_SHARED_CACHE");
+
+        // enable shared cache, especially useful with SQLite >= 3.5.0.
+        // Connections sharing their cache lock tables against each other: not with the write-ahead log.
+        if (!writeAheadLog)
+        {
+            toAdd << QLatin1String("QSQLITE_ENABLE_SHARED_CACHE");
+        }
+
         // We do our own waiting.
         toAdd << QLatin1String("QSQLITE_BUSY_TIMEOUT=0");
 
@@ -211,6 +231,61 @@ QSqlDatabase BdEngineBackendPrivate::createDatabaseConnection()
     return db;
 }
 
+bool BdEngineBackendPrivate::canUseWriteAheadLog() const
+{
+    if (!parameters.isSQLite())
+    {
+        return false;
+    }
+
+    // The readers and the writer share an index in memory mapped from a file next to the database:
+    // this does not work on network file systems.
+
+    QStorageInfo storage(QFileInfo(parameters.databaseNameCore).absolutePath());
+    const QString type = QString::fromLatin1(storage.fileSystemType()).toLower();
+
+    return (!type.startsWith(QLatin1String("nfs"))  &&
+            !type.contains(QLatin1String("cifs"))   &&
+            !type.contains(QLatin1String("smb"))    &&
+            !type.contains(QLatin1String("sshfs")));
+}
+
+bool BdEngineBackendPrivate::setJournalMode(const QSqlDatabase& db, bool useWriteAheadLog)
+{
+    // The journal mode is stored in the database file, and used by all connections opened later.
+    // A database which cannot use the write-ahead log goes back to the rollback journal: it may
+    // have been switched before, as on a local disk before it was moved to a network share.
+
+    QSqlQuery query(db);
+    const QString mode = useWriteAheadLog ? QLatin1String("WAL") : QLatin1String("DELETE");
+
+    if (!query.exec(QString::fromLatin1("PRAGMA journal_mode=%1;").arg(mode)) || !query.next())
+    {
+        qCWarning(DIGIKAM_DBENGINE_LOG) << "Cannot set the journal mode of" << parameters.databaseNameCore
+                                        << "to" << mode << query.lastError();
+        return false;
+    }
+
+    const QString current = query.value(0).toString();
+
+    if (current.compare(mode, Qt::CaseInsensitive) != 0)
+    {
+        qCWarning(DIGIKAM_DBENGINE_LOG) << "The journal mode of" << parameters.databaseNameCore
+                                        << "stays" << current << "instead of" << mode;
+    }
+
+    return (useWriteAheadLog && (current.compare(QLatin1String("wal"), Qt::CaseInsensitive) == 0));
+}
+
+bool BdEngineBackendPrivate::isSchemaStatement(const QString& sql)
+{
+    const QString statement = sql.trimmed();
+
+    return (statement.startsWith(QLatin1String("CREATE"), Qt::CaseInsensitive) ||
+            statement.startsWith(QLatin1String("ALTER"),  Qt::CaseInsensitive) ||
+            statement.startsWith(QLatin1String("DROP"),   Qt::CaseInsensitive));
+}
+
 void BdEngineBackendPrivate::closeDatabaseForThread()
 {
     if (threadDataStorage.hasLocalData())
@@ -762,7 +837,13 @@ bool BdEngineBackend::isCompatible(const DbEngineParameters& parameters)
 bool BdEngineBackend::open(const DbEngineParameters& parameters)
 {
     Q_D(BdEngineBackend);
-    d->parameters = parameters;
+    d->parameters    = parameters;
+
+    // The journal mode is decided here only: the other threads read writeAheadLog without lock,
+    // once the backend is ready. Connections in write-ahead log mode do not share their cache.
+    const bool useWriteAheadLog = d->canUseWriteAheadLog();
+    d->writeAheadLog            = useWriteAheadLog;
+
     // This will make possibly opened thread dbs reload at next access
     d->currentValidity++;
 
@@ -787,6 +868,16 @@ bool BdEngineBackend::open(const DbEngineParameters& parameters)
         }
         else
         {
+            if (d->parameters.isSQLite())
+            {
+                d->writeAheadLog = d->setJournalMode(database, useWriteAheadLog);
+
+                if (useWriteAheadLog && !d->writeAheadLog)
+                {
+                    qCWarning(DIGIKAM_DBENGINE_LOG) << "Concurrent reads are disabled for" << d->parameters.databaseNameCore;
+                }
+            }
+
             break;
         }
     }
@@ -798,6 +889,10 @@ bool BdEngineBackend::open(const DbEngineParameters& parameters)
 void BdEngineBackend::close()
 {
     Q_D(BdEngineBackend);
+
+    qCDebug(DIGIKAM_DBENGINE_LOG) << "Prepared statements cache:" << d->queryCacheHits.load() << "hits,"
+                                  << d->queryCacheMisses.load() << "misses";
+
     d->closeDatabaseForThread();
     d->status = Unavailable;
 }
@@ -808,6 +903,18 @@ BdEngineBackend::Status BdEngineBackend::status() const
     return d->status;
 }
 
+bool BdEngineBackend::supportsConcurrentReads() const
+{
+    Q_D(const BdEngineBackend);
+
+    if (d->parameters.isMySQL())
+    {
+        return true;
+    }
+
+    return d->writeAheadLog;
+}
+
 /*
 bool BdEngineBackend::execSql(const QString& sql, QStringList* const values)
 {
@@ -882,23 +989,32 @@ BdEngineBackend::QueryState BdEngineBackend::handleQueryResult(DbEngineSqlQuery&
 
 BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql, QList<QVariant>* const values, QVariant* const lastInsertId)
 {
-    DbEngineSqlQuery query = execQuery(sql);
-    return handleQueryResult(query, values, lastInsertId);
+    DbEngineSqlQuery query = cachedQuery(sql);
+    exec(query);
+    QueryState state       = handleQueryResult(query, values, lastInsertId);
+    query.finish();
+    return state;
 }
 
 BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql, const QVariant& boundValue1,
                                                      QList<QVariant>* const values, QVariant* const lastInsertId)
 {
-    DbEngineSqlQuery query = execQuery(sql, boundValue1);
-    return handleQueryResult(query, values, lastInsertId);
+    DbEngineSqlQuery query = cachedQuery(sql);
+    execQuery(query, boundValue1);
+    QueryState state       = handleQueryResult(query, values, lastInsertId);
+    query.finish();
+    return state;
 }
 
 BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
                                                      const QVariant& boundValue1, const QVariant& boundValue2,
                                                      QList<QVariant>* const values, QVariant* const lastInsertId)
 {
-    DbEngineSqlQuery query = execQuery(sql, boundValue1, boundValue2);
-    return handleQueryResult(query, values, lastInsertId);
+    DbEngineSqlQuery query = cachedQuery(sql);
+    execQuery(query, boundValue1, boundValue2);
+    QueryState state       = handleQueryResult(query, values, lastInsertId);
+    query.finish();
+    return state;
 }
 
 BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
@@ -906,8 +1022,11 @@ BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
                                                      const QVariant& boundValue3, QList<QVariant>* const values,
                                                      QVariant* const lastInsertId)
 {
-    DbEngineSqlQuery query = execQuery(sql, boundValue1, boundValue2, boundValue3);
-    return handleQueryResult(query, values, lastInsertId);
+    DbEngineSqlQuery query = cachedQuery(sql);
+    execQuery(query, boundValue1, boundValue2, boundValue3);
+    QueryState state       = handleQueryResult(query, values, lastInsertId);
+    query.finish();
+    return state;
 }
 
 BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
@@ -915,15 +1034,21 @@ BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
                                                      const QVariant& boundValue3, const QVariant& boundValue4,
                                                      QList<QVariant>* const values, QVariant* const lastInsertId)
 {
-    DbEngineSqlQuery query = execQuery(sql, boundValue1, boundValue2, boundValue3, boundValue4);
-    return handleQueryResult(query, values, lastInsertId);
+    DbEngineSqlQuery query = cachedQuery(sql);
+    execQuery(query, boundValue1, boundValue2, boundValue3, boundValue4);
+    QueryState state       = handleQueryResult(query, values, lastInsertId);
+    query.finish();
+    return state;
 }
 
 BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql, const QList<QVariant>& boundValues,
                                                      QList<QVariant>* const values, QVariant* const lastInsertId)
 {
-    DbEngineSqlQuery query = execQuery(sql, boundValues);
-    return handleQueryResult(query, values, lastInsertId);
+    DbEngineSqlQuery query = cachedQuery(sql);
+    execQuery(query, boundValues);
+    QueryState state       = handleQueryResult(query, values, lastInsertId);
+    query.finish();
+    return state;
 }
 
 BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql, const QMap<QString, QVariant>& bindingMap,
@@ -1376,6 +1501,9 @@ BdEngineBackend::QueryState BdEngineBackend::execDirectSql(const QString& sql)
         }
     }
 
+    // Direct statements change the schema: the prepared statements may refer to dropped tables.
+    d->queryCacheGeneration.ref();
+
     return BdEngineBackend::NoErrors;
 }
 
@@ -1411,6 +1539,9 @@ BdEngineBackend::QueryState BdEngineBackend::execDirectSqlWithResult(const QStri
         }
     }
 
+    // Direct statements change the schema: the prepared statements may refer to dropped tables.
+    d->queryCacheGeneration.ref();
+
     return BdEngineBackend::NoErrors;
 }
 
@@ -1446,6 +1577,12 @@ bool BdEngineBackend::exec(DbEngineSqlQuery& query)
         }
     }
 
+    // Schema statements run as prepared queries too, e.g. by the schema updater and the database actions.
+    if (d->isSchemaStatement(query.lastQuery()))
+    {
+        d->queryCacheGeneration.ref();
+    }
+
     return true;
 }
 
@@ -1479,6 +1616,12 @@ bool BdEngineBackend::execBatch(DbEngineSqlQuery& query)
         }
     }
 
+    // Schema statements run as prepared queries too, e.g. by the schema updater and the database actions.
+    if (d->isSchemaStatement(query.lastQuery()))
+    {
+        d->queryCacheGeneration.ref();
+    }
+
     return true;
 }
 
@@ -1510,6 +1653,61 @@ DbEngineSqlQuery BdEngineBackend::prepareQuery(const QString& sql)
     }
 }
 
+DbEngineSqlQuery BdEngineBackend::cachedQuery(const QString& sql)
+{
+    Q_D(BdEngineBackend);
+
+    // Opens the connection of this thread, or opens it again if it was invalidated.
+    d->databaseForThread();
+
+    // A schema statement is run once, and would only push the useful statements out of the cache.
+    if (d->isSchemaStatement(sql))
+    {
+        return prepareQuery(sql);
+    }
+
+    DbEngineThreadData* const threadData = d->threadDataStorage.localData();
+    const int generation                 = d->queryCacheGeneration.load();
+
+    if (threadData->queryCacheGeneration != generation)
+    {
+        threadData->preparedQueries.clear();
+        threadData->queryCacheGeneration = generation;
+    }
+
+    DbEngineSqlQuery* const cached = threadData->preparedQueries.object(sql);
+
+    // A statement still running for a caller up the stack cannot be shared.
+
+    if (cached && !cached->isActive())
+    {
+        d->queryCacheHits.ref();
+        return *cached;
+    }
+
+    d->queryCacheMisses.ref();
+    DbEngineSqlQuery query = prepareQuery(sql);
+
+    if (!cached && query.lastError().type() == QSqlError::NoError)
+    {
+        threadData->preparedQueries.insert(sql, new DbEngineSqlQuery(query));
+    }
+
+    return query;
+}
+
+int BdEngineBackend::cachedQueryHits() const
+{
+    Q_D(const BdEngineBackend);
+    return d->queryCacheHits.load();
+}
+
+int BdEngineBackend::cachedQueryMisses() const
+{
+    Q_D(const BdEngineBackend);
+    return d->queryCacheMisses.load();
+}
+
 DbEngineSqlQuery BdEngineBackend::copyQuery(const DbEngineSqlQuery& old)
 {
     DbEngineSqlQuery query = getQuery();
@@ -195,6 +195,13 @@ public:
         return status() == OpenSchemaChecked;
     }
 
+    /**
+     * Returns true if connections of different threads can read the database while another
+     * one writes to it: a MySQL database, or a SQLite database in write-ahead log mode.
+     * SQLite databases on a local file system are switched to this mode when opened.
+     */
+    bool supportsConcurrentReads() const;
+
     /**
      * Add a DbEngineErrorHandler. This object must be created in the main thread.
      * If a database error occurs, this object can handle problem solving and user interaction.
@@ -379,6 +386,19 @@ public:
      * Creates a query object prepared with the statement, waiting for bound values
      */
     DbEngineSqlQuery prepareQuery(const QString& sql);
+    /**
+     * Returns a query prepared with the statement from the cache of the connection of this thread,
+     * preparing it on first use. The cache keeps the most recently used statements of each connection,
+     * and is emptied when the connection is closed or when a CREATE, ALTER or DROP statement is run.
+     * These schema statements are never cached themselves.
+     * The query is shared with the cache: call finish() on it once its results are read.
+     */
+    DbEngineSqlQuery cachedQuery(const QString& sql);
+    /**
+     * Returns the number of cachedQuery() calls served by the cache, and prepared again.
+     */
+    int cachedQueryHits()   const;
+    int cachedQueryMisses() const;
     /**
      * Creates an empty query object waiting for the statement
      */
@@ -27,6 +27,8 @@
 
 // Qt includes
 
+#include <QAtomicInt>
+#include <QCache>
 #include <QHash>
 #include <QSqlDatabase>
 #include <QThread>
@@ -38,6 +40,7 @@
 #include "digikam_export.h"
 #include "dbengineparameters.h"
 #include "dbengineerrorhandler.h"
+#include "dbenginesqlquery.h"
 
 namespace Digikam
 {
@@ -51,10 +54,16 @@ public:
 
     void closeDatabase();
 
-    QSqlDatabase database;
-    int          valid;
-    int          transactionCount;
-    QSqlError    lastError;
+    QSqlDatabase                      database;
+    int                               valid;
+    int                               transactionCount;
+    QSqlError                         lastError;
+
+    /// The statements prepared on this connection, by SQL text, the least recently used dropped first
+    QCache<QString, DbEngineSqlQuery> preparedQueries;
+
+    /// This compares to the backend's queryCacheGeneration: if different, the cached statements are dropped
+    int                               queryCacheGeneration;
 };
 
 class DIGIKAM_EXPORT BdEngineBackendPrivate : public DbEngineErrorAnswer
@@ -74,6 +83,9 @@ public:
 
     QSqlDatabase createDatabaseConnection();
     void closeDatabaseForThread();
+    bool canUseWriteAheadLog() const;
+    bool setJournalMode(const QSqlDatabase& db, bool useWriteAheadLog);
+    static bool isSchemaStatement(const QString& sql);
     bool incrementTransactionCount();
     bool decrementTransactionCount();
 
@@ -109,6 +121,15 @@ public:
 
     bool                                      isInTransaction;
 
+    // SQLite only: the connections use the write-ahead log, readers are not blocked by a writer.
+    // Only written by open(), before the backend is ready.
+    bool                                      writeAheadLog;
+
+    // Increased when the schema may have changed, making the threads drop their prepared statements
+    QAtomicInt                                queryCacheGeneration;
+    QAtomicInt                                queryCacheHits;
+    QAtomicInt                                queryCacheMisses;
+
     QString                                   backendName;
 
     DbEngineParameters                        parameters;
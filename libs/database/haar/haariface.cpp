@@ -31,14 +31,21 @@
 #include <fstream>
 #include <cmath>
 #include <cstring>
+#include <algorithm>
+#include <limits>
 
 // Qt includes
 
+#include <QAtomicInt>
 #include <QByteArray>
 #include <QDataStream>
 #include <QImage>
 #include <QImageReader>
 #include <QMap>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
 
 // Local includes
 
@@ -52,15 +59,13 @@
 #include "coredbbackend.h"
 #include "coredbsearchxml.h"
 #include "dbenginesqlquery.h"
+#include "haarsignatureindex.h"
 
 using namespace std;
 
 namespace Digikam
 {
 
-typedef QMap<qlonglong, Haar::SignatureData> SignatureCache;
-typedef QMap<qlonglong, int>                 AlbumCache;
-
 /** This class encapsulates the Haar signature in a QByteArray
  *  that can be stored as a BLOB in the database.
  *
@@ -147,6 +152,230 @@ public:
 
 // -----------------------------------------------------------------------------------------------------
 
+/** The signatures of the images searched for duplicates, stored in flat arrays
+ *  sorted by image id. The arrays are read-only while searching and shared
+ *  by all search threads.
+ */
+class DuplicatesSignatures
+{
+public:
+
+    int count() const
+    {
+        return ids.size();
+    }
+
+    const double* average(int index) const
+    {
+        return averages.constData() + 3 * index;
+    }
+
+    const Haar::Idx* coefficients(int index, int channel) const
+    {
+        return coefs.constData() + (3 * index + channel) * Haar::NumberOfCoefficients;
+    }
+
+    void signature(int index, Haar::SignatureData* const sig) const
+    {
+        for (int channel = 0; channel < 3; ++channel)
+        {
+            sig->avg[channel] = average(index)[channel];
+            memcpy(sig->sig[channel], coefficients(index, channel), sizeof(sig->sig[channel]));
+        }
+    }
+
+public:
+
+    QVector<qlonglong> ids;
+    QVector<int>       albums;
+    QVector<double>    averages;    // 3 per image
+    QVector<Haar::Idx> coefs;       // 3 * Haar::NumberOfCoefficients per image
+};
+
+/** A match found for a query image: the index of the matching image and its similarity.
+ */
+typedef QPair<int, double> DuplicatesMatch;
+
+/** State shared by the threads of a duplicates search. Each query image is processed
+ *  once by one thread, and its matches are stored at the query index in results.
+ */
+class DuplicatesSearchContext
+{
+public:
+
+    DuplicatesSearchContext()
+        : iface(0),
+          signatures(0),
+          bin(0),
+          requiredPercentage(0.0),
+          maximumPercentage(0.0),
+          restriction(HaarIface::None)
+    {
+    }
+
+    HaarIface*                              iface;
+    const DuplicatesSignatures*             signatures;
+    const Haar::WeightBin*                  bin;
+    double                                  requiredPercentage;
+    double                                  maximumPercentage;
+    HaarIface::DuplicatesSearchRestrictions restriction;
+
+    QAtomicInt                              nextQuery;
+    QAtomicInt                              processed;
+    QAtomicInt                              canceled;
+
+    QVector<QVector<DuplicatesMatch> >      results;
+};
+
+class DuplicatesSearchTask : public QRunnable
+{
+public:
+
+    explicit DuplicatesSearchTask(DuplicatesSearchContext* const context)
+        : c(context)
+    {
+    }
+
+    void run()
+    {
+        const int count = c->signatures->count();
+        int query;
+
+        while (!c->canceled.load() && (query = c->nextQuery.fetchAndAddOrdered(1)) < count)
+        {
+            c->results[query] = searchMatches(query);
+            c->processed.ref();
+        }
+    }
+
+private:
+
+    /** Same computations as HaarIface::bestMatchesWithThreshold() and HaarIface::calculateScore(),
+     *  over all signatures.
+     */
+    QVector<DuplicatesMatch> searchMatches(int query)
+    {
+        const DuplicatesSignatures& sigs = *c->signatures;
+        Haar::Weights weights(Haar::Weights::ScannedSketch);
+
+        Haar::SignatureData querySig;
+        sigs.signature(query, &querySig);
+
+        for (int channel = 0; channel < 3; ++channel)
+        {
+            queryMaps[channel].fill(querySig.sig[channel]);
+        }
+
+        double lowest, highest;
+        c->iface->getBestAndWorstPossibleScore(&querySig, HaarIface::ScannedSketch, &lowest, &highest);
+
+        const double scoreRange    = highest - lowest;
+        const double requiredScore = lowest + scoreRange * (1.0 - c->requiredPercentage);
+        const double supremum      = (floor(c->maximumPercentage*100 + 1.0))/100;
+
+        const int queryAlbum       = sigs.albums.at(query);
+        const double* const qAvg   = sigs.average(query);
+        QVector<DuplicatesMatch> matches;
+
+        for (int target = 0 ; target < sigs.count() ; ++target)
+        {
+            // Same as HaarIface::fulfillsRestrictions() without target albums
+            if (target != query && c->restriction != HaarIface::None)
+            {
+                const bool sameAlbum = (sigs.albums.at(target) == queryAlbum);
+
+                if ((c->restriction == HaarIface::SameAlbum && !sameAlbum) ||
+                    (c->restriction == HaarIface::DifferentAlbum && sameAlbum))
+                {
+                    continue;
+                }
+            }
+
+            const double* const tAvg = sigs.average(target);
+            double score             = 0.0;
+
+            for (int channel = 0; channel < 3; ++channel)
+            {
+                score += weights.weightForAverage(channel) * fabs(qAvg[channel] - tAvg[channel]);
+            }
+
+            for (int channel = 0; channel < 3; ++channel)
+            {
+                const Haar::Idx* const sig         = sigs.coefficients(target, channel);
+                const Haar::SignatureMap& queryMap = queryMaps[channel];
+
+                for (int coef = 0; coef < Haar::NumberOfCoefficients; ++coef)
+                {
+                    if (queryMap[sig[coef]])
+                    {
+                        score -= weights.weight(c->bin->binAbs(sig[coef]), channel);
+                    }
+                }
+            }
+
+            if (score <= requiredScore)
+            {
+                const double percentage = 1.0 - (score - lowest) / scoreRange;
+
+                if (target == query || percentage < supremum)
+                {
+                    matches << DuplicatesMatch(target, percentage);
+                }
+            }
+        }
+
+        return matches;
+    }
+
+private:
+
+    DuplicatesSearchContext* const c;
+    Haar::SignatureMap             queryMaps[3];
+};
+
+// -----------------------------------------------------------------------------------------------------
+
+/** The restrictions of HaarIface searches on the images of the signature index.
+ */
+class HaarSearchFilter : public HaarSignatureIndex::Filter
+{
+public:
+
+    HaarSearchFilter(HaarIface* const iface, QList<int>& targetAlbums, const QSet<int>& albumRoots,
+                     HaarIface::DuplicatesSearchRestrictions restriction,
+                     qlonglong originalImageId, int originalAlbumId)
+        : iface(iface),
+          targetAlbums(targetAlbums),
+          albumRoots(albumRoots),
+          restriction(restriction),
+          originalImageId(originalImageId),
+          originalAlbumId(originalAlbumId)
+    {
+    }
+
+    bool accepts(qlonglong imageid, int albumId, int albumRootId) const
+    {
+        if (!albumRoots.isEmpty() && !albumRoots.contains(albumRootId))
+        {
+            return false;
+        }
+
+        return iface->fulfillsRestrictions(imageid, albumId, originalImageId, originalAlbumId,
+                                           targetAlbums, restriction);
+    }
+
+private:
+
+    HaarIface* const                        iface;
+    QList<int>&                             targetAlbums;
+    const QSet<int>&                        albumRoots;
+    HaarIface::DuplicatesSearchRestrictions restriction;
+    qlonglong                               originalImageId;
+    int                                     originalAlbumId;
+};
+
+// -----------------------------------------------------------------------------------------------------
+
 class HaarIface::Private
 {
 public:
@@ -155,9 +384,6 @@ public:
     {
         data                       = 0;
         bin                        = 0;
-        signatureCache             = 0;
-        albumCache                 = 0;
-        useSignatureCache          = false;
 
         signatureQuery             = QString::fromUtf8("SELECT M.imageid, 0, M.matrix, Images.album "
                                              " FROM ImageHaarMatrix AS M "
@@ -169,14 +395,18 @@ public:
                                              "    INNER JOIN Images ON Images.id=M.imageid "
                                              "    INNER JOIN Albums ON Albums.id=Images.album"
                                              " WHERE Images.status=1;");
+
+        signatureOfImagesQuery     = QString::fromUtf8("SELECT M.imageid, Albums.albumRoot, M.matrix, Images.album "
+                                             " FROM ImageHaarMatrix AS M "
+                                             "    INNER JOIN Images ON Images.id=M.imageid "
+                                             "    INNER JOIN Albums ON Albums.id=Images.album"
+                                             " WHERE Images.status=1 AND M.imageid IN (");
     }
 
     ~Private()
     {
         delete data;
         delete bin;
-        delete signatureCache;
-        delete albumCache;
     }
 
     void createLoadingBuffer()
@@ -195,88 +425,151 @@ public:
         }
     }
 
-    void setSignatureCacheEnabled(bool cache, const QSet<qlonglong>& imageIds)
+    /** Loads the signatures of all images into the shared index, if needed.
+     */
+    void loadSignatureIndex()
     {
-        setSignatureCacheEnabled(cache);
+        HaarSignatureIndex* const index = HaarSignatureIndex::instance();
+        QList<qlonglong>          imageIds;
 
-        // stop here if we disable cached signatures
-        if (!cache || imageIds.isEmpty())
+        if (!index->beginLoading(imageIds))
         {
             return;
         }
 
-        // Remove all ids from the fully created signatureCache that are not needed for the duplicates search.
-        // This is usually faster then starting a query for every single id in imageIds.
-        for (SignatureCache::iterator it = signatureCache->begin();
-             it != signatureCache->end(); )
         {
-            if (!imageIds.contains(it.key()))
+            CoreDbAccess access;
+
+            if (imageIds.isEmpty())
             {
-                it = signatureCache->erase(it);
+                DbEngineSqlQuery query = access.backend()->prepareQuery(signatureByAlbumRootsQuery);
+
+                // We don't use CoreDbBackend's convenience calls, as the result set is large
+                // and we try to avoid copying in a temporary QList<QVariant>
+                if (access.backend()->exec(query))
+                {
+                    addToSignatureIndex(query);
+                }
             }
             else
             {
-                ++it;
+                // Only the images changed since the index was loaded
+                const int chunkSize = qMin(access.backend()->maximumBoundValues(), 500);
+
+                for (int i = 0 ; i < imageIds.size() ; i += chunkSize)
+                {
+                    QList<QVariant> boundValues;
+
+                    foreach (qlonglong imageid, imageIds.mid(i, chunkSize))
+                    {
+                        boundValues << imageid;
+                    }
+
+                    QString sql = signatureOfImagesQuery;
+                    CoreDB::addBoundValuePlaceholders(sql, boundValues.size());
+                    sql        += QLatin1String(");");
+
+                    DbEngineSqlQuery query = access.backend()->execQuery(sql, boundValues);
+                    addToSignatureIndex(query);
+                }
             }
         }
+
+        index->endLoading();
     }
 
-    void setSignatureCacheEnabled(bool cache)
+    void addToSignatureIndex(DbEngineSqlQuery& query)
     {
-        delete signatureCache;
-        signatureCache = 0;
-        delete albumCache;
-        albumCache     = 0;
+        HaarSignatureIndex* const index = HaarSignatureIndex::instance();
+        DatabaseBlob              blob;
+        Haar::SignatureData       targetSig;
 
-        if (cache)
+        while (query.next())
         {
-            signatureCache = new SignatureCache();
-            albumCache     = new AlbumCache();
+            blob.read(query.value(2).toByteArray(), &targetSig);
+            index->add(query.value(0).toLongLong(), query.value(3).toInt(), query.value(1).toInt(), targetSig);
         }
-        useSignatureCache = cache;
+    }
+
+    /** Reads the signatures of the given images into flat arrays, sorted by image id.
+     */
+    void loadDuplicatesSignatures(const QSet<qlonglong>& imageIds, DuplicatesSignatures* const sigs)
+    {
+        DuplicatesSignatures unsorted;
+        DatabaseBlob         blob;
+        Haar::SignatureData  targetSig;
 
-        // stop here if we disable cached signatures
-        if (!cache)
         {
-            return;
-        }
+            CoreDbAccess access;
+            DbEngineSqlQuery query = access.backend()->prepareQuery(signatureQuery);
 
-        // Variables for data read from DB
-        CoreDbAccess      access;
-        DatabaseBlob        blob;
-        qlonglong           imageid;
-        int                 albumid;
-        Haar::SignatureData targetSig;
+            if (!access.backend()->exec(query))
+            {
+                return;
+            }
 
-        // reference for easier access
-        SignatureCache& signatureCache = *this->signatureCache;
-        AlbumCache&     albumCache     = *this->albumCache;
+            while (query.next())
+            {
+                qlonglong imageid = query.value(0).toLongLong();
 
-        DbEngineSqlQuery query = access.backend()->prepareQuery(signatureQuery);
+                if (!imageIds.contains(imageid))
+                {
+                    continue;
+                }
+
+                blob.read(query.value(2).toByteArray(), &targetSig);
+
+                unsorted.ids    << imageid;
+                unsorted.albums << query.value(3).toInt();
+
+                for (int channel = 0; channel < 3; ++channel)
+                {
+                    unsorted.averages << targetSig.avg[channel];
+                }
+
+                for (int channel = 0; channel < 3; ++channel)
+                {
+                    for (int coef = 0; coef < Haar::NumberOfCoefficients; ++coef)
+                    {
+                        unsorted.coefs << targetSig.sig[channel][coef];
+                    }
+                }
+            }
+        }
 
-        if (!access.backend()->exec(query))
+        QVector<int> order(unsorted.count());
+
+        for (int i = 0; i < order.size(); ++i)
         {
-            return;
+            order[i] = i;
         }
 
-        while (query.next())
+        std::sort(order.begin(), order.end(),
+                  [&unsorted](int a, int b) { return unsorted.ids.at(a) < unsorted.ids.at(b); });
+
+        const int coefCount = 3 * Haar::NumberOfCoefficients;
+
+        sigs->ids.resize(order.size());
+        sigs->albums.resize(order.size());
+        sigs->averages.resize(3 * order.size());
+        sigs->coefs.resize(coefCount * order.size());
+
+        for (int i = 0; i < order.size(); ++i)
         {
-            imageid = query.value(0).toLongLong();
-            blob.read(query.value(2).toByteArray(), &targetSig);
-            albumid = query.value(3).toInt();
-            signatureCache[imageid] = targetSig;
-            albumCache[imageid]     = albumid;
+            const int index  = order.at(i);
+            sigs->ids[i]     = unsorted.ids.at(index);
+            sigs->albums[i]  = unsorted.albums.at(index);
+            memcpy(sigs->averages.data() + 3 * i, unsorted.averages.constData() + 3 * index, 3 * sizeof(double));
+            memcpy(sigs->coefs.data() + coefCount * i, unsorted.coefs.constData() + coefCount * index, coefCount * sizeof(Haar::Idx));
         }
     }
 
-    bool             useSignatureCache;
     Haar::ImageData* data;
     Haar::WeightBin* bin;
-    SignatureCache*  signatureCache;
-    AlbumCache*      albumCache;
 
     QString          signatureQuery;
     QString          signatureByAlbumRootsQuery;
+    QString          signatureOfImagesQuery;
     QSet<int>        albumRootsToSearch;
 };
 
@@ -376,10 +669,10 @@ bool HaarIface::indexImage(qlonglong imageid)
     Haar::SignatureData sig;
     haar.calcHaar(d->data, &sig);
 
-    CoreDbAccess access;
-
     // Store main entry
     {
+        CoreDbAccess access;
+
         // prepare blob
         DatabaseBlob blob;
         QByteArray array = blob.write(&sig);
@@ -391,6 +684,9 @@ bool HaarIface::indexImage(qlonglong imageid)
                                   array, imageid);
     }
 
+    // Outside of the database lock, which is taken by the index while loading
+    HaarSignatureIndex::instance()->update(imageid, sig);
+
     return true;
 }
 
@@ -466,24 +762,14 @@ QPair<double,QMap<qlonglong,double>> HaarIface::bestMatchesForImageWithThreshold
                                                              double maximumPercentage, QList<int>& targetAlbums,
                                                              DuplicatesSearchRestrictions searchResultRestriction, SketchType type)
 {
-    if ( !d->useSignatureCache || (d->signatureCache->isEmpty() && d->useSignatureCache) )
-    {
-        Haar::SignatureData sig;
-
-        if (!retrieveSignatureFromDB(imageid, &sig))
-        {
-            return QPair<double,QMap<qlonglong,double>>();
-        }
+    Haar::SignatureData sig;
 
-        return bestMatchesWithThreshold(imageid, &sig, requiredPercentage, maximumPercentage, targetAlbums, searchResultRestriction, type);
-    }
-    else
+    if (!retrieveSignatureFromDB(imageid, &sig))
     {
-        // reference for easier access
-        SignatureCache& signatureCache = *d->signatureCache;
-        Haar::SignatureData& sig       = signatureCache[imageid];
-        return bestMatchesWithThreshold(imageid, &sig, requiredPercentage, maximumPercentage, targetAlbums, searchResultRestriction, type);
+        return QPair<double,QMap<qlonglong,double>>();
     }
+
+    return bestMatchesWithThreshold(imageid, &sig, requiredPercentage, maximumPercentage, targetAlbums, searchResultRestriction, type);
 }
 
 QList<qlonglong> HaarIface::bestMatchesForFile(const QString& filename, QList<int>& targetAlbums, int numberOfResults, SketchType type)
@@ -519,7 +805,7 @@ QMap<qlonglong,double> HaarIface::bestMatchesForSignature(const QString& signatu
 
 QMultiMap<double, qlonglong> HaarIface::bestMatches(Haar::SignatureData* const querySig, int numberOfResults, QList<int>& targetAlbums, SketchType type)
 {
-    QMap<qlonglong, double> scores = searchDatabase(querySig, type, targetAlbums);
+    QMap<qlonglong, double> scores = searchDatabase(querySig, type, targetAlbums, numberOfResults, numeric_limits<double>::max());
 
     // Find out the best matches, those with the lowest score
     // We make use of the feature that QMap keys are sorted in ascending order
@@ -580,7 +866,6 @@ QPair<double,QMap<qlonglong,double>> HaarIface::bestMatchesWithThreshold(qlonglo
                                                                          SketchType type)
 {
     int albumId = CoreDbAccess().db()->getItemAlbum(imageid);
-    QMap<qlonglong, double> scores = searchDatabase(querySig, type, targetAlbums, searchResultRestriction, imageid, albumId);
     double lowest, highest;
     getBestAndWorstPossibleScore(querySig, type, &lowest, &highest);
     // The range between the highest (worst) and lowest (best) score
@@ -598,6 +883,9 @@ QPair<double,QMap<qlonglong,double>> HaarIface::bestMatchesWithThreshold(qlonglo
     // with similarity 50,x.
     double supremum = (floor(maximumPercentage*100 + 1.0))/100;
 
+    QMap<qlonglong, double> scores = searchDatabase(querySig, type, targetAlbums, 0, requiredScore,
+                                                    searchResultRestriction, imageid, albumId);
+
     QMap<qlonglong, double> bestMatches;
     double score, percentage, avgPercentage = 0.0;
     QPair<double,QMap<qlonglong,double>> result;
@@ -684,128 +972,25 @@ bool HaarIface::fulfillsRestrictions(qlonglong imageId, int albumId, qlonglong o
     }
 }
 
-/// This method is the core functionality: It assigns a score to every image in the db
+/// This method is the core functionality: It assigns a score to the images in the db
 QMap<qlonglong, double> HaarIface::searchDatabase(Haar::SignatureData* const querySig, SketchType type, QList<int>& targetAlbums,
+                                                  int numberOfResults, double maximumScore,
                                                   DuplicatesSearchRestrictions searchResultRestriction,
                                                   qlonglong originalImageId, int originalAlbumId)
 {
-    d->createWeightBin();
-
-    // The table of constant weight factors applied to each channel and bin
-    Haar::Weights weights((Haar::Weights::SketchType)type);
-
-    // layout the query signature for fast lookup
-    Haar::SignatureMap queryMapY, queryMapI, queryMapQ;
-    queryMapY.fill(querySig->sig[0]);
-    queryMapI.fill(querySig->sig[1]);
-    queryMapQ.fill(querySig->sig[2]);
-    Haar::SignatureMap* queryMaps[3] = { &queryMapY, &queryMapI, &queryMapQ };
-
-    // Map imageid -> score. Lowest score is best.
-    // any newly inserted value will be initialized with a score of 0, as required
-    QMap<qlonglong, double> scores;
-
-    // Variables for data read from DB
-    CoreDbAccess      access;
-    DatabaseBlob        blob;
-    qlonglong           imageid;
-    int                 albumid;
-    Haar::SignatureData targetSig;
-
-    // reference for easier access
-    SignatureCache& signatureCache = *d->signatureCache;
-    AlbumCache&     albumCache     = *d->albumCache;
-
-    bool filterByAlbumRoots = !d->albumRootsToSearch.isEmpty();
-
-    // if no cache is used or the cache signature map is empty, query the database
-    if (!d->useSignatureCache || (signatureCache.isEmpty() && d->useSignatureCache))
-    {
-        QString queryText;
-
-        if (filterByAlbumRoots)
-        {
-            queryText = d->signatureByAlbumRootsQuery;
-        }
-        else
-        {
-            queryText = d->signatureQuery;
-        }
-
-        DbEngineSqlQuery query = access.backend()->prepareQuery(queryText);
-
-        if (!access.backend()->exec(query))
-        {
-            return scores;
-        }
-
-        // We don't use CoreDbBackend's convenience calls, as the result set is large
-        // and we try to avoid copying in a temporary QList<QVariant>
-        int albumRootId = 0;
-
-        while (query.next())
-        {
-            imageid = query.value(0).toLongLong();
-
-            if (filterByAlbumRoots)
-            {
-                albumRootId = query.value(1).toInt();
-
-                if (!d->albumRootsToSearch.contains(albumRootId))
-                {
-                    continue;
-                }
-            }
-
-            blob.read(query.value(2).toByteArray(), &targetSig);
-            albumid = query.value(3).toInt();
-
-            if (d->useSignatureCache)
-            {
-                signatureCache[imageid] = targetSig;
-                albumCache[imageid]     = albumid;
-            }
-
-            // If the image is the original one or
-            // No restrictions apply or
-            // SameAlbum restriction applies and the albums are equal or
-            // DifferentAlbum restriction applies and the albums differ
-            // then calculate the score.
-            // Also, restrict to target album
-            if ( fulfillsRestrictions(imageid, albumid, originalImageId, originalAlbumId, targetAlbums, searchResultRestriction) )
-            {
-                double&              score = scores[imageid];
-                Haar::SignatureData& qSig  = *querySig;
-                Haar::SignatureData& tSig  = targetSig;
-
-                score = calculateScore(qSig, tSig, weights, queryMaps);
-            }
-        }
-    }
-    // read cached signature map if possible
-    else
-    {
-        foreach(const qlonglong& imageid, signatureCache.keys())
-        {
-            albumid = albumCache[imageid];
-
-            // If the image is the original one or
-            // No restrictions apply or
-            // SameAlbum restriction applies and the albums are equal or
-            // DifferentAlbum restriction applies and the albums differ
-            // then calculate the score.
-            if ( fulfillsRestrictions(imageid, albumid, originalImageId, originalAlbumId, targetAlbums, searchResultRestriction) )
-            {
-                double& score              = scores[imageid];
-                Haar::SignatureData& qSig  = *querySig;
-                Haar::SignatureData& tSig  = signatureCache[imageid];
-
-                score = calculateScore(qSig, tSig, weights, queryMaps);
-            }
-        }
-    }
-
-    return scores;
+    d->loadSignatureIndex();
+
+    // If the image is the original one or
+    // No restrictions apply or
+    // SameAlbum restriction applies and the albums are equal or
+    // DifferentAlbum restriction applies and the albums differ
+    // then calculate the score.
+    // Also, restrict to target album and album roots
+    HaarSearchFilter filter(this, targetAlbums, d->albumRootsToSearch, searchResultRestriction,
+                            originalImageId, originalAlbumId);
+
+    return HaarSignatureIndex::instance()->scores(*querySig, (Haar::Weights::SketchType)type,
+                                                  filter, maximumScore, numberOfResults);
 }
 
 QImage HaarIface::loadQImage(const QString& filename)
@@ -1072,75 +1257,140 @@ QMap< double,QMap< qlonglong,QList<qlonglong> > > HaarIface::findDuplicates(cons
 {
     QMap<double,QMap<qlonglong,QList<qlonglong>>> resultsMap;
     QMap<double,QMap<qlonglong,QList<qlonglong>>>::iterator similarity_it;
-    QSet<qlonglong>::const_iterator     it;
-    QPair<double,QMap<qlonglong,double>>      bestMatches;
     QList<qlonglong>                    imageIdList;
-    QSet<qlonglong>                     resultsCandidates;
 
-    int                                 total        = 0;
-    int                                 progress     = 0;
-    int                                 progressStep = 20;
+    int                                 total = images2Scan.count();
 
     if (observer)
     {
-        total        = images2Scan.count();
-        progressStep = qMax(progressStep, total / 100);
         observer->totalNumberToScan(total);
     }
 
-    // create signature cache map for fast lookup
-    d->setSignatureCacheEnabled(true, images2Scan);
+    d->createWeightBin();
+
+    // The signatures of all images to scan, the targets of the search as well as the queries
+    DuplicatesSignatures sigs;
+    d->loadDuplicatesSignatures(images2Scan, &sigs);
+
+    const int count = sigs.count();
+
+    // First pass: the matches of all images are searched in parallel,
+    // each thread taking the next query image when done with one.
+
+    DuplicatesSearchContext context;
+    context.iface              = this;
+    context.signatures         = &sigs;
+    context.bin                = d->bin;
+    context.requiredPercentage = requiredPercentage;
+    context.maximumPercentage  = maximumPercentage;
+    context.restriction        = searchResultRestriction;
+    context.results.resize(count);
+
+    QThreadPool pool;
+    const int threads = qMax(1, qMin(QThread::idealThreadCount(), count));
+
+    for (int i = 0 ; i < threads ; ++i)
+    {
+        pool.start(new DuplicatesSearchTask(&context));
+    }
 
-    for (it = images2Scan.constBegin(); it != images2Scan.constEnd(); ++it)
+    while (!pool.waitForDone(200))
     {
-        if (observer && observer->isCanceled())
+        if (observer)
         {
-            break;
+            if (observer->isCanceled())
+            {
+                context.canceled.store(1);
+            }
+
+            observer->processedNumber(qMin(context.processed.load(), total));
         }
+    }
+
+    if (context.canceled.load())
+    {
+        return resultsMap;
+    }
 
-        if (!resultsCandidates.contains(*it))
+    // Second pass: the results are merged in the order of image ids. Images found as duplicates
+    // are not used as query images again. Images which are no duplicates are removed from
+    // the matches of the following images, which is also what the single-threaded search did.
+
+    QVector<bool> candidates(count, false);
+    QVector<bool> removed(count, false);
+
+    CoreDbAccess      access;
+    CoreDbTransaction transaction(&access);
+
+    for (int query = 0 ; query < count ; ++query)
+    {
+        const qlonglong imageid = sigs.ids.at(query);
+
+        if (!candidates.at(query))
         {
-            QList<int> targetAlbums;
-            // find images with required similarity
-            bestMatches = bestMatchesForImageWithThreshold(*it, requiredPercentage, maximumPercentage, targetAlbums, searchResultRestriction, ScannedSketch);
+            QMap<qlonglong, double> bestMatches;
+            double avgPercentage = 0.0;
+
+            foreach (const DuplicatesMatch& match, context.results.at(query))
+            {
+                if (removed.at(match.first))
+                {
+                    continue;
+                }
+
+                const qlonglong id = sigs.ids.at(match.first);
+                bestMatches.insert(id, match.second);
+
+                if (id != imageid)
+                {
+                    // Save the similarity of the found image to the original image.
+                    access.db()->setImageProperty(id, QLatin1String("similarityTo_") + QString::number(imageid),
+                                                  QString::number(match.second));
+                    avgPercentage += match.second;
+                }
+            }
+
+            if (bestMatches.count() > 1)
+            {
+                avgPercentage = avgPercentage / (bestMatches.count() - 1);
+            }
+
             // We need only the image ids from the best matches map.
-            imageIdList = bestMatches.second.keys();
-            if (!imageIdList.isEmpty())
+            imageIdList = bestMatches.keys();
+
+            // the list will usually contain one image: the original. Filter out.
+            if (!imageIdList.isEmpty() && !(imageIdList.count() == 1 && imageIdList.first() == imageid))
             {
-                // the list will usually contain one image: the original. Filter out.
-                if (!(imageIdList.count() == 1 && imageIdList.first() == *it))
+                // make a lookup for the average similarity
+                similarity_it = resultsMap.find(avgPercentage);
+                // If there is an entry for this similarity, add the result set. Else, create a new similarity entry.
+                if (similarity_it != resultsMap.end())
                 {
-                    // make a lookup for the average similarity
-                    similarity_it = resultsMap.find(bestMatches.first);
-                    // If there is an entry for this similarity, add the result set. Else, create a new similarity entry.
-                    if (similarity_it != resultsMap.end())
-                    {
-                        similarity_it->insert(*it,imageIdList);
-                    }
-                    else
+                    similarity_it->insert(imageid, imageIdList);
+                }
+                else
+                {
+                    QMap<qlonglong,QList<qlonglong>> result;
+                    result.insert(imageid, imageIdList);
+                    resultsMap.insert(avgPercentage, result);
+                }
+
+                candidates[query] = true;
+
+                foreach (const DuplicatesMatch& match, context.results.at(query))
+                {
+                    if (!removed.at(match.first))
                     {
-                        QMap<qlonglong,QList<qlonglong>> result;
-                        result.insert(*it, imageIdList);
-                        resultsMap.insert(bestMatches.first,result);
+                        candidates[match.first] = true;
                     }
-                    resultsCandidates << *it;
-                    resultsCandidates.unite(imageIdList.toSet());
                 }
             }
         }
 
-        // if an imageid is not a results candidate, remove it from the cached signature map as well,
-        // to greatly improve speed
-        if (!resultsCandidates.contains(*it))
-        {
-            d->signatureCache->remove(*it);
-        }
-
-        ++progress;
-
-        if (observer && (progress == total || progress % progressStep == 0))
+        // if an image is not a results candidate, it is not a match for the following images
+        if (!candidates.at(query))
         {
-            observer->processedNumber(progress);
+            removed[query] = true;
         }
     }
 
@@ -1150,9 +1400,6 @@ QMap< double,QMap< qlonglong,QList<qlonglong> > > HaarIface::findDuplicates(cons
         observer->processedNumber(total);
     }
 
-    // disable cache
-    d->setSignatureCacheEnabled(false);
-
     return resultsMap;
 }
 
@@ -226,15 +226,18 @@ private:
             DuplicatesSearchRestrictions searchResultRestriction, SketchType type);
 
     /**
-     * This function generates the scores for all images in database.
+     * This function generates the scores of the images in database, using the signature index.
      * @param data The signature of the original image for score calculation.
      * @param type The type of the sketch, e.g. scanned.
+     * @param numberOfResults if positive, images which cannot be among the numberOfResults best ones can be left out.
+     * @param maximumScore only images with at most this score are returned.
      * @param searchResultRestriction restrictions to apply to the generated map, i.e. None (default), same album or different album.
      * @param originalImageId the id of the original image to compare to other images. -1 is only used for sketch search.
      * @param albumId The album which images must or must not belong to (depending on searchResultRestriction).
      * @return The map of image ids and scores which fulfill the restrictions, if any.
      */
     QMap<qlonglong, double> searchDatabase(Haar::SignatureData* const data, SketchType type, QList<int>& targetAlbums,
+                                           int numberOfResults, double maximumScore,
                                            DuplicatesSearchRestrictions searchResultRestriction = None,
                                            qlonglong originalImageId = -1, int albumId = -1);
     double calculateScore(Haar::SignatureData& querySig, Haar::SignatureData& targetSig,
@@ -0,0 +1,637 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-03-24
+ * Description : Inverted index of Haar signature coefficients
+ *               for fast similarity searches
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "haarsignatureindex.h"
+
+// C++ includes
+
+#include <algorithm>
+#include <cmath>
+
+// Qt includes
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QReadLocker>
+#include <QReadWriteLock>
+#include <QSet>
+#include <QThreadStorage>
+#include <QVector>
+#include <QWriteLocker>
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "coredbaccess.h"
+#include "coredbchangesets.h"
+#include "coredbwatch.h"
+
+namespace Digikam
+{
+
+/**
+ * The scores of a query, per position of the index. Kept per thread and reused by the next query:
+ * only the entries of the candidates are touched, and reset when the query is done.
+ */
+class HaarScoreBuffer
+{
+public:
+
+    void reserve(int count)
+    {
+        if (coefScores.size() < count)
+        {
+            coefScores.resize(count);
+            isCandidate.resize(count);
+        }
+    }
+
+    void reset()
+    {
+        foreach (int position, candidates)
+        {
+            coefScores[position]  = 0.0;
+            isCandidate[position] = false;
+        }
+
+        candidates.clear();
+    }
+
+public:
+
+    QVector<double> coefScores;
+    QVector<bool>   isCandidate;
+    QVector<int>    candidates;
+};
+
+// -----------------------------------------------------------------------------------------------------
+
+class HaarSignatureIndex::Private
+{
+public:
+
+    enum
+    {
+        /// Number of coefficient values per channel, negative and positive ones
+        NumberOfCoefficientValues = 2 * Haar::NumberOfPixelsSquared
+    };
+
+public:
+
+    Private()
+        : loaded(false),
+          watched(false),
+          invalidCount(0),
+          changesFullReload(false)
+    {
+        postings = new QVector<int>[3 * NumberOfCoefficientValues];
+    }
+
+    ~Private()
+    {
+        delete [] postings;
+    }
+
+    QVector<int>& postingList(int channel, Haar::Idx coef)
+    {
+        return postings[channel * NumberOfCoefficientValues + coef + Haar::NumberOfPixelsSquared];
+    }
+
+    void clear()
+    {
+        ids.clear();
+        albums.clear();
+        albumRoots.clear();
+        averages.clear();
+        valid.clear();
+        positions.clear();
+        invalidCount = 0;
+
+        for (int i = 0 ; i < 3 * NumberOfCoefficientValues ; ++i)
+        {
+            postings[i].clear();
+        }
+    }
+
+    int append(qlonglong imageid, int albumId, int albumRootId, const Haar::SignatureData& sig)
+    {
+        const int position = ids.size();
+
+        ids        << imageid;
+        albums     << albumId;
+        albumRoots << albumRootId;
+        valid      << true;
+
+        for (int channel = 0 ; channel < 3 ; ++channel)
+        {
+            averages << sig.avg[channel];
+
+            for (int coef = 0 ; coef < Haar::NumberOfCoefficients ; ++coef)
+            {
+                postingList(channel, sig.sig[channel][coef]) << position;
+            }
+        }
+
+        positions[imageid] = position;
+
+        return position;
+    }
+
+    /// The postings of a removed signature are only skipped by queries, until compact()
+    void invalidatePosition(int position)
+    {
+        valid[position] = false;
+        ++invalidCount;
+    }
+
+    void removeImage(qlonglong imageid)
+    {
+        QHash<qlonglong, int>::iterator it = positions.find(imageid);
+
+        if (it != positions.end())
+        {
+            invalidatePosition(it.value());
+            positions.erase(it);
+        }
+    }
+
+    void removeAlbums(const QSet<int>& albumIds)
+    {
+        for (QHash<qlonglong, int>::iterator it = positions.begin() ; it != positions.end() ; )
+        {
+            if (albumIds.contains(albums.at(it.value())))
+            {
+                invalidatePosition(it.value());
+                it = positions.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    /**
+     * Removes the skipped postings and signatures once they are half of the index.
+     */
+    void compactIfNeeded()
+    {
+        if (invalidCount == 0 || invalidCount < ids.size() / 2)
+        {
+            return;
+        }
+
+        QVector<int> newPositions(ids.size(), -1);
+        int          count = 0;
+
+        for (int position = 0 ; position < ids.size() ; ++position)
+        {
+            if (!valid.at(position))
+            {
+                continue;
+            }
+
+            newPositions[position]  = count;
+            ids[count]              = ids.at(position);
+            albums[count]           = albums.at(position);
+            albumRoots[count]       = albumRoots.at(position);
+
+            for (int channel = 0 ; channel < 3 ; ++channel)
+            {
+                averages[3 * count + channel] = averages.at(3 * position + channel);
+            }
+
+            ++count;
+        }
+
+        ids.resize(count);
+        albums.resize(count);
+        albumRoots.resize(count);
+        averages.resize(3 * count);
+        valid.fill(true, count);
+        invalidCount = 0;
+
+        // Positions only decrease: the posting lists stay sorted.
+
+        for (int i = 0 ; i < 3 * NumberOfCoefficientValues ; ++i)
+        {
+            QVector<int>& list = postings[i];
+            int kept           = 0;
+
+            for (int j = 0 ; j < list.size() ; ++j)
+            {
+                const int position = newPositions.at(list.at(j));
+
+                if (position != -1)
+                {
+                    list[kept++] = position;
+                }
+            }
+
+            list.resize(kept);
+        }
+
+        for (QHash<qlonglong, int>::iterator it = positions.begin() ; it != positions.end() ; ++it)
+        {
+            it.value() = newPositions.at(it.value());
+        }
+    }
+
+    bool hasChanges() const
+    {
+        QMutexLocker locker(&changesMutex);
+
+        return (changesFullReload || !changedIds.isEmpty() || !changedAlbums.isEmpty());
+    }
+
+    double averageScore(const Haar::SignatureData& querySig, const Haar::Weights& weights, int position) const
+    {
+        const double* const avg = averages.constData() + 3 * position;
+        double score            = 0.0;
+
+        for (int channel = 0 ; channel < 3 ; ++channel)
+        {
+            score += weights.weightForAverage(channel) * fabs(querySig.avg[channel] - avg[channel]);
+        }
+
+        return score;
+    }
+
+    HaarScoreBuffer& scoreBuffer()
+    {
+        if (!scoreBuffers.hasLocalData())
+        {
+            scoreBuffers.setLocalData(new HaarScoreBuffer);
+        }
+
+        return *scoreBuffers.localData();
+    }
+
+public:
+
+    QReadWriteLock          lock;
+    bool                    loaded;
+    bool                    watched;
+
+    Haar::WeightBin         bin;
+
+    /// Per indexed signature
+    QVector<qlonglong>      ids;
+    QVector<int>            albums;
+    QVector<int>            albumRoots;
+    QVector<double>         averages;       // 3 per signature
+    QVector<bool>           valid;          // false if replaced or removed
+    int                     invalidCount;
+
+    /// Image id -> position of its valid signature
+    QHash<qlonglong, int>   positions;
+
+    /// For each channel and coefficient, the positions of the signatures containing it
+    QVector<int>*           postings;
+
+    QThreadStorage<HaarScoreBuffer*> scoreBuffers;
+
+    /// Changes notified by the database, applied on next use. They are notified
+    /// while the database may be locked: only changesMutex is taken to store them.
+    mutable QMutex          changesMutex;
+    QSet<qlonglong>         changedIds;
+    QSet<int>               changedAlbums;  // all images of these albums were removed
+    bool                    changesFullReload;
+};
+
+// -----------------------------------------------------------------------------------------------------
+
+class HaarSignatureIndexCreator
+{
+public:
+
+    HaarSignatureIndex object;
+};
+
+Q_GLOBAL_STATIC(HaarSignatureIndexCreator, creator)
+
+// -----------------------------------------------------------------------------------------------------
+
+HaarSignatureIndex* HaarSignatureIndex::instance()
+{
+    return &creator->object;
+}
+
+HaarSignatureIndex::HaarSignatureIndex()
+    : d(new Private)
+{
+}
+
+HaarSignatureIndex::~HaarSignatureIndex()
+{
+    delete d;
+}
+
+void HaarSignatureIndex::connectToDatabaseWatch()
+{
+    CoreDbWatch* const dbwatch = CoreDbAccess::databaseWatch();
+
+    if (!dbwatch)
+    {
+        return;
+    }
+
+    // Direct connections: the slots only record the change, and are called while the emitter may hold the database lock.
+
+    connect(dbwatch, SIGNAL(collectionImageChange(CollectionImageChangeset)),
+            this, SLOT(slotCollectionImageChange(CollectionImageChangeset)),
+            Qt::DirectConnection);
+
+    connect(dbwatch, SIGNAL(albumRootChange(AlbumRootChangeset)),
+            this, SLOT(slotAlbumRootChange(AlbumRootChangeset)),
+            Qt::DirectConnection);
+
+    connect(dbwatch, SIGNAL(databaseChanged()),
+            this, SLOT(invalidate()),
+            Qt::DirectConnection);
+
+    d->watched = true;
+}
+
+bool HaarSignatureIndex::beginLoading(QList<qlonglong>& imageIds)
+{
+    imageIds.clear();
+
+    // The common case: concurrent queries only share the read lock.
+    {
+        QReadLocker locker(&d->lock);
+
+        if (d->loaded && d->watched && !d->hasChanges())
+        {
+            return false;
+        }
+    }
+
+    d->lock.lockForWrite();
+
+    if (!d->watched)
+    {
+        connectToDatabaseWatch();
+    }
+
+    // Changes notified from now on happen after loading has started, and are applied on next use.
+
+    QSet<qlonglong> changedIds;
+    QSet<int>       changedAlbums;
+    bool            fullReload;
+
+    {
+        QMutexLocker locker(&d->changesMutex);
+        changedIds.swap(d->changedIds);
+        changedAlbums.swap(d->changedAlbums);
+        fullReload           = d->changesFullReload;
+        d->changesFullReload = false;
+    }
+
+    // Without database watch, changes cannot be tracked and the index is always loaded again.
+    if (!d->loaded || !d->watched || fullReload)
+    {
+        d->clear();
+        return true;
+    }
+
+    // The signatures of the changed images are read again, if they still exist.
+
+    d->removeAlbums(changedAlbums);
+
+    foreach (qlonglong imageid, changedIds)
+    {
+        d->removeImage(imageid);
+    }
+
+    if (changedIds.isEmpty())
+    {
+        d->compactIfNeeded();
+        d->lock.unlock();
+        return false;
+    }
+
+    imageIds = changedIds.toList();
+
+    return true;
+}
+
+void HaarSignatureIndex::add(qlonglong imageid, int albumId, int albumRootId, const Haar::SignatureData& sig)
+{
+    d->removeImage(imageid);
+    d->append(imageid, albumId, albumRootId, sig);
+}
+
+void HaarSignatureIndex::endLoading()
+{
+    if (!d->loaded)
+    {
+        d->loaded = true;
+
+        qCDebug(DIGIKAM_DATABASE_LOG) << "Haar signature index loaded with" << d->ids.size() << "signatures";
+    }
+
+    d->compactIfNeeded();
+
+    d->lock.unlock();
+}
+
+void HaarSignatureIndex::update(qlonglong imageid, const Haar::SignatureData& sig)
+{
+    QWriteLocker locker(&d->lock);
+
+    if (!d->loaded)
+    {
+        return;
+    }
+
+    QHash<qlonglong, int>::const_iterator it = d->positions.constFind(imageid);
+
+    if (it == d->positions.constEnd())
+    {
+        // Album and album root of the image are unknown here: read on next use
+        QMutexLocker changesLocker(&d->changesMutex);
+        d->changedIds << imageid;
+        return;
+    }
+
+    const int oldPosition = it.value();
+    const int albumId     = d->albums.at(oldPosition);
+    const int albumRootId = d->albumRoots.at(oldPosition);
+
+    d->removeImage(imageid);
+    d->append(imageid, albumId, albumRootId, sig);
+    d->compactIfNeeded();
+}
+
+void HaarSignatureIndex::invalidate()
+{
+    QMutexLocker locker(&d->changesMutex);
+    d->changesFullReload = true;
+}
+
+void HaarSignatureIndex::slotCollectionImageChange(const CollectionImageChangeset& changeset)
+{
+    QMutexLocker locker(&d->changesMutex);
+
+    switch (changeset.operation())
+    {
+        case CollectionImageChangeset::Unknown:
+            d->changesFullReload = true;
+            break;
+
+        case CollectionImageChangeset::RemovedAll:
+            d->changedAlbums += changeset.albums().toSet();
+            d->changedIds    += changeset.ids().toSet();
+            break;
+
+        default:
+            // Added, moved and copied images are read again, removed and deleted ones are not found any more.
+            d->changedIds    += changeset.ids().toSet();
+            break;
+    }
+}
+
+void HaarSignatureIndex::slotAlbumRootChange(const AlbumRootChangeset&)
+{
+    invalidate();
+}
+
+QMap<qlonglong, double> HaarSignatureIndex::scores(const Haar::SignatureData& querySig, Haar::Weights::SketchType type,
+                                                   const Filter& filter, double maximumScore, int numberOfResults)
+{
+    QReadLocker locker(&d->lock);
+
+    Haar::Weights    weights(type);
+    const int        count  = d->ids.size();
+    HaarScoreBuffer& buffer = d->scoreBuffer();
+    buffer.reserve(count);
+
+    QVector<double>& coefScores  = buffer.coefScores;
+    QVector<bool>&   isCandidate = buffer.isCandidate;
+    QVector<int>&    candidates  = buffer.candidates;
+
+    // Step 1: the coefficient part of the score, for all signatures sharing coefficients with the query.
+    // This is the part of HaarIface::calculateScore() looking up the query signature map.
+
+    for (int channel = 0 ; channel < 3 ; ++channel)
+    {
+        for (int coef = 0 ; coef < Haar::NumberOfCoefficients ; ++coef)
+        {
+            const Haar::Idx x            = querySig.sig[channel][coef];
+            const double weight          = weights.weight(d->bin.binAbs(x), channel);
+            const QVector<int>& postings = d->postingList(channel, x);
+
+            foreach (int position, postings)
+            {
+                if (!isCandidate.at(position))
+                {
+                    isCandidate[position] = true;
+                    candidates << position;
+                }
+
+                coefScores[position] -= weight;
+            }
+        }
+    }
+
+    // Step 2: the full score of the candidates
+
+    typedef QPair<double, int> ScoredPosition;
+    QVector<ScoredPosition> results;
+
+    foreach (int position, candidates)
+    {
+        if (!d->valid.at(position) ||
+            !filter.accepts(d->ids.at(position), d->albums.at(position), d->albumRoots.at(position)))
+        {
+            continue;
+        }
+
+        const double score = d->averageScore(querySig, weights, position) + coefScores.at(position);
+
+        if (score <= maximumScore)
+        {
+            results << ScoredPosition(score, position);
+        }
+    }
+
+    // Step 3: the other signatures have no coefficient in common with the query, their score is the
+    // average part only, which is never negative. They are only needed if they can match.
+
+    bool complete = (maximumScore < 0.0);
+
+    if (!complete && numberOfResults > 0 && results.size() >= numberOfResults)
+    {
+        std::nth_element(results.begin(), results.begin() + numberOfResults - 1, results.end());
+        complete = (results.at(numberOfResults - 1).first < 0.0);
+    }
+
+    if (!complete)
+    {
+        for (int position = 0 ; position < count ; ++position)
+        {
+            if (isCandidate.at(position) || !d->valid.at(position) ||
+                !filter.accepts(d->ids.at(position), d->albums.at(position), d->albumRoots.at(position)))
+            {
+                continue;
+            }
+
+            const double score = d->averageScore(querySig, weights, position);
+
+            if (score <= maximumScore)
+            {
+                results << ScoredPosition(score, position);
+            }
+        }
+    }
+
+    // Only the best results, with the ones scoring as the last of them, are needed.
+
+    double worstScore = maximumScore;
+
+    if (numberOfResults > 0 && results.size() > numberOfResults)
+    {
+        std::nth_element(results.begin(), results.begin() + numberOfResults - 1, results.end());
+        worstScore = results.at(numberOfResults - 1).first;
+    }
+
+    QMap<qlonglong, double> scores;
+
+    foreach (const ScoredPosition& result, results)
+    {
+        if (result.first <= worstScore)
+        {
+            scores.insert(d->ids.at(result.second), result.first);
+        }
+    }
+
+    buffer.reset();
+
+    return scores;
+}
+
+}  // namespace Digikam
@@ -0,0 +1,132 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-03-24
+ * Description : Inverted index of Haar signature coefficients
+ *               for fast similarity searches
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef HAARSIGNATUREINDEX_H
+#define HAARSIGNATUREINDEX_H
+
+// Qt includes
+
+#include <QObject>
+#include <QList>
+#include <QMap>
+
+// Local includes
+
+#include "haar.h"
+
+namespace Digikam
+{
+
+class AlbumRootChangeset;
+class CollectionImageChangeset;
+
+/**
+ * An inverted index of the Haar signatures stored in the database: for each channel
+ * and coefficient, the list of images having this coefficient in their signature.
+ * A query only visits the images sharing coefficients with the query signature,
+ * instead of scoring all signatures of the database.
+ *
+ * The index is shared by all HaarIface instances and kept in memory for the session.
+ * It is loaded on first use, and kept up to date from the database changesets: on next
+ * use, the signatures of added, moved and modified images are read again and the ones
+ * of removed images are dropped. Queries share a read lock.
+ */
+class HaarSignatureIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /** Restricts the images returned by scores().
+     */
+    class Filter
+    {
+    public:
+
+        virtual ~Filter()
+        {
+        }
+
+        virtual bool accepts(qlonglong imageid, int albumId, int albumRootId) const = 0;
+    };
+
+public:
+
+    static HaarSignatureIndex* instance();
+
+    /**
+     * Returns true if signatures need to be loaded. In this case, the index is locked
+     * for writing: the caller adds the signatures with add(), then calls endLoading().
+     * If imageIds is not empty, only the signatures of these images are needed, if they
+     * still exist: they changed since the index was loaded. Else all signatures are needed.
+     * Returns false if the index is up to date.
+     */
+    bool beginLoading(QList<qlonglong>& imageIds);
+    void add(qlonglong imageid, int albumId, int albumRootId, const Haar::SignatureData& sig);
+    void endLoading();
+
+    /**
+     * Replaces the signature of an image which is already indexed.
+     * The signature is read on next use if the image is not indexed yet.
+     */
+    void update(qlonglong imageid, const Haar::SignatureData& sig);
+
+    /**
+     * Returns the scores of the images accepted by the filter, as computed by HaarIface::calculateScore()
+     * (lowest is best), if they are at most maximumScore. If numberOfResults is positive, images
+     * which cannot be among the numberOfResults best ones may be left out.
+     */
+    QMap<qlonglong, double> scores(const Haar::SignatureData& querySig, Haar::Weights::SketchType type,
+                                   const Filter& filter, double maximumScore, int numberOfResults = 0);
+
+public Q_SLOTS:
+
+    /**
+     * Marks the index for loading all signatures again on next use.
+     */
+    void invalidate();
+
+private Q_SLOTS:
+
+    void slotCollectionImageChange(const CollectionImageChangeset&);
+    void slotAlbumRootChange(const AlbumRootChangeset&);
+
+private:
+
+    HaarSignatureIndex();
+    ~HaarSignatureIndex();
+
+    void connectToDatabaseWatch();
+
+private:
+
+    class Private;
+    Private* const d;
+
+    friend class HaarSignatureIndexCreator;
+};
+
+}  // namespace Digikam
+
+#endif // HAARSIGNATUREINDEX_H
@@ -532,7 +532,7 @@ qlonglong ImageInfo::fileSize() const
 
     RETURN_IF_CACHED(fileSize)
 
-    QVariantList values = CoreDbAccess().db()->getImagesFields(m_data->id, DatabaseFields::FileSize);
+    QVariantList values = CoreDbAccess(CoreDbAccess::ReadOnly).db()->getImagesFields(m_data->id, DatabaseFields::FileSize);
 
     STORE_IN_CACHE_AND_RETURN(fileSize, values.first().toLongLong())
 }
@@ -636,7 +636,7 @@ int ImageInfo::rating() const
 
     RETURN_IF_CACHED(rating)
 
-    QVariantList values = CoreDbAccess().db()->getImageInformation(m_data->id, DatabaseFields::Rating);
+    QVariantList values = CoreDbAccess(CoreDbAccess::ReadOnly).db()->getImageInformation(m_data->id, DatabaseFields::Rating);
     STORE_IN_CACHE_AND_RETURN(rating, values.first().toLongLong())
 }
 
@@ -648,7 +648,7 @@ QString ImageInfo::format() const
     }
 
     RETURN_IF_CACHED(format)
-    QVariantList values = CoreDbAccess().db()->getImageInformation(m_data->id, DatabaseFields::Format);
+    QVariantList values = CoreDbAccess(CoreDbAccess::ReadOnly).db()->getImageInformation(m_data->id, DatabaseFields::Format);
     STORE_IN_CACHE_AND_RETURN(format, values.first().toString())
 }
 
@@ -660,7 +660,7 @@ DatabaseItem::Category ImageInfo::category() const
     }
 
     RETURN_IF_CACHED(category)
-    QVariantList values = CoreDbAccess().db()->getImagesFields(m_data->id, DatabaseFields::Category);
+    QVariantList values = CoreDbAccess(CoreDbAccess::ReadOnly).db()->getImagesFields(m_data->id, DatabaseFields::Category);
     STORE_IN_CACHE_AND_RETURN(category, (DatabaseItem::Category)values.first().toInt())
 }
 
@@ -672,7 +672,7 @@ QDateTime ImageInfo::dateTime() const
     }
 
     RETURN_IF_CACHED(creationDate)
-    QVariantList values = CoreDbAccess().db()->getImageInformation(m_data->id, DatabaseFields::CreationDate);
+    QVariantList values = CoreDbAccess(CoreDbAccess::ReadOnly).db()->getImageInformation(m_data->id, DatabaseFields::CreationDate);
     STORE_IN_CACHE_AND_RETURN(creationDate, values.first().toDateTime())
 }
 
@@ -684,7 +684,7 @@ QDateTime ImageInfo::modDateTime() const
     }
 
     RETURN_IF_CACHED(modificationDate)
-    QVariantList values = CoreDbAccess().db()->getImagesFields(m_data->id, DatabaseFields::ModificationDate);
+    QVariantList values = CoreDbAccess(CoreDbAccess::ReadOnly).db()->getImagesFields(m_data->id, DatabaseFields::ModificationDate);
     STORE_IN_CACHE_AND_RETURN(modificationDate, values.first().toDateTime())
 }
 
@@ -696,7 +696,7 @@ QSize ImageInfo::dimensions() const
     }
 
     RETURN_IF_CACHED(imageSize)
-    QVariantList values = CoreDbAccess().db()->getImageInformation(m_data->id, DatabaseFields::Width | DatabaseFields::Height);
+    QVariantList values = CoreDbAccess(CoreDbAccess::ReadOnly).db()->getImageInformation(m_data->id, DatabaseFields::Width | DatabaseFields::Height);
     ImageInfoWriteLocker lock;
     m_data.constCastData()->imageSizeCached = true;
 
@@ -717,7 +717,7 @@ QList<int> ImageInfo::tagIds() const
 
     RETURN_IF_CACHED(tagIds)
 
-    QList<int> ids = CoreDbAccess().db()->getItemTagIDs(m_data->id);
+    QList<int> ids = CoreDbAccess(CoreDbAccess::ReadOnly).db()->getItemTagIDs(m_data->id);
     ImageInfoWriteLocker lock;
     m_data.constCastData()->tagIds       = ids;
     m_data.constCastData()->tagIdsCached = true;
@@ -726,7 +726,7 @@ QList<int> ImageInfo::tagIds() const
 
 void ImageInfoList::loadTagIds() const
 {
-    QVector<QList<int> > allTagIds = CoreDbAccess().db()->getItemsTagIDs(toImageIdList());
+    QVector<QList<int> > allTagIds = CoreDbAccess(CoreDbAccess::ReadOnly).db()->getItemsTagIDs(toImageIdList());
 
     ImageInfoWriteLocker lock;
 
@@ -745,6 +745,177 @@ void ImageInfoList::loadTagIds() const
     }
 }
 
+void ImageInfoList::loadFields(const DatabaseFields::Set& fields) const
+{
+    DatabaseFields::Images imagesFields         = fields.getImages() &
+                                                  (DatabaseFields::Category         |
+                                                   DatabaseFields::ModificationDate |
+                                                   DatabaseFields::FileSize);
+    DatabaseFields::ImageInformation infoFields = fields.getImageInformation() &
+                                                  (DatabaseFields::Rating       |
+                                                   DatabaseFields::CreationDate |
+                                                   DatabaseFields::Width        |
+                                                   DatabaseFields::Height       |
+                                                   DatabaseFields::Format);
+    const bool labels                           = fields.getImageInformation() &
+                                                  (DatabaseFields::ColorLabel | DatabaseFields::PickLabel);
+
+    if (infoFields & (DatabaseFields::Width | DatabaseFields::Height))
+    {
+        // Both make the cached dimensions.
+        infoFields |= DatabaseFields::Width | DatabaseFields::Height;
+    }
+
+    QList<qlonglong> imagesIds, infoIds;
+    QList<int>       imagesRows, infoRows;
+    ImageInfoList    untagged;
+
+    {
+        ImageInfoReadLocker lock;
+
+        for (int i = 0 ; i < size() ; ++i)
+        {
+            const ImageInfoData* const data = at(i).m_data.constData();
+
+            if (!data)
+            {
+                continue;
+            }
+
+            if (((imagesFields & DatabaseFields::Category)         && !data->categoryCached)         ||
+                ((imagesFields & DatabaseFields::ModificationDate) && !data->modificationDateCached) ||
+                ((imagesFields & DatabaseFields::FileSize)         && !data->fileSizeCached))
+            {
+                imagesIds  << data->id;
+                imagesRows << i;
+            }
+
+            if (((infoFields & DatabaseFields::Rating)       && !data->ratingCached)       ||
+                ((infoFields & DatabaseFields::CreationDate) && !data->creationDateCached) ||
+                ((infoFields & DatabaseFields::Width)        && !data->imageSizeCached)    ||
+                ((infoFields & DatabaseFields::Format)       && !data->formatCached))
+            {
+                infoIds  << data->id;
+                infoRows << i;
+            }
+
+            if (labels && !data->tagIdsCached)
+            {
+                untagged << at(i);
+            }
+        }
+    }
+
+    QVector<QVariantList> imagesValues, infoValues;
+
+    if (!imagesIds.isEmpty() || !infoIds.isEmpty())
+    {
+        CoreDbAccess access(CoreDbAccess::ReadOnly);
+        imagesValues = access.db()->getImagesFields(imagesIds, imagesFields);
+        infoValues   = access.db()->getImageInformation(infoIds, infoFields);
+    }
+
+    {
+        // As the getters, an item without a row in the database gets the default values cached.
+
+        ImageInfoWriteLocker lock;
+
+        for (int i = 0 ; i < imagesRows.size() ; ++i)
+        {
+            ImageInfoData* const data  = at(imagesRows.at(i)).m_data.constCastData();
+            const QVariantList& values = imagesValues.at(i);
+            int index                  = 0;
+
+            if (imagesFields & DatabaseFields::Category)
+            {
+                if (!data->categoryCached && !values.isEmpty())
+                {
+                    data->category = (DatabaseItem::Category)values.at(index).toInt();
+                }
+
+                data->categoryCached = true;
+                ++index;
+            }
+
+            if (imagesFields & DatabaseFields::ModificationDate)
+            {
+                if (!data->modificationDateCached && !values.isEmpty())
+                {
+                    data->modificationDate = values.at(index).toDateTime();
+                }
+
+                data->modificationDateCached = true;
+                ++index;
+            }
+
+            if (imagesFields & DatabaseFields::FileSize)
+            {
+                if (!data->fileSizeCached && !values.isEmpty())
+                {
+                    data->fileSize = values.at(index).toLongLong();
+                }
+
+                data->fileSizeCached = true;
+            }
+        }
+
+        for (int i = 0 ; i < infoRows.size() ; ++i)
+        {
+            ImageInfoData* const data  = at(infoRows.at(i)).m_data.constCastData();
+            const QVariantList& values = infoValues.at(i);
+            int index                  = 0;
+
+            if (infoFields & DatabaseFields::Rating)
+            {
+                if (!data->ratingCached && !values.isEmpty())
+                {
+                    data->rating = values.at(index).toInt();
+                }
+
+                data->ratingCached = true;
+                ++index;
+            }
+
+            if (infoFields & DatabaseFields::CreationDate)
+            {
+                if (!data->creationDateCached && !values.isEmpty())
+                {
+                    data->creationDate = values.at(index).toDateTime();
+                }
+
+                data->creationDateCached = true;
+                ++index;
+            }
+
+            if (infoFields & DatabaseFields::Width)
+            {
+                if (!data->imageSizeCached && !values.isEmpty())
+                {
+                    data->imageSize = QSize(values.at(index).toInt(), values.at(index + 1).toInt());
+                }
+
+                data->imageSizeCached = true;
+                index += 2;
+            }
+
+            if (infoFields & DatabaseFields::Format)
+            {
+                if (!data->formatCached && !values.isEmpty())
+                {
+                    data->format = values.at(index).toString();
+                }
+
+                data->formatCached = true;
+            }
+        }
+    }
+
+    if (!untagged.isEmpty())
+    {
+        untagged.loadTagIds();
+    }
+}
+
 int ImageInfo::orientation() const
 {
     if (!m_data)
@@ -752,7 +923,7 @@ int ImageInfo::orientation() const
         return 0; // ORIENTATION_UNSPECIFIED
     }
 
-    QVariantList values = CoreDbAccess().db()->getImageInformation(m_data->id, DatabaseFields::Orientation);
+    QVariantList values = CoreDbAccess(CoreDbAccess::ReadOnly).db()->getImageInformation(m_data->id, DatabaseFields::Orientation);
 
     if (values.isEmpty())
     {
@@ -815,7 +986,7 @@ bool ImageInfo::isVisible() const
         return false;
     }
 
-    QVariantList value = CoreDbAccess().db()->getImagesFields(m_data->id, DatabaseFields::Status);
+    QVariantList value = CoreDbAccess(CoreDbAccess::ReadOnly).db()->getImagesFields(m_data->id, DatabaseFields::Status);
 
     if (!value.isEmpty())
     {
@@ -832,7 +1003,7 @@ bool ImageInfo::isRemoved() const
         return true;
     }
 
-    QVariantList value = CoreDbAccess().db()->getImagesFields(m_data->id, DatabaseFields::Status);
+    QVariantList value = CoreDbAccess(CoreDbAccess::ReadOnly).db()->getImagesFields(m_data->id, DatabaseFields::Status);
 
     if (!value.isEmpty())
     {
@@ -1872,7 +2043,7 @@ ImageInfo::DatabaseFieldsHashRaw ImageInfo::getDatabaseFieldsRaw(const DatabaseF
 
         if (missingVideoMetadata)
         {
-            const QVariantList fieldValues = CoreDbAccess().db()->getVideoMetadata(m_data->id, missingVideoMetadata);
+            const QVariantList fieldValues = CoreDbAccess(CoreDbAccess::ReadOnly).db()->getVideoMetadata(m_data->id, missingVideoMetadata);
 
             ImageInfoWriteLocker lock;
             if (fieldValues.isEmpty())
@@ -1906,7 +2077,7 @@ ImageInfo::DatabaseFieldsHashRaw ImageInfo::getDatabaseFieldsRaw(const DatabaseF
 
         if (missingImageMetadata)
         {
-            const QVariantList fieldValues = CoreDbAccess().db()->getImageMetadata(m_data->id, missingImageMetadata);
+            const QVariantList fieldValues = CoreDbAccess(CoreDbAccess::ReadOnly).db()->getImageMetadata(m_data->id, missingImageMetadata);
 
             ImageInfoWriteLocker lock;
             if (fieldValues.isEmpty())
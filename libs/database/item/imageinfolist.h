@@ -31,6 +31,7 @@
 // Local includes
 
 #include "imageinfo.h"
+#include "coredbfields.h"
 #include "digikam_export.h"
 #include "digikam_config.h"
 
@@ -61,6 +62,16 @@ public:
     void loadGroupImageIds() const;
     void loadTagIds() const;
 
+    /**
+     * Loads the given fields of all items which do not have them cached yet,
+     * reading the database in chunks of items instead of once per item and field.
+     * Supported are the fields of the Images and ImageInformation tables cached by
+     * ImageInfo (category, modification date, file size, rating, creation date,
+     * format and dimensions), and the labels, which are loaded with the tags.
+     * Other fields are ignored.
+     */
+    void loadFields(const DatabaseFields::Set& fields) const;
+
     bool static namefileLessThan(const ImageInfo& d1, const ImageInfo& d2);
 
     /**
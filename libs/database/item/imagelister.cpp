@@ -53,6 +53,7 @@
 #include "imagequerybuilder.h"
 #include "dmetadata.h"
 #include "haariface.h"
+#include "dbengineaction.h"
 #include "dbenginesqlquery.h"
 #include "tagscache.h"
 #include "imagetagpair.h"
@@ -74,9 +75,9 @@ uint qHash(const ImageListerRecord& key)
  * If the value fits, we pass it. If it does not, we pass -1,
  * and the receiver shall get the full number itself
  */
-static inline int toInt32BitSafe(const QList<QVariant>::const_iterator& it)
+static inline int toInt32BitSafe(const QVariant& value)
 {
-    qlonglong v = (*it).toLongLong();
+    qlonglong v = value.toLongLong();
 
     if (v > std::numeric_limits<int>::max() || v < 0)
     {
@@ -85,6 +86,62 @@ static inline int toInt32BitSafe(const QList<QVariant>::const_iterator& it)
     return (int)v;
 }
 
+static inline int toInt32BitSafe(const QList<QVariant>::const_iterator& it)
+{
+    return toInt32BitSafe(*it);
+}
+
+static inline QDateTime toDateTime(const QVariant& value)
+{
+    return value.isNull() ? QDateTime()
+                          : QDateTime::fromString(value.toString(), Qt::ISODate);
+}
+
+/**
+ * Decodes the current row of a listing query, with the columns: id, name, album, albumRoot
+ * (if withAlbumRoot), rating, category, format, creationDate, modificationDate, fileSize,
+ * width and height. The listings walk their query row by row with this, instead of reading
+ * the whole result set as a list of values first.
+ */
+static void readRecord(const DbEngineSqlQuery& query, bool withAlbumRoot, ImageListerRecord& record)
+{
+    int column              = 0;
+    record.imageID          = query.value(column++).toLongLong();
+    record.name             = query.value(column++).toString();
+    record.albumID          = query.value(column++).toInt();
+
+    if (withAlbumRoot)
+    {
+        record.albumRootID  = query.value(column++).toInt();
+    }
+
+    record.rating           = query.value(column++).toInt();
+    record.category         = (DatabaseItem::Category)query.value(column++).toInt();
+    record.format           = query.value(column++).toString();
+    record.creationDate     = toDateTime(query.value(column++));
+    record.modificationDate = toDateTime(query.value(column++));
+    record.fileSize         = toInt32BitSafe(query.value(column++));
+    const int width         = query.value(column++).toInt();
+    record.imageSize        = QSize(width, query.value(column).toInt());
+}
+
+/**
+ * The listings walk their query in chunks of this many rows. They hold the read-only database
+ * access while they read a chunk, and hand its records to the receiver only once it is released.
+ * The query stays open between the chunks: it is bound to the database connection of the thread.
+ */
+static const int listingChunkSize = 500;
+
+static void sendRecords(ImageListerReceiver* const receiver, QList<ImageListerRecord>& records)
+{
+    foreach(const ImageListerRecord& record, records)
+    {
+        receiver->receive(record);
+    }
+
+    records.clear();
+}
+
 // ---------------------------------------------------------------------------------
 
 class ImageLister::Private
@@ -168,7 +225,7 @@ void ImageLister::listAlbum(ImageListerReceiver* const receiver, int albumRootId
 
     if (d->recursive)
     {
-        QList<int> intAlbumIds = CoreDbAccess().db()->getAlbumAndSubalbumsForPath(albumRootId, album);
+        QList<int> intAlbumIds = CoreDbAccess(CoreDbAccess::ReadOnly).db()->getAlbumAndSubalbumsForPath(albumRootId, album);
 
         if (intAlbumIds.isEmpty())
         {
@@ -182,7 +239,7 @@ void ImageLister::listAlbum(ImageListerReceiver* const receiver, int albumRootId
     }
     else
     {
-        int albumId = CoreDbAccess().db()->getAlbumForPath(albumRootId, album, false);
+        int albumId = CoreDbAccess(CoreDbAccess::ReadOnly).db()->getAlbumForPath(albumRootId, album, false);
 
         if (albumId == -1)
         {
@@ -192,8 +249,6 @@ void ImageLister::listAlbum(ImageListerReceiver* const receiver, int albumRootId
         albumIds << albumId;
     }
 
-    QList<QVariant> values;
-
     QString query = QString::fromUtf8("SELECT DISTINCT Images.id, Images.name, Images.album, "
                     "       ImageInformation.rating, Images.category, "
                     "       ImageInformation.format, ImageInformation.creationDate, "
@@ -201,71 +256,40 @@ void ImageLister::listAlbum(ImageListerReceiver* const receiver, int albumRootId
                     "       ImageInformation.width, ImageInformation.height "
                     " FROM Images "
                     "       LEFT JOIN ImageInformation ON Images.id=ImageInformation.imageid "
-                    " WHERE Images.status=1 AND ");
+                    " WHERE Images.status=1 AND Images.album IN (");
 
-    if (d->recursive)
-    {
-        // SQLite allows no more than 999 parameters
-        const int maxParams = CoreDbAccess().backend()->maximumBoundValues();
+    // SQLite allows no more than 999 parameters
+    const int maxParams = CoreDbAccess(CoreDbAccess::ReadOnly).backend()->maximumBoundValues();
+    QList<ImageListerRecord> records;
 
-        for (int i = 0 ; i < albumIds.size() ; i++)
-        {
-            QString q           = query;
-            QList<QVariant> ids =  (albumIds.size() <= maxParams) ? albumIds : albumIds.mid(i, maxParams);
-            i                  += ids.count();
-
-            QList<QVariant> v;
-            CoreDbAccess  access;
-            q += QString::fromUtf8("Images.album IN (");
-            access.db()->addBoundValuePlaceholders(q, ids.size());
-            q += QString::fromUtf8(");");
-            access.backend()->execSql(q, ids, &v);
-
-            values += v;
-        }
-    }
-    else
+    for (int start = 0 ; start < albumIds.size() ; start += maxParams)
     {
-        CoreDbAccess access;
-        query += QString::fromUtf8("Images.album = ?;");
-        access.backend()->execSql(query, albumIds, &values);
-    }
+        const QList<QVariant> ids = albumIds.mid(start, maxParams);
+        QString q                 = query;
+        CoreDB::addBoundValuePlaceholders(q, ids.size());
+        q                        += QString::fromUtf8(");");
 
-    int width, height;
+        DbEngineSqlQuery sqlQuery = CoreDbAccess(CoreDbAccess::ReadOnly).backend()->execQuery(q, ids);
+        int rows                  = 0;
 
-    for (QList<QVariant>::const_iterator it = values.constBegin(); it != values.constEnd();)
-    {
-        ImageListerRecord record;
-        record.imageID           = (*it).toLongLong();
-        ++it;
-        record.name              = (*it).toString();
-        ++it;
-        record.albumID           = (*it).toInt();
-        ++it;
-        record.rating            = (*it).toInt();
-        ++it;
-        record.category          = (DatabaseItem::Category)(*it).toInt();
-        ++it;
-        record.format            = (*it).toString();
-        ++it;
-        record.creationDate      = (*it).isNull() ? QDateTime()
-                                   : QDateTime::fromString((*it).toString(), Qt::ISODate);
-        ++it;
-        record.modificationDate  = (*it).isNull() ? QDateTime()
-                                   : QDateTime::fromString((*it).toString(), Qt::ISODate);
-        ++it;
-        record.fileSize          = toInt32BitSafe(it);
-        ++it;
-        width                    = (*it).toInt();
-        ++it;
-        height                   = (*it).toInt();
-        ++it;
+        do
+        {
+            {
+                CoreDbAccess access(CoreDbAccess::ReadOnly);
 
-        record.imageSize         = QSize(width, height);
+                for (rows = 0 ; rows < listingChunkSize && sqlQuery.next() ; ++rows)
+                {
+                    ImageListerRecord record;
+                    readRecord(sqlQuery, false, record);
+                    record.albumRootID = albumRootId;
 
-        record.albumRootID = albumRootId;
+                    records << record;
+                }
+            }
 
-        receiver->receive(record);
+            sendRecords(receiver, records);
+        }
+        while (rows == listingChunkSize);
     }
 }
 
@@ -274,66 +298,36 @@ void ImageLister::listTag(ImageListerReceiver* const receiver, QList<int> tagIds
     QSet<ImageListerRecord> records;
     QList<int>::iterator it;
 
+    QSet<int> albumRoots = albumRootsToList();
+
     for(it = tagIds.begin() ; it != tagIds.end() ; ++it)
     {
-        QList<QVariant>         values;
         QMap<QString, QVariant> parameters;
         parameters.insert(QLatin1String(":tagPID"), *it);
         parameters.insert(QLatin1String(":tagID"),  *it);
 
-        CoreDbAccess access;
+        CoreDbAccess access(CoreDbAccess::ReadOnly);
 
-        if (d->recursive)
-        {
-            access.backend()->execDBAction(access.backend()->getDBAction(QLatin1String("listTagRecursive")), parameters, &values);
-        }
-        else
+        DbEngineAction action = access.backend()->getDBAction(d->recursive ? QLatin1String("listTagRecursive")
+                                                                           : QLatin1String("listTag"));
+
+        if (action.dbActionElements.isEmpty())
         {
-            access.backend()->execDBAction(access.backend()->getDBAction(QLatin1String("listTag")), parameters, &values);
+            continue;
         }
 
-        QSet<int> albumRoots = albumRootsToList();
+        DbEngineSqlQuery query = access.backend()->execQuery(action.dbActionElements.first().statement, parameters);
 
-        int width, height;
-
-        for (QList<QVariant>::const_iterator it = values.constBegin(); it != values.constEnd();)
+        while (query.next())
         {
             ImageListerRecord record;
-
-            record.imageID           = (*it).toLongLong();
-            ++it;
-            record.name              = (*it).toString();
-            ++it;
-            record.albumID           = (*it).toInt();
-            ++it;
-            record.albumRootID       = (*it).toInt();
-            ++it;
-            record.rating            = (*it).toInt();
-            ++it;
-            record.category          = (DatabaseItem::Category)(*it).toInt();
-            ++it;
-            record.format            = (*it).toString();
-            ++it;
-            record.creationDate      = (*it).isNull() ? QDateTime()
-                                       : QDateTime::fromString((*it).toString(), Qt::ISODate);
-            ++it;
-            record.modificationDate  = (*it).isNull() ? QDateTime()
-                                       : QDateTime::fromString((*it).toString(), Qt::ISODate);
-            ++it;
-            record.fileSize          = toInt32BitSafe(it);
-            ++it;
-            width                    = (*it).toInt();
-            ++it;
-            height                   = (*it).toInt();
-            ++it;
+            readRecord(query, true, record);
 
             if (d->listOnlyAvailableImages && !albumRoots.contains(record.albumRootID))
             {
                 continue;
             }
 
-            record.imageSize         = QSize(width, height);
-
             records.insert(record);
         }
     }
@@ -349,7 +343,7 @@ void ImageLister::listFaces(ImageListerReceiver* const receiver, int personId)
 {
     QList<qlonglong> list;
     QList<QVariant>  values;
-    CoreDbAccess   access;
+    CoreDbAccess   access(CoreDbAccess::ReadOnly);
 
     access.backend()->execSql(QString::fromUtf8("SELECT Images.id "
                                                 " FROM Images "
@@ -383,129 +377,108 @@ void ImageLister::listFaces(ImageListerReceiver* const receiver, int personId)
 
 void ImageLister::listDateRange(ImageListerReceiver* const receiver, const QDate& startDate, const QDate& endDate)
 {
-    QList<QVariant> values;
-
-    {
-        CoreDbAccess access;
-        access.backend()->execSql(QString::fromUtf8("SELECT DISTINCT Images.id, Images.name, Images.album, "
-                                          "       Albums.albumRoot, "
-                                          "       ImageInformation.rating, Images.category, "
-                                          "       ImageInformation.format, ImageInformation.creationDate, "
-                                          "       Images.modificationDate, Images.fileSize, "
-                                          "       ImageInformation.width, ImageInformation.height "
-                                          " FROM Images "
-                                          "       LEFT JOIN ImageInformation ON Images.id=ImageInformation.imageid "
-                                          "       INNER JOIN Albums ON Albums.id=Images.album "
-                                          " WHERE Images.status=1 "
-                                          "   AND ImageInformation.creationDate < ? "
-                                          "   AND ImageInformation.creationDate >= ? "
-                                          " ORDER BY Images.album;"),
-                                  QDateTime(endDate).toString(Qt::ISODate),
-                                  QDateTime(startDate).toString(Qt::ISODate),
-                                  &values);
-    }
-
     QSet<int> albumRoots = albumRootsToList();
-    int       width, height;
-
-    for (QList<QVariant>::const_iterator it = values.constBegin(); it != values.constEnd();)
+    const QString sql    = QString::fromUtf8("SELECT DISTINCT Images.id, Images.name, Images.album, "
+                                             "       Albums.albumRoot, "
+                                             "       ImageInformation.rating, Images.category, "
+                                             "       ImageInformation.format, ImageInformation.creationDate, "
+                                             "       Images.modificationDate, Images.fileSize, "
+                                             "       ImageInformation.width, ImageInformation.height "
+                                             " FROM Images "
+                                             "       LEFT JOIN ImageInformation ON Images.id=ImageInformation.imageid "
+                                             "       INNER JOIN Albums ON Albums.id=Images.album "
+                                             " WHERE Images.status=1 "
+                                             "   AND ImageInformation.creationDate < ? "
+                                             "   AND ImageInformation.creationDate >= ? "
+                                             " ORDER BY Images.album;");
+
+    DbEngineSqlQuery query = CoreDbAccess(CoreDbAccess::ReadOnly).backend()->execQuery(sql,
+                                                                                       QDateTime(endDate).toString(Qt::ISODate),
+                                                                                       QDateTime(startDate).toString(Qt::ISODate));
+
+    QList<ImageListerRecord> records;
+    int rows = 0;
+
+    do
     {
-        ImageListerRecord record;
+        {
+            CoreDbAccess access(CoreDbAccess::ReadOnly);
 
-        record.imageID           = (*it).toLongLong();
-        ++it;
-        record.name              = (*it).toString();
-        ++it;
-        record.albumID           = (*it).toInt();
-        ++it;
-        record.albumRootID       = (*it).toInt();
-        ++it;
-        record.rating            = (*it).toInt();
-        ++it;
-        record.category          = (DatabaseItem::Category)(*it).toInt();
-        ++it;
-        record.format            = (*it).toString();
-        ++it;
-        record.creationDate      = (*it).isNull() ? QDateTime()
-                                   : QDateTime::fromString((*it).toString(), Qt::ISODate);
-        ++it;
-        record.modificationDate  = (*it).isNull() ? QDateTime()
-                                   : QDateTime::fromString((*it).toString(), Qt::ISODate);
-        ++it;
-        record.fileSize          = toInt32BitSafe(it);
-        ++it;
-        width                    = (*it).toInt();
-        ++it;
-        height                   = (*it).toInt();
-        ++it;
+            for (rows = 0 ; rows < listingChunkSize && query.next() ; ++rows)
+            {
+                ImageListerRecord record;
+                readRecord(query, true, record);
 
-        if (d->listOnlyAvailableImages && !albumRoots.contains(record.albumRootID))
-        {
-            continue;
-        }
+                if (d->listOnlyAvailableImages && !albumRoots.contains(record.albumRootID))
+                {
+                    continue;
+                }
 
-        record.imageSize         = QSize(width, height);
+                records << record;
+            }
+        }
 
-        receiver->receive(record);
+        sendRecords(receiver, records);
     }
+    while (rows == listingChunkSize);
 }
 
 void ImageLister::listAreaRange(ImageListerReceiver* const receiver, double lat1, double lat2, double lon1, double lon2)
 {
-    QList<QVariant> values;
     QList<QVariant> boundValues;
     boundValues << lat1 << lat2 << lon1 << lon2;
 
     qCDebug(DIGIKAM_DATABASE_LOG) << "Listing area" << lat1 << lat2 << lon1 << lon2;
 
-    CoreDbAccess access;
-
-    access.backend()->execSql(QString::fromUtf8("SELECT DISTINCT Images.id, "
-                                      "       Albums.albumRoot, ImageInformation.rating, ImageInformation.creationDate, "
-                                      "       ImagePositions.latitudeNumber, ImagePositions.longitudeNumber "
-                                      " FROM Images "
-                                      "       LEFT JOIN ImageInformation ON Images.id=ImageInformation.imageid "
-                                      "       INNER JOIN Albums ON Albums.id=Images.album "
-                                      "       INNER JOIN ImagePositions   ON Images.id=ImagePositions.imageid "
-                                      " WHERE Images.status=1 "
-                                      "   AND (ImagePositions.latitudeNumber>? AND ImagePositions.latitudeNumber<?) "
-                                      "   AND (ImagePositions.longitudeNumber>? AND ImagePositions.longitudeNumber<?);"),
-                              boundValues,
-                              &values);
-
-
-    qCDebug(DIGIKAM_DATABASE_LOG) << "Results:" << values.size() / 14;
-
     QSet<int> albumRoots = albumRootsToList();
-    double    lat, lon;
-
-    for (QList<QVariant>::const_iterator it = values.constBegin(); it != values.constEnd();)
+    int       results    = 0;
+    const QString sql    = QString::fromUtf8("SELECT DISTINCT Images.id, "
+                                             "       Albums.albumRoot, ImageInformation.rating, ImageInformation.creationDate, "
+                                             "       ImagePositions.latitudeNumber, ImagePositions.longitudeNumber "
+                                             " FROM Images "
+                                             "       LEFT JOIN ImageInformation ON Images.id=ImageInformation.imageid "
+                                             "       INNER JOIN Albums ON Albums.id=Images.album "
+                                             "       INNER JOIN ImagePositions   ON Images.id=ImagePositions.imageid "
+                                             " WHERE Images.status=1 "
+                                             "   AND (ImagePositions.latitudeNumber>? AND ImagePositions.latitudeNumber<?) "
+                                             "   AND (ImagePositions.longitudeNumber>? AND ImagePositions.longitudeNumber<?);");
+
+    DbEngineSqlQuery query = CoreDbAccess(CoreDbAccess::ReadOnly).backend()->execQuery(sql, boundValues);
+
+    QList<ImageListerRecord> records;
+    int rows = 0;
+
+    do
     {
-        ImageListerRecord record(d->allowExtraValues ? ImageListerRecord::ExtraValueFormat : ImageListerRecord::TraditionalFormat);
+        {
+            CoreDbAccess access(CoreDbAccess::ReadOnly);
 
-        record.imageID           = (*it).toLongLong();
-        ++it;
-        record.albumRootID       = (*it).toInt();
-        ++it;
+            for (rows = 0 ; rows < listingChunkSize && query.next() ; ++rows)
+            {
+                ImageListerRecord record(d->allowExtraValues ? ImageListerRecord::ExtraValueFormat : ImageListerRecord::TraditionalFormat);
 
-        record.rating            = (*it).toInt();
-        ++it;
-        record.creationDate      = (*it).toDateTime();
-        ++it;
-        lat                      = (*it).toDouble();
-        ++it;
-        lon                      = (*it).toDouble();
-        ++it;
+                record.imageID           = query.value(0).toLongLong();
+                record.albumRootID       = query.value(1).toInt();
+                record.rating            = query.value(2).toInt();
+                record.creationDate      = query.value(3).toDateTime();
+                ++results;
 
-        if (d->listOnlyAvailableImages && !albumRoots.contains(record.albumRootID))
-        {
-            continue;
-        }
+                if (d->listOnlyAvailableImages && !albumRoots.contains(record.albumRootID))
+                {
+                    continue;
+                }
 
-        record.extraValues       << lat << lon;
+                record.extraValues       << query.value(4).toDouble() << query.value(5).toDouble();
 
-        receiver->receive(record);
+                records << record;
+            }
+        }
+
+        sendRecords(receiver, records);
     }
+    while (rows == listingChunkSize);
+
+    qCDebug(DIGIKAM_DATABASE_LOG) << "Results:" << results;
 }
 
 void ImageLister::listSearch(ImageListerReceiver* const receiver, const QString& xml, int limit, qlonglong referenceImageId)
@@ -556,7 +529,7 @@ void ImageLister::listSearch(ImageListerReceiver* const receiver, const QString&
 
     bool executionSuccess;
     {
-        CoreDbAccess access;
+        CoreDbAccess access(CoreDbAccess::ReadOnly);
         executionSuccess = access.backend()->execSql(sqlQuery, boundValues, &values);
 
         if (!executionSuccess)
@@ -577,60 +550,71 @@ void ImageLister::listSearch(ImageListerReceiver* const receiver, const QString&
     int       width, height;
     double    lat,lon;
 
-    CoreDbAccess access;
+    QList<ImageListerRecord> records;
+    QList<QVariant>::const_iterator it = values.constBegin();
 
-    for (QList<QVariant>::const_iterator it = values.constBegin(); it != values.constEnd();)
+    while (it != values.constEnd())
     {
-        ImageListerRecord record;
-
-        record.imageID           = (*it).toLongLong();
-        ++it;
-        record.name              = (*it).toString();
-        ++it;
-        record.albumID           = (*it).toInt();
-        ++it;
-        record.albumRootID       = (*it).toInt();
-        ++it;
-        record.rating            = (*it).toInt();
-        ++it;
-        record.category          = (DatabaseItem::Category)(*it).toInt();
-        ++it;
-        record.format            = (*it).toString();
-        ++it;
-        record.creationDate      = (*it).isNull() ? QDateTime()
-                                   : QDateTime::fromString((*it).toString(), Qt::ISODate);
-        ++it;
-        record.modificationDate  = (*it).isNull() ? QDateTime()
-                                   : QDateTime::fromString((*it).toString(), Qt::ISODate);
-        ++it;
-        record.fileSize          = toInt32BitSafe(it);
-        ++it;
-        width                    = (*it).toInt();
-        ++it;
-        height                   = (*it).toInt();
-        ++it;
-        lat                      = (*it).toDouble();
-        ++it;
-        lon                      = (*it).toDouble();
-        ++it;
-
-        record.currentSimilarity                 = access.db()->getImageProperty(record.imageID,QLatin1String("similarityTo_") +
-                                                   QString::number(referenceImageId)).toDouble();
-        record.currentFuzzySearchReferenceImage  = referenceImageId;
-
-        if (d->listOnlyAvailableImages && !albumRoots.contains(record.albumRootID))
         {
-            continue;
-        }
+            // The similarity is read from the database: the records of a chunk are made with the access held.
+            CoreDbAccess access(CoreDbAccess::ReadOnly);
 
-        if (!hooks.checkPosition(lat, lon))
-        {
-            continue;
+            for (int rows = 0 ; rows < listingChunkSize && it != values.constEnd() ; ++rows)
+            {
+                ImageListerRecord record;
+
+                record.imageID           = (*it).toLongLong();
+                ++it;
+                record.name              = (*it).toString();
+                ++it;
+                record.albumID           = (*it).toInt();
+                ++it;
+                record.albumRootID       = (*it).toInt();
+                ++it;
+                record.rating            = (*it).toInt();
+                ++it;
+                record.category          = (DatabaseItem::Category)(*it).toInt();
+                ++it;
+                record.format            = (*it).toString();
+                ++it;
+                record.creationDate      = (*it).isNull() ? QDateTime()
+                                           : QDateTime::fromString((*it).toString(), Qt::ISODate);
+                ++it;
+                record.modificationDate  = (*it).isNull() ? QDateTime()
+                                           : QDateTime::fromString((*it).toString(), Qt::ISODate);
+                ++it;
+                record.fileSize          = toInt32BitSafe(it);
+                ++it;
+                width                    = (*it).toInt();
+                ++it;
+                height                   = (*it).toInt();
+                ++it;
+                lat                      = (*it).toDouble();
+                ++it;
+                lon                      = (*it).toDouble();
+                ++it;
+
+                record.currentSimilarity                 = access.db()->getImageProperty(record.imageID,QLatin1String("similarityTo_") +
+                                                           QString::number(referenceImageId)).toDouble();
+                record.currentFuzzySearchReferenceImage  = referenceImageId;
+
+                if (d->listOnlyAvailableImages && !albumRoots.contains(record.albumRootID))
+                {
+                    continue;
+                }
+
+                if (!hooks.checkPosition(lat, lon))
+                {
+                    continue;
+                }
+
+                record.imageSize         = QSize(width, height);
+
+                records << record;
+            }
         }
 
-        record.imageSize         = QSize(width, height);
-
-        receiver->receive(record);
+        sendRecords(receiver, records);
     }
 }
 
@@ -675,7 +659,7 @@ void ImageLister::listImageTagPropertySearch(ImageListerReceiver* const receiver
 
     bool executionSuccess;
     {
-        CoreDbAccess access;
+        CoreDbAccess access(CoreDbAccess::ReadOnly);
         executionSuccess = access.backend()->execSql(sqlQuery, boundValues, &values);
 
         if (!executionSuccess)
@@ -882,7 +866,7 @@ void ImageLister::listFromHaarSearch(ImageListerReceiver* const receiver, const
 
     {
         // Generate the query that returns the similarity as constant for a given image id.
-        CoreDbAccess access;
+        CoreDbAccess access(CoreDbAccess::ReadOnly);
         DbEngineSqlQuery query = access.backend()->prepareQuery(QString::fromUtf8(
                              "SELECT DISTINCT Images.id, Images.name, Images.album, "
                              "       Albums.albumRoot, "
@@ -999,7 +983,7 @@ void ImageLister::listFromIdList(ImageListerReceiver* const receiver, const QLis
         query.addBindValue(variantIdList);
         executionSuccess = query.execBatch
 */
-        CoreDbAccess access;
+        CoreDbAccess access(CoreDbAccess::ReadOnly);
         DbEngineSqlQuery query = access.backend()->prepareQuery(QString::fromUtf8(
                              "SELECT DISTINCT Images.id, Images.name, Images.album, "
                              "       Albums.albumRoot, "
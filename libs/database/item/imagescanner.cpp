@@ -26,6 +26,7 @@
 
 // Qt includes
 
+#include <QFile>
 #include <QImageReader>
 #include <QTime>
 
@@ -137,6 +138,7 @@ public:
         : hasImage(false),
           hasMetadata(false),
           loadedFromDisk(false),
+          uniqueHashVersion(0),
           scanMode(ModifiedScan),
           hasHistoryToResolve(false)
     {
@@ -149,8 +151,16 @@ public:
     bool                   hasMetadata;
     bool                   loadedFromDisk;
 
+    /// The unique hash version set by setUniqueHashV2(), 0 to read it from the database
+    int                    uniqueHashVersion;
+
     QFileInfo              fileInfo;
 
+    /// Parts of the file while loadFromDisk() runs, if they could be read: the first bytes,
+    /// including the metadata segments of a JPEG file, and the last 100 kB
+    QByteArray             fileHead;
+    QByteArray             fileTail;
+
     DMetadata              metadata;
     DImg                   img;
     ItemScanInfo           scanInfo;
@@ -1563,6 +1573,106 @@ void ImageScanner::scanAudioFile()
             DatabaseFields::Format;
 }
 
+/// The unique hashes read the first and the last 100 kB of the file
+static const int scannedFilePartSize    = 100 * 1024;
+
+/// Beyond this, the metadata segments of a JPEG file are parsed from the file by Exiv2
+static const int maxScannedMetadataSize = 8 * 1024 * 1024;
+
+/**
+ * Reads more of file at the end of head, until head holds at least size bytes.
+ * Returns false if it cannot, or if size is too large for the metadata segments.
+ */
+static bool readFileHeadTo(QFile& file, QByteArray& head, int size)
+{
+    if (size > maxScannedMetadataSize)
+    {
+        return false;
+    }
+
+    if (head.size() < size)
+    {
+        // read ahead by large blocks: the segments are small and follow each other
+        const int toRead = qMin(qMax(size - head.size(), scannedFilePartSize), maxScannedMetadataSize - head.size());
+        head            += file.read(toRead);
+    }
+
+    return (head.size() >= size);
+}
+
+/**
+ * Reads in head the start of a JPEG file up to its image data: the markers and metadata segments,
+ * up to the start of scan header. Returns the size of this part, or 0 if the file is not a JPEG file,
+ * is malformed, or its metadata segments are too large.
+ */
+static int readJpegMetadataSegments(QFile& file, QByteArray& head)
+{
+    if (!readFileHeadTo(file, head, 4) ||
+        (uchar)head.at(0) != 0xFF || (uchar)head.at(1) != 0xD8)
+    {
+        return 0;
+    }
+
+    int pos = 2;
+
+    forever
+    {
+        if (!readFileHeadTo(file, head, pos + 4))
+        {
+            return 0;
+        }
+
+        const uchar* const data = reinterpret_cast<const uchar*>(head.constData());
+
+        if (data[pos] != 0xFF)
+        {
+            return 0;
+        }
+
+        const uchar marker = data[pos + 1];
+
+        if (marker == 0xFF)
+        {
+            // fill byte
+            ++pos;
+            continue;
+        }
+
+        if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7))
+        {
+            // markers without segment
+            pos += 2;
+            continue;
+        }
+
+        if (marker == 0xD9)
+        {
+            // end of image before any image data
+            return 0;
+        }
+
+        const int length = (data[pos + 2] << 8) | data[pos + 3];
+
+        if (length < 2)
+        {
+            return 0;
+        }
+
+        pos += 2 + length;
+
+        if (marker == 0xDA)
+        {
+            // start of scan: the image data follows its header
+            return (readFileHeadTo(file, head, pos) ? pos : 0);
+        }
+    }
+}
+
+void ImageScanner::setUniqueHashV2(bool v2)
+{
+    d->uniqueHashVersion = v2 ? 2 : 1;
+}
+
 void ImageScanner::loadFromDisk()
 {
     if (d->loadedFromDisk)
@@ -1571,8 +1681,57 @@ void ImageScanner::loadFromDisk()
     }
 
     d->loadedFromDisk = true;
+
+    // Open the file once, and read only the parts needed: the unique hash is computed from its
+    // first and last 100 kB. The metadata of JPEG files, in segments before the image data, are
+    // parsed from memory. Other formats, as RAW files with metadata anywhere in the file, are
+    // parsed by Exiv2 from the file. The file is read, not mapped: files are often scanned while
+    // an import tool or a sync client still writes them, and accessing a mapping of a truncated
+    // file would crash.
+    const qint64 size     = d->fileInfo.size();
+    const qint64 partSize = qMin(size, (qint64)scannedFilePartSize);
+    QByteArray   metadataData;
+
+    if (size > 0)
+    {
+        QFile file(d->fileInfo.filePath());
+
+        if (file.open(QIODevice::ReadOnly))
+        {
+            d->fileHead           = file.read(partSize);
+            const int jpegDataPos = readJpegMetadataSegments(file, d->fileHead);
+
+            if (jpegDataPos > 0)
+            {
+                metadataData = QByteArray::fromRawData(d->fileHead.constData(), jpegDataPos);
+            }
+
+            if (d->fileHead.size() == size)
+            {
+                d->fileTail = d->fileHead.right(partSize);
+            }
+            else if (file.seek(size - partSize))
+            {
+                d->fileTail = file.read(partSize);
+            }
+
+            file.close();
+        }
+
+        // The file changed while it was read: use the file based code path.
+        const QFileInfo check(d->fileInfo.filePath());
+
+        if (d->fileHead.size() < partSize || d->fileTail.size() != partSize ||
+            check.size() != size  || check.lastModified() != d->fileInfo.lastModified())
+        {
+            metadataData = QByteArray();
+            d->fileHead  = QByteArray();
+            d->fileTail  = QByteArray();
+        }
+    }
+
     d->metadata.registerMetadataSettings();
-    d->hasMetadata    = d->metadata.load(d->fileInfo.filePath());
+    d->hasMetadata    = d->metadata.load(d->fileInfo.filePath(), metadataData);
 
     if (d->scanInfo.category == DatabaseItem::Image)
     {
@@ -1590,6 +1749,10 @@ void ImageScanner::loadFromDisk()
     // NOTE: call uniqueHash after loading the image above, else it will fail
     d->scanInfo.uniqueHash       = uniqueHash();
 
+    metadataData = QByteArray();
+    d->fileHead  = QByteArray();
+    d->fileTail  = QByteArray();
+
    // faster than loading twice from disk
     if (d->hasMetadata)
     {
@@ -1600,17 +1763,25 @@ void ImageScanner::loadFromDisk()
 QString ImageScanner::uniqueHash() const
 {
     // the QByteArray is an ASCII hex string
+    // the parts of the file are used if they were read by loadFromDisk()
+    const bool hasData = !d->fileHead.isNull();
+    const bool v2      = d->uniqueHashVersion ? (d->uniqueHashVersion == 2)
+                                              : CoreDbAccess().db()->isUniqueHashV2();
+
     if (d->scanInfo.category == DatabaseItem::Image)
     {
-        if (CoreDbAccess().db()->isUniqueHashV2())
-            return QString::fromUtf8(d->img.getUniqueHashV2());
+        // as with the file path, there is no hash if the image could not be loaded
+        const bool useData = hasData && d->hasImage;
+
+        if (v2)
+            return QString::fromUtf8(useData ? d->img.getUniqueHashV2FromData(d->fileHead, d->fileTail) : d->img.getUniqueHashV2());
         else
-            return QString::fromUtf8(d->img.getUniqueHash());
+            return QString::fromUtf8(useData ? d->img.getUniqueHashFromData(d->fileHead, d->fileInfo.size()) : d->img.getUniqueHash());
     }
     else
     {
-        if (CoreDbAccess().db()->isUniqueHashV2())
-            return QString::fromUtf8(DImg::getUniqueHashV2(d->fileInfo.filePath()));
+        if (v2)
+            return QString::fromUtf8(hasData ? DImg().getUniqueHashV2FromData(d->fileHead, d->fileTail) : DImg::getUniqueHashV2(d->fileInfo.filePath()));
         else
             return QString::fromUtf8(DImg::getUniqueHash(d->fileInfo.filePath()));
     }
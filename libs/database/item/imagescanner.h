@@ -153,6 +153,12 @@ public:
      */
     void loadFromDisk();
 
+    /**
+     * Sets the version of the unique hash computed by loadFromDisk(), instead of reading
+     * it from the database. Use it when loading files in parallel threads.
+     */
+    void setUniqueHashV2(bool v2);
+
     /**
      * Returns a suitable creation date from file system information.
      * Use this as a fallback if metadata is not available.
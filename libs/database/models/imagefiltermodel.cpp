@@ -259,6 +259,15 @@ void ImageFilterModel::setDirectSourceImageModel(ImageModel* sourceModel)
         d->imageModel->unsetPreprocessor(d);
         disconnect(d->imageModel, SIGNAL(modelReset()),
                    this, SLOT(slotModelReset()));
+
+        disconnect(d->imageModel, SIGNAL(rowsInserted(QModelIndex,int,int)),
+                   d, SLOT(sourceRowsInserted(QModelIndex,int,int)));
+
+        disconnect(d->imageModel, SIGNAL(rowsRemoved(QModelIndex,int,int)),
+                   d, SLOT(sourceRowsRemoved(QModelIndex,int,int)));
+
+        disconnect(d->imageModel, SIGNAL(layoutChanged()),
+                   d, SLOT(sourceLayoutChanged()));
         slotModelReset();
     }
 
@@ -283,6 +292,15 @@ void ImageFilterModel::setDirectSourceImageModel(ImageModel* sourceModel)
         connect(d->imageModel, SIGNAL(modelReset()),
                 this, SLOT(slotModelReset()));
 
+        connect(d->imageModel, SIGNAL(rowsInserted(QModelIndex,int,int)),
+                d, SLOT(sourceRowsInserted(QModelIndex,int,int)));
+
+        connect(d->imageModel, SIGNAL(rowsRemoved(QModelIndex,int,int)),
+                d, SLOT(sourceRowsRemoved(QModelIndex,int,int)));
+
+        connect(d->imageModel, SIGNAL(layoutChanged()),
+                d, SLOT(sourceLayoutChanged()));
+
         connect(d->imageModel, SIGNAL(imageChange(ImageChangeset,QItemSelection)),
                 this, SLOT(slotImageChange(ImageChangeset)));
 
@@ -421,6 +439,9 @@ void ImageFilterModel::setImageFilterSettings(const ImageFilterSettings& setting
         d->needPrepareGroups   = true;
         d->needPrepare         = d->needPrepareComments || d->needPrepareTags || d->needPrepareGroups;
 
+        d->prepareFields       = settings.watchFlags();
+        d->prepareFields.setFields(d->sorter.watchFlags());
+
         d->hasOneMatch         = false;
         d->hasOneMatchForText  = false;
     }
@@ -542,6 +563,7 @@ void ImageFilterModel::slotModelReset()
         d->hasOneMatchForText = false;
     }
     d->filterResults.clear();
+    d->sortKeys.invalidate();
 }
 
 bool ImageFilterModel::filterAcceptsRow(int source_row, const QModelIndex& source_parent) const
@@ -639,12 +661,14 @@ void ImageFilterModelPreparer::process(ImageFilterModelTodoPackage package)
 
     // get thread-local copy
     bool needPrepareTags, needPrepareComments, needPrepareGroups;
+    DatabaseFields::Set prepareFields;
     QList<ImageFilterModelPrepareHook*> prepareHooks;
     {
         QMutexLocker lock(&d->mutex);
         needPrepareTags     = d->needPrepareTags;
         needPrepareComments = d->needPrepareComments;
         needPrepareGroups   = d->needPrepareGroups;
+        prepareFields       = d->prepareFields;
         prepareHooks        = d->prepareHooks;
     }
 
@@ -666,12 +690,10 @@ void ImageFilterModelPreparer::process(ImageFilterModelTodoPackage package)
     // The downside of QVector: At some point, we may need a QList for an API.
     // Nonetheless, QList and ImageInfo is fast. We could as well
     // reimplement ImageInfoList to ImageInfoVector (internally with templates?)
-    ImageInfoList infoList;
+    ImageInfoList infoList = package.infos.toList();
 
-    if (needPrepareTags || needPrepareGroups)
-    {
-        infoList = package.infos.toList();
-    }
+    // The filterer and the sorting read these fields of each item: load them for the whole package.
+    infoList.loadFields(prepareFields);
 
     if (needPrepareTags)
     {
@@ -714,13 +736,25 @@ void ImageFilterModelFilterer::process(ImageFilterModelTodoPackage package)
         hasOneMatchForText = d->hasOneMatchForText;
     }
 
+    // Read the filter keys of all infos in one pass, so that each info is looked up once
+    // for its tags, rating and album, and the infos rejected by their keys are not read further.
+    const int                count = package.infos.size();
+    QVector<ImageFilterKeys> keys;
+    keys.reserve(count);
+
+    foreach(const ImageInfo& info, package.infos)
+    {
+        keys << localFilter.filterKeys(info);
+    }
+
     // Actual filtering. The variants to spare checking hasOneMatch over and over again.
     if (hasOneMatch && hasOneMatchForText)
     {
-        foreach(const ImageInfo& info, package.infos)
+        for (int i = 0 ; i < count ; ++i)
         {
-            package.filterResults[info.id()] = localFilter.matches(info)        &&
-                                               localVersionFilter.matches(info) &&
+            const ImageInfo& info            = package.infos.at(i);
+            package.filterResults[info.id()] = localFilter.matches(info, keys.at(i)) &&
+                                               localVersionFilter.matches(info)      &&
                                                localGroupFilter.matches(info);
         }
     }
@@ -728,10 +762,11 @@ void ImageFilterModelFilterer::process(ImageFilterModelTodoPackage package)
     {
         bool matchForText;
 
-        foreach(const ImageInfo& info, package.infos)
+        for (int i = 0 ; i < count ; ++i)
         {
-            package.filterResults[info.id()] = localFilter.matches(info, &matchForText) &&
-                                               localVersionFilter.matches(info)         &&
+            const ImageInfo& info            = package.infos.at(i);
+            package.filterResults[info.id()] = localFilter.matches(info, keys.at(i), &matchForText) &&
+                                               localVersionFilter.matches(info)                     &&
                                                localGroupFilter.matches(info);
 
             if (matchForText)
@@ -744,10 +779,11 @@ void ImageFilterModelFilterer::process(ImageFilterModelTodoPackage package)
     {
         bool result, matchForText;
 
-        foreach(const ImageInfo& info, package.infos)
+        for (int i = 0 ; i < count ; ++i)
         {
-            result                           = localFilter.matches(info, &matchForText) &&
-                                               localVersionFilter.matches(info)         &&
+            const ImageInfo& info            = package.infos.at(i);
+            result                           = localFilter.matches(info, keys.at(i), &matchForText) &&
+                                               localVersionFilter.matches(info)                     &&
                                                localGroupFilter.matches(info);
             package.filterResults[info.id()] = result;
 
@@ -779,6 +815,21 @@ void ImageFilterModel::setImageSortSettings(const ImageSortSettings& sorter)
 {
     Q_D(ImageFilterModel);
     d->sorter = sorter;
+    d->sortKeys.invalidate();
+
+    {
+        QMutexLocker lock(&d->mutex);
+        d->prepareFields = d->filterCopy.watchFlags();
+        d->prepareFields.setFields(d->sorter.watchFlags());
+    }
+
+    // Sorting compares every item with several others: load the sort fields
+    // of the items already in the model before, in a few queries.
+    if (d->imageModel)
+    {
+        ImageInfoList(d->imageModel->imageInfos()).loadFields(d->sorter.watchFlags());
+    }
+
     setCategorizedModel(d->sorter.categorizationMode != ImageSortSettings::NoCategories);
     invalidate();
 }
@@ -859,6 +910,28 @@ bool ImageFilterModel::subSortLessThan(const QModelIndex& left, const QModelInde
         return false;
     }
 
+    if (d->sorter.hasSortKey())
+    {
+        // Compare the keys of the rows. Items of different groups, equal keys
+        // and rows of the same item are compared below, with their ImageInfo.
+
+        d->sortKeys.update(d->imageModel, d->sorter);
+
+        const int leftRow  = left.row();
+        const int rightRow = right.row();
+
+        if (d->sortKeys.ids.at(leftRow)           != d->sortKeys.ids.at(rightRow) &&
+            d->sortKeys.groupImageIds.at(leftRow) == d->sortKeys.groupImageIds.at(rightRow))
+        {
+            int result = d->sorter.compareSortKeys(d->sortKeys.keys.at(leftRow), d->sortKeys.keys.at(rightRow));
+
+            if (result != 0)
+            {
+                return result < 0;
+            }
+        }
+    }
+
     const ImageInfo& leftInfo  = d->imageModel->imageInfoRef(left);
     const ImageInfo& rightInfo = d->imageModel->imageInfoRef(right);
 
@@ -999,6 +1072,21 @@ void ImageFilterModel::slotImageChange(const ImageChangeset& changeset)
         return;
     }
 
+    // Keep the sort keys of the changed items current.
+    DatabaseFields::Set keyFields = d->sorter.watchFlags();
+    keyFields.setFields(DatabaseFields::ImageRelations);
+
+    if (d->sortKeys.valid && (keyFields & changeset.changes()))
+    {
+        foreach(const qlonglong& id, changeset.ids())
+        {
+            foreach(const QModelIndex& index, d->imageModel->indexesForImageId(id))
+            {
+                d->sortKeys.refreshRow(d->imageModel, d->sorter, index.row());
+            }
+        }
+    }
+
     // already scheduled to re-filter?
     if (d->updateFilterTimer->isActive())
     {
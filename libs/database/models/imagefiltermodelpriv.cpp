@@ -31,6 +31,7 @@
 
 #include "digikam_debug.h"
 #include "imagefiltermodelthreads.h"
+#include "imageinfolist.h"
 
 namespace Digikam
 {
@@ -255,4 +256,102 @@ void ImageFilterModel::ImageFilterModelPrivate::packageDiscarded(const ImageFilt
     }
 }
 
+void ImageFilterModel::ImageFilterModelPrivate::sourceRowsInserted(const QModelIndex&, int, int end)
+{
+    // The model appends its rows. Keys of rows inserted before the last ones would be misplaced.
+    if (end != imageModel->rowCount() - 1)
+    {
+        sortKeys.invalidate();
+    }
+}
+
+void ImageFilterModel::ImageFilterModelPrivate::sourceRowsRemoved(const QModelIndex&, int start, int end)
+{
+    sortKeys.removeRows(start, end);
+}
+
+void ImageFilterModel::ImageFilterModelPrivate::sourceLayoutChanged()
+{
+    sortKeys.invalidate();
+}
+
+// ------------------------------------------------------------------------------------------------
+
+void ImageSortKeyTable::invalidate()
+{
+    ids.clear();
+    groupImageIds.clear();
+    keys.clear();
+    valid = false;
+}
+
+void ImageSortKeyTable::update(ImageModel* const model, const ImageSortSettings& sorter)
+{
+    const int rows = model->rowCount();
+
+    if (!valid || ids.size() > rows)
+    {
+        invalidate();
+        ids.reserve(rows);
+        groupImageIds.reserve(rows);
+        keys.reserve(rows);
+        valid = true;
+    }
+
+    // Load the fields of all missing rows at once, not one item after the other.
+
+    if (ids.size() < rows)
+    {
+        ImageInfoList infos;
+
+        for (int row = ids.size() ; row < rows ; ++row)
+        {
+            infos << model->imageInfoRef(row);
+        }
+
+        infos.loadFields(sorter.watchFlags());
+        infos.loadGroupImageIds();
+    }
+
+    for (int row = ids.size() ; row < rows ; ++row)
+    {
+        const ImageInfo& info = model->imageInfoRef(row);
+        ids           << info.id();
+        groupImageIds << info.groupImageId();
+        keys          << sorter.sortKey(info);
+    }
+}
+
+void ImageSortKeyTable::removeRows(int start, int end)
+{
+    if (!valid)
+    {
+        return;
+    }
+
+    if (end >= ids.size())
+    {
+        invalidate();
+        return;
+    }
+
+    const int count = end - start + 1;
+    ids.remove(start, count);
+    groupImageIds.remove(start, count);
+    keys.remove(start, count);
+}
+
+void ImageSortKeyTable::refreshRow(ImageModel* const model, const ImageSortSettings& sorter, int row)
+{
+    if (!valid || row >= ids.size())
+    {
+        return;
+    }
+
+    const ImageInfo& info = model->imageInfoRef(row);
+    ids[row]              = info.id();
+    groupImageIds[row]    = info.groupImageId();
+    keys[row]             = sorter.sortKey(info);
+}
+
 } // namespace Digikam
@@ -32,10 +32,12 @@
 #include <QSet>
 #include <QThread>
 #include <QTimer>
+#include <QVector>
 #include <QWaitCondition>
 
 // Local includes
 
+#include "coredbfields.h"
 #include "imageinfo.h"
 #include "imagefiltermodel.h"
 
@@ -73,6 +75,45 @@ public:
 
 // ------------------------------------------------------------------------------------------------
 
+/**
+ * The sort keys of the rows of an ImageModel, in plain arrays indexed by row: the id, the group
+ * image id and the number compared by the sort role. Comparing two rows reads the arrays instead
+ * of the ImageInfo data under the cache lock.
+ *
+ * The table is built on first use, and extended with the rows appended to the model.
+ * Removed rows are removed, changed items are refreshed, anything else invalidates it.
+ *
+ * The filterer does not use this table: it runs in its own thread on packages of infos, and
+ * reads their filter keys once per package instead, see ImageFilterSettings::filterKeys().
+ * Sorting stays a sequential QSortFilterProxyModel sort over these keys.
+ */
+class ImageSortKeyTable
+{
+public:
+
+    ImageSortKeyTable()
+        : valid(false)
+    {
+    }
+
+    void invalidate();
+
+    /// Builds the table if invalid, or computes the keys of the rows appended to the model since
+    void update(ImageModel* const model, const ImageSortSettings& sorter);
+
+    void removeRows(int start, int end);
+    void refreshRow(ImageModel* const model, const ImageSortSettings& sorter, int row);
+
+public:
+
+    QVector<qlonglong> ids;
+    QVector<qlonglong> groupImageIds;
+    QVector<double>    keys;
+    bool               valid;
+};
+
+// ------------------------------------------------------------------------------------------------
+
 class ImageFilterModelPreparer;
 class ImageFilterModelFilterer;
 
@@ -114,6 +155,9 @@ public:
     bool                                needPrepareTags;
     bool                                needPrepareGroups;
 
+    // The fields used by the filter and the sort settings, loaded in bulk when preparing
+    DatabaseFields::Set                 prepareFields;
+
     QMutex                              mutex;
     ImageFilterSettings                 filterCopy;
     VersionImageFilterSettings          versionFilterCopy;
@@ -127,6 +171,9 @@ public:
 
     QList<ImageFilterModelPrepareHook*> prepareHooks;
 
+    // Used and updated by the sorting in the const subSortLessThan()
+    mutable ImageSortKeyTable           sortKeys;
+
 /*
     QHash<int, QSet<qlonglong> >        categoryCountHashInt;
     QHash<QString, QSet<qlonglong> >    categoryCountHashString;
@@ -146,6 +193,10 @@ public Q_SLOTS:
     void packageFinished(const ImageFilterModelTodoPackage& package);
     void packageDiscarded(const ImageFilterModelTodoPackage& package);
 
+    void sourceRowsInserted(const QModelIndex& parent, int start, int end);
+    void sourceRowsRemoved(const QModelIndex& parent, int start, int end);
+    void sourceLayoutChanged();
+
 Q_SIGNALS:
 
     void packageToPrepare(const ImageFilterModelTodoPackage& package);
@@ -313,11 +313,39 @@ bool ImageFilterSettings::matches(const ImageInfo& info, bool* const foundText)
         return true;
     }
 
+    return matches(info, filterKeys(info), foundText);
+}
+
+ImageFilterKeys ImageFilterSettings::filterKeys(const ImageInfo& info) const
+{
+    ImageFilterKeys keys;
+
+    if (isFilteringByTags() || isFilteringByPickLabels() || isFilteringByColorLabels() ||
+        (isFilteringByText() && (m_textFilterSettings.textFields & SearchTextFilterSettings::TagName)))
+    {
+        keys.tagIds = info.tagIds();
+    }
+
+    if (m_ratingFilter >= 0)
+    {
+        keys.rating = info.rating();
+    }
+
+    if (isFilteringByText() && (m_textFilterSettings.textFields & SearchTextFilterSettings::AlbumName))
+    {
+        keys.albumId = info.albumId();
+    }
+
+    return keys;
+}
+
+bool ImageFilterSettings::matchesKeys(const ImageFilterKeys& keys) const
+{
     bool match = false;
 
     if (!m_includeTagFilter.isEmpty() || !m_excludeTagFilter.isEmpty())
     {
-        QList<int>                 tagIds = info.tagIds();
+        const QList<int>&          tagIds = keys.tagIds;
         QList<int>::const_iterator it;
 
         match = m_includeTagFilter.isEmpty();
@@ -366,7 +394,7 @@ bool ImageFilterSettings::matches(const ImageInfo& info, bool* const foundText)
     }
     else if (m_untaggedFilter)
     {
-        match = !TagsCache::instance()->containsPublicTags(info.tagIds());
+        match = !TagsCache::instance()->containsPublicTags(keys.tagIds);
     }
     else
     {
@@ -377,8 +405,8 @@ bool ImageFilterSettings::matches(const ImageInfo& info, bool* const foundText)
 
     if (!m_pickLabelTagFilter.isEmpty())
     {
-        QList<int> tagIds = info.tagIds();
-        bool matchPL      = false;
+        const QList<int>& tagIds = keys.tagIds;
+        bool matchPL             = false;
 
         if (containsAnyOf(m_pickLabelTagFilter, tagIds))
         {
@@ -403,8 +431,8 @@ bool ImageFilterSettings::matches(const ImageInfo& info, bool* const foundText)
 
     if (!m_colorLabelTagFilter.isEmpty())
     {
-        QList<int> tagIds = info.tagIds();
-        bool matchCL      = false;
+        const QList<int>& tagIds = keys.tagIds;
+        bool matchCL             = false;
 
         if (containsAnyOf(m_colorLabelTagFilter, tagIds))
         {
@@ -425,19 +453,12 @@ bool ImageFilterSettings::matches(const ImageInfo& info, bool* const foundText)
         match &= matchCL;
     }
 
-    //-- Filter by date -----------------------------------------------------------
-
-    if (!m_dayFilter.isEmpty())
-    {
-        match &= m_dayFilter.contains(QDateTime(info.dateTime().date(), QTime()));
-    }
-
     //-- Filter by rating ---------------------------------------------------------
 
     if (m_ratingFilter >= 0)
     {
         // for now we treat -1 (no rating) just like a rating of 0.
-        int rating = info.rating();
+        int rating = keys.rating;
 
         if (rating == -1)
         {
@@ -477,6 +498,37 @@ bool ImageFilterSettings::matches(const ImageInfo& info, bool* const foundText)
         }
     }
 
+    return match;
+}
+
+bool ImageFilterSettings::matches(const ImageInfo& info, const ImageFilterKeys& keys, bool* const foundText) const
+{
+    if (foundText)
+    {
+        *foundText = false;
+    }
+
+    if (!isFilteringInternally())
+    {
+        return true;
+    }
+
+    bool match = matchesKeys(keys);
+
+    // The criteria below can only reject the info, except the text search which is also reported.
+
+    if (!match && (!foundText || !isFilteringByText()))
+    {
+        return false;
+    }
+
+    //-- Filter by date -----------------------------------------------------------
+
+    if (!m_dayFilter.isEmpty())
+    {
+        match &= m_dayFilter.contains(QDateTime(info.dateTime().date(), QTime()));
+    }
+
     // -- Filter by mime type -----------------------------------------------------
 
     switch (m_mimeTypeFilter)
@@ -632,7 +684,7 @@ bool ImageFilterSettings::matches(const ImageInfo& info, bool* const foundText)
         }
 
         // Tag names
-        foreach(int id, info.tagIds())
+        foreach(int id, keys.tagIds)
         {
             if (m_textFilterSettings.textFields & SearchTextFilterSettings::TagName &&
                 m_tagNameHash.value(id).contains(m_textFilterSettings.text, m_textFilterSettings.caseSensitive))
@@ -643,7 +695,7 @@ bool ImageFilterSettings::matches(const ImageInfo& info, bool* const foundText)
 
         // Album names
         if (m_textFilterSettings.textFields & SearchTextFilterSettings::AlbumName &&
-            m_albumNameHash.value(info.albumId()).contains(m_textFilterSettings.text, m_textFilterSettings.caseSensitive))
+            m_albumNameHash.value(keys.albumId).contains(m_textFilterSettings.text, m_textFilterSettings.caseSensitive))
         {
             textMatch = true;
         }
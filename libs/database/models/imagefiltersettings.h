@@ -93,6 +93,28 @@ public:
 
 // ---------------------------------------------------------------------------------------
 
+/**
+ * The values of an image read by the tag, label, rating and album name criteria of
+ * ImageFilterSettings. Only the values used by the current criteria are filled in,
+ * see ImageFilterSettings::filterKeys().
+ */
+class DIGIKAM_DATABASE_EXPORT ImageFilterKeys
+{
+public:
+
+    ImageFilterKeys()
+        : albumId(-1),
+          rating(-1)
+    {
+    }
+
+    int        albumId;
+    int        rating;
+    QList<int> tagIds;
+};
+
+// ---------------------------------------------------------------------------------------
+
 class DIGIKAM_DATABASE_EXPORT ImageFilterSettings
 {
 public:
@@ -105,6 +127,15 @@ public:
      */
     bool matches(const ImageInfo& info, bool* const foundText = 0) const;
 
+    /**
+     *  Same as above, with the keys of the info read before by filterKeys().
+     *  An info rejected by its keys is not read any further, unless foundText is needed.
+     */
+    bool matches(const ImageInfo& info, const ImageFilterKeys& keys, bool* const foundText = 0) const;
+
+    /// Reads the keys of the given ImageInfo used by the current criteria
+    ImageFilterKeys filterKeys(const ImageInfo& info) const;
+
 public:
 
     /// --- Tags filter ---
@@ -222,6 +253,9 @@ private:
      */
     bool isFilteringInternally() const;
 
+    /// Returns true if the keys match the tag, label and rating criteria
+    bool matchesKeys(const ImageFilterKeys& keys) const;
+
 private:
 
     /// --- Tags filter ---
@@ -24,6 +24,10 @@
 
 #include "imagesortsettings.h"
 
+// C++ includes
+
+#include <limits>
+
 // Qt includes
 
 #include <QDateTime>
@@ -254,44 +258,76 @@ int ImageSortSettings::compare(const ImageInfo& left, const ImageInfo& right, So
         case SortByFilePath:
             return naturalCompare(left.filePath(), right.filePath(), currentSortOrder, sortCaseSensitivity, strTypeNatural);
         case SortByFileSize:
-            return compareByOrder(left.fileSize(), right.fileSize(), currentSortOrder);
         case SortByModificationDate:
-            return compareByOrder(left.modDateTime(), right.modDateTime(), currentSortOrder);
         case SortByCreationDate:
-            return compareByOrder(left.dateTime(), right.dateTime(), currentSortOrder);
+        case SortByRating:
+        case SortByImageSize:
+        case SortByAspectRatio:
+        case SortBySimilarity:
+            // Compared by the same keys as the sort key table of ImageFilterModel
+            return compareByOrder(sortKey(left, role), sortKey(right, role), currentSortOrder);
+        default:
+            return 1;
+    }
+}
+
+bool ImageSortSettings::hasSortKey() const
+{
+    return (sortRole != SortByFileName && sortRole != SortByFilePath);
+}
+
+double ImageSortSettings::sortKey(const ImageInfo& info) const
+{
+    return sortKey(info, sortRole);
+}
+
+double ImageSortSettings::sortKey(const ImageInfo& info, SortRole role) const
+{
+    // The keys are exact in a double: dates in milliseconds and file sizes are less than 2^53.
+    // Dates are compared in UTC, invalid dates before all others.
+
+    switch (role)
+    {
+        case SortByFileSize:
+            return info.fileSize();
+        case SortByModificationDate:
+        {
+            QDateTime date = info.modDateTime();
+            return date.isValid() ? date.toMSecsSinceEpoch() : -std::numeric_limits<double>::max();
+        }
+        case SortByCreationDate:
+        {
+            QDateTime date = info.dateTime();
+            return date.isValid() ? date.toMSecsSinceEpoch() : -std::numeric_limits<double>::max();
+        }
         case SortByRating:
             // I have the feeling that inverting the sort order for rating is the natural order
-            return - compareByOrder(left.rating(), right.rating(), currentSortOrder);
+            return - info.rating();
         case SortByImageSize:
         {
-            QSize leftSize  = left.dimensions();
-            QSize rightSize = right.dimensions();
-            int leftPixels  = leftSize.width() * leftSize.height();
-            int rightPixels = rightSize.width() * rightSize.height();
-            return compareByOrder(leftPixels, rightPixels, currentSortOrder);
+            QSize size = info.dimensions();
+            int pixels = size.width() * size.height();
+            return pixels;
         }
         case SortByAspectRatio:
         {
-            QSize leftSize = left.dimensions();
-            QSize rightSize = right.dimensions();
-            int leftAR = (double(leftSize.width()) / double(leftSize.height())) * 1000000;
-            int rightAR = (double(rightSize.width()) / double(rightSize.height())) * 1000000;
-            return compareByOrder(leftAR, rightAR, currentSortOrder);
+            QSize size = info.dimensions();
+            int ar     = (double(size.width()) / double(size.height())) * 1000000;
+            return ar;
         }
         case SortBySimilarity:
-        {
-            qlonglong leftReferenceImageId  = left.currentReferenceImage();
-            qlonglong rightReferenceImageId = right.currentReferenceImage();
             // make sure that the original image has always the highest similarity.
-            double leftSimilarity  = left.id() == leftReferenceImageId ? 1.1 : left.currentSimilarity();
-            double rightSimilarity = right.id() == rightReferenceImageId ? 1.1 : right.currentSimilarity();
-            return compareByOrder(leftSimilarity, rightSimilarity, currentSortOrder);
-        }
+            return info.id() == info.currentReferenceImage() ? 1.1 : info.currentSimilarity();
         default:
-            return 1;
+            return 0;
     }
 }
 
+int ImageSortSettings::compareSortKeys(double left, double right) const
+{
+    return compareByOrder(left, right, currentSortOrder);
+}
+
 bool ImageSortSettings::lessThan(const QVariant& left, const QVariant& right) const
 {
     if (left.type() != right.type())
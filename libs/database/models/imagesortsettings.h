@@ -137,6 +137,18 @@ public:
 
     int compare(const ImageInfo& left, const ImageInfo& right, SortRole sortRole) const;
 
+    /** Returns true if the sort role compares a number of each item, as returned by sortKey(),
+     *  and false if it compares the names or paths.
+     */
+    bool hasSortKey() const;
+
+    /** Returns the number compared for the sort role, or the given role. compare() compares
+     *  these keys, so compareSortKeys() on the keys of two items returns the same as compare().
+     */
+    double sortKey(const ImageInfo& info) const;
+    double sortKey(const ImageInfo& info, SortRole role) const;
+    int    compareSortKeys(double left, double right) const;
+
     // --- ---
 
     static Qt::SortOrder defaultSortOrderForCategorizationMode(CategorizationMode mode);
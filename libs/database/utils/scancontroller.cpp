@@ -700,6 +700,7 @@ void ScanController::run()
 
             scanner.setNeedFileCount(d->needTotalFiles);
             scanner.setDeferredFileScanning(doScanDeferred);
+            scanner.setParallelScanning(true);
             scanner.setHintContainer(d->hints);
 
             SimpleCollectionScannerObserver observer(&d->continueScan);
@@ -728,6 +729,7 @@ void ScanController::run()
             emit collectionScanStarted(i18nc("@info:status", "Scanning collection"));
             //TODO: reconsider performance
             scanner.setNeedFileCount(true);//d->needTotalFiles);
+            scanner.setParallelScanning(true);
 
             scanner.setHintContainer(d->hints);
 
@@ -55,6 +55,7 @@ extern "C"
 #include <QPainter>
 #include <QPixmap>
 #include <QSysInfo>
+#include <QThreadStorage>
 #include <QUuid>
 
 // Local includes
@@ -89,6 +90,9 @@ typedef int64_t  llong;
 namespace Digikam
 {
 
+/// The thread budget of the DImg operations called from each thread, see DImg::setProcessingThreads()
+static QThreadStorage<int> processingThreadsStorage;
+
 DImg::DImg()
     : m_priv(new Private)
 {
@@ -226,7 +230,7 @@ void DImg::putImageData(uint width, uint height, bool sixteenBit, bool alpha, uc
     setImageData(true, width, height, sixteenBit, alpha);
 
     // replace data
-    delete [] m_priv->data;
+    Private::releaseData(m_priv->data);
 
     if (null)
     {
@@ -260,7 +264,7 @@ void DImg::putImageData(uchar* const data, bool copyData)
 {
     if (!data)
     {
-        delete [] m_priv->data;
+        Private::releaseData(m_priv->data);
         m_priv->data = 0;
         m_priv->null = true;
     }
@@ -283,7 +287,10 @@ void DImg::resetMetaData()
 
 uchar* DImg::stripImageData()
 {
-    uchar* const data  = m_priv->data;
+    // the new owner frees the data with delete[]
+    DImgBufferPool* const pool = DImgBufferPool::instance();
+    uchar* const data          = pool ? pool->detach(m_priv->data) : m_priv->data;
+
     m_priv->data       = 0;
     m_priv->null       = true;
     return data;
@@ -306,8 +313,8 @@ void DImg::copyImageData(const Private* const src)
 
 size_t DImg::allocateData()
 {
-    size_t size  = m_priv->width * m_priv->height * (m_priv->sixteenBit ? 8 : 4);
-    m_priv->data = DImgLoader::new_failureTolerant(size);
+    size_t size  = (size_t)m_priv->width * m_priv->height * (m_priv->sixteenBit ? 8 : 4);
+    m_priv->data = Private::allocateData(size);
 
     if (!m_priv->data)
     {
@@ -571,6 +578,16 @@ bool DImg::load(const QString& filePath, int loadFlagsInt, DImgLoaderObserver* c
     return false;
 }
 
+void DImg::setProcessingThreads(int threads)
+{
+    processingThreadsStorage.setLocalData(threads);
+}
+
+int DImg::processingThreads()
+{
+    return processingThreadsStorage.hasLocalData() ? processingThreadsStorage.localData() : 0;
+}
+
 QString DImg::formatToMimeType(FORMAT frm)
 {
     QString format;
@@ -903,7 +920,7 @@ uchar* DImg::scanLine(uint i) const
         return 0;
     }
 
-    uchar* const data = bits() + (width() * bytesDepth() * i);
+    uchar* const data = bits() + ((size_t)width() * bytesDepth() * i);
     return data;
 }
 
@@ -1008,9 +1025,31 @@ void DImg::setMetadata(const MetaEngineData& data)
     m_priv->metaData = data;
 }
 
-uint DImg::numBytes() const
+quint64 DImg::numBytes() const
+{
+    return ((quint64)width() * height() * bytesDepth());
+}
+
+bool DImg::isOutOfCore() const
 {
-    return (width() * height() * bytesDepth());
+    DImgBufferPool* const pool = DImgBufferPool::instance();
+
+    return (pool && m_priv->data && pool->isMapped(m_priv->data));
+}
+
+void DImg::releaseRows(uint y, uint rows) const
+{
+    DImgBufferPool* const pool = DImgBufferPool::instance();
+
+    if (!pool || !m_priv->data || y >= height())
+    {
+        return;
+    }
+
+    const size_t bytesPerLine = (size_t)width() * bytesDepth();
+    const uint   end          = qMin(y + rows, height());
+
+    pool->releasePages(m_priv->data, y * bytesPerLine, end * bytesPerLine);
 }
 
 uint DImg::numPixels() const
@@ -2219,16 +2258,19 @@ void DImg::crop(int x, int y, int w, int h)
         return;
     }
 
-    uint  oldw = width();
-    uint  oldh = height();
-    QScopedArrayPointer<uchar> old(stripImageData());
+    uint  oldw       = width();
+    uint  oldh       = height();
+    uchar* const old = m_priv->data;
+    m_priv->data     = 0;
 
     // set new image data, bits(), width(), height() change
     setImageDimension(w, h);
     allocateData();
 
     // copy image region (x|y), wxh, from old data to point (0|0) of new data
-    bitBlt(old.data(), bits(), x, y, w, h, 0, 0, oldw, oldh, width(), height(), sixteenBit(), bytesDepth(), bytesDepth());
+    bitBlt(old, bits(), x, y, w, h, 0, 0, oldw, oldh, width(), height(), sixteenBit(), bytesDepth(), bytesDepth());
+
+    Private::releaseData(old);
 }
 
 void DImg::resize(int w, int h)
@@ -2240,8 +2282,11 @@ void DImg::resize(int w, int h)
 
     DImg image = smoothScale(w, h);
 
-    delete [] m_priv->data;
-    m_priv->data = image.stripImageData();
+    // take over the buffer of the scaled image, which stays in the pool
+    Private::releaseData(m_priv->data);
+    m_priv->data       = image.m_priv->data;
+    image.m_priv->data = 0;
+    image.m_priv->null = true;
     setImageDimension(w, h);
 }
 
@@ -2280,7 +2325,7 @@ void DImg::rotate(ANGLE angle)
 
             if (sixteenBit())
             {
-                ullong* newData = DImgLoader::new_failureTolerant<ullong>(w * h);
+                ullong* newData = reinterpret_cast<ullong*>(Private::allocateData(w * h * sizeof(ullong)));
                 ullong* from    = reinterpret_cast<ullong*>(m_priv->data);
                 ullong* to      = 0;
 
@@ -2297,12 +2342,12 @@ void DImg::rotate(ANGLE angle)
 
                 switchDims = true;
 
-                delete [] m_priv->data;
+                Private::releaseData(m_priv->data);
                 m_priv->data = (uchar*)newData;
             }
             else
             {
-                uint* newData = DImgLoader::new_failureTolerant<uint>(w * h);
+                uint* newData = reinterpret_cast<uint*>(Private::allocateData(w * h * sizeof(uint)));
                 uint* from    = reinterpret_cast<uint*>(m_priv->data);
                 uint* to      = 0;
 
@@ -2319,7 +2364,7 @@ void DImg::rotate(ANGLE angle)
 
                 switchDims = true;
 
-                delete [] m_priv->data;
+                Private::releaseData(m_priv->data);
                 m_priv->data = (uchar*)newData;
             }
 
@@ -2410,7 +2455,7 @@ void DImg::rotate(ANGLE angle)
 
             if (sixteenBit())
             {
-                ullong* newData = DImgLoader::new_failureTolerant<ullong>(w * h);
+                ullong* newData = reinterpret_cast<ullong*>(Private::allocateData(w * h * sizeof(ullong)));
                 ullong* from    = reinterpret_cast<ullong*>(m_priv->data);
                 ullong* to      = 0;
 
@@ -2427,12 +2472,12 @@ void DImg::rotate(ANGLE angle)
 
                 switchDims = true;
 
-                delete [] m_priv->data;
+                Private::releaseData(m_priv->data);
                 m_priv->data = (uchar*)newData;
             }
             else
             {
-                uint* newData = DImgLoader::new_failureTolerant<uint>(w * h);
+                uint* newData = reinterpret_cast<uint*>(Private::allocateData(w * h * sizeof(uint)));
                 uint* from    = reinterpret_cast<uint*>(m_priv->data);
                 uint* to      = 0;
 
@@ -2449,7 +2494,7 @@ void DImg::rotate(ANGLE angle)
 
                 switchDims = true;
 
-                delete [] m_priv->data;
+                Private::releaseData(m_priv->data);
                 m_priv->data = (uchar*)newData;
             }
 
@@ -2784,7 +2829,7 @@ void DImg::convertDepth(int depth)
     {
         // downgrading from 16 bit to 8 bit
 
-        uchar*  data = new uchar[width()*height() * 4];
+        uchar*  data = Private::allocateData(width()*height() * 4);
         uchar*  dptr = data;
         ushort* sptr = reinterpret_cast<ushort*>(bits());
         uint dim     = width() * height() * 4;
@@ -2794,7 +2839,7 @@ void DImg::convertDepth(int depth)
             *dptr++ = (*sptr++ * 256UL) / 65536UL;
         }
 
-        delete [] m_priv->data;
+        Private::releaseData(m_priv->data);
         m_priv->data = data;
         m_priv->sixteenBit = false;
     }
@@ -2802,7 +2847,7 @@ void DImg::convertDepth(int depth)
     {
         // upgrading from 8 bit to 16 bit
 
-        uchar*  data = new uchar[width()*height() * 8];
+        uchar*  data = Private::allocateData(width()*height() * 8);
         ushort* dptr = reinterpret_cast<ushort*>(data);
         uchar*  sptr = bits();
 
@@ -2826,7 +2871,7 @@ void DImg::convertDepth(int depth)
             *dptr++ = (*sptr++ * 65536ULL) / 256ULL + noise;
         }
 
-        delete [] m_priv->data;
+        Private::releaseData(m_priv->data);
         m_priv->data       = data;
         m_priv->sixteenBit = true;
     }
@@ -2938,6 +2983,27 @@ QByteArray DImg::getUniqueHashV2(const QString& filePath)
     return DImgLoader::uniqueHashV2(filePath);
 }
 
+QByteArray DImg::getUniqueHashFromData(const QByteArray& fileHead, qint64 fileSize) const
+{
+    if (m_priv->attributes.contains(QLatin1String("uniqueHash")))
+    {
+        return m_priv->attributes[QLatin1String("uniqueHash")].toByteArray();
+    }
+
+    // attribute is written by DImgLoader
+    return DImgLoader::uniqueHash(fileHead, fileSize, *this);
+}
+
+QByteArray DImg::getUniqueHashV2FromData(const QByteArray& fileHead, const QByteArray& fileTail) const
+{
+    if (m_priv->attributes.contains(QLatin1String("uniqueHashV2")))
+    {
+        return m_priv->attributes[QLatin1String("uniqueHashV2")].toByteArray();
+    }
+
+    return DImgLoader::uniqueHashV2(fileHead, fileTail, this);
+}
+
 QByteArray DImg::createImageUniqueId() const
 {
     NonDeterministicRandomData randomData(16);
@@ -112,6 +112,15 @@ public:
 
     static QString formatToMimeType(FORMAT frm);
 
+    /** The smooth scale methods, IccTransform::apply() and ImageHistogram split large images
+     *  in bands of rows, processed in parallel. This sets the maximum number of threads used by
+     *  these operations when called from the current thread: 0, the default, uses the threads
+     *  of the global thread pool, and 1 processes in the calling thread.
+     *  Code already running in parallel, as the thumbnail and batch queue threads, sets 1.
+     */
+    static void setProcessingThreads(int threads);
+    static int  processingThreads();
+
 public:
 
     class Private;
@@ -197,6 +206,7 @@ public:
 
     /** Returns the data of this image.
         Ownership of the buffer is passed to the caller, this image will be null afterwards.
+        The data of an out-of-core image is copied to memory first.
      */
     uchar*      stripImageData();
 
@@ -237,7 +247,7 @@ public:
     uchar*      scanLine(uint i) const;
     bool        hasAlpha()       const;
     bool        sixteenBit()     const;
-    uint        numBytes()       const;
+    quint64     numBytes()       const;
     uint        numPixels()      const;
 
     /** Return the number of bytes depth of one pixel : 4 (non sixteenBit) or 8 (sixteen)
@@ -248,6 +258,18 @@ public:
      */
     int         bitsDepth()  const;
 
+    /** Returns true if the image data is mapped from a scratch file instead of held in memory,
+     *  as for images larger than the out-of-core threshold of DImgBufferPool. The data is
+     *  accessed as usual with bits() and scanLine(), only the pages in use are resident.
+     */
+    bool        isOutOfCore() const;
+
+    /** Hint that the rows from y to y + rows - 1 will not be used soon, for code working
+     *  on an image by bands of rows. The rows of an out-of-core image leave memory, and are
+     *  read again from the scratch file when accessed. Does nothing for other images.
+     */
+    void        releaseRows(uint y, uint rows) const;
+
     /** Returns the file path from which this DImg was originally loaded.
      *  Returns a null string if the DImg was not loaded from a file.
      */
@@ -636,6 +658,14 @@ public:
     QByteArray getUniqueHashV2() const;
     static QByteArray getUniqueHashV2(const QString& filePath);
 
+    /** Same as getUniqueHash() and getUniqueHashV2(), but computed from the parts of the file
+        already read in memory, instead of reading the file again: fileHead starts at the beginning
+        of the file, fileTail holds its last 100 kB, or the whole file if smaller.
+        The hash is kept in the object. getUniqueHashFromData() requires the metadata to be set.
+     */
+    QByteArray getUniqueHashFromData(const QByteArray& fileHead, qint64 fileSize) const;
+    QByteArray getUniqueHashV2FromData(const QByteArray& fileHead, const QByteArray& fileTail) const;
+
     /** This method creates a new 256-bit UUID meant to be globally unique.
      *  The UUID will be returned as a 64-byte hexadecimal string.
      *  At least 128bits of the UUID will be created by the platform random number
@@ -25,6 +25,10 @@
 #ifndef DIMGPRIVATE_H
 #define DIMGPRIVATE_H
 
+// C++ includes
+
+#include <new>
+
 // Qt includes
 
 #include <QString>
@@ -39,6 +43,7 @@
 #include "dshareddata.h"
 #include "dimagehistory.h"
 #include "iccprofile.h"
+#include "dimgbufferpool.h"
 
 /** Lanczos kernel is precomputed in a table with this resolution
     The value below seems to be enough for HQ upscaling up to eight times
@@ -84,10 +89,29 @@ public:
 
     ~Private()
     {
-        delete [] data;
+        releaseData(data);
         delete [] lanczos_func;
     }
 
+    /// Pixel buffers come from the DImgBufferPool, and may outlive it at application exit
+    static uchar* allocateData(size_t size)
+    {
+        DImgBufferPool* const pool = DImgBufferPool::instance();
+
+        return pool ? pool->allocate(size) : new (std::nothrow) uchar[size];
+    }
+
+    static void releaseData(uchar* const data)
+    {
+        DImgBufferPool* const pool = DImgBufferPool::instance();
+
+        // Once the pool is gone, the buffer may be an unmapped out-of-core one: leave it to the system.
+        if (pool)
+        {
+            pool->release(data);
+        }
+    }
+
     static QStringList fileOriginAttributes()
     {
         QStringList list;
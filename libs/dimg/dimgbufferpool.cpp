@@ -0,0 +1,570 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-03-30
+ * Description : pool of recycled DImg pixel buffers
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "dimgbufferpool.h"
+
+// C ANSI includes
+
+#include <string.h>
+
+#ifdef Q_OS_UNIX
+#   include <sys/mman.h>
+#   include <unistd.h>
+#endif
+
+#if defined(Q_OS_LINUX) || defined(Q_OS_FREEBSD)
+#   include <fcntl.h>
+#endif
+
+// Qt includes
+
+#include <QDir>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QStandardPaths>
+#include <QStorageInfo>
+#include <QTemporaryFile>
+
+// Local includes
+
+#include "dimgloader.h"
+#include "kmemoryinfo.h"
+#include "digikam_debug.h"
+
+namespace Digikam
+{
+
+DImgBufferPoolStatistics::DImgBufferPoolStatistics()
+    : allocations(0),
+      reuses(0),
+      releases(0),
+      evictions(0),
+      cachedBytes(0),
+      maximumBytes(0),
+      cachedBuffers(0),
+      usedBuffers(0),
+      mappedBytes(0),
+      mappedBuffers(0)
+{
+}
+
+double DImgBufferPoolStatistics::reuseRatio() const
+{
+    if (allocations == 0)
+    {
+        return 0.0;
+    }
+
+    return double(reuses) / double(allocations);
+}
+
+// --------------------------------------------------------------------------------------------------------------
+
+class DImgBufferPool::Private
+{
+public:
+
+    /// Below this size, the system allocator is fast and the waste of a size class not worth it
+    enum
+    {
+        MinimumPooledSize = 512 * 1024
+    };
+
+    class Buffer
+    {
+    public:
+
+        Buffer(uchar* const data = 0, size_t size = 0)
+            : data(data),
+              size(size)
+        {
+        }
+
+        uchar* data;
+        size_t size;
+    };
+
+    class MappedBuffer
+    {
+    public:
+
+        MappedBuffer(QTemporaryFile* const file = 0, size_t size = 0)
+            : file(file),
+              size(size)
+        {
+        }
+
+        QTemporaryFile* file;
+        size_t          size;
+    };
+
+public:
+
+    Private()
+        : maximumBytes(0),
+          cachedBytes(0),
+          outOfCoreThreshold(0)
+    {
+        // Not the temporary directory: it is often a tmpfs, in memory or swap, which defeats the purpose.
+        scratchPath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+
+        if (scratchPath.isEmpty())
+        {
+            scratchPath = QDir::tempPath();
+        }
+    }
+
+    /// Rounds the size up to the next quarter step between two powers of two
+    static size_t sizeClass(size_t size)
+    {
+        size_t power = 1;
+
+        while (power <= size / 2)
+        {
+            power *= 2;
+        }
+
+        const size_t step = power / 4;
+
+        return ((size + step - 1) / step) * step;
+    }
+
+    /// Frees the oldest cached buffers until the cache respects the maximum. Called with the mutex locked.
+    void evict(qint64 maximum)
+    {
+        while (cachedBytes > maximum && !cached.isEmpty())
+        {
+            const Buffer buffer = cached.takeFirst();
+            cachedBytes        -= buffer.size;
+            ++stats.evictions;
+            delete [] buffer.data;
+        }
+    }
+
+    /**
+     * Grows the empty file to size bytes with its blocks allocated on disk: writing to a hole
+     * of a sparse file through the mapping would crash the application if the disk is full.
+     */
+    static bool reserveFile(QFile& file, qint64 size)
+    {
+#if defined(Q_OS_LINUX) || defined(Q_OS_FREEBSD)
+
+        return (posix_fallocate(file.handle(), 0, size) == 0);
+
+#else
+
+        static const char zeros[65536] = { 0 };
+
+        for (qint64 left = size ; left > 0 ; )
+        {
+            const qint64 written = file.write(zeros, qMin(left, (qint64)sizeof(zeros)));
+
+            if (written <= 0)
+            {
+                return false;
+            }
+
+            left -= written;
+        }
+
+        return file.flush();
+
+#endif
+    }
+
+    /// Maps a buffer from a new scratch file, or returns 0
+    uchar* allocateMapped(size_t size)
+    {
+        const QString path = scratchPath;
+
+        // Fails early, before reserving the blocks of a file which cannot fit.
+        QStorageInfo storage(path);
+
+        if (storage.isValid() && storage.bytesAvailable() < (qint64)size)
+        {
+            qCWarning(DIGIKAM_DIMG_LOG) << "Not enough disk space in" << path
+                                        << "for an out-of-core image of size" << size;
+            return 0;
+        }
+
+        QDir().mkpath(path);
+
+        QTemporaryFile* const file = new QTemporaryFile(path + QLatin1String("/digikam-dimg-XXXXXX.scratch"));
+        uchar* data                = 0;
+
+        if (file->open())
+        {
+            if (reserveFile(*file, size))
+            {
+                data = file->map(0, size);
+            }
+            else
+            {
+                qCWarning(DIGIKAM_DIMG_LOG) << "Cannot reserve" << size << "bytes of disk space in" << path
+                                            << "for an out-of-core image";
+            }
+        }
+
+        if (!data)
+        {
+            qCWarning(DIGIKAM_DIMG_LOG) << "Cannot map an out-of-core image of size" << size
+                                        << "from" << file->fileName() << file->errorString();
+            delete file;
+            return 0;
+        }
+
+        qCDebug(DIGIKAM_DIMG_LOG) << "Out-of-core image of size" << size << "mapped from" << file->fileName();
+
+        QMutexLocker lock(&mutex);
+        mapped.insert(data, MappedBuffer(file, size));
+
+        return data;
+    }
+
+    /// Unmaps the buffer and removes its scratch file
+    static void freeMapped(uchar* const data, const MappedBuffer& buffer)
+    {
+        buffer.file->unmap(data);
+        delete buffer.file;
+    }
+
+public:
+
+    mutable QMutex              mutex;
+
+    /// Buffers owned by images, with their size class
+    QHash<uchar*, size_t>       used;
+
+    /// Buffers waiting to be reused, the most recently released last
+    QList<Buffer>               cached;
+
+    /// Out-of-core buffers, with their scratch file
+    QHash<uchar*, MappedBuffer> mapped;
+
+    qint64                      maximumBytes;
+    qint64                      cachedBytes;
+    qint64                      outOfCoreThreshold;   // set at construction, read without the mutex
+    QString                     scratchPath;          // set at construction, read without the mutex
+
+    DImgBufferPoolStatistics    stats;
+};
+
+// --------------------------------------------------------------------------------------------------------------
+
+class DImgBufferPoolCreator
+{
+public:
+
+    DImgBufferPool object;
+};
+
+Q_GLOBAL_STATIC(DImgBufferPoolCreator, creator)
+
+// --------------------------------------------------------------------------------------------------------------
+
+DImgBufferPool* DImgBufferPool::instance()
+{
+    if (creator.isDestroyed())
+    {
+        return 0;
+    }
+
+    return &creator->object;
+}
+
+DImgBufferPool::DImgBufferPool()
+    : d(new Private)
+{
+    KMemoryInfo memory = KMemoryInfo::currentInfo();
+    qint64 megabytes   = 64;
+    qint64 outOfCore   = 4096;
+
+    if (memory.isValid() == 1)
+    {
+        megabytes = qBound(64, int(memory.megabytes(KMemoryInfo::TotalRam) * 0.1), 1024);
+        outOfCore = qMax(1024, int(memory.megabytes(KMemoryInfo::TotalRam) * 0.5));
+    }
+
+    d->maximumBytes       = megabytes * 1024 * 1024;
+    d->outOfCoreThreshold = outOfCore * 1024 * 1024;
+}
+
+DImgBufferPool::~DImgBufferPool()
+{
+    clear();
+
+    // Buffers still owned by images are freed by them with delete[], once the pool is gone.
+    // Out-of-core buffers cannot: unmap them now.
+    for (QHash<uchar*, Private::MappedBuffer>::const_iterator it = d->mapped.constBegin() ;
+         it != d->mapped.constEnd() ; ++it)
+    {
+        Private::freeMapped(it.key(), it.value());
+    }
+
+    delete d;
+}
+
+uchar* DImgBufferPool::allocate(size_t size)
+{
+    if (size < (size_t)Private::MinimumPooledSize)
+    {
+        return DImgLoader::new_failureTolerant(size);
+    }
+
+    if ((qint64)size >= d->outOfCoreThreshold)
+    {
+        uchar* const data = d->allocateMapped(size);
+
+        if (data)
+        {
+            return data;
+        }
+
+        // fall back to memory
+    }
+
+    const size_t classSize = Private::sizeClass(size);
+
+    {
+        QMutexLocker lock(&d->mutex);
+        ++d->stats.allocations;
+
+        for (int i = d->cached.size() - 1 ; i >= 0 ; --i)
+        {
+            if (d->cached.at(i).size == classSize)
+            {
+                const Private::Buffer buffer = d->cached.takeAt(i);
+                d->cachedBytes              -= buffer.size;
+                d->used.insert(buffer.data, buffer.size);
+                ++d->stats.reuses;
+
+                return buffer.data;
+            }
+        }
+    }
+
+    uchar* data = DImgLoader::new_failureTolerant(classSize);
+
+    if (!data)
+    {
+        // The cached buffers may be what is missing
+        clear();
+        data = DImgLoader::new_failureTolerant(classSize);
+
+        if (!data)
+        {
+            return 0;
+        }
+    }
+
+    QMutexLocker lock(&d->mutex);
+    d->used.insert(data, classSize);
+
+    return data;
+}
+
+void DImgBufferPool::release(uchar* const data)
+{
+    if (!data)
+    {
+        return;
+    }
+
+    QMutexLocker lock(&d->mutex);
+    QHash<uchar*, size_t>::iterator it = d->used.find(data);
+
+    if (it == d->used.end())
+    {
+        QHash<uchar*, Private::MappedBuffer>::iterator mit = d->mapped.find(data);
+
+        if (mit != d->mapped.end())
+        {
+            const Private::MappedBuffer buffer = mit.value();
+            d->mapped.erase(mit);
+            lock.unlock();
+            Private::freeMapped(data, buffer);
+            return;
+        }
+
+        lock.unlock();
+        delete [] data;
+        return;
+    }
+
+    const size_t size = it.value();
+    d->used.erase(it);
+    ++d->stats.releases;
+
+    if ((qint64)size > d->maximumBytes)
+    {
+        lock.unlock();
+        delete [] data;
+        return;
+    }
+
+    d->cached << Private::Buffer(data, size);
+    d->cachedBytes += size;
+    d->evict(d->maximumBytes);
+}
+
+uchar* DImgBufferPool::detach(uchar* const data)
+{
+    if (!data)
+    {
+        return 0;
+    }
+
+    QMutexLocker lock(&d->mutex);
+
+    if (d->used.remove(data))
+    {
+        return data;
+    }
+
+    QHash<uchar*, Private::MappedBuffer>::iterator it = d->mapped.find(data);
+
+    if (it == d->mapped.end())
+    {
+        return data;
+    }
+
+    const Private::MappedBuffer buffer = it.value();
+    d->mapped.erase(it);
+    lock.unlock();
+
+    uchar* const copy = DImgLoader::new_failureTolerant(buffer.size);
+
+    if (copy)
+    {
+        memcpy(copy, data, buffer.size);
+    }
+
+    Private::freeMapped(data, buffer);
+
+    return copy;
+}
+
+bool DImgBufferPool::isMapped(const uchar* const data) const
+{
+    QMutexLocker lock(&d->mutex);
+
+    return d->mapped.contains(const_cast<uchar*>(data));
+}
+
+void DImgBufferPool::releasePages(uchar* const data, size_t begin, size_t end)
+{
+#ifdef Q_OS_UNIX
+    if (!data || begin >= end)
+    {
+        return;
+    }
+
+    {
+        QMutexLocker lock(&d->mutex);
+        QHash<uchar*, Private::MappedBuffer>::const_iterator it = d->mapped.constFind(data);
+
+        if (it == d->mapped.constEnd())
+        {
+            return;
+        }
+
+        end = qMin(end, it.value().size);
+    }
+
+    // Only whole pages in the range: the pages at both ends may hold bytes still in use.
+    const size_t page = sysconf(_SC_PAGESIZE);
+    begin             = ((begin + page - 1) / page) * page;
+    end               = (end / page) * page;
+
+    if (begin < end)
+    {
+        // The mapping is shared: dirty pages are written back to the scratch file, not lost.
+        madvise(data + begin, end - begin, MADV_DONTNEED);
+    }
+#else
+    Q_UNUSED(data);
+    Q_UNUSED(begin);
+    Q_UNUSED(end);
+#endif
+}
+
+void DImgBufferPool::setMaximumCachedBytes(qint64 bytes)
+{
+    QMutexLocker lock(&d->mutex);
+    d->maximumBytes = qMax(bytes, (qint64)0);
+    d->evict(d->maximumBytes);
+
+    qCDebug(DIGIKAM_DIMG_LOG) << "DImg buffer pool keeps up to" << d->maximumBytes << "bytes";
+}
+
+qint64 DImgBufferPool::maximumCachedBytes() const
+{
+    QMutexLocker lock(&d->mutex);
+    return d->maximumBytes;
+}
+
+qint64 DImgBufferPool::outOfCoreThreshold() const
+{
+    return d->outOfCoreThreshold;
+}
+
+QString DImgBufferPool::scratchPath() const
+{
+    return d->scratchPath;
+}
+
+void DImgBufferPool::clear()
+{
+    QMutexLocker lock(&d->mutex);
+    const qint64 evictions = d->stats.evictions;
+    d->evict(0);
+    d->stats.evictions     = evictions;
+}
+
+DImgBufferPoolStatistics DImgBufferPool::statistics() const
+{
+    QMutexLocker lock(&d->mutex);
+    DImgBufferPoolStatistics stats = d->stats;
+    stats.cachedBytes              = d->cachedBytes;
+    stats.maximumBytes             = d->maximumBytes;
+    stats.cachedBuffers            = d->cached.size();
+    stats.usedBuffers              = d->used.size();
+    stats.mappedBuffers            = d->mapped.size();
+
+    foreach (const Private::MappedBuffer& buffer, d->mapped)
+    {
+        stats.mappedBytes += buffer.size;
+    }
+
+    return stats;
+}
+
+void DImgBufferPool::resetStatistics()
+{
+    QMutexLocker lock(&d->mutex);
+    d->stats = DImgBufferPoolStatistics();
+}
+
+}  // namespace Digikam
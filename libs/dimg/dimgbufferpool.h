@@ -0,0 +1,182 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-03-30
+ * Description : pool of recycled DImg pixel buffers
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIMGBUFFERPOOL_H
+#define DIMGBUFFERPOOL_H
+
+// C ANSI includes
+
+#include <stddef.h>
+
+// Qt includes
+
+#include <QtGlobal>
+#include <QString>
+
+// Local includes
+
+#include "digikam_export.h"
+
+namespace Digikam
+{
+
+class DIGIKAM_EXPORT DImgBufferPoolStatistics
+{
+public:
+
+    DImgBufferPoolStatistics();
+
+    /// Returns the ratio of pooled allocations served by a recycled buffer, between 0 and 1
+    double reuseRatio() const;
+
+public:
+
+    qint64 allocations;     // allocations of pooled size, recycled or not
+    qint64 reuses;          // allocations served by a recycled buffer
+    qint64 releases;        // pooled buffers given back
+    qint64 evictions;       // recycled buffers freed to respect the maximum
+
+    qint64 cachedBytes;     // bytes of the buffers waiting to be reused
+    qint64 maximumBytes;
+    int    cachedBuffers;
+    int    usedBuffers;     // pooled buffers currently owned by images
+
+    qint64 mappedBytes;     // bytes of the out-of-core buffers
+    int    mappedBuffers;
+};
+
+// --------------------------------------------------------------------------------------------------------------
+
+/**
+ * The pixel buffers of DImg are taken from this pool, and given back to it when the image
+ * is freed. Batch processing and editor filters allocate one or more buffers of the same
+ * size for each image: the freed buffers are kept, up to a maximum amount of memory, and
+ * reused for the next image instead of going back to the system allocator.
+ *
+ * Buffers are rounded up to a size class, a quarter step between two powers of two,
+ * so that images of slightly different sizes share buffers. Small buffers are not pooled.
+ *
+ * Buffers larger than the out-of-core threshold, as the ones of stitched panoramas, are
+ * mapped from a scratch file instead: only the pages in use are resident, and the system
+ * writes them back to the file instead of the swap. Such buffers are not recycled.
+ *
+ * Other buffers are allocated with new[]. A buffer taken out of DImg by stripImageData()
+ * is detached from the pool, and may be freed with delete[] by its new owner.
+ */
+class DIGIKAM_EXPORT DImgBufferPool
+{
+public:
+
+    static DImgBufferPool* instance();
+
+    /**
+     * Returns a buffer of at least the given size, or 0 if the memory cannot be allocated.
+     */
+    uchar* allocate(size_t size);
+
+    /**
+     * Gives the buffer back to the pool. Buffers which were not allocated by the pool are
+     * freed with delete[]. A null buffer is ignored.
+     */
+    void   release(uchar* const data);
+
+    /**
+     * The buffer is no longer tracked by the pool: its owner frees it with delete[].
+     * Out-of-core buffers cannot be freed this way: they are copied to a new buffer,
+     * which is returned, and unmapped. Returns 0 if the copy cannot be allocated.
+     */
+    uchar* detach(uchar* const data);
+
+    /**
+     * Returns true if the buffer is mapped from a scratch file.
+     */
+    bool   isMapped(const uchar* const data) const;
+
+    /**
+     * Hint that the bytes from begin to end of the buffer will not be used soon.
+     * The pages of an out-of-core buffer are written back to the scratch file and leave
+     * memory, and are read again when accessed. Other buffers are left untouched.
+     */
+    void   releasePages(uchar* const data, size_t begin, size_t end);
+
+    /**
+     * Sets the maximum amount of memory kept by the pool for reuse. 0 disables recycling.
+     * The default is 10% of the physical memory, between 64 MB and 1 GB.
+     */
+    void   setMaximumCachedBytes(qint64 bytes);
+    qint64 maximumCachedBytes() const;
+
+    /**
+     * Returns the size from which buffers are mapped from a scratch file:
+     * half of the physical memory, and at least 1 GB.
+     */
+    qint64 outOfCoreThreshold() const;
+
+    /**
+     * Returns the directory of the scratch files: the cache directory of the application,
+     * as the temporary directory is often in memory.
+     */
+    QString scratchPath() const;
+
+    /**
+     * Frees all buffers waiting to be reused.
+     */
+    void   clear();
+
+    DImgBufferPoolStatistics statistics() const;
+    void   resetStatistics();
+
+private:
+
+    DImgBufferPool();
+    ~DImgBufferPool();
+
+private:
+
+    class Private;
+    Private* const d;
+
+    friend class DImgBufferPoolCreator;
+};
+
+// --------------------------------------------------------------------------------------------------------------
+
+/**
+ * Gives a buffer back to the pool, as QScopedPointer<uchar, DImgBufferPoolCleanup> for loaders.
+ */
+class DImgBufferPoolCleanup
+{
+public:
+
+    static inline void cleanup(uchar* const data)
+    {
+        if (data)
+        {
+            DImgBufferPool::instance()->release(data);
+        }
+    }
+};
+
+}  // namespace Digikam
+
+#endif // DIMGBUFFERPOOL_H
@@ -47,11 +47,18 @@ extern "C"
 #include <cstdlib>
 #include <cstdio>
 
+// Qt includes
+
+#include <QFuture>
+#include <QThreadPool>
+#include <QtConcurrent>
+
 // Local includes
 
 #include "digikam_debug.h"
 #include "dimg.h"
 #include "dimg_p.h"
+#include "dimgscalekernels.h"
 
 typedef uint64_t ullong;
 typedef int64_t  llong;
@@ -155,10 +162,176 @@ void dimgScaleAARGB16(DImgScaleInfo* const isi, ullong* const dest,
                       int dxx, int dyy, int dw, int dh,
                       int dow, int sow,
                       int clip_dx, int clip_dy, int clip_dw, int clip_dh);
+
+/** Scales the clip region in bands of rows, in parallel. The bands share the scale info tables.
+ */
+class DImgScaleBands
+{
+public:
+
+    enum
+    {
+        /// Source and destination pixels below which a band is not worth a thread
+        MinimumPixelsPerBand = 256 * 1024,
+
+        /// Source bytes read by a chunk of rows of out-of-core images, before they can leave memory
+        OutOfCoreBytesPerChunk = 64 * 1024 * 1024
+    };
+
+public:
+
+    DImgScaleBands(DImgScaleInfo* const isi, const DImg& src, DImg& dest,
+                   int sw, int sh,
+                   int dxx, int dyy, int dw, int dh,
+                   int clip_dx, int clip_dy, int clip_dw, int clip_dh);
+
+    void scale();
+
+private:
+
+    void scaleRows(int begin, int end);
+    void scaleChunk(int begin, int end);
+
+private:
+
+    DImgScaleInfo* const isi;
+    const DImg&          src;
+    DImg&                dest;
+    const int            sw;
+    const int            sh;
+    const int            dxx;
+    const int            dyy;
+    const int            dw;
+    const int            dh;
+    const int            clip_dx;
+    const int            clip_dy;
+    const int            clip_dw;
+    const int            clip_dh;
+};
 }
 
 using namespace DImgScale;
 
+DImgScaleBands::DImgScaleBands(DImgScaleInfo* const isi, const DImg& src, DImg& dest,
+                               int sw, int sh,
+                               int dxx, int dyy, int dw, int dh,
+                               int clip_dx, int clip_dy, int clip_dw, int clip_dh)
+    : isi(isi),
+      src(src),
+      dest(dest),
+      sw(sw),
+      sh(sh),
+      dxx(dxx),
+      dyy(dyy),
+      dw(dw),
+      dh(dh),
+      clip_dx(clip_dx),
+      clip_dy(clip_dy),
+      clip_dw(clip_dw),
+      clip_dh(clip_dh)
+{
+}
+
+void DImgScaleBands::scale()
+{
+    int threads = DImg::processingThreads();
+
+    if (threads <= 0)
+    {
+        threads = QThreadPool::globalInstance()->maxThreadCount();
+    }
+
+    // The work of the clip region: the source pixels it reads, and the pixels it writes.
+    const qulonglong work = (qulonglong)sw * sh * clip_dh / dh + (qulonglong)clip_dw * clip_dh;
+    threads               = (int)qMin((qulonglong)threads, work / MinimumPixelsPerBand + 1);
+    threads               = qMin(threads, clip_dh);
+
+    if (threads <= 1)
+    {
+        scaleRows(0, clip_dh);
+        return;
+    }
+
+    QList<QFuture<void> > tasks;
+
+    for (int i = 1 ; i < threads ; ++i)
+    {
+        tasks.append(QtConcurrent::run(this,
+                                       &DImgScaleBands::scaleRows,
+                                       (int)((qlonglong)clip_dh * i       / threads),
+                                       (int)((qlonglong)clip_dh * (i + 1) / threads)
+                                      ));
+    }
+
+    // The first band is scaled in the calling thread.
+    scaleRows(0, clip_dh / threads);
+
+    foreach(QFuture<void> t, tasks)
+        t.waitForFinished();
+}
+
+void DImgScaleBands::scaleRows(int begin, int end)
+{
+    if (!src.isOutOfCore() && !dest.isOutOfCore())
+    {
+        scaleChunk(begin, end);
+        return;
+    }
+
+    // Out-of-core images are scaled in chunks of rows, and the rows done leave memory.
+    const qlonglong bytesPerRow = qMax((qlonglong)src.width() * src.bytesDepth() * sh / dh, (qlonglong)1);
+    const int       rows        = (int)qBound((qlonglong)1, OutOfCoreBytesPerChunk / bytesPerRow, (qlonglong)(end - begin));
+
+    for (int y = begin ; y < end ; y += rows)
+    {
+        const int last = qMin(y + rows, end);
+        scaleChunk(y, last);
+
+        const int srcBegin = (int)((qlonglong)(clip_dy + y)    * sh / dh);
+        const int srcEnd   = (int)((qlonglong)(clip_dy + last) * sh / dh);
+        src.releaseRows(srcBegin, srcEnd - srcBegin);
+        dest.releaseRows(y, last - y);
+    }
+}
+
+void DImgScaleBands::scaleChunk(int begin, int end)
+{
+    const int sow    = src.width();
+    uchar* const ptr = dest.bits() + (qlonglong)begin * clip_dw * dest.bytesDepth();
+
+    if (src.sixteenBit())
+    {
+        if (src.hasAlpha())
+        {
+            dimgScaleAARGBA16(isi, reinterpret_cast<ullong*>(ptr),
+                              dxx, dyy, dw, dh, clip_dw, sow,
+                              clip_dx, clip_dy + begin, clip_dw, end - begin);
+        }
+        else
+        {
+            dimgScaleAARGB16(isi, reinterpret_cast<ullong*>(ptr),
+                             dxx, dyy, dw, dh, clip_dw, sow,
+                             clip_dx, clip_dy + begin, clip_dw, end - begin);
+        }
+    }
+    else
+    {
+        if (src.hasAlpha())
+        {
+            dimgScaleAARGBA(isi, reinterpret_cast<uint*>(ptr),
+                            dxx, dyy, dw, dh, clip_dw, sow,
+                            clip_dx, clip_dy + begin, clip_dw, end - begin);
+        }
+        else
+        {
+            dimgScaleAARGB(isi, reinterpret_cast<uint*>(ptr),
+                           dxx, dyy, dw, dh, clip_dw, sow,
+                           clip_dx, clip_dy + begin, clip_dw, end - begin);
+        }
+    }
+}
+
+
 /*
 #define CLIP(x, y, w, h, xx, yy, ww, hh) \
 if (x < (xx)) {w += (x - (xx)); x = (xx);} \
@@ -229,36 +402,10 @@ DImg DImg::smoothScaleClipped(int dw, int dh, int clipx, int clipy, int clipw, i
 
     DImg buffer(*this, clipw, cliph);
 
-    if (sixteenBit())
-    {
-        if (hasAlpha())
-        {
-            dimgScaleAARGBA16(scaleinfo, reinterpret_cast<ullong*>(buffer.bits()),
-                              0, 0, dw, dh, clipw, w,
-                              clipx, clipy, clipw, cliph);
-        }
-        else
-        {
-            dimgScaleAARGB16(scaleinfo, reinterpret_cast<ullong*>(buffer.bits()),
-                             0, 0, dw, dh, clipw, w,
-                             clipx, clipy, clipw, cliph);
-        }
-    }
-    else
-    {
-        if (hasAlpha())
-        {
-            dimgScaleAARGBA(scaleinfo, reinterpret_cast<uint*>(buffer.bits()),
-                            0, 0, dw, dh, clipw, w,
-                            clipx, clipy, clipw, cliph);
-        }
-        else
-        {
-            dimgScaleAARGB(scaleinfo, reinterpret_cast<uint*>(buffer.bits()),
-                           0, 0, dw, dh, clipw, w,
-                           clipx, clipy, clipw, cliph);
-        }
-    }
+    DImgScaleBands bands(scaleinfo, *this, buffer, w, h,
+                         0, 0, dw, dh,
+                         clipx, clipy, clipw, cliph);
+    bands.scale();
 
     delete scaleinfo;
 
@@ -336,46 +483,10 @@ DImg DImg::smoothScaleSection(int sx, int sy,
 
     DImg buffer(*this, dw, dh);
 
-    if (sixteenBit())
-    {
-        if (hasAlpha())
-        {
-            dimgScaleAARGBA16(scaleinfo, reinterpret_cast<ullong*>(buffer.bits()),
-                              ((sx * dw) / sw),
-                              ((sy * dh) / sh),
-                              dw, dh,
-                              dw, w);
-        }
-        else
-        {
-            dimgScaleAARGB16(scaleinfo, reinterpret_cast<ullong*>(buffer.bits()),
-                             ((sx * dw) / sw),
-                             ((sy * dh) / sh),
-                             dw, dh,
-                             dw, w);
-        }
-    }
-    else
-    {
-        if (hasAlpha())
-        {
-            dimgScaleAARGBA(scaleinfo,
-                            reinterpret_cast<uint*>(buffer.bits()),
-                            ((sx * dw) / sw),
-                            ((sy * dh) / sh),
-                            dw, dh,
-                            dw, w);
-        }
-        else
-        {
-            dimgScaleAARGB(scaleinfo,
-                           reinterpret_cast<uint*>(buffer.bits()),
-                           ((sx * dw) / sw),
-                           ((sy * dh) / sh),
-                           dw, dh,
-                           dw, w);
-        }
-    }
+    DImgScaleBands bands(scaleinfo, *this, buffer, sw, sh,
+                         ((sx * dw) / sw), ((sy * dh) / sh), dw, dh,
+                         0, 0, dw, dh);
+    bands.scale();
 
     delete scaleinfo;
 
@@ -995,130 +1106,13 @@ void DImgScale::dimgScaleAARGBA(DImgScaleInfo* const isi, uint* const dest,
     /* if we're scaling down horizontally & vertically */
     else
     {
-        /*\ 'Correct' version, with math units prepared for MMXification:
-        |*|  The operation 'b = (b * c) >> 16' translates to pmulhw,
-        |*|  so the operation 'b = (b * c) >> d' would translate to
-        |*|  psllw (16 - d), %mmb; pmulh %mmc, %mmb
-        \*/
-        int Cx, Cy, i, j;
-        uint* pix=0;
-        int a, r, g, b, ax, rx, gx, bx;
-        int xap, yap;
+        // The kernels use the SIMD instructions of the CPU, with the same result.
+        const DImgScaleKernels::ScaleDownRow scaleDownRow = DImgScaleKernels::kernels().scaleDownRow;
 
         for (y = y_begin; y < y_end; ++y)
         {
-            Cy   = YAP >> 16;
-            yap  = YAP & 0xffff;
-            dptr = dest + (y - y_begin) * dow;
-
-            for (x = x_begin; x < x_end; ++x)
-            {
-                Cx  = XAP >> 16;
-                xap = XAP & 0xffff;
-
-                sptr = ypoints[dyy + y] + xpoints[x];
-                pix  = sptr;
-                sptr += sow;
-                rx   = (R_VAL(pix) * xap) >> 9;
-                gx   = (G_VAL(pix) * xap) >> 9;
-                bx   = (B_VAL(pix) * xap) >> 9;
-                ax   = (A_VAL(pix) * xap) >> 9;
-                ++pix;
-
-                for (i = (1 << 14) - xap; i > Cx; i -= Cx)
-                {
-                    rx += (R_VAL(pix) * Cx) >> 9;
-                    gx += (G_VAL(pix) * Cx) >> 9;
-                    bx += (B_VAL(pix) * Cx) >> 9;
-                    ax += (A_VAL(pix) * Cx) >> 9;
-                    ++pix;
-                }
-
-                if (i > 0)
-                {
-                    rx += (R_VAL(pix) * i) >> 9;
-                    gx += (G_VAL(pix) * i) >> 9;
-                    bx += (B_VAL(pix) * i) >> 9;
-                    ax += (A_VAL(pix) * i) >> 9;
-                }
-
-                r = (rx * yap) >> 14;
-                g = (gx * yap) >> 14;
-                b = (bx * yap) >> 14;
-                a = (ax * yap) >> 14;
-
-                for (j = (1 << 14) - yap; j > Cy; j -= Cy)
-                {
-                    pix  = sptr;
-                    sptr += sow;
-                    rx   = (R_VAL(pix) * xap) >> 9;
-                    gx   = (G_VAL(pix) * xap) >> 9;
-                    bx   = (B_VAL(pix) * xap) >> 9;
-                    ax   = (A_VAL(pix) * xap) >> 9;
-                    ++pix;
-
-                    for (i = (1 << 14) - xap; i > Cx; i -= Cx)
-                    {
-                        rx += (R_VAL(pix) * Cx) >> 9;
-                        gx += (G_VAL(pix) * Cx) >> 9;
-                        bx += (B_VAL(pix) * Cx) >> 9;
-                        ax += (A_VAL(pix) * Cx) >> 9;
-                        ++pix;
-                    }
-
-                    if (i > 0)
-                    {
-                        rx += (R_VAL(pix) * i) >> 9;
-                        gx += (G_VAL(pix) * i) >> 9;
-                        bx += (B_VAL(pix) * i) >> 9;
-                        ax += (A_VAL(pix) * i) >> 9;
-                    }
-
-                    r += (rx * Cy) >> 14;
-                    g += (gx * Cy) >> 14;
-                    b += (bx * Cy) >> 14;
-                    a += (ax * Cy) >> 14;
-                }
-
-                if (j > 0)
-                {
-                    pix  = sptr;
-                    sptr += sow;
-                    rx   = (R_VAL(pix) * xap) >> 9;
-                    gx   = (G_VAL(pix) * xap) >> 9;
-                    bx   = (B_VAL(pix) * xap) >> 9;
-                    ax   = (A_VAL(pix) * xap) >> 9;
-                    ++pix;
-
-                    for (i = (1 << 14) - xap; i > Cx; i -= Cx)
-                    {
-                        rx += (R_VAL(pix) * Cx) >> 9;
-                        gx += (G_VAL(pix) * Cx) >> 9;
-                        bx += (B_VAL(pix) * Cx) >> 9;
-                        ax += (A_VAL(pix) * Cx) >> 9;
-                        ++pix;
-                    }
-
-                    if (i > 0)
-                    {
-                        rx += (R_VAL(pix) * i) >> 9;
-                        gx += (G_VAL(pix) * i) >> 9;
-                        bx += (B_VAL(pix) * i) >> 9;
-                        ax += (A_VAL(pix) * i) >> 9;
-                    }
-
-                    r += (rx * j) >> 14;
-                    g += (gx * j) >> 14;
-                    b += (bx * j) >> 14;
-                    a += (ax * j) >> 14;
-                }
-
-                R_VAL(dptr) = r >> 5;
-                G_VAL(dptr) = g >> 5;
-                B_VAL(dptr) = b >> 5;
-                A_VAL(dptr) = a >> 5;
-                ++dptr;
-            }
+            scaleDownRow(ypoints[dyy + y], sow, xpoints, xapoints, x_begin, x_end,
+                         YAP >> 16, YAP & 0xffff, true, dest + (y - y_begin) * dow);
         }
     }
 }
@@ -1438,113 +1432,13 @@ void DImgScale::dimgScaleAARGB(DImgScaleInfo* const isi, uint* const dest,
     /* if we're scaling down horizontally & vertically */
     else
     {
-        /*\ 'Correct' version, with math units prepared for MMXification \*/
-        int Cx, Cy, i, j;
-        uint* pix=0;
-        int r, g, b, rx, gx, bx;
-        int xap, yap;
+        // The kernels use the SIMD instructions of the CPU, with the same result.
+        const DImgScaleKernels::ScaleDownRow scaleDownRow = DImgScaleKernels::kernels().scaleDownRow;
 
         for (y = y_begin; y < y_end; ++y)
         {
-            Cy   = YAP >> 16;
-            yap  = YAP & 0xffff;
-            dptr = dest + (y - y_begin) * dow;
-
-            for (x = x_begin; x < x_end; ++x)
-            {
-                Cx   = XAP >> 16;
-                xap  = XAP & 0xffff;
-                sptr = ypoints[dyy + y] + xpoints[x];
-                pix  = sptr;
-                sptr += sow;
-                rx   = (R_VAL(pix) * xap) >> 9;
-                gx   = (G_VAL(pix) * xap) >> 9;
-                bx   = (B_VAL(pix) * xap) >> 9;
-                ++pix;
-
-                for (i = (1 << 14) - xap; i > Cx; i -= Cx)
-                {
-                    rx += (R_VAL(pix) * Cx) >> 9;
-                    gx += (G_VAL(pix) * Cx) >> 9;
-                    bx += (B_VAL(pix) * Cx) >> 9;
-                    ++pix;
-                }
-
-                if (i > 0)
-                {
-                    rx += (R_VAL(pix) * i) >> 9;
-                    gx += (G_VAL(pix) * i) >> 9;
-                    bx += (B_VAL(pix) * i) >> 9;
-                }
-
-                r = (rx * yap) >> 14;
-                g = (gx * yap) >> 14;
-                b = (bx * yap) >> 14;
-
-                for (j = (1 << 14) - yap; j > Cy; j -= Cy)
-                {
-                    pix  = sptr;
-                    sptr += sow;
-                    rx   = (R_VAL(pix) * xap) >> 9;
-                    gx   = (G_VAL(pix) * xap) >> 9;
-                    bx   = (B_VAL(pix) * xap) >> 9;
-                    ++pix;
-
-                    for (i = (1 << 14) - xap; i > Cx; i -= Cx)
-                    {
-                        rx += (R_VAL(pix) * Cx) >> 9;
-                        gx += (G_VAL(pix) * Cx) >> 9;
-                        bx += (B_VAL(pix) * Cx) >> 9;
-                        ++pix;
-                    }
-
-                    if (i > 0)
-                    {
-                        rx += (R_VAL(pix) * i) >> 9;
-                        gx += (G_VAL(pix) * i) >> 9;
-                        bx += (B_VAL(pix) * i) >> 9;
-                    }
-
-                    r += (rx * Cy) >> 14;
-                    g += (gx * Cy) >> 14;
-                    b += (bx * Cy) >> 14;
-                }
-
-                if (j > 0)
-                {
-                    pix  = sptr;
-                    sptr += sow;
-                    rx   = (R_VAL(pix) * xap) >> 9;
-                    gx   = (G_VAL(pix) * xap) >> 9;
-                    bx   = (B_VAL(pix) * xap) >> 9;
-                    ++pix;
-
-                    for (i = (1 << 14) - xap; i > Cx; i -= Cx)
-                    {
-                        rx += (R_VAL(pix) * Cx) >> 9;
-                        gx += (G_VAL(pix) * Cx) >> 9;
-                        bx += (B_VAL(pix) * Cx) >> 9;
-                        ++pix;
-                    }
-
-                    if (i > 0)
-                    {
-                        rx += (R_VAL(pix) * i) >> 9;
-                        gx += (G_VAL(pix) * i) >> 9;
-                        bx += (B_VAL(pix) * i) >> 9;
-                    }
-
-                    r += (rx * j) >> 14;
-                    g += (gx * j) >> 14;
-                    b += (bx * j) >> 14;
-                }
-
-                R_VAL(dptr) = r >> 5;
-                G_VAL(dptr) = g >> 5;
-                B_VAL(dptr) = b >> 5;
-                A_VAL(dptr) = 0xFF;
-                ++dptr;
-            }
+            scaleDownRow(ypoints[dyy + y], sow, xpoints, xapoints, x_begin, x_end,
+                         YAP >> 16, YAP & 0xffff, false, dest + (y - y_begin) * dow);
         }
     }
 }
@@ -1865,113 +1759,13 @@ void DImgScale::dimgScaleAARGB16(DImgScaleInfo* const isi, ullong* const dest,
     // if we're scaling down horizontally & vertically
     else
     {
-        // 'Correct' version, with math units prepared for MMXification
-        int Cx, Cy, i, j;
-        ullong* pix=0;
-        llong r, g, b, rx, gx, bx;
-        int xap, yap;
+        // The kernels use the SIMD instructions of the CPU, with the same result.
+        const DImgScaleKernels::ScaleDownRow16 scaleDownRow16 = DImgScaleKernels::kernels().scaleDownRow16;
 
         for (y = y_begin; y < y_end; ++y)
         {
-            Cy   = YAP >> 16;
-            yap  = YAP & 0xffff;
-            dptr = dest + (y - y_begin) * dow;
-
-            for (x = x_begin; x < x_end; ++x)
-            {
-                Cx   = XAP >> 16;
-                xap  = XAP & 0xffff;
-                sptr = ypoints[dyy + y] + xpoints[x];
-                pix  = sptr;
-                sptr += sow;
-                rx   = (R_VAL16(pix) * xap) >> 9;
-                gx   = (G_VAL16(pix) * xap) >> 9;
-                bx   = (B_VAL16(pix) * xap) >> 9;
-                ++pix;
-
-                for (i = (1 << 14) - xap; i > Cx; i -= Cx)
-                {
-                    rx += (R_VAL16(pix) * Cx) >> 9;
-                    gx += (G_VAL16(pix) * Cx) >> 9;
-                    bx += (B_VAL16(pix) * Cx) >> 9;
-                    ++pix;
-                }
-
-                if (i > 0)
-                {
-                    rx += (R_VAL16(pix) * i) >> 9;
-                    gx += (G_VAL16(pix) * i) >> 9;
-                    bx += (B_VAL16(pix) * i) >> 9;
-                }
-
-                r = (rx * yap) >> 14;
-                g = (gx * yap) >> 14;
-                b = (bx * yap) >> 14;
-
-                for (j = (1 << 14) - yap; j > Cy; j -= Cy)
-                {
-                    pix  = sptr;
-                    sptr += sow;
-                    rx   = (R_VAL16(pix) * xap) >> 9;
-                    gx   = (G_VAL16(pix) * xap) >> 9;
-                    bx   = (B_VAL16(pix) * xap) >> 9;
-                    ++pix;
-
-                    for (i = (1 << 14) - xap; i > Cx; i -= Cx)
-                    {
-                        rx += (R_VAL16(pix) * Cx) >> 9;
-                        gx += (G_VAL16(pix) * Cx) >> 9;
-                        bx += (B_VAL16(pix) * Cx) >> 9;
-                        ++pix;
-                    }
-
-                    if (i > 0)
-                    {
-                        rx += (R_VAL16(pix) * i) >> 9;
-                        gx += (G_VAL16(pix) * i) >> 9;
-                        bx += (B_VAL16(pix) * i) >> 9;
-                    }
-
-                    r += (rx * Cy) >> 14;
-                    g += (gx * Cy) >> 14;
-                    b += (bx * Cy) >> 14;
-                }
-
-                if (j > 0)
-                {
-                    pix  = sptr;
-                    sptr += sow;
-                    rx   = (R_VAL16(pix) * xap) >> 9;
-                    gx   = (G_VAL16(pix) * xap) >> 9;
-                    bx   = (B_VAL16(pix) * xap) >> 9;
-                    ++pix;
-
-                    for (i = (1 << 14) - xap; i > Cx; i -= Cx)
-                    {
-                        rx += (R_VAL16(pix) * Cx) >> 9;
-                        gx += (G_VAL16(pix) * Cx) >> 9;
-                        bx += (B_VAL16(pix) * Cx) >> 9;
-                        ++pix;
-                    }
-
-                    if (i > 0)
-                    {
-                        rx += (R_VAL16(pix) * i) >> 9;
-                        gx += (G_VAL16(pix) * i) >> 9;
-                        bx += (B_VAL16(pix) * i) >> 9;
-                    }
-
-                    r += (rx * j) >> 14;
-                    g += (gx * j) >> 14;
-                    b += (bx * j) >> 14;
-                }
-
-                R_VAL16(dptr) = r >> 5;
-                G_VAL16(dptr) = g >> 5;
-                B_VAL16(dptr) = b >> 5;
-                A_VAL16(dptr) = 0xFFFF;
-                ++dptr;
-            }
+            scaleDownRow16(ypoints[dyy + y], sow, xpoints, xapoints, x_begin, x_end,
+                           YAP >> 16, YAP & 0xffff, false, dest + (y - y_begin) * dow);
         }
     }
 }
@@ -2317,130 +2111,13 @@ void DImgScale::dimgScaleAARGBA16(DImgScaleInfo* const isi, ullong* const dest,
     /* if we're scaling down horizontally & vertically */
     else
     {
-        /*\ 'Correct' version, with math units prepared for MMXification:
-        |*|  The operation 'b = (b * c) >> 16' translates to pmulhw,
-        |*|  so the operation 'b = (b * c) >> d' would translate to
-        |*|  psllw (16 - d), %mmb; pmulh %mmc, %mmb
-        \*/
-        int Cx, Cy, i, j;
-        ullong* pix=0;
-        llong a, r, g, b, ax, rx, gx, bx;
-        int xap, yap;
+        // The kernels use the SIMD instructions of the CPU, with the same result.
+        const DImgScaleKernels::ScaleDownRow16 scaleDownRow16 = DImgScaleKernels::kernels().scaleDownRow16;
 
         for (y = y_begin; y < y_end; ++y)
         {
-            Cy   = YAP >> 16;
-            yap  = YAP & 0xffff;
-            dptr = dest + (y - y_begin) * dow;
-
-            for (x = x_begin; x < x_end; ++x)
-            {
-                Cx   = XAP >> 16;
-                xap  = XAP & 0xffff;
-                sptr = ypoints[dyy + y] + xpoints[x];
-                pix  = sptr;
-                sptr += sow;
-                rx   = (R_VAL16(pix) * xap) >> 9;
-                gx   = (G_VAL16(pix) * xap) >> 9;
-                bx   = (B_VAL16(pix) * xap) >> 9;
-                ax   = (A_VAL16(pix) * xap) >> 9;
-                ++pix;
-
-                for (i = (1 << 14) - xap; i > Cx; i -= Cx)
-                {
-                    rx += (R_VAL16(pix) * Cx) >> 9;
-                    gx += (G_VAL16(pix) * Cx) >> 9;
-                    bx += (B_VAL16(pix) * Cx) >> 9;
-                    ax += (A_VAL16(pix) * Cx) >> 9;
-                    ++pix;
-                }
-
-                if (i > 0)
-                {
-                    rx += (R_VAL16(pix) * i) >> 9;
-                    gx += (G_VAL16(pix) * i) >> 9;
-                    bx += (B_VAL16(pix) * i) >> 9;
-                    ax += (A_VAL16(pix) * i) >> 9;
-                }
-
-                r = (rx * yap) >> 14;
-                g = (gx * yap) >> 14;
-                b = (bx * yap) >> 14;
-                a = (ax * yap) >> 14;
-
-
-                for (j = (1 << 14) - yap; j > Cy; j -= Cy)
-                {
-                    pix  = sptr;
-                    sptr += sow;
-                    rx   = (R_VAL16(pix) * xap) >> 9;
-                    gx   = (G_VAL16(pix) * xap) >> 9;
-                    bx   = (B_VAL16(pix) * xap) >> 9;
-                    ax   = (A_VAL16(pix) * xap) >> 9;
-                    ++pix;
-
-                    for (i = (1 << 14) - xap; i > Cx; i -= Cx)
-                    {
-                        rx += (R_VAL16(pix) * Cx) >> 9;
-                        gx += (G_VAL16(pix) * Cx) >> 9;
-                        bx += (B_VAL16(pix) * Cx) >> 9;
-                        ax += (A_VAL16(pix) * Cx) >> 9;
-                        ++pix;
-                    }
-
-                    if (i > 0)
-                    {
-                        rx += (R_VAL16(pix) * i) >> 9;
-                        gx += (G_VAL16(pix) * i) >> 9;
-                        bx += (B_VAL16(pix) * i) >> 9;
-                        ax += (A_VAL16(pix) * i) >> 9;
-                    }
-
-                    r += (rx * Cy) >> 14;
-                    g += (gx * Cy) >> 14;
-                    b += (bx * Cy) >> 14;
-                    a += (ax * Cy) >> 14;
-                }
-
-                if (j > 0)
-                {
-                    pix  = sptr;
-                    sptr += sow;
-                    rx   = (R_VAL16(pix) * xap) >> 9;
-                    gx   = (G_VAL16(pix) * xap) >> 9;
-                    bx   = (B_VAL16(pix) * xap) >> 9;
-                    ax   = (A_VAL16(pix) * xap) >> 9;
-                    ++pix;
-
-                    for (i = (1 << 14) - xap; i > Cx; i -= Cx)
-                    {
-                        rx += (R_VAL16(pix) * Cx) >> 9;
-                        gx += (G_VAL16(pix) * Cx) >> 9;
-                        bx += (B_VAL16(pix) * Cx) >> 9;
-                        ax += (A_VAL16(pix) * Cx) >> 9;
-                        ++pix;
-                    }
-
-                    if (i > 0)
-                    {
-                        rx += (R_VAL16(pix) * i) >> 9;
-                        gx += (G_VAL16(pix) * i) >> 9;
-                        bx += (B_VAL16(pix) * i) >> 9;
-                        ax += (A_VAL16(pix) * i) >> 9;
-                    }
-
-                    r += (rx * j) >> 14;
-                    g += (gx * j) >> 14;
-                    b += (bx * j) >> 14;
-                    a += (ax * j) >> 14;
-                }
-
-                R_VAL16(dptr) = r >> 5;
-                G_VAL16(dptr) = g >> 5;
-                B_VAL16(dptr) = b >> 5;
-                A_VAL16(dptr) = a >> 5;
-                ++dptr;
-            }
+            scaleDownRow16(ypoints[dyy + y], sow, xpoints, xapoints, x_begin, x_end,
+                           YAP >> 16, YAP & 0xffff, true, dest + (y - y_begin) * dow);
         }
     }
 }
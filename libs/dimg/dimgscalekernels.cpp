@@ -0,0 +1,472 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-03-28
+ * Description : smooth scale kernels, with implementations
+ *               for the SIMD instructions of the CPU
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "dimgscalekernels.h"
+
+// C++ includes
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#   include <intrin.h>
+#endif
+
+// Qt includes
+
+#include <QtGlobal>
+
+// Local includes
+
+#include "digikam_debug.h"
+
+typedef uint64_t ullong;
+typedef int64_t  llong;
+
+#define A_VAL(p) ((unsigned char*)(p))[3]
+#define R_VAL(p) ((unsigned char*)(p))[2]
+#define G_VAL(p) ((unsigned char*)(p))[1]
+#define B_VAL(p) ((unsigned char*)(p))[0]
+
+#define A_VAL16(p) ((ushort*)(p))[3]
+#define R_VAL16(p) ((ushort*)(p))[2]
+#define G_VAL16(p) ((ushort*)(p))[1]
+#define B_VAL16(p) ((ushort*)(p))[0]
+
+#define XAP (xapoints[x])
+
+namespace Digikam
+{
+
+/** The scalar kernels are the original area sampling of DImgScale, which the SIMD kernels reproduce.
+ *  See dimgCalcApoints(): the weights of a destination pixel sum to 1 << 14.
+ */
+template <bool alpha>
+static void scaleDownRowScalar(const uint* const src, int sow,
+                               const int* const xpoints, const int* const xapoints,
+                               int x_begin, int x_end, int Cy, int yap,
+                               bool, uint* const dest)
+{
+    int Cx, i, j;
+    const uint* sptr = 0;
+    const uint* pix  = 0;
+    int a = 0, r, g, b, ax = 0, rx, gx, bx;
+    int xap;
+    uint* dptr       = dest;
+
+    for (int x = x_begin; x < x_end; ++x)
+    {
+        Cx   = XAP >> 16;
+        xap  = XAP & 0xffff;
+        sptr = src + xpoints[x];
+        pix  = sptr;
+        sptr += sow;
+        rx   = (R_VAL(pix) * xap) >> 9;
+        gx   = (G_VAL(pix) * xap) >> 9;
+        bx   = (B_VAL(pix) * xap) >> 9;
+
+        if (alpha)
+        {
+            ax = (A_VAL(pix) * xap) >> 9;
+        }
+
+        ++pix;
+
+        for (i = (1 << 14) - xap; i > Cx; i -= Cx)
+        {
+            rx += (R_VAL(pix) * Cx) >> 9;
+            gx += (G_VAL(pix) * Cx) >> 9;
+            bx += (B_VAL(pix) * Cx) >> 9;
+
+            if (alpha)
+            {
+                ax += (A_VAL(pix) * Cx) >> 9;
+            }
+
+            ++pix;
+        }
+
+        if (i > 0)
+        {
+            rx += (R_VAL(pix) * i) >> 9;
+            gx += (G_VAL(pix) * i) >> 9;
+            bx += (B_VAL(pix) * i) >> 9;
+
+            if (alpha)
+            {
+                ax += (A_VAL(pix) * i) >> 9;
+            }
+        }
+
+        r = (rx * yap) >> 14;
+        g = (gx * yap) >> 14;
+        b = (bx * yap) >> 14;
+
+        if (alpha)
+        {
+            a = (ax * yap) >> 14;
+        }
+
+        for (j = (1 << 14) - yap; j > 0; j -= Cy)
+        {
+            // The last row gets the rest of the weight
+            const int wy = (j > Cy) ? Cy : j;
+            pix          = sptr;
+            sptr        += sow;
+            rx           = (R_VAL(pix) * xap) >> 9;
+            gx           = (G_VAL(pix) * xap) >> 9;
+            bx           = (B_VAL(pix) * xap) >> 9;
+
+            if (alpha)
+            {
+                ax = (A_VAL(pix) * xap) >> 9;
+            }
+
+            ++pix;
+
+            for (i = (1 << 14) - xap; i > Cx; i -= Cx)
+            {
+                rx += (R_VAL(pix) * Cx) >> 9;
+                gx += (G_VAL(pix) * Cx) >> 9;
+                bx += (B_VAL(pix) * Cx) >> 9;
+
+                if (alpha)
+                {
+                    ax += (A_VAL(pix) * Cx) >> 9;
+                }
+
+                ++pix;
+            }
+
+            if (i > 0)
+            {
+                rx += (R_VAL(pix) * i) >> 9;
+                gx += (G_VAL(pix) * i) >> 9;
+                bx += (B_VAL(pix) * i) >> 9;
+
+                if (alpha)
+                {
+                    ax += (A_VAL(pix) * i) >> 9;
+                }
+            }
+
+            r += (rx * wy) >> 14;
+            g += (gx * wy) >> 14;
+            b += (bx * wy) >> 14;
+
+            if (alpha)
+            {
+                a += (ax * wy) >> 14;
+            }
+        }
+
+        R_VAL(dptr) = r >> 5;
+        G_VAL(dptr) = g >> 5;
+        B_VAL(dptr) = b >> 5;
+        A_VAL(dptr) = alpha ? (a >> 5) : 0xFF;
+        ++dptr;
+    }
+}
+
+template <bool alpha>
+static void scaleDownRow16Scalar(const ullong* const src, int sow,
+                                 const int* const xpoints, const int* const xapoints,
+                                 int x_begin, int x_end, int Cy, int yap,
+                                 bool, ullong* const dest)
+{
+    int Cx, i, j;
+    const ullong* sptr = 0;
+    const ullong* pix  = 0;
+    llong a = 0, r, g, b, ax = 0, rx, gx, bx;
+    int xap;
+    ullong* dptr       = dest;
+
+    for (int x = x_begin; x < x_end; ++x)
+    {
+        Cx   = XAP >> 16;
+        xap  = XAP & 0xffff;
+        sptr = src + xpoints[x];
+        pix  = sptr;
+        sptr += sow;
+        rx   = (R_VAL16(pix) * xap) >> 9;
+        gx   = (G_VAL16(pix) * xap) >> 9;
+        bx   = (B_VAL16(pix) * xap) >> 9;
+
+        if (alpha)
+        {
+            ax = (A_VAL16(pix) * xap) >> 9;
+        }
+
+        ++pix;
+
+        for (i = (1 << 14) - xap; i > Cx; i -= Cx)
+        {
+            rx += (R_VAL16(pix) * Cx) >> 9;
+            gx += (G_VAL16(pix) * Cx) >> 9;
+            bx += (B_VAL16(pix) * Cx) >> 9;
+
+            if (alpha)
+            {
+                ax += (A_VAL16(pix) * Cx) >> 9;
+            }
+
+            ++pix;
+        }
+
+        if (i > 0)
+        {
+            rx += (R_VAL16(pix) * i) >> 9;
+            gx += (G_VAL16(pix) * i) >> 9;
+            bx += (B_VAL16(pix) * i) >> 9;
+
+            if (alpha)
+            {
+                ax += (A_VAL16(pix) * i) >> 9;
+            }
+        }
+
+        r = (rx * yap) >> 14;
+        g = (gx * yap) >> 14;
+        b = (bx * yap) >> 14;
+
+        if (alpha)
+        {
+            a = (ax * yap) >> 14;
+        }
+
+        for (j = (1 << 14) - yap; j > 0; j -= Cy)
+        {
+            // The last row gets the rest of the weight
+            const int wy = (j > Cy) ? Cy : j;
+            pix          = sptr;
+            sptr        += sow;
+            rx           = (R_VAL16(pix) * xap) >> 9;
+            gx           = (G_VAL16(pix) * xap) >> 9;
+            bx           = (B_VAL16(pix) * xap) >> 9;
+
+            if (alpha)
+            {
+                ax = (A_VAL16(pix) * xap) >> 9;
+            }
+
+            ++pix;
+
+            for (i = (1 << 14) - xap; i > Cx; i -= Cx)
+            {
+                rx += (R_VAL16(pix) * Cx) >> 9;
+                gx += (G_VAL16(pix) * Cx) >> 9;
+                bx += (B_VAL16(pix) * Cx) >> 9;
+
+                if (alpha)
+                {
+                    ax += (A_VAL16(pix) * Cx) >> 9;
+                }
+
+                ++pix;
+            }
+
+            if (i > 0)
+            {
+                rx += (R_VAL16(pix) * i) >> 9;
+                gx += (G_VAL16(pix) * i) >> 9;
+                bx += (B_VAL16(pix) * i) >> 9;
+
+                if (alpha)
+                {
+                    ax += (A_VAL16(pix) * i) >> 9;
+                }
+            }
+
+            r += (rx * wy) >> 14;
+            g += (gx * wy) >> 14;
+            b += (bx * wy) >> 14;
+
+            if (alpha)
+            {
+                a += (ax * wy) >> 14;
+            }
+        }
+
+        R_VAL16(dptr) = r >> 5;
+        G_VAL16(dptr) = g >> 5;
+        B_VAL16(dptr) = b >> 5;
+        A_VAL16(dptr) = alpha ? (a >> 5) : 0xFFFF;
+        ++dptr;
+    }
+}
+
+static void scaleDownRowScalar(const uint* const src, int sow,
+                               const int* const xpoints, const int* const xapoints,
+                               int x_begin, int x_end, int Cy, int yap,
+                               bool alpha, uint* const dest)
+{
+    if (alpha)
+    {
+        scaleDownRowScalar<true>(src, sow, xpoints, xapoints, x_begin, x_end, Cy, yap, alpha, dest);
+    }
+    else
+    {
+        scaleDownRowScalar<false>(src, sow, xpoints, xapoints, x_begin, x_end, Cy, yap, alpha, dest);
+    }
+}
+
+static void scaleDownRow16Scalar(const ullong* const src, int sow,
+                                 const int* const xpoints, const int* const xapoints,
+                                 int x_begin, int x_end, int Cy, int yap,
+                                 bool alpha, ullong* const dest)
+{
+    if (alpha)
+    {
+        scaleDownRow16Scalar<true>(src, sow, xpoints, xapoints, x_begin, x_end, Cy, yap, alpha, dest);
+    }
+    else
+    {
+        scaleDownRow16Scalar<false>(src, sow, xpoints, xapoints, x_begin, x_end, Cy, yap, alpha, dest);
+    }
+}
+
+// --------------------------------------------------------------------------------------
+
+static bool cpuSupports(DImgScaleKernels::Instructions instructions)
+{
+    switch (instructions)
+    {
+        case DImgScaleKernels::Scalar:
+            return true;
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+
+        case DImgScaleKernels::SSE2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse2");
+
+        case DImgScaleKernels::AVX2:
+            // This also checks that the operating system saves the AVX registers.
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+
+#elif defined(_MSC_VER) && defined(_M_X64)
+
+        case DImgScaleKernels::SSE2:
+            return true;
+
+        case DImgScaleKernels::AVX2:
+        {
+            int info[4];
+            __cpuid(info, 0);
+
+            if (info[0] < 7)
+            {
+                return false;
+            }
+
+            // The CPU must support AVX and XSAVE, and the operating system
+            // must save the XMM and YMM registers on context switches.
+
+            __cpuid(info, 1);
+
+            const bool osxsave = (info[2] & (1 << 27)) != 0;
+            const bool avx     = (info[2] & (1 << 28)) != 0;
+
+            if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+            {
+                return false;
+            }
+
+            __cpuidex(info, 7, 0);
+
+            return ((info[1] & (1 << 5)) != 0);
+        }
+
+#endif
+
+        default:
+            return false;
+    }
+}
+
+class DImgScaleKernelsCreator
+{
+public:
+
+    DImgScaleKernelsCreator()
+        : object(DImgScaleKernels::kernels(DImgScaleKernels::AVX2))
+    {
+        qCDebug(DIGIKAM_DIMG_LOG) << "Smooth scale kernels use"
+                                  << DImgScaleKernels::instructionsName(object.instructions);
+    }
+
+    DImgScaleKernels object;
+};
+
+Q_GLOBAL_STATIC(DImgScaleKernelsCreator, creator)
+
+// --------------------------------------------------------------------------------------
+
+DImgScaleKernels::DImgScaleKernels()
+    : instructions(Scalar),
+      scaleDownRow(&scaleDownRowScalar),
+      scaleDownRow16(&scaleDownRow16Scalar)
+{
+}
+
+const DImgScaleKernels& DImgScaleKernels::kernels()
+{
+    return creator->object;
+}
+
+DImgScaleKernels DImgScaleKernels::kernels(Instructions instructions)
+{
+    DImgScaleKernels kernels;
+
+    if (instructions >= AVX2 && cpuSupports(AVX2) && dimgScaleKernelsAVX2(kernels))
+    {
+        kernels.instructions = AVX2;
+    }
+    else if (instructions >= SSE2 && cpuSupports(SSE2) && dimgScaleKernelsSSE2(kernels))
+    {
+        kernels.instructions = SSE2;
+    }
+
+    return kernels;
+}
+
+void DImgScaleKernels::setMaximumInstructions(Instructions instructions)
+{
+    creator->object = kernels(instructions);
+}
+
+QString DImgScaleKernels::instructionsName(Instructions instructions)
+{
+    switch (instructions)
+    {
+        case SSE2:
+            return QLatin1String("SSE2");
+
+        case AVX2:
+            return QLatin1String("AVX2");
+
+        default:
+            return QLatin1String("scalar");
+    }
+}
+
+}  // namespace Digikam
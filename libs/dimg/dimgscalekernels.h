@@ -0,0 +1,119 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-03-28
+ * Description : smooth scale kernels, with implementations
+ *               for the SIMD instructions of the CPU
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIMGSCALEKERNELS_H
+#define DIMGSCALEKERNELS_H
+
+// C ANSI includes
+
+extern "C"
+{
+#include <stdint.h>
+}
+
+// Qt includes
+
+#include <QString>
+
+// Local includes
+
+#include "digikam_export.h"
+
+namespace Digikam
+{
+
+/**
+ * The kernels of DImg::smoothScale() scaling down both ways, where each destination pixel
+ * is the area average of a block of source pixels. This is the case of all thumbnails and
+ * previews. The SSE2 and AVX2 implementations give exactly the same result as the scalar one.
+ */
+class DIGIKAM_EXPORT DImgScaleKernels
+{
+public:
+
+    enum Instructions
+    {
+        Scalar = 0,
+        SSE2,
+        AVX2
+    };
+
+    /**
+     * Scales down one destination row, from x_begin to x_end. src is the first source row
+     * of the destination row and sow the source scanline width. xpoints and xapoints are
+     * the source offsets and weights of the destination columns, Cy and yap the weights of
+     * the source rows. If alpha is false, the destination alpha is set to opaque.
+     */
+    typedef void (*ScaleDownRow)(const uint* const src, int sow,
+                                 const int* const xpoints, const int* const xapoints,
+                                 int x_begin, int x_end, int Cy, int yap,
+                                 bool alpha, uint* const dest);
+
+    typedef void (*ScaleDownRow16)(const uint64_t* const src, int sow,
+                                   const int* const xpoints, const int* const xapoints,
+                                   int x_begin, int x_end, int Cy, int yap,
+                                   bool alpha, uint64_t* const dest);
+
+public:
+
+    DImgScaleKernels();
+
+    /**
+     * Returns the kernels used by DImg: the best ones supported by the CPU,
+     * unless restricted with setMaximumInstructions().
+     */
+    static const DImgScaleKernels& kernels();
+
+    /**
+     * Returns the kernels for the given instructions, or the best ones below
+     * if the CPU or the build do not support them.
+     */
+    static DImgScaleKernels kernels(Instructions instructions);
+
+    /**
+     * Restricts the kernels used by DImg to the given instructions.
+     * This is meant for tests and benchmarks, and is not thread-safe.
+     */
+    static void setMaximumInstructions(Instructions instructions);
+
+    static QString instructionsName(Instructions instructions);
+
+public:
+
+    Instructions   instructions;
+    ScaleDownRow   scaleDownRow;
+    ScaleDownRow16 scaleDownRow16;
+};
+
+// --------------------------------------------------------------------------------------
+
+/** The implementations, filled in by each file compiled for its instructions.
+ *  They return false if the build does not support the instructions.
+ */
+bool dimgScaleKernelsSSE2(DImgScaleKernels& kernels);
+bool dimgScaleKernelsAVX2(DImgScaleKernels& kernels);
+
+} // namespace Digikam
+
+#endif // DIMGSCALEKERNELS_H
@@ -0,0 +1,240 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-03-28
+ * Description : smooth scale kernels using AVX2 instructions
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "dimgscalekernels.h"
+
+// Qt includes
+
+#include <QtGlobal>
+
+#if defined(__AVX2__)
+
+// C++ includes
+
+#include <immintrin.h>
+
+namespace Digikam
+{
+
+/** Two source rows are processed at once, one in each 128 bits half, with the 4 channels
+ *  of a pixel in 32 bits lanes. The integer operations are the ones of the scalar kernels,
+ *  and the halves are added at the end: the result is exactly the same.
+ */
+
+/// The weight of the next source row of a destination pixel, or 0 if there is none
+static inline int nextRowWeight(int& rest, int Cy)
+{
+    if (rest <= 0)
+    {
+        return 0;
+    }
+
+    const int weight = (rest > Cy) ? Cy : rest;
+    rest            -= weight;
+
+    return weight;
+}
+
+// --- 8 bits ---------------------------------------------------------------------------
+
+static inline __m256i weightedPixels(const uint* const pa, const uint* const pb, const __m256i& weight)
+{
+    const __m128i v = _mm_unpacklo_epi32(_mm_cvtsi32_si128(*(const int*)pa),
+                                         _mm_cvtsi32_si128(*(const int*)pb));
+
+    // Weights are at most 1 << 14: the signed 16 bits multiply-add of (value, 0) by (weight, 0) is exact.
+    return _mm256_srli_epi32(_mm256_madd_epi16(_mm256_cvtepu8_epi32(v), weight), 9);
+}
+
+static inline __m256i weightedRows(const uint* pa, const uint* pb, int xap, int Cx, int wa, int wb)
+{
+    __m256i rx = weightedPixels(pa, pb, _mm256_set1_epi32(xap));
+    ++pa;
+    ++pb;
+
+    int i;
+    const __m256i wx = _mm256_set1_epi32(Cx);
+
+    for (i = (1 << 14) - xap; i > Cx; i -= Cx)
+    {
+        rx = _mm256_add_epi32(rx, weightedPixels(pa, pb, wx));
+        ++pa;
+        ++pb;
+    }
+
+    if (i > 0)
+    {
+        rx = _mm256_add_epi32(rx, weightedPixels(pa, pb, _mm256_set1_epi32(i)));
+    }
+
+    // The sums are at most 8160, the products still fit in 31 bits.
+    const __m256i wy = _mm256_setr_epi32(wa, wa, wa, wa, wb, wb, wb, wb);
+
+    return _mm256_srli_epi32(_mm256_madd_epi16(rx, wy), 14);
+}
+
+static void scaleDownRowAVX2(const uint* const src, int sow,
+                             const int* const xpoints, const int* const xapoints,
+                             int x_begin, int x_end, int Cy, int yap,
+                             bool alpha, uint* const dest)
+{
+    const __m128i opaque = _mm_cvtsi32_si128(alpha ? 0 : (int)0xFF000000);
+    uint* dptr           = dest;
+
+    for (int x = x_begin ; x < x_end ; ++x)
+    {
+        const int Cx     = xapoints[x] >> 16;
+        const int xap    = xapoints[x] & 0xffff;
+        const uint* sptr = src + xpoints[x];
+        __m256i r        = _mm256_setzero_si256();
+        int rest         = (1 << 14) - yap;
+        int wa           = yap;
+
+        forever
+        {
+            // A missing second row gets a null weight, and is read from the first one.
+            const int wb         = nextRowWeight(rest, Cy);
+            const uint* const pb = wb ? sptr + sow : sptr;
+            r                    = _mm256_add_epi32(r, weightedRows(sptr, pb, xap, Cx, wa, wb));
+
+            if (rest <= 0)
+            {
+                break;
+            }
+
+            sptr += 2 * sow;
+            wa    = nextRowWeight(rest, Cy);
+        }
+
+        __m128i s = _mm_add_epi32(_mm256_castsi256_si128(r), _mm256_extracti128_si256(r, 1));
+        s         = _mm_srli_epi32(s, 5);
+        s         = _mm_packs_epi32(s, s);
+        s         = _mm_packus_epi16(s, s);
+        *dptr     = (uint)_mm_cvtsi128_si32(_mm_or_si128(s, opaque));
+        ++dptr;
+    }
+}
+
+// --- 16 bits --------------------------------------------------------------------------
+
+static inline __m256i weightedPixels16(const uint64_t* const pa, const uint64_t* const pb, const __m256i& weight)
+{
+    const __m128i v = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i*)pa),
+                                         _mm_loadl_epi64((const __m128i*)pb));
+
+    // Unsigned 16 bits values by weights of at most 1 << 14: the 32 bits products are exact.
+    return _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_cvtepu16_epi32(v), weight), 9);
+}
+
+static inline __m256i weightedRows16(const uint64_t* pa, const uint64_t* pb, int xap, int Cx, int wa, int wb)
+{
+    __m256i rx = weightedPixels16(pa, pb, _mm256_set1_epi32(xap));
+    ++pa;
+    ++pb;
+
+    int i;
+    const __m256i wx = _mm256_set1_epi32(Cx);
+
+    for (i = (1 << 14) - xap; i > Cx; i -= Cx)
+    {
+        rx = _mm256_add_epi32(rx, weightedPixels16(pa, pb, wx));
+        ++pa;
+        ++pb;
+    }
+
+    if (i > 0)
+    {
+        rx = _mm256_add_epi32(rx, weightedPixels16(pa, pb, _mm256_set1_epi32(i)));
+    }
+
+    // The sums have up to 21 bits and the products up to 35 bits: multiply in 64 bits,
+    // even and odd lanes apart, and put the shifted results back in 32 bits lanes.
+    const __m256i wy   = _mm256_setr_epi32(wa, wa, wa, wa, wb, wb, wb, wb);
+    const __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(rx, wy), 14);
+    const __m256i odd  = _mm256_srli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(rx, 32), wy), 14);
+
+    return _mm256_or_si256(even, _mm256_slli_epi64(odd, 32));
+}
+
+static void scaleDownRow16AVX2(const uint64_t* const src, int sow,
+                               const int* const xpoints, const int* const xapoints,
+                               int x_begin, int x_end, int Cy, int yap,
+                               bool alpha, uint64_t* const dest)
+{
+    const __m128i opaque = _mm_set_epi32(0, 0, alpha ? 0 : (int)0xFFFF0000, 0);
+    uint64_t* dptr       = dest;
+
+    for (int x = x_begin ; x < x_end ; ++x)
+    {
+        const int Cx         = xapoints[x] >> 16;
+        const int xap        = xapoints[x] & 0xffff;
+        const uint64_t* sptr = src + xpoints[x];
+        __m256i r            = _mm256_setzero_si256();
+        int rest             = (1 << 14) - yap;
+        int wa               = yap;
+
+        forever
+        {
+            const int wb             = nextRowWeight(rest, Cy);
+            const uint64_t* const pb = wb ? sptr + sow : sptr;
+            r                        = _mm256_add_epi32(r, weightedRows16(sptr, pb, xap, Cx, wa, wb));
+
+            if (rest <= 0)
+            {
+                break;
+            }
+
+            sptr += 2 * sow;
+            wa    = nextRowWeight(rest, Cy);
+        }
+
+        __m128i s = _mm_add_epi32(_mm256_castsi256_si128(r), _mm256_extracti128_si256(r, 1));
+        s         = _mm_packus_epi32(_mm_srli_epi32(s, 5), _mm_setzero_si128());
+        _mm_storel_epi64((__m128i*)dptr, _mm_or_si128(s, opaque));
+        ++dptr;
+    }
+}
+
+bool dimgScaleKernelsAVX2(DImgScaleKernels& kernels)
+{
+    kernels.scaleDownRow   = &scaleDownRowAVX2;
+    kernels.scaleDownRow16 = &scaleDownRow16AVX2;
+
+    return true;
+}
+
+}  // namespace Digikam
+
+#else // defined(__AVX2__)
+
+namespace Digikam
+{
+
+bool dimgScaleKernelsAVX2(DImgScaleKernels&)
+{
+    return false;
+}
+
+}  // namespace Digikam
+
+#endif // defined(__AVX2__)
@@ -0,0 +1,205 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-03-28
+ * Description : smooth scale kernels using SSE2 instructions
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "dimgscalekernels.h"
+
+// Qt includes
+
+#include <QtGlobal>
+
+#if defined(__SSE2__) || defined(_M_X64)
+
+// C++ includes
+
+#include <emmintrin.h>
+
+namespace Digikam
+{
+
+/** The 4 channels of a pixel are processed at once in 32 bits lanes, with the same integer
+ *  operations as the scalar kernels: the result is exactly the same.
+ */
+
+// --- 8 bits ---------------------------------------------------------------------------
+
+/// The channels of the pixel, multiplied by the weight, shifted right by 9
+static inline __m128i weightedPixel(const uint* const pix, const __m128i& weight)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i v          = _mm_cvtsi32_si128(*(const int*)pix);
+    v                  = _mm_unpacklo_epi16(_mm_unpacklo_epi8(v, zero), zero);
+
+    // Weights are at most 1 << 14: the signed 16 bits multiply-add of (value, 0) by (weight, 0) is exact.
+    return _mm_srli_epi32(_mm_madd_epi16(v, weight), 9);
+}
+
+/// The horizontal sum of the row, multiplied by the weight of the row, shifted right by 14
+static inline __m128i weightedRow(const uint* pix, int xap, int Cx, int wy)
+{
+    __m128i rx = weightedPixel(pix, _mm_set1_epi32(xap));
+    ++pix;
+
+    int i;
+    const __m128i wx = _mm_set1_epi32(Cx);
+
+    for (i = (1 << 14) - xap; i > Cx; i -= Cx)
+    {
+        rx = _mm_add_epi32(rx, weightedPixel(pix, wx));
+        ++pix;
+    }
+
+    if (i > 0)
+    {
+        rx = _mm_add_epi32(rx, weightedPixel(pix, _mm_set1_epi32(i)));
+    }
+
+    // The sum is at most 8160, the product still fits in 31 bits.
+    return _mm_srli_epi32(_mm_madd_epi16(rx, _mm_set1_epi32(wy)), 14);
+}
+
+static void scaleDownRowSSE2(const uint* const src, int sow,
+                             const int* const xpoints, const int* const xapoints,
+                             int x_begin, int x_end, int Cy, int yap,
+                             bool alpha, uint* const dest)
+{
+    const __m128i opaque = _mm_cvtsi32_si128(alpha ? 0 : (int)0xFF000000);
+    uint* dptr           = dest;
+
+    for (int x = x_begin ; x < x_end ; ++x)
+    {
+        const int Cx     = xapoints[x] >> 16;
+        const int xap    = xapoints[x] & 0xffff;
+        const uint* sptr = src + xpoints[x];
+        __m128i r        = weightedRow(sptr, xap, Cx, yap);
+        sptr            += sow;
+
+        for (int j = (1 << 14) - yap ; j > 0 ; j -= Cy)
+        {
+            r     = _mm_add_epi32(r, weightedRow(sptr, xap, Cx, (j > Cy) ? Cy : j));
+            sptr += sow;
+        }
+
+        r     = _mm_srli_epi32(r, 5);
+        r     = _mm_packs_epi32(r, r);
+        r     = _mm_packus_epi16(r, r);
+        *dptr = (uint)_mm_cvtsi128_si32(_mm_or_si128(r, opaque));
+        ++dptr;
+    }
+}
+
+// --- 16 bits --------------------------------------------------------------------------
+
+static inline __m128i weightedPixel16(const uint64_t* const pix, const __m128i& weight)
+{
+    // Unsigned 16 bits values by weights of at most 1 << 14: the 32 bits products are exact.
+    const __m128i v  = _mm_loadl_epi64((const __m128i*)pix);
+    const __m128i lo = _mm_mullo_epi16(v, weight);
+    const __m128i hi = _mm_mulhi_epu16(v, weight);
+
+    return _mm_srli_epi32(_mm_unpacklo_epi16(lo, hi), 9);
+}
+
+static inline __m128i weightedRow16(const uint64_t* pix, int xap, int Cx, int wy)
+{
+    __m128i rx = weightedPixel16(pix, _mm_set1_epi16((short)xap));
+    ++pix;
+
+    int i;
+    const __m128i wx = _mm_set1_epi16((short)Cx);
+
+    for (i = (1 << 14) - xap; i > Cx; i -= Cx)
+    {
+        rx = _mm_add_epi32(rx, weightedPixel16(pix, wx));
+        ++pix;
+    }
+
+    if (i > 0)
+    {
+        rx = _mm_add_epi32(rx, weightedPixel16(pix, _mm_set1_epi16((short)i)));
+    }
+
+    // The sum has up to 21 bits and the product up to 35 bits: multiply in 64 bits,
+    // even and odd lanes apart, and put the shifted results back in 32 bits lanes.
+    const __m128i w    = _mm_set1_epi32(wy);
+    const __m128i even = _mm_srli_epi64(_mm_mul_epu32(rx, w), 14);
+    const __m128i odd  = _mm_srli_epi64(_mm_mul_epu32(_mm_srli_epi64(rx, 32), w), 14);
+
+    return _mm_or_si128(even, _mm_slli_epi64(odd, 32));
+}
+
+static void scaleDownRow16SSE2(const uint64_t* const src, int sow,
+                               const int* const xpoints, const int* const xapoints,
+                               int x_begin, int x_end, int Cy, int yap,
+                               bool alpha, uint64_t* const dest)
+{
+    const __m128i opaque = _mm_set_epi32(0, 0, alpha ? 0 : (int)0xFFFF0000, 0);
+    const __m128i bias32 = _mm_set1_epi32(32768);
+    const __m128i bias16 = _mm_set1_epi16((short)0x8000);
+    uint64_t* dptr       = dest;
+
+    for (int x = x_begin ; x < x_end ; ++x)
+    {
+        const int Cx         = xapoints[x] >> 16;
+        const int xap        = xapoints[x] & 0xffff;
+        const uint64_t* sptr = src + xpoints[x];
+        __m128i r            = weightedRow16(sptr, xap, Cx, yap);
+        sptr                += sow;
+
+        for (int j = (1 << 14) - yap ; j > 0 ; j -= Cy)
+        {
+            r     = _mm_add_epi32(r, weightedRow16(sptr, xap, Cx, (j > Cy) ? Cy : j));
+            sptr += sow;
+        }
+
+        // SSE2 only packs to signed 16 bits: pack the values shifted down by 32768, and shift them back.
+        r = _mm_srli_epi32(r, 5);
+        r = _mm_packs_epi32(_mm_sub_epi32(r, bias32), _mm_sub_epi32(r, bias32));
+        r = _mm_xor_si128(r, bias16);
+        _mm_storel_epi64((__m128i*)dptr, _mm_or_si128(r, opaque));
+        ++dptr;
+    }
+}
+
+bool dimgScaleKernelsSSE2(DImgScaleKernels& kernels)
+{
+    kernels.scaleDownRow   = &scaleDownRowSSE2;
+    kernels.scaleDownRow16 = &scaleDownRow16SSE2;
+
+    return true;
+}
+
+}  // namespace Digikam
+
+#else // defined(__SSE2__) || defined(_M_X64)
+
+namespace Digikam
+{
+
+bool dimgScaleKernelsSSE2(DImgScaleKernels&)
+{
+    return false;
+}
+
+}  // namespace Digikam
+
+#endif // defined(__SSE2__) || defined(_M_X64)
@@ -50,21 +50,34 @@ AutoExpoFilter::~AutoExpoFilter()
 
 void AutoExpoFilter::filterImage()
 {
-    if (m_refImage.isNull())
-    {
-        m_refImage = m_orgImage;
-    }
-
-    if (m_orgImage.sixteenBit() != m_refImage.sixteenBit())
+    if (!m_refImage.isNull() && m_orgImage.sixteenBit() != m_refImage.sixteenBit())
     {
         qCDebug(DIGIKAM_DIMG_LOG) << "Ref. image and Org. have different bits depth";
         return;
     }
 
-    autoExposureAdjustement(&m_refImage, m_settings.black, m_settings.expositionMain);
     WBFilter::filterImage();
 }
 
+bool AutoExpoFilter::needsInputPixels() const
+{
+    return true;
+}
+
+void AutoExpoFilter::preparePointFilter(const DImg& image)
+{
+    if (m_refImage.isNull() || m_refImage.sixteenBit() != image.sixteenBit())
+    {
+        autoExposureAdjustement(&image, m_settings.black, m_settings.expositionMain);
+    }
+    else
+    {
+        autoExposureAdjustement(&m_refImage, m_settings.black, m_settings.expositionMain);
+    }
+
+    WBFilter::preparePointFilter(image);
+}
+
 FilterAction AutoExpoFilter::filterAction()
 {
     return DefaultFilterAction<AutoExpoFilter>();
@@ -74,6 +74,11 @@ public:
 
     void                    readParameters(const FilterAction& action);
 
+    /** The exposure is computed from the input of the filter, unless a reference image is given.
+     */
+    virtual bool            needsInputPixels() const;
+    virtual void            preparePointFilter(const DImg& image);
+
 private:
 
     void filterImage();
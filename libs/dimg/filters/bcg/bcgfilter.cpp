@@ -111,6 +111,15 @@ BCGFilter::BCGFilter(DImg* const orgImage, QObject* const parent, const BCGConta
     initFilter();
 }
 
+BCGFilter::BCGFilter(const BCGContainer& settings, QObject* const parent)
+    : DImgThreadedFilter(parent, QLatin1String("BCGFilter")),
+      d(new Private)
+{
+    d->settings = settings;
+    reset();
+    initFilter();
+}
+
 BCGFilter::BCGFilter(const BCGContainer& settings, DImgThreadedFilter* const master,
                      const DImg& orgImage, const DImg& destImage, int progressBegin, int progressEnd)
     : DImgThreadedFilter(master, orgImage, destImage, progressBegin, progressEnd, QLatin1String("WBFilter")),
@@ -141,11 +150,21 @@ void BCGFilter::readParameters(const FilterAction& action)
 
 void BCGFilter::filterImage()
 {
+    DImgPointFilterChain chain(QList<DImgPointFilter*>() << this, this, m_orgImage, m_orgImage);
+    m_destImage = m_orgImage;
+}
+
+bool BCGFilter::mapsChannelsIndependently() const
+{
+    return true;
+}
+
+void BCGFilter::preparePointFilter(const DImg&)
+{
+    reset();
     setGamma(d->settings.gamma);
     setBrightness(d->settings.brightness);
     setContrast(d->settings.contrast);
-    applyBCG(m_orgImage);
-    m_destImage = m_orgImage;
 }
 
 void BCGFilter::setGamma(double val)
@@ -208,101 +227,68 @@ void BCGFilter::reset()
     }
 }
 
-void BCGFilter::applyBCG(DImg& image)
-{
-    if (image.isNull())
-    {
-        return;
-    }
-
-    applyBCG(image.bits(), image.width(), image.height(), image.sixteenBit());
-}
-
-void BCGFilter::applyBCG(uchar* const bits, uint width, uint height, bool sixteenBits)
+void BCGFilter::processPixels(uchar* const data, uint count, bool sixteenBit) const
 {
-    if (!bits)
-    {
-        return;
-    }
-
-    uint size = width * height;
-    int  progress;
-
-    if (!sixteenBits)                    // 8 bits image.
+    if (!sixteenBit)                    // 8 bits image.
     {
-        uchar* data = bits;
+        uchar* ptr = data;
 
-        for (uint i = 0; runningFlag() && (i < size); ++i)
+        for (uint i = 0; i < count; ++i)
         {
             switch (d->settings.channel)
             {
                 case BlueChannel:
-                    data[0] = CLAMP0255(d->map[data[0]]);
+                    ptr[0] = CLAMP0255(d->map[ptr[0]]);
                     break;
 
                 case GreenChannel:
-                    data[1] = CLAMP0255(d->map[data[1]]);
+                    ptr[1] = CLAMP0255(d->map[ptr[1]]);
                     break;
 
                 case RedChannel:
-                    data[2] = CLAMP0255(d->map[data[2]]);
+                    ptr[2] = CLAMP0255(d->map[ptr[2]]);
                     break;
 
                 default:      // all channels
-                    data[0] = CLAMP0255(d->map[data[0]]);
-                    data[1] = CLAMP0255(d->map[data[1]]);
-                    data[2] = CLAMP0255(d->map[data[2]]);
+                    ptr[0] = CLAMP0255(d->map[ptr[0]]);
+                    ptr[1] = CLAMP0255(d->map[ptr[1]]);
+                    ptr[2] = CLAMP0255(d->map[ptr[2]]);
                     break;
             }
 
-            data += 4;
-
-            progress = (int)(((double)i * 100.0) / size);
-
-            if (progress % 5 == 0)
-            {
-                postProgress(progress);
-            }
+            ptr += 4;
         }
     }
     else                                        // 16 bits image.
     {
-        ushort* data = reinterpret_cast<ushort*>(bits);
+        ushort* ptr = reinterpret_cast<ushort*>(data);
 
-        for (uint i = 0; runningFlag() && (i < size); ++i)
+        for (uint i = 0; i < count; ++i)
         {
             switch (d->settings.channel)
             {
                 case BlueChannel:
-                    data[0] = CLAMP065535(d->map16[data[0]]);
+                    ptr[0] = CLAMP065535(d->map16[ptr[0]]);
                     break;
 
                 case GreenChannel:
-                    data[1] = CLAMP065535(d->map16[data[1]]);
+                    ptr[1] = CLAMP065535(d->map16[ptr[1]]);
                     break;
 
                 case RedChannel:
-                    data[2] = CLAMP065535(d->map16[data[2]]);
+                    ptr[2] = CLAMP065535(d->map16[ptr[2]]);
                     break;
 
                 default:      // all channels
-                    data[0] = CLAMP065535(d->map16[data[0]]);
-                    data[1] = CLAMP065535(d->map16[data[1]]);
-                    data[2] = CLAMP065535(d->map16[data[2]]);
+                    ptr[0] = CLAMP065535(d->map16[ptr[0]]);
+                    ptr[1] = CLAMP065535(d->map16[ptr[1]]);
+                    ptr[2] = CLAMP065535(d->map16[ptr[2]]);
                     break;
             }
 
-            data += 4;
-
-            progress = (int)(((double)i * 100.0) / size);
-
-            if (progress % 5 == 0)
-            {
-                postProgress(progress);
-            }
+            ptr += 4;
         }
     }
-
 }
 
 }  // namespace Digikam
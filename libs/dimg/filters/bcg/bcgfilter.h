@@ -31,6 +31,7 @@
 #include "bcgcontainer.h"
 #include "digikam_export.h"
 #include "dimgthreadedfilter.h"
+#include "dimgpointfilter.h"
 #include "digikam_globals.h"
 
 namespace Digikam
@@ -38,13 +39,14 @@ namespace Digikam
 
 class DImg;
 
-class DIGIKAM_EXPORT BCGFilter : public DImgThreadedFilter
+class DIGIKAM_EXPORT BCGFilter : public DImgThreadedFilter, public DImgPointFilter
 {
 
 public:
 
     explicit BCGFilter(QObject* const parent=0);
     explicit BCGFilter(DImg* const orgImage, QObject* const parent=0, const BCGContainer& settings=BCGContainer());
+    explicit BCGFilter(const BCGContainer& settings, QObject* const parent=0);
     explicit BCGFilter(const BCGContainer& settings, DImgThreadedFilter* const master,
                        const DImg& orgImage, const DImg& destImage, int progressBegin=0, int progressEnd=100);
     virtual ~BCGFilter();
@@ -78,6 +80,10 @@ public:
 
     void                    readParameters(const FilterAction& action);
 
+    virtual bool            mapsChannelsIndependently() const;
+    virtual void            preparePointFilter(const DImg& image);
+    virtual void            processPixels(uchar* const data, uint count, bool sixteenBit) const;
+
 private:
 
     void filterImage();
@@ -86,8 +92,6 @@ private:
     void setGamma(double val);
     void setBrightness(double val);
     void setContrast(double val);
-    void applyBCG(DImg& image);
-    void applyBCG(uchar* const bits, uint width, uint height, bool sixteenBits);
 
 private:
 
@@ -0,0 +1,299 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-04-02
+ * Description : blur kernels with a cost independent of the radius,
+ *               shared by the blur based filters
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "blurkernels.h"
+
+// C++ includes
+
+#include <cmath>
+
+// Qt includes
+
+#include <QVarLengthArray>
+#include <QVector>
+#include <QtMath>
+
+namespace Digikam
+{
+
+class BoxBlur::Private
+{
+public:
+
+    explicit Private(const DImg& src, int radius)
+        : src(src),
+          width(src.width()),
+          height(src.height()),
+          radius(radius),
+          windowTop(0),
+          windowBottom(-1),
+          columns(src.width() * 4)
+    {
+    }
+
+    /// Adds (sign 1) or removes (sign -1) the source row y to the column sums
+    template <typename T>
+    void addRow(int y, int sign)
+    {
+        const T* src  = reinterpret_cast<const T*>(this->src.scanLine(y));
+        quint32* sums = columns.data();
+
+        if (sign > 0)
+        {
+            for (int i = 0 ; i < width * 4 ; ++i)
+            {
+                sums[i] += src[i];
+            }
+        }
+        else
+        {
+            for (int i = 0 ; i < width * 4 ; ++i)
+            {
+                sums[i] -= src[i];
+            }
+        }
+    }
+
+    void addRow(int y, int sign)
+    {
+        if (src.sixteenBit())
+        {
+            addRow<unsigned short>(y, sign);
+        }
+        else
+        {
+            addRow<uchar>(y, sign);
+        }
+    }
+
+    /// Writes the averages of the horizontal windows of the column sums, for windows of rows pixels high
+    template <typename T>
+    void blurRow(T* dest, int rows) const
+    {
+        const quint32* sums = columns.data();
+        quint64 b           = 0;
+        quint64 g           = 0;
+        quint64 r           = 0;
+        quint64 a           = 0;
+        const int first     = qMin(radius, width - 1);
+
+        for (int x = 0 ; x <= first ; ++x)
+        {
+            b += sums[4 * x];
+            g += sums[4 * x + 1];
+            r += sums[4 * x + 2];
+            a += sums[4 * x + 3];
+        }
+
+        for (int x = 0 ; x < width ; ++x)
+        {
+            const int     left   = qMax(x - radius, 0);
+            const int     right  = qMin(x + radius, width - 1);
+            const quint64 pixels = (quint64)(right - left + 1) * rows;
+
+            dest[0] = (T)(b / pixels);
+            dest[1] = (T)(g / pixels);
+            dest[2] = (T)(r / pixels);
+            dest[3] = (T)(a / pixels);
+            dest   += 4;
+
+            // Slide the window right.
+
+            if (x + radius + 1 < width)
+            {
+                const quint32* const in = sums + 4 * (x + radius + 1);
+                b += in[0];
+                g += in[1];
+                r += in[2];
+                a += in[3];
+            }
+
+            if (x - radius >= 0)
+            {
+                const quint32* const out = sums + 4 * (x - radius);
+                b -= out[0];
+                g -= out[1];
+                r -= out[2];
+                a -= out[3];
+            }
+        }
+    }
+
+public:
+
+    const DImg&      src;
+    const int        width;
+    const int        height;
+    const int        radius;
+
+    /// The rows of the vertical window in the column sums, from windowTop to windowBottom
+    int              windowTop;
+    int              windowBottom;
+
+    QVector<quint32> columns;
+};
+
+BoxBlur::BoxBlur(const DImg& src, int radius)
+    : d(new Private(src, radius))
+{
+}
+
+BoxBlur::~BoxBlur()
+{
+    delete d;
+}
+
+void BoxBlur::startAt(int y)
+{
+    d->columns.fill(0);
+    d->windowTop    = qMax(y - d->radius, 0);
+    d->windowBottom = qMin(y + d->radius, d->height - 1);
+
+    for (int yy = d->windowTop ; yy <= d->windowBottom ; ++yy)
+    {
+        d->addRow(yy, 1);
+    }
+}
+
+void BoxBlur::blurRow(int y, uchar* const dest)
+{
+    const int rows = d->windowBottom - d->windowTop + 1;
+
+    if (d->src.sixteenBit())
+    {
+        d->blurRow(reinterpret_cast<unsigned short*>(dest), rows);
+    }
+    else
+    {
+        d->blurRow(dest, rows);
+    }
+
+    // Slide the window down.
+
+    if (y + d->radius + 1 < d->height)
+    {
+        d->addRow(y + d->radius + 1, 1);
+        d->windowBottom = y + d->radius + 1;
+    }
+
+    if (y - d->radius >= 0)
+    {
+        d->addRow(y - d->radius, -1);
+        d->windowTop = y - d->radius + 1;
+    }
+}
+
+// --------------------------------------------------------------------------------------------------------------
+
+/// Keeps the values of the filter away from denormal floats, which are very slow to compute
+static const float denormalRemove = (float)(1e-15);
+
+/// Number of columns walked together: their values of a row fit in a few cache lines
+static const int   columnsPerBlock = 64;
+
+float RecursiveBlur::coefficient(float blur)
+{
+    if (blur < 0.3)
+    {
+        return 0.0;
+    }
+
+    float a = (float)(qExp(log(0.25) / blur));
+
+    if ((a <= 0.0) || (a >= 1.0))
+    {
+        return 0.0;
+    }
+
+    a *= a;
+
+    return a;
+}
+
+void RecursiveBlur::blurRow(float* const row, int sizex, float a)
+{
+    int   pos = 0;
+    float old = row[pos];
+    ++pos;
+
+    for (int x = 1 ; x < sizex ; ++x)
+    {
+        old      = (row[pos] * (1 - a) + old * a) + denormalRemove;
+        row[pos] = old;
+        ++pos;
+    }
+
+    pos = sizex - 1;
+
+    for (int x = 1 ; x < sizex ; ++x)
+    {
+        old      = (row[pos] * (1 - a) + old * a) + denormalRemove;
+        row[pos] = old;
+        pos--;
+    }
+}
+
+void RecursiveBlur::blurColumns(float* const data, int sizex, int sizey, float a, int start, int stop)
+{
+    QVarLengthArray<float, columnsPerBlock> old(columnsPerBlock);
+
+    for (int block = start ; block < stop ; block += columnsPerBlock)
+    {
+        const int count = qMin(stop - block, columnsPerBlock);
+        float*    line  = data + block;
+
+        for (int c = 0 ; c < count ; ++c)
+        {
+            old[c] = line[c];
+        }
+
+        // As the filter always did, the way down starts at the first row and ends before the last one.
+
+        for (int y = 1 ; y < sizey ; ++y)
+        {
+            for (int c = 0 ; c < count ; ++c)
+            {
+                old[c]  = (line[c] * (1 - a) + old[c] * a) + denormalRemove;
+                line[c] = old[c];
+            }
+
+            line += sizex;
+        }
+
+        // line is the last row: walk back up, from it.
+
+        for (int y = 1 ; y < sizey ; ++y)
+        {
+            for (int c = 0 ; c < count ; ++c)
+            {
+                old[c]  = (line[c] * (1 - a) + old[c] * a) + denormalRemove;
+                line[c] = old[c];
+            }
+
+            line -= sizex;
+        }
+    }
+}
+
+}  // namespace Digikam
@@ -0,0 +1,99 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-04-02
+ * Description : blur kernels with a cost independent of the radius,
+ *               shared by the blur based filters
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef BLURKERNELS_H
+#define BLURKERNELS_H
+
+// Local includes
+
+#include "digikam_export.h"
+#include "dimg.h"
+
+namespace Digikam
+{
+
+/**
+ * Box blur of a DImg, the average of the pixels in a square of (2 * radius + 1) pixels wide,
+ * clipped at the image borders. A column sum is kept for each pixel of the row, and the
+ * window slides down one row and right one pixel by adding and removing its edges: the cost
+ * per pixel does not depend on the radius.
+ *
+ * The rows of a band are blurred in order, from the row given to startAt(). Bands of rows
+ * are blurred in parallel with one instance each. The source must not be the destination.
+ */
+class DIGIKAM_EXPORT BoxBlur
+{
+public:
+
+    BoxBlur(const DImg& src, int radius);
+    ~BoxBlur();
+
+    /**
+     * Starts a band at row y: sums the columns of the window of this row.
+     */
+    void startAt(int y);
+
+    /**
+     * Writes the blurred row y, the next row of the band, to dest, and slides the window to the next row.
+     */
+    void blurRow(int y, uchar* const dest);
+
+private:
+
+    class Private;
+    Private* const d;
+};
+
+// --------------------------------------------------------------------------------------------------------------
+
+/**
+ * Recursive approximation of a Gaussian blur on a plane of floats, with a first order filter
+ * run forward then backward on each row and each column. The cost per pixel does not depend
+ * on the blur size. Rows and columns are independent, and can be blurred in parallel.
+ */
+class DIGIKAM_EXPORT RecursiveBlur
+{
+public:
+
+    /**
+     * Returns the filter coefficient of a blur of the given size,
+     * or 0 if the blur is too small to change the image.
+     */
+    static float coefficient(float blur);
+
+    /**
+     * Blurs the row of sizex values.
+     */
+    static void blurRow(float* const row, int sizex, float a);
+
+    /**
+     * Blurs the columns from start to stop - 1 of the plane of sizex by sizey values.
+     * The columns are walked together row by row, to read the plane in memory order.
+     */
+    static void blurColumns(float* const data, int sizex, int sizey, float a, int start, int stop);
+};
+
+}  // namespace Digikam
+
+#endif // BLURKERNELS_H
@@ -82,6 +82,15 @@ CBFilter::CBFilter(DImg* const orgImage, QObject* const parent, const CBContaine
     initFilter();
 }
 
+CBFilter::CBFilter(const CBContainer& settings, QObject* const parent)
+    : DImgThreadedFilter(parent, QLatin1String("CBFilter")),
+      d(new Private)
+{
+    d->settings = settings;
+    reset();
+    initFilter();
+}
+
 CBFilter::CBFilter(const CBContainer& settings, DImgThreadedFilter* const master,
             const DImg& orgImage, DImg& destImage, int progressBegin, int progressEnd)
     : DImgThreadedFilter(master, orgImage, destImage, progressBegin, progressEnd, QLatin1String("CBFilter")),
@@ -101,11 +110,22 @@ CBFilter::~CBFilter()
 
 void CBFilter::filterImage()
 {
-    setGamma(d->settings.gamma);
-    applyCBFilter(m_orgImage, d->settings.red, d->settings.green, d->settings.blue, d->settings.alpha);
+    DImgPointFilterChain chain(QList<DImgPointFilter*>() << this, this, m_orgImage, m_orgImage);
     m_destImage = m_orgImage;
 }
 
+bool CBFilter::mapsChannelsIndependently() const
+{
+    return true;
+}
+
+void CBFilter::preparePointFilter(const DImg& image)
+{
+    reset();
+    setGamma(d->settings.gamma);
+    adjustRGB(d->settings.red, d->settings.green, d->settings.blue, d->settings.alpha, image.sixteenBit());
+}
+
 void CBFilter::reset()
 {
     // initialize to linear mapping
@@ -229,58 +249,34 @@ void CBFilter::getTables(int* const redMap, int* const greenMap, int* const blue
     }
 }
 
-void CBFilter::applyCBFilter(DImg& image, double r, double g, double b, double a)
+void CBFilter::processPixels(uchar* const data, uint count, bool sixteenBit) const
 {
-    if (image.isNull())
+    if (!sixteenBit)                    // 8 bits image.
     {
-        return;
-    }
-
-    uint size = image.width() * image.height();
-    int  progress;
-
-    adjustRGB(r, g, b, a, image.sixteenBit());
+        uchar* ptr = data;
 
-    if (!image.sixteenBit())                    // 8 bits image.
-    {
-        uchar* data = (uchar*) image.bits();
-
-        for (uint i = 0; runningFlag() && (i < size); ++i)
+        for (uint i = 0; i < count; ++i)
         {
-            data[0] = d->blueMap[data[0]];
-            data[1] = d->greenMap[data[1]];
-            data[2] = d->redMap[data[2]];
-            data[3] = d->alphaMap[data[3]];
-
-            data += 4;
+            ptr[0] = d->blueMap[ptr[0]];
+            ptr[1] = d->greenMap[ptr[1]];
+            ptr[2] = d->redMap[ptr[2]];
+            ptr[3] = d->alphaMap[ptr[3]];
 
-            progress = (int)(((double)i * 100.0) / size);
-
-            if (progress % 5 == 0)
-            {
-                postProgress(progress);
-            }
+            ptr += 4;
         }
     }
     else                                        // 16 bits image.
     {
-        ushort* data = reinterpret_cast<ushort*>(image.bits());
+        ushort* ptr = reinterpret_cast<ushort*>(data);
 
-        for (uint i = 0; runningFlag() && (i < size); ++i)
+        for (uint i = 0; i < count; ++i)
         {
-            data[0] = d->blueMap16[data[0]];
-            data[1] = d->greenMap16[data[1]];
-            data[2] = d->redMap16[data[2]];
-            data[3] = d->alphaMap16[data[3]];
-
-            data += 4;
+            ptr[0] = d->blueMap16[ptr[0]];
+            ptr[1] = d->greenMap16[ptr[1]];
+            ptr[2] = d->redMap16[ptr[2]];
+            ptr[3] = d->alphaMap16[ptr[3]];
 
-            progress = (int)(((double)i * 100.0) / size);
-
-            if (progress % 5 == 0)
-            {
-                postProgress(progress);
-            }
+            ptr += 4;
         }
     }
 }
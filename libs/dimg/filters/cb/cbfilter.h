@@ -29,6 +29,7 @@
 
 #include "digikam_export.h"
 #include "dimgthreadedfilter.h"
+#include "dimgpointfilter.h"
 #include "digikam_globals.h"
 
 namespace Digikam
@@ -63,13 +64,14 @@ public:
 
 // -----------------------------------------------------------------------------------------------
 
-class DIGIKAM_EXPORT CBFilter : public DImgThreadedFilter
+class DIGIKAM_EXPORT CBFilter : public DImgThreadedFilter, public DImgPointFilter
 {
 
 public:
 
     explicit CBFilter(QObject* const parent = 0);
     explicit CBFilter(DImg* const orgImage, QObject* const parent=0, const CBContainer& settings=CBContainer());
+    explicit CBFilter(const CBContainer& settings, QObject* const parent=0);
     explicit CBFilter(const CBContainer& settings, DImgThreadedFilter* const master,
                       const DImg& orgImage, DImg& destImage, int progressBegin=0, int progressEnd=100);
     virtual ~CBFilter();
@@ -103,6 +105,10 @@ public:
 
     virtual FilterAction    filterAction();
 
+    virtual bool            mapsChannelsIndependently() const;
+    virtual void            preparePointFilter(const DImg& image);
+    virtual void            processPixels(uchar* const data, uint count, bool sixteenBit) const;
+
 private:
 
     void filterImage();
@@ -112,7 +118,6 @@ private:
     void setTables(int* const redMap, int* const greenMap, int* const blueMap, int* const alphaMap, bool sixteenBit);
     void getTables(int* const redMap, int* const greenMap, int* const blueMap, int* const alphaMap, bool sixteenBit);
     void adjustRGB(double r, double g, double b, double a, bool sixteenBit);
-    void applyCBFilter(DImg& image, double r, double g, double b, double a);
 
 private:
 
@@ -33,13 +33,23 @@ namespace Digikam
 {
 
 CurvesFilter::CurvesFilter(QObject* const parent)
-    : DImgThreadedFilter(parent)
+    : DImgThreadedFilter(parent),
+      m_curves(false)
 {
     initFilter();
 }
 
 CurvesFilter::CurvesFilter(DImg* const orgImage, QObject* const parent, const CurvesContainer& settings)
-    : DImgThreadedFilter(orgImage, parent, QLatin1String("CurvesFilter"))
+    : DImgThreadedFilter(orgImage, parent, QLatin1String("CurvesFilter")),
+      m_curves(false)
+{
+    m_settings = settings;
+    initFilter();
+}
+
+CurvesFilter::CurvesFilter(const CurvesContainer& settings, QObject* const parent)
+    : DImgThreadedFilter(parent, QLatin1String("CurvesFilter")),
+      m_curves(false)
 {
     m_settings = settings;
     initFilter();
@@ -47,7 +57,8 @@ CurvesFilter::CurvesFilter(DImg* const orgImage, QObject* const parent, const Cu
 
 CurvesFilter::CurvesFilter(const CurvesContainer& settings, DImgThreadedFilter* const master,
                            const DImg& orgImage, DImg& destImage, int progressBegin, int progressEnd)
-    : DImgThreadedFilter(master, orgImage, destImage, progressBegin, progressEnd, QLatin1String("CurvesFilter"))
+    : DImgThreadedFilter(master, orgImage, destImage, progressBegin, progressEnd, QLatin1String("CurvesFilter")),
+      m_curves(false)
 {
     m_settings = settings;
 
@@ -63,28 +74,36 @@ CurvesFilter::~CurvesFilter()
 
 void CurvesFilter::filterImage()
 {
-    postProgress(0);
+    DImgPointFilterChain chain(QList<DImgPointFilter*>() << this, this, m_orgImage, m_destImage);
+}
 
+bool CurvesFilter::mapsChannelsIndependently() const
+{
+    return true;
+}
+
+void CurvesFilter::preparePointFilter(const DImg& image)
+{
     ImageCurves curves(m_settings);
 
-    if (m_orgImage.sixteenBit() != m_settings.sixteenBit)
+    if (image.sixteenBit() != m_settings.sixteenBit)
     {
-        ImageCurves depthCurve(m_orgImage.sixteenBit());
+        ImageCurves depthCurve(image.sixteenBit());
         depthCurve.fillFromOtherCurves(&curves);
         curves = depthCurve;
     }
 
-    qCDebug(DIGIKAM_DIMG_LOG) << "Image 16 bits: " << m_orgImage.sixteenBit();
+    qCDebug(DIGIKAM_DIMG_LOG) << "Image 16 bits: " << image.sixteenBit();
     qCDebug(DIGIKAM_DIMG_LOG) << "Curve 16 bits: " << curves.isSixteenBits();
 
-    postProgress(50);
-
     // Process all channels curves
     curves.curvesLutSetup(AlphaChannel);
-    postProgress(75);
+    m_curves = curves;
+}
 
-    curves.curvesLutProcess(m_orgImage.bits(), m_destImage.bits(), m_orgImage.width(), m_orgImage.height());
-    postProgress(100);
+void CurvesFilter::processPixels(uchar* const data, uint count, bool) const
+{
+    m_curves.curvesLutProcess(data, data, count, 1);
 }
 
 FilterAction CurvesFilter::filterAction()
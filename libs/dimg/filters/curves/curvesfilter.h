@@ -33,6 +33,7 @@
 
 #include "digikam_export.h"
 #include "dimgthreadedfilter.h"
+#include "dimgpointfilter.h"
 #include "digikam_globals.h"
 #include "imagecurves.h"
 
@@ -41,13 +42,14 @@ namespace Digikam
 
 class DImg;
 
-class DIGIKAM_EXPORT CurvesFilter : public DImgThreadedFilter
+class DIGIKAM_EXPORT CurvesFilter : public DImgThreadedFilter, public DImgPointFilter
 {
 
 public:
 
     explicit CurvesFilter(QObject* const parent = 0);
     explicit CurvesFilter(DImg* const orgImage, QObject* const parent=0, const CurvesContainer& settings=CurvesContainer());
+    explicit CurvesFilter(const CurvesContainer& settings, QObject* const parent=0);
     explicit CurvesFilter(const CurvesContainer& settings, DImgThreadedFilter* const master,
                           const DImg& orgImage, DImg& destImage, int progressBegin=0, int progressEnd=100);
     virtual ~CurvesFilter();
@@ -80,6 +82,10 @@ public:
     virtual FilterAction    filterAction();
     void                    readParameters(const FilterAction& action);
 
+    virtual bool            mapsChannelsIndependently() const;
+    virtual void            preparePointFilter(const DImg& image);
+    virtual void            processPixels(uchar* const data, uint count, bool sixteenBit) const;
+
 private:
 
     void filterImage();
@@ -87,6 +93,7 @@ private:
 private:
 
     CurvesContainer m_settings;
+    ImageCurves     m_curves;
 };
 
 } // namespace Digikam
@@ -648,7 +648,7 @@ void ImageCurves::curvesLutSetup(int nchannels)
     }
 }
 
-void ImageCurves::curvesLutProcess(uchar* const srcPR, uchar* const destPR, int w, int h)
+void ImageCurves::curvesLutProcess(uchar* const srcPR, uchar* const destPR, int w, int h) const
 {
     unsigned short* lut0 = NULL, *lut1 = NULL, *lut2 = NULL, *lut3 = NULL;
     int i;
@@ -95,7 +95,7 @@ public:
     void   curvesCalculateAllCurves();
     float  curvesLutFunc(int n_channels, int channel, float value);
     void   curvesLutSetup(int nchannels);
-    void   curvesLutProcess(uchar* const srcPR, uchar* const destPR, int w, int h);
+    void   curvesLutProcess(uchar* const srcPR, uchar* const destPR, int w, int h) const;
 
     // Methods for to set manually the curves values.
 
@@ -0,0 +1,349 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-03-26
+ * Description : point operation filters, applied together
+ *               in one pass over the image
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "dimgpointfilter.h"
+
+// C++ includes
+
+#include <cstring>
+
+// Qt includes
+
+#include <QByteArray>
+#include <QtConcurrent>
+
+// Local includes
+
+#include "digikam_debug.h"
+
+namespace Digikam
+{
+
+DImgPointFilter::~DImgPointFilter()
+{
+}
+
+bool DImgPointFilter::needsInputPixels() const
+{
+    return false;
+}
+
+bool DImgPointFilter::mapsChannelsIndependently() const
+{
+    return false;
+}
+
+// --------------------------------------------------------------------------------------
+
+class DImgPointFilterChain::Stage
+{
+public:
+
+    Stage()
+        : filter(0)
+    {
+    }
+
+    /// The filter of this stage, or 0 if the stage applies the lookup table
+    const DImgPointFilter* filter;
+
+    /// Lookup table of fused filters: the result of the filters for each channel value, as pixels.
+    QByteArray             lut;
+};
+
+class DImgPointFilterChain::Private
+{
+public:
+
+    enum
+    {
+        /// Pixels processed by all stages at once: 32 KB in 16 bits, to stay in the CPU cache
+        BlockPixels = 4096,
+
+        /// Progress steps of a pass
+        Bands       = 20
+    };
+
+public:
+
+    Private()
+        : src(0),
+          dst(0),
+          sixteenBit(false)
+    {
+    }
+
+    QList<DImgPointFilter*> filters;
+
+    /// Input and output of the current pass
+    const uchar*            src;
+    uchar*                  dst;
+    bool                    sixteenBit;
+};
+
+// --------------------------------------------------------------------------------------
+
+static void applyLookupTable(const QByteArray& lut, const uchar* src, uchar* dst, uint count, bool sixteenBit)
+{
+    if (!sixteenBit)        // 8 bits image.
+    {
+        const uchar* const table = reinterpret_cast<const uchar*>(lut.constData());
+
+        for (uint i = 0 ; i < count ; ++i)
+        {
+            dst[0] = table[4 * src[0]];
+            dst[1] = table[4 * src[1] + 1];
+            dst[2] = table[4 * src[2] + 2];
+            dst[3] = table[4 * src[3] + 3];
+            src   += 4;
+            dst   += 4;
+        }
+    }
+    else                    // 16 bits image.
+    {
+        const unsigned short* const table = reinterpret_cast<const unsigned short*>(lut.constData());
+        const unsigned short* sptr        = reinterpret_cast<const unsigned short*>(src);
+        unsigned short* dptr              = reinterpret_cast<unsigned short*>(dst);
+
+        for (uint i = 0 ; i < count ; ++i)
+        {
+            dptr[0] = table[4 * sptr[0]];
+            dptr[1] = table[4 * sptr[1] + 1];
+            dptr[2] = table[4 * sptr[2] + 2];
+            dptr[3] = table[4 * sptr[3] + 3];
+            sptr   += 4;
+            dptr   += 4;
+        }
+    }
+}
+
+static QByteArray identityLookupTable(bool sixteenBit)
+{
+    const int  values = sixteenBit ? 65536 : 256;
+    QByteArray lut(values * (sixteenBit ? 8 : 4), 0);
+
+    if (!sixteenBit)        // 8 bits image.
+    {
+        uchar* ptr = reinterpret_cast<uchar*>(lut.data());
+
+        for (int i = 0 ; i < values ; ++i)
+        {
+            ptr[0] = i;
+            ptr[1] = i;
+            ptr[2] = i;
+            ptr[3] = i;
+            ptr   += 4;
+        }
+    }
+    else                    // 16 bits image.
+    {
+        unsigned short* ptr = reinterpret_cast<unsigned short*>(lut.data());
+
+        for (int i = 0 ; i < values ; ++i)
+        {
+            ptr[0] = i;
+            ptr[1] = i;
+            ptr[2] = i;
+            ptr[3] = i;
+            ptr   += 4;
+        }
+    }
+
+    return lut;
+}
+
+// --------------------------------------------------------------------------------------
+
+DImgPointFilterChain::DImgPointFilterChain(const QList<DImgPointFilter*>& filters, DImgThreadedFilter* const master,
+                                           const DImg& orgImage, const DImg& destImage,
+                                           int progressBegin, int progressEnd)
+    : DImgThreadedFilter(master, orgImage, destImage, progressBegin, progressEnd, QLatin1String("DImgPointFilterChain")),
+      d(new Private)
+{
+    d->filters = filters;
+    initFilter();
+}
+
+DImgPointFilterChain::~DImgPointFilterChain()
+{
+    cancelFilter();
+    delete d;
+}
+
+DImgPointFilter* DImgPointFilterChain::pointFilter(DImgThreadedFilter* const filter)
+{
+    return dynamic_cast<DImgPointFilter*>(filter);
+}
+
+void DImgPointFilterChain::prepareDestImage()
+{
+    // Keep the destination given to the constructor, which can share the data of the original image.
+    if (m_destImage.isNull()                               ||
+        m_destImage.width()      != m_orgImage.width()     ||
+        m_destImage.height()     != m_orgImage.height()    ||
+        m_destImage.sixteenBit() != m_orgImage.sixteenBit())
+    {
+        DImgThreadedFilter::prepareDestImage();
+    }
+}
+
+void DImgPointFilterChain::filterImage()
+{
+    d->sixteenBit         = m_orgImage.sixteenBit();
+    const uint numPixels  = m_orgImage.numPixels();
+
+    // A filter reading its input pixels to be set up starts a new pass over the image.
+
+    QList<QList<DImgPointFilter*> > passes;
+
+    foreach (DImgPointFilter* const filter, d->filters)
+    {
+        if (!filter)
+        {
+            continue;
+        }
+
+        if (passes.isEmpty() || filter->needsInputPixels())
+        {
+            passes << QList<DImgPointFilter*>();
+        }
+
+        passes.last() << filter;
+    }
+
+    if (passes.isEmpty())
+    {
+        if (m_destImage.bits() != m_orgImage.bits())
+        {
+            memcpy(m_destImage.bits(), m_orgImage.bits(), m_orgImage.numBytes());
+        }
+
+        return;
+    }
+
+    postProgress(0);
+
+    for (int pass = 0 ; runningFlag() && (pass < passes.size()) ; ++pass)
+    {
+        // The next passes work on the result of the previous ones.
+        const DImg& input = (pass == 0) ? m_orgImage : m_destImage;
+        d->src            = input.bits();
+        d->dst            = m_destImage.bits();
+
+        QList<Stage*> stages;
+
+        foreach (DImgPointFilter* const filter, passes.at(pass))
+        {
+            filter->preparePointFilter(input);
+
+            if (!filter->mapsChannelsIndependently())
+            {
+                Stage* const stage = new Stage;
+                stage->filter      = filter;
+                stages << stage;
+                continue;
+            }
+
+            if (stages.isEmpty() || stages.last()->filter)
+            {
+                Stage* const stage = new Stage;
+                stage->lut         = identityLookupTable(d->sixteenBit);
+                stages << stage;
+            }
+
+            // The lookup table holds one pixel per channel value: the filter maps it as any other pixels,
+            // and the result is the composition of the fused filters.
+            QByteArray& lut = stages.last()->lut;
+            filter->processPixels(reinterpret_cast<uchar*>(lut.data()), lut.size() / (d->sixteenBit ? 8 : 4), d->sixteenBit);
+        }
+
+        qCDebug(DIGIKAM_DIMG_LOG) << "Point filters pass" << pass << ":" << passes.at(pass).size()
+                                  << "filters in" << stages.size() << "stages";
+
+        // Each band of the image is shared between the CPU cores.
+
+        for (int band = 0 ; runningFlag() && (band < Private::Bands) ; ++band)
+        {
+            const uint start = (uint)((qulonglong)numPixels * band       / Private::Bands);
+            const uint stop  = (uint)((qulonglong)numPixels * (band + 1) / Private::Bands);
+            QList<int> vals  = multithreadedSteps(stop - start);
+            QList <QFuture<void> > tasks;
+
+            for (int j = 0 ; runningFlag() && (j < vals.count()-1) ; ++j)
+            {
+                tasks.append(QtConcurrent::run(this,
+                                               &DImgPointFilterChain::processPixels,
+                                               stages,
+                                               start + vals[j],
+                                               start + vals[j+1]
+                                              ));
+            }
+
+            foreach(QFuture<void> t, tasks)
+                t.waitForFinished();
+
+            // The whole rows done can leave memory if the images are out-of-core.
+            releaseRows(start / m_orgImage.width(), stop / m_orgImage.width());
+
+            postProgress((int)(((pass * Private::Bands + band + 1) * 100.0) / (passes.size() * Private::Bands)));
+        }
+
+        qDeleteAll(stages);
+    }
+}
+
+void DImgPointFilterChain::processPixels(const QList<Stage*>& stages, uint start, uint stop)
+{
+    const size_t bytesDepth = d->sixteenBit ? 8 : 4;
+
+    for (uint block = start ; block < stop ; block += Private::BlockPixels)
+    {
+        const uint   count = qMin(stop - block, (uint)Private::BlockPixels);
+        const uchar* src   = d->src + block * bytesDepth;
+        uchar* const dst   = d->dst + block * bytesDepth;
+
+        // The first stage reads the input pixels, the next ones work in place on the block.
+        for (int i = 0 ; i < stages.size() ; ++i)
+        {
+            const uchar* const in = (i == 0) ? src : dst;
+            const Stage* const stage = stages.at(i);
+
+            if (stage->filter)
+            {
+                if (in != dst)
+                {
+                    memcpy(dst, in, count * bytesDepth);
+                }
+
+                stage->filter->processPixels(dst, count, d->sixteenBit);
+            }
+            else
+            {
+                applyLookupTable(stage->lut, in, dst, count, d->sixteenBit);
+            }
+        }
+    }
+}
+
+}  // namespace Digikam
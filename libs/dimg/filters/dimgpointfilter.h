@@ -0,0 +1,141 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-03-26
+ * Description : point operation filters, applied together
+ *               in one pass over the image
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIMGPOINTFILTER_H
+#define DIMGPOINTFILTER_H
+
+// Qt includes
+
+#include <QList>
+
+// Local includes
+
+#include "digikam_export.h"
+#include "dimgthreadedfilter.h"
+
+namespace Digikam
+{
+
+/**
+ * Interface of the filters computing each pixel from the pixel value only, as BCGFilter,
+ * CurvesFilter or HSLFilter. A sequence of such filters is applied with DImgPointFilterChain,
+ * in one pass over the image, and a filter alone uses the same chain in its filterImage().
+ */
+class DIGIKAM_EXPORT DImgPointFilter
+{
+public:
+
+    virtual ~DImgPointFilter();
+
+    /**
+     * Returns true if preparePointFilter() reads the pixels of the image.
+     * The chain then starts a new pass with this filter, so that it gets its real input.
+     */
+    virtual bool needsInputPixels() const;
+
+    /**
+     * Returns true if each channel of the result only depends on the same channel of the pixel.
+     * The chain then fuses the filter with its neighbours of the same kind into one lookup table.
+     */
+    virtual bool mapsChannelsIndependently() const;
+
+    /**
+     * Prepares the filter before processPixels() is called. The image is the input of the filter
+     * if needsInputPixels() returns true, otherwise only its depth is relevant.
+     */
+    virtual void preparePointFilter(const DImg& image) = 0;
+
+    /**
+     * Changes count pixels in place. This is called in parallel on separate pixels.
+     */
+    virtual void processPixels(uchar* const data, uint count, bool sixteenBit) const = 0;
+};
+
+// --------------------------------------------------------------------------------------
+
+/**
+ * Applies a sequence of point filters in one pass over the image: the image is processed
+ * by blocks of pixels small enough to stay in the CPU cache while all filters run on them,
+ * and the blocks are processed in parallel. The filters which map channels independently
+ * are composed into one lookup table beforehand.
+ *
+ * The chain does not take the ownership of the filters. The filter actions are the ones
+ * of the filters, see DImgThreadedFilter::filterAction().
+ */
+class DIGIKAM_EXPORT DImgPointFilterChain : public DImgThreadedFilter
+{
+
+public:
+
+    /**
+     * Constructs the chain as slave of master (which can be null) and applies it at once
+     * if the master is set. orgImage and destImage can share the same data to process
+     * the image in place.
+     */
+    explicit DImgPointFilterChain(const QList<DImgPointFilter*>& filters, DImgThreadedFilter* const master,
+                                  const DImg& orgImage, const DImg& destImage,
+                                  int progressBegin=0, int progressEnd=100);
+    ~DImgPointFilterChain();
+
+    /**
+     * Returns the point filter interface of the filter, or 0 if it is not a point filter.
+     */
+    static DImgPointFilter* pointFilter(DImgThreadedFilter* const filter);
+
+    /**
+     * These methods do not make sense here. Use the actions of the filters.
+     */
+    virtual FilterAction filterAction()
+    {
+        return FilterAction();
+    }
+
+    virtual void readParameters(const FilterAction&)
+    {
+    }
+
+    virtual QString filterIdentifier() const
+    {
+        return QString();
+    }
+
+protected:
+
+    virtual void prepareDestImage();
+    virtual void filterImage();
+
+private:
+
+    class Stage;
+    void processPixels(const QList<Stage*>& stages, uint start, uint stop);
+
+private:
+
+    class Private;
+    Private* const d;
+};
+
+}  // namespace Digikam
+
+#endif /* DIMGPOINTFILTER_H */
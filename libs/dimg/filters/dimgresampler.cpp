@@ -0,0 +1,433 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-04-06
+ * Description : resampling of whole rows of a DImg at arbitrary
+ *               positions, for the geometric filters
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "dimgresampler.h"
+
+// C++ includes
+
+#include <cmath>
+#include <limits>
+
+// Qt includes
+
+#include <QVarLengthArray>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#   include <emmintrin.h>
+#   define RESAMPLER_SSE2
+#endif
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "dimgthreadedfilter.h"
+#include "dimgtilescheduler.h"
+
+namespace Digikam
+{
+
+/// Positions of a row transformed at once, small enough to stay in the L1 cache
+static const int positionsPerChunk = 1024;
+
+/** The bilinear weights are fixed point: 7 bits for 8 bits images, so that the products of the
+ *  SSE2 kernel fit in signed 16 bits lanes, and 16 bits for 16 bits images.
+ */
+template <typename T>
+class ResampleTraits;
+
+template <>
+class ResampleTraits<uchar>
+{
+public:
+
+    typedef quint32 Accumulator;
+    enum { WeightBits = 7 };
+};
+
+template <>
+class ResampleTraits<unsigned short>
+{
+public:
+
+    typedef quint64 Accumulator;
+    enum { WeightBits = 16 };
+};
+
+// --------------------------------------------------------------------------------------------------------------
+
+template <typename T>
+static inline const T* pixelAt(const T* const data, int width, int x, int y)
+{
+    return data + ((size_t)y * width + x) * 4;
+}
+
+template <typename T>
+static inline void sampleNearest(const T* const data, int width, int height, float x, float y, T* const dest)
+{
+    const T* const src = pixelAt(data, width,
+                                 qBound(0, (int)::floorf(x + 0.5f), width  - 1),
+                                 qBound(0, (int)::floorf(y + 0.5f), height - 1));
+
+    dest[0] = src[0];
+    dest[1] = src[1];
+    dest[2] = src[2];
+    dest[3] = src[3];
+}
+
+template <typename T>
+static inline void sampleBilinear(const T* const data, int width, int height, float x, float y, T* const dest)
+{
+    typedef typename ResampleTraits<T>::Accumulator Accumulator;
+
+    const int         bits = ResampleTraits<T>::WeightBits;
+    const Accumulator one  = (Accumulator)1 << bits;
+    const float       fx   = ::floorf(x);
+    const float       fy   = ::floorf(y);
+    const Accumulator wx   = (Accumulator)((x - fx) * one);
+    const Accumulator wy   = (Accumulator)((y - fy) * one);
+    const int         x0   = qMax((int)fx, 0);
+    const int         x1   = qMin((int)fx + 1, width  - 1);
+    const int         y0   = qMax((int)fy, 0);
+    const int         y1   = qMin((int)fy + 1, height - 1);
+
+    const T* const p00     = pixelAt(data, width, x0, y0);
+    const T* const p10     = pixelAt(data, width, x1, y0);
+    const T* const p01     = pixelAt(data, width, x0, y1);
+    const T* const p11     = pixelAt(data, width, x1, y1);
+
+    for (int c = 0 ; c < 4 ; ++c)
+    {
+        const Accumulator top    = p00[c] * (one - wx) + p10[c] * wx;
+        const Accumulator bottom = p01[c] * (one - wx) + p11[c] * wx;
+
+        dest[c] = (T)((top * (one - wy) + bottom * wy + (one * one / 2)) >> (2 * bits));
+    }
+}
+
+#ifdef RESAMPLER_SSE2
+
+/** The 4 channels of the pixel are interpolated at once, with the same integer operations
+ *  as the scalar kernel: the result is exactly the same.
+ */
+static inline void sampleBilinear(const uchar* const data, int width, int height, float x, float y, uchar* const dest)
+{
+    const float fx = ::floorf(x);
+    const float fy = ::floorf(y);
+    const int   x0 = (int)fx;
+    const int   y0 = (int)fy;
+
+    if ((x0 < 0) || (y0 < 0) || (x0 + 1 >= width) || (y0 + 1 >= height))
+    {
+        sampleBilinear<uchar>(data, width, height, x, y, dest);
+        return;
+    }
+
+    const int      one  = 1 << ResampleTraits<uchar>::WeightBits;
+    const int      wx   = (int)((x - fx) * one);
+    const int      wy   = (int)((y - fy) * one);
+    const uchar*   p0   = pixelAt(data, width, x0, y0);
+    const uchar*   p1   = p0 + (size_t)width * 4;
+    const __m128i  zero = _mm_setzero_si128();
+
+    // The 2 pixels of each row, interleaved by channel: b0 b1 g0 g1 r0 r1 a0 a1, in 16 bits lanes.
+
+    __m128i top    = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p0));
+    __m128i bottom = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p1));
+    top            = _mm_unpacklo_epi8(_mm_unpacklo_epi8(top,    _mm_srli_si128(top,    4)), zero);
+    bottom         = _mm_unpacklo_epi8(_mm_unpacklo_epi8(bottom, _mm_srli_si128(bottom, 4)), zero);
+
+    // Horizontal interpolation, at most 255 << 7 in 32 bits lanes.
+
+    const __m128i weightsX = _mm_set1_epi32((wx << 16) | (one - wx));
+    top                    = _mm_madd_epi16(top,    weightsX);
+    bottom                 = _mm_madd_epi16(bottom, weightsX);
+
+    // Vertical interpolation, on the top and bottom values interleaved by channel in 16 bits lanes.
+
+    const __m128i packed   = _mm_packs_epi32(top, bottom);
+    const __m128i weightsY = _mm_set1_epi32((wy << 16) | (one - wy));
+    __m128i pixel          = _mm_madd_epi16(_mm_unpacklo_epi16(packed, _mm_unpackhi_epi64(packed, packed)), weightsY);
+    pixel                  = _mm_srli_epi32(_mm_add_epi32(pixel, _mm_set1_epi32(one * one / 2)),
+                                            2 * ResampleTraits<uchar>::WeightBits);
+    pixel                  = _mm_packus_epi16(_mm_packs_epi32(pixel, zero), zero);
+
+    *reinterpret_cast<int*>(dest) = _mm_cvtsi128_si32(pixel);
+}
+
+#endif // RESAMPLER_SSE2
+
+/// Weights of the Catmull-Rom spline at distance t of the second of 4 samples
+static inline void cubicWeights(float t, float* const w)
+{
+    const float t2 = t * t;
+    const float t3 = t2 * t;
+
+    w[0]           = -0.5f * t3 +        t2 - 0.5f * t;
+    w[1]           =  1.5f * t3 - 2.5f * t2 + 1.0f;
+    w[2]           = -1.5f * t3 + 2.0f * t2 + 0.5f * t;
+    w[3]           =  0.5f * t3 - 0.5f * t2;
+}
+
+template <typename T>
+static inline void sampleBicubic(const T* const data, int width, int height, float x, float y, T* const dest)
+{
+    const float fx  = ::floorf(x);
+    const float fy  = ::floorf(y);
+    const float max = (float)std::numeric_limits<T>::max();
+    float       wx[4];
+    float       wy[4];
+    int         xs[4];
+    float       sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+    cubicWeights(x - fx, wx);
+    cubicWeights(y - fy, wy);
+
+    for (int i = 0 ; i < 4 ; ++i)
+    {
+        xs[i] = qBound(0, (int)fx - 1 + i, width - 1);
+    }
+
+    for (int j = 0 ; j < 4 ; ++j)
+    {
+        const int yy   = qBound(0, (int)fy - 1 + j, height - 1);
+        float row[4]   = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+        for (int i = 0 ; i < 4 ; ++i)
+        {
+            const T* const src = pixelAt(data, width, xs[i], yy);
+
+            for (int c = 0 ; c < 4 ; ++c)
+            {
+                row[c] += wx[i] * src[c];
+            }
+        }
+
+        for (int c = 0 ; c < 4 ; ++c)
+        {
+            sum[c] += wy[j] * row[c];
+        }
+    }
+
+    // The spline overshoots around sharp edges.
+
+    for (int c = 0 ; c < 4 ; ++c)
+    {
+        dest[c] = (T)qBound(0.0f, sum[c] + 0.5f, max);
+    }
+}
+
+/// Samples a row, with the kernel of the interpolation and of the channel type chosen at compile time
+template <typename T, int interpolation>
+static void resampleRowKernel(const uchar* const bits, int width, int height,
+                              const float* coords, int count, uchar* const dest)
+{
+    const T* const data   = reinterpret_cast<const T*>(bits);
+    T*             dptr   = reinterpret_cast<T*>(dest);
+    const float    right  = width  - 0.5f;
+    const float    bottom = height - 0.5f;
+
+    for (int i = 0 ; i < count ; ++i, coords += 2, dptr += 4)
+    {
+        const float x = coords[0];
+        const float y = coords[1];
+
+        // Written this way, the test rejects NaN positions too.
+
+        if (!((x >= -0.5f) && (x < right) && (y >= -0.5f) && (y < bottom)))
+        {
+            continue;
+        }
+
+        switch (interpolation)
+        {
+            case DImgResampler::NearestNeighbor:
+                sampleNearest(data, width, height, x, y, dptr);
+                break;
+
+            case DImgResampler::Bilinear:
+                sampleBilinear(data, width, height, x, y, dptr);
+                break;
+
+            default:
+                sampleBicubic(data, width, height, x, y, dptr);
+                break;
+        }
+    }
+}
+
+typedef void (*ResampleRowKernel)(const uchar* const bits, int width, int height,
+                                  const float* coords, int count, uchar* const dest);
+
+template <typename T>
+static ResampleRowKernel selectRowKernel(DImgResampler::Interpolation interpolation)
+{
+    switch (interpolation)
+    {
+        case DImgResampler::NearestNeighbor:
+            return &resampleRowKernel<T, DImgResampler::NearestNeighbor>;
+
+        case DImgResampler::Bilinear:
+            return &resampleRowKernel<T, DImgResampler::Bilinear>;
+
+        default:
+            return &resampleRowKernel<T, DImgResampler::Bicubic>;
+    }
+}
+
+// --------------------------------------------------------------------------------------------------------------
+
+/// The rows of a destination image transformed in tiles
+class ResampleTiles : public DImgTileScheduler
+{
+public:
+
+    ResampleTiles(const DImgResampler* const resampler, DImg& dest, const QTransform& destToSrc,
+                  DImgThreadedFilter* const filter)
+        : DImgTileScheduler(filter),
+          m_resampler(resampler),
+          m_dest(dest),
+          m_destToSrc(destToSrc)
+    {
+    }
+
+protected:
+
+    void processTile(uint start, uint stop)
+    {
+        for (uint y = start ; y < stop ; ++y)
+        {
+            m_resampler->transformRow(m_destToSrc, 0, y, m_dest.width(), m_dest.scanLine(y));
+        }
+    }
+
+private:
+
+    const DImgResampler* const m_resampler;
+    DImg&                      m_dest;
+    const QTransform           m_destToSrc;
+};
+
+// --------------------------------------------------------------------------------------------------------------
+
+class DImgResampler::Private
+{
+public:
+
+    explicit Private(const DImg& src)
+        : src(src),
+          width(src.width()),
+          height(src.height()),
+          kernel(0)
+    {
+    }
+
+public:
+
+    const DImg        src;
+    const int         width;
+    const int         height;
+
+    ResampleRowKernel kernel;
+};
+
+DImgResampler::DImgResampler(const DImg& src, Interpolation interpolation)
+    : d(new Private(src))
+{
+    if (src.sixteenBit())
+    {
+        d->kernel = selectRowKernel<unsigned short>(interpolation);
+    }
+    else
+    {
+        d->kernel = selectRowKernel<uchar>(interpolation);
+    }
+}
+
+DImgResampler::~DImgResampler()
+{
+    delete d;
+}
+
+void DImgResampler::resampleRow(const float* const coords, int count, uchar* const dest) const
+{
+    if (d->src.isNull() || (count <= 0))
+    {
+        return;
+    }
+
+    d->kernel(d->src.bits(), d->width, d->height, coords, count, dest);
+}
+
+void DImgResampler::transformRow(const QTransform& destToSrc, int x, int y, int count, uchar* const dest) const
+{
+    if (d->src.isNull() || (count <= 0))
+    {
+        return;
+    }
+
+    const bool projective = (destToSrc.type() == QTransform::TxProject);
+    const int  bytesDepth = d->src.bytesDepth();
+    QVarLengthArray<float, 2 * positionsPerChunk> coords(2 * qMin(count, positionsPerChunk));
+
+    // Positions are computed in double, then sampled by chunks.
+
+    for (int done = 0 ; done < count ; done += positionsPerChunk)
+    {
+        const int chunk = qMin(count - done, positionsPerChunk);
+        float*    pos   = coords.data();
+
+        for (int i = 0 ; i < chunk ; ++i, pos += 2)
+        {
+            const double dx = x + done + i;
+            double       sx = destToSrc.m11() * dx + destToSrc.m21() * y + destToSrc.m31();
+            double       sy = destToSrc.m12() * dx + destToSrc.m22() * y + destToSrc.m32();
+
+            if (projective)
+            {
+                const double w = destToSrc.m13() * dx + destToSrc.m23() * y + destToSrc.m33();
+                sx            /= w;
+                sy            /= w;
+            }
+
+            pos[0] = (float)sx;
+            pos[1] = (float)sy;
+        }
+
+        d->kernel(d->src.bits(), d->width, d->height, coords.constData(), chunk, dest + (size_t)done * bytesDepth);
+    }
+}
+
+bool DImgResampler::transform(DImg& dest, const QTransform& destToSrc, DImgThreadedFilter* const filter,
+                              int progressBegin, int progressEnd) const
+{
+    if (d->src.isNull() || dest.isNull() || (dest.sixteenBit() != d->src.sixteenBit()))
+    {
+        qCWarning(DIGIKAM_DIMG_LOG) << "Cannot resample an image to an image of another depth";
+        return false;
+    }
+
+    return ResampleTiles(this, dest, destToSrc, filter).run(0, dest.height(), progressBegin, progressEnd);
+}
+
+}  // namespace Digikam
@@ -0,0 +1,98 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-04-06
+ * Description : resampling of whole rows of a DImg at arbitrary
+ *               positions, for the geometric filters
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIMGRESAMPLER_H
+#define DIMGRESAMPLER_H
+
+// Qt includes
+
+#include <QTransform>
+
+// Local includes
+
+#include "digikam_export.h"
+#include "dimg.h"
+
+namespace Digikam
+{
+
+class DImgThreadedFilter;
+
+/**
+ * Samples a DImg at arbitrary positions, for the rotation, shear and lens filters. Whole
+ * destination rows are produced at once, from a map of source positions or through a
+ * transform, instead of one DColor per pixel. The kernels are templates on the channel
+ * type, selected once for the depth of the image, and the bilinear kernel of 8 bits images
+ * works on the 4 channels at once with SSE2 when the build targets it.
+ *
+ * Pixel centers are at integer positions. A destination pixel is written only if its source
+ * position falls on the source image, from -0.5 to width - 0.5 and height - 0.5: the other
+ * pixels keep the background of the destination. The neighbors of the positions near the
+ * borders are taken from the border.
+ */
+class DIGIKAM_EXPORT DImgResampler
+{
+public:
+
+    enum Interpolation
+    {
+        NearestNeighbor = 0,
+        Bilinear,
+        Bicubic
+    };
+
+public:
+
+    explicit DImgResampler(const DImg& src, Interpolation interpolation = Bilinear);
+    ~DImgResampler();
+
+    /**
+     * Samples count pixels to dest, pixels of the depth of the source, at the source
+     * positions given by coords as pairs of x and y.
+     */
+    void resampleRow(const float* const coords, int count, uchar* const dest) const;
+
+    /**
+     * Samples the pixels from x to x + count - 1 of the destination row y to dest, at
+     * their positions mapped to the source by destToSrc.
+     */
+    void transformRow(const QTransform& destToSrc, int x, int y, int count, uchar* const dest) const;
+
+    /**
+     * Samples all the rows of dest, of the depth of the source, through destToSrc. Rows are
+     * shared in tiles between the threads of the filter, which gives the cancellation and
+     * the progress, from progressBegin to progressEnd. Returns false if the filter was cancelled.
+     */
+    bool transform(DImg& dest, const QTransform& destToSrc, DImgThreadedFilter* const filter,
+                   int progressBegin = 0, int progressEnd = 100) const;
+
+private:
+
+    class Private;
+    Private* const d;
+};
+
+}  // namespace Digikam
+
+#endif // DIMGRESAMPLER_H
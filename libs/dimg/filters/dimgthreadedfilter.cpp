@@ -253,6 +253,21 @@ void DImgThreadedFilter::postProgress(int progr)
     }
 }
 
+void DImgThreadedFilter::releaseRows(int start, int stop) const
+{
+    if (stop <= start)
+    {
+        return;
+    }
+
+    m_orgImage.releaseRows(start, stop - start);
+
+    if (m_destImage.bits() != m_orgImage.bits())
+    {
+        m_destImage.releaseRows(start, stop - start);
+    }
+}
+
 void DImgThreadedFilter::setSlave(DImgThreadedFilter* const slave)
 {
     m_slave = slave;
@@ -95,6 +95,7 @@ public:
      *  To be sure that all vlaues will be processed, in case of CPU core division give rest, the last step compensate
      *  the difference.
      *  See Blur filter loop implementation for exemple to see how to use this method with QtConcurrents API.
+     *  When the cost of the rows is uneven, prefer DImgTileScheduler, which balances small tiles between the threads.
      */
     QList<int> multithreadedSteps(int stop, int start=0) const;
 
@@ -186,6 +187,12 @@ protected:
      */
     void postProgress(int progress);
 
+    /** For filters working by bands of rows: hint that the rows from start to stop - 1
+        of the original and destination images will not be used soon.
+        The rows of out-of-core images leave memory, see DImg::releaseRows().
+     */
+    void releaseRows(int start, int stop) const;
+
 protected:
 
     /**
@@ -293,6 +300,8 @@ protected:
     /** The master of this slave filter. Progress info will be routed to this one.
      */
     DImgThreadedFilter* m_master;
+
+    friend class DImgTileScheduler;
 };
 
 }  // namespace Digikam
@@ -0,0 +1,166 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-04-04
+ * Description : dynamic scheduling of the rows of a threaded filter
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "dimgtilescheduler.h"
+
+// Qt includes
+
+#include <QAtomicInt>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+// Local includes
+
+#include "dimgthreadedfilter.h"
+
+namespace Digikam
+{
+
+/// Number of tiles given to each thread when the tile size is not set
+static const uint tilesPerThread = 16;
+
+class DImgTileScheduler::Private
+{
+public:
+
+    explicit Private(DImgThreadedFilter* const filter)
+        : filter(filter),
+          start(0),
+          stop(0),
+          chunk(1),
+          done(0),
+          progressBegin(0),
+          progressEnd(100),
+          lastProgress(0)
+    {
+    }
+
+public:
+
+    DImgThreadedFilter* const filter;
+
+    uint                      start;
+    uint                      stop;
+    uint                      chunk;
+
+    /// Offset from start of the next tile to take
+    QAtomicInt                next;
+
+    QMutex                    lock;
+    quint64                   done;
+    int                       progressBegin;
+    int                       progressEnd;
+    int                       lastProgress;
+};
+
+DImgTileScheduler::DImgTileScheduler(DImgThreadedFilter* const filter)
+    : d(new Private(filter))
+{
+}
+
+DImgTileScheduler::~DImgTileScheduler()
+{
+    delete d;
+}
+
+bool DImgTileScheduler::run(uint start, uint stop, int progressBegin, int progressEnd, uint chunk)
+{
+    if (stop <= start)
+    {
+        return d->filter->runningFlag();
+    }
+
+    const uint count   = stop - start;
+    const uint threads = qMax(QThreadPool::globalInstance()->maxThreadCount(), 1);
+
+    if (chunk == 0)
+    {
+        chunk = qMax(count / (threads * tilesPerThread), 1U);
+    }
+
+    d->start         = start;
+    d->stop          = stop;
+    d->chunk         = chunk;
+    d->done          = 0;
+    d->progressBegin = progressBegin;
+    d->progressEnd   = progressEnd;
+    d->lastProgress  = progressBegin;
+    d->next.store(0);
+
+    // No more threads than tiles. The calling thread is one of them: the tiles are done
+    // even if the pool is busy with other work.
+
+    const uint tiles   = (count - 1) / chunk + 1;
+    const uint workers = qMin(threads, tiles);
+    QList <QFuture<void> > tasks;
+
+    for (uint i = 1 ; d->filter->runningFlag() && (i < workers) ; ++i)
+    {
+        tasks.append(QtConcurrent::run(this,
+                                       &DImgTileScheduler::work
+                                      ));
+    }
+
+    work();
+
+    foreach(QFuture<void> t, tasks)
+        t.waitForFinished();
+
+    return d->filter->runningFlag();
+}
+
+void DImgTileScheduler::work()
+{
+    while (d->filter->runningFlag())
+    {
+        const uint offset = (uint)d->next.fetchAndAddOrdered((int)d->chunk);
+
+        if (offset >= d->stop - d->start)
+        {
+            return;
+        }
+
+        const uint first = d->start + offset;
+        const uint last  = d->start + qMin(offset + d->chunk, d->stop - d->start);
+
+        processTile(first, last);
+
+        // Tiles are done out of order: only the count of done items makes the progress.
+
+        QMutexLocker locker(&d->lock);
+
+        d->done            += last - first;
+        const int progress  = d->progressBegin +
+                              (int)((qint64)(d->progressEnd - d->progressBegin) * (qint64)d->done / (qint64)(d->stop - d->start));
+
+        if (progress > d->lastProgress)
+        {
+            d->lastProgress = progress;
+            d->filter->postProgress(progress);
+        }
+    }
+}
+
+}  // namespace Digikam
@@ -0,0 +1,121 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-04-04
+ * Description : dynamic scheduling of the rows of a threaded filter
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIMGTILESCHEDULER_H
+#define DIMGTILESCHEDULER_H
+
+// Qt includes
+
+#include <QtGlobal>
+
+// Local includes
+
+#include "digikam_export.h"
+
+namespace Digikam
+{
+
+class DImgThreadedFilter;
+
+/**
+ * Runs a threaded filter over a range of rows, or of any other independent items, cut in
+ * small tiles. Contrary to multithreadedSteps(), which gives one band of the same size to
+ * each core, the threads take the next tile as soon as they are done with the previous one:
+ * a thread working on an expensive part of the image does not hold back the others.
+ *
+ * The calling thread works on tiles too. Threads stop taking tiles as soon as the filter
+ * is cancelled. The progress of the filter is posted as the tiles are done, over the given
+ * progress span, and modulated for slave filters as usual.
+ *
+ * Filters opt in with DImgTileFunction, calling one of their methods for each tile:
+ *
+ *     DImgTileFunction<MyFilter>(this, &MyFilter::filterRows).run(0, m_orgImage.height(), 0, 100);
+ */
+class DIGIKAM_EXPORT DImgTileScheduler
+{
+public:
+
+    explicit DImgTileScheduler(DImgThreadedFilter* const filter);
+    virtual ~DImgTileScheduler();
+
+    /**
+     * Processes the items from start to stop - 1 in tiles of chunk items, and returns
+     * once all tiles are done. If chunk is 0, a size giving about 16 tiles per thread is used.
+     * Progress goes from progressBegin to progressEnd. Returns false if the filter was cancelled.
+     */
+    bool run(uint start, uint stop, int progressBegin = 0, int progressEnd = 100, uint chunk = 0);
+
+protected:
+
+    /**
+     * Processes the items from start to stop - 1. Called concurrently for different tiles.
+     */
+    virtual void processTile(uint start, uint stop) = 0;
+
+private:
+
+    void work();
+
+private:
+
+    class Private;
+    Private* const d;
+};
+
+// --------------------------------------------------------------------------------------------------------------
+
+/**
+ * Tile scheduler calling a method of the filter for each tile.
+ */
+template <class Filter>
+class DImgTileFunction : public DImgTileScheduler
+{
+public:
+
+    typedef void (Filter::*Method)(uint start, uint stop);
+
+public:
+
+    DImgTileFunction(Filter* const filter, Method method)
+        : DImgTileScheduler(filter),
+          m_filter(filter),
+          m_method(method)
+    {
+    }
+
+protected:
+
+    void processTile(uint start, uint stop)
+    {
+        (m_filter->*m_method)(start, stop);
+    }
+
+private:
+
+    Filter* const m_filter;
+    const Method  m_method;
+};
+
+}  // namespace Digikam
+
+#endif // DIMGTILESCHEDULER_H
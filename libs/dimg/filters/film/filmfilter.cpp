@@ -353,29 +353,24 @@ FilmFilter::~FilmFilter()
 
 void FilmFilter::filterImage()
 {
-    DImg tmpLevel;
-    DImg tmpGamma;
-    DImg tmpInv;
-
-    LevelsContainer l = d->film.toLevels();
-    CBContainer cb  = d->film.toCB();
-    CBContainer gamma;
-
     // level the image first, this removes the orange mask and corrects
     // colors according to the density ranges of the film profile
-    LevelsFilter(l, this, m_orgImage, tmpLevel, 0, 40);
+    LevelsFilter levels(d->film.toLevels());
 
     // in case of a linear raw scan, gamma needs to be
     // applied after leveling the image, otherwise the image will
     // look too bright. The standard value is 2.2, but 1.8 is also
     // frequently found in literature
+    CBContainer gamma;
     gamma.gamma = d->film.gamma();
-    CBFilter(gamma, this, tmpLevel, tmpGamma, 40, 80);
+    CBFilter cb(gamma);
 
     // invert the image to have a positive image
-    InvertFilter(this, tmpGamma, tmpInv, 80, 100);
+    InvertFilter invert;
+
+    // The three filters are applied in one pass over the image
+    DImgPointFilterChain chain(QList<DImgPointFilter*>() << &levels << &cb << &invert, this, m_orgImage, m_destImage);
 
-    m_destImage = tmpInv;
     postProgress(100);
 }
 
@@ -38,6 +38,7 @@
 #include "digikam_export.h"
 #include "dimgbuiltinfilter.h"
 #include "dimgfiltermanager.h"
+#include "dimgpointfilter.h"
 #include "filteraction.h"
 
 namespace Digikam
@@ -58,6 +59,9 @@ public:
     QList<FilterAction> appliedActions;
 
     QString             errorMessage;
+
+    /// Consecutive point filters, applied together before the next action
+    QList<DImgThreadedFilter*> pointFilters;
 };
 
 FilterActionFilter::FilterActionFilter(QObject* const parent)
@@ -69,6 +73,7 @@ FilterActionFilter::FilterActionFilter(QObject* const parent)
 
 FilterActionFilter::~FilterActionFilter()
 {
+    qDeleteAll(d->pointFilters);
     delete d;
 }
 
@@ -178,6 +183,7 @@ void FilterActionFilter::filterImage()
     d->errorMessage.clear();
     const float progressIncrement = 1.0 / qMax(1, d->actions.size());
     float progress                = 0;
+    float pointFiltersProgress    = 0;
 
     postProgress(0);
 
@@ -210,6 +216,7 @@ void FilterActionFilter::filterImage()
                 }
             }
 
+            applyPointFilters(img, (int)pointFiltersProgress, (int)progress);
             filter.apply(img);
             d->appliedActions << filter.filterAction();
         }
@@ -248,17 +255,61 @@ void FilterActionFilter::filterImage()
                 }
             }
 
-            // compute
-            filter->setupAndStartDirectly(img, this, (int)progress, (int)(progress + progressIncrement));
-            img = filter->getTargetImage();
-            d->appliedActions << filter->filterAction();
+            if (DImgPointFilterChain::pointFilter(filter.data()))
+            {
+                // computed with the next point filters
+                if (d->pointFilters.isEmpty())
+                {
+                    pointFiltersProgress = progress;
+                }
+
+                d->pointFilters << filter.take();
+            }
+            else
+            {
+                applyPointFilters(img, (int)pointFiltersProgress, (int)progress);
+
+                // compute
+                filter->setupAndStartDirectly(img, this, (int)progress, (int)(progress + progressIncrement));
+                img = filter->getTargetImage();
+                d->appliedActions << filter->filterAction();
+            }
         }
 
         progress += progressIncrement;
         postProgress((int)progress);
     }
 
+    applyPointFilters(img, (int)pointFiltersProgress, (int)progress);
+
     m_destImage = img;
 }
 
+void FilterActionFilter::applyPointFilters(DImg& img, int progressBegin, int progressEnd)
+{
+    if (d->pointFilters.isEmpty())
+    {
+        return;
+    }
+
+    QList<DImgPointFilter*> filters;
+
+    foreach (DImgThreadedFilter* const filter, d->pointFilters)
+    {
+        filters << DImgPointFilterChain::pointFilter(filter);
+    }
+
+    DImgPointFilterChain chain(filters, this, img, DImg(), progressBegin, progressEnd);
+    img = chain.getTargetImage();
+
+    // Each filter keeps its own entry in the history
+    foreach (DImgThreadedFilter* const filter, d->pointFilters)
+    {
+        d->appliedActions << filter->filterAction();
+    }
+
+    qDeleteAll(d->pointFilters);
+    d->pointFilters.clear();
+}
+
 } // namespace Digikam
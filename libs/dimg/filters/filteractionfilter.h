@@ -126,6 +126,13 @@ protected:
 
     virtual void filterImage();
 
+private:
+
+    /**
+     * Applies the pending point filters to img in one pass, and records their actions.
+     */
+    void applyPointFilters(DImg& img, int progressBegin, int progressEnd);
+
 private:
 
     class Private;
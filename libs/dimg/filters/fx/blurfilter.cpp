@@ -34,6 +34,7 @@
 // Local includes
 
 #include "digikam_debug.h"
+#include "blurkernels.h"
 
 namespace Digikam
 {
@@ -51,6 +52,8 @@ public:
     int    radius;
     int    globalProgress;
 
+    DImg   source;
+
     QMutex lock;
 };
 
@@ -88,129 +91,15 @@ BlurFilter::~BlurFilter()
 
 void BlurFilter::blurMultithreaded(uint start, uint stop)
 {
-    bool sixteenBit  = m_orgImage.sixteenBit();
-    int  height      = m_orgImage.height();
-    int  width       = m_orgImage.width();
-    int  radius      = d->radius;
+    BoxBlur box(d->source, d->radius);
     int  oldProgress = 0;
     int  progress    = 0;
-    uint a, r, g, b;
-    int  mx;
-    int  my;
-    int  mw;
-    int  mh;
-    int  mt;
-    int* as = new int[width];
-    int* rs = new int[width];
-    int* gs = new int[width];
-    int* bs = new int[width];
+
+    box.startAt(start);
 
     for (uint y = start ; runningFlag() && (y < stop) ; ++y)
     {
-        my = y - radius;
-        mh = (radius << 1) + 1;
-
-        if (my < 0)
-        {
-            mh += my;
-            my = 0;
-        }
-
-        if ((my + mh) > height)
-        {
-            mh = height - my;
-        }
-
-        uchar* pDst8           = m_destImage.scanLine(y);
-        unsigned short* pDst16 = reinterpret_cast<unsigned short*>(m_destImage.scanLine(y));
-
-        memset(as, 0, width * sizeof(int));
-        memset(rs, 0, width * sizeof(int));
-        memset(gs, 0, width * sizeof(int));
-        memset(bs, 0, width * sizeof(int));
-
-        for (int yy = 0; yy < mh; yy++)
-        {
-            uchar* pSrc8           = m_orgImage.scanLine(yy + my);
-            unsigned short* pSrc16 = reinterpret_cast<unsigned short*>(m_orgImage.scanLine(yy + my));
-
-            for (int x = 0; x < width; x++)
-            {
-                if (sixteenBit)
-                {
-                    bs[x]  += pSrc16[0];
-                    gs[x]  += pSrc16[1];
-                    rs[x]  += pSrc16[2];
-                    as[x]  += pSrc16[3];
-                    pSrc16 += 4;
-                }
-                else
-                {
-                    bs[x] += pSrc8[0];
-                    gs[x] += pSrc8[1];
-                    rs[x] += pSrc8[2];
-                    as[x] += pSrc8[3];
-                    pSrc8 += 4;
-                }
-            }
-        }
-
-        if (width > ((radius << 1) + 1))
-        {
-            for (int x = 0; x < width; x++)
-            {
-                a  = r = g = b = 0;
-                mx = x - radius;
-                mw = (radius << 1) + 1;
-
-                if (mx < 0)
-                {
-                    mw += mx;
-                    mx = 0;
-                }
-
-                if ((mx + mw) > width)
-                {
-                    mw = width - mx;
-                }
-
-                mt = mw * mh;
-
-                for (int xx = mx; xx < (mw + mx); xx++)
-                {
-                    a += as[xx];
-                    r += rs[xx];
-                    g += gs[xx];
-                    b += bs[xx];
-                }
-
-                a = a / mt;
-                r = r / mt;
-                g = g / mt;
-                b = b / mt;
-
-                if (sixteenBit)
-                {
-                    pDst16[0] = b;
-                    pDst16[1] = g;
-                    pDst16[2] = r;
-                    pDst16[3] = a;
-                    pDst16   += 4;
-                }
-                else
-                {
-                    pDst8[0] = b;
-                    pDst8[1] = g;
-                    pDst8[2] = r;
-                    pDst8[3] = a;
-                    pDst8   += 4;
-                }
-            }
-        }
-        else
-        {
-            qCDebug(DIGIKAM_DIMG_LOG) << "Radius too small...";
-        }
+        box.blurRow(y, m_destImage.scanLine(y));
 
         progress = (int)( ( (double)y * (100.0 / QThreadPool::globalInstance()->maxThreadCount()) ) / (stop-start));
 
@@ -223,11 +112,6 @@ void BlurFilter::blurMultithreaded(uint start, uint stop)
             d->lock.unlock();
         }
     }
-
-    delete [] as;
-    delete [] rs;
-    delete [] gs;
-    delete [] bs;
 }
 
 void BlurFilter::filterImage()
@@ -239,6 +123,9 @@ void BlurFilter::filterImage()
         return;
     }
 
+    // The window of a row reads the rows around it: blur from a copy when working in place.
+    d->source = (m_orgImage.bits() == m_destImage.bits()) ? m_orgImage.copy() : m_orgImage;
+
     QList<int> vals = multithreadedSteps(m_orgImage.height());
     QList <QFuture<void> > tasks;
 
@@ -253,6 +140,8 @@ void BlurFilter::filterImage()
 
     foreach(QFuture<void> t, tasks)
         t.waitForFinished();
+
+    d->source = DImg();
 }
 
 FilterAction BlurFilter::filterAction()
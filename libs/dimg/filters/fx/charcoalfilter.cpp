@@ -31,14 +31,10 @@
 
 #include <cmath>
 
-// Qt includes
-
-#include <QtConcurrent>
-#include <QMutex>
-
 // Local includes
 
 #include "dimg.h"
+#include "dimgtilescheduler.h"
 #include "digikam_debug.h"
 #include "blurfilter.h"
 #include "stretchfilter.h"
@@ -54,16 +50,18 @@ public:
 
     Private()
     {
-        globalProgress = 0;
-        pencil         = 5.0;
-        smooth         = 10.0;
+        pencil        = 5.0;
+        smooth        = 10.0;
+        normal_kernel = 0;
+        kernelWidth   = 0.0;
     }
 
-    double pencil;
-    double smooth;
-    int    globalProgress;
+    double  pencil;
+    double  smooth;
 
-    QMutex lock;
+    /// The normalized kernel of the convolution in progress
+    double* normal_kernel;
+    double  kernelWidth;
 };
 
 CharcoalFilter::CharcoalFilter(QObject* const parent)
@@ -184,12 +182,15 @@ void CharcoalFilter::filterImage()
     }
 }
 
-void CharcoalFilter::convolveImageMultithreaded(uint start, uint stop, double* normal_kernel, double kernelWidth)
+void CharcoalFilter::convolveImageMultithreaded(uint start, uint stop)
 {
-    int     mx, my, sx, sy, mcx, mcy, oldProgress=0, progress=0;
+    int     mx, my, sx, sy, mcx, mcy;
     double  red, green, blue, alpha;
     double* k = 0;
 
+    double* normal_kernel = d->normal_kernel;
+    double  kernelWidth   = d->kernelWidth;
+
     uint height     = m_destImage.height();
     uint width      = m_destImage.width();
     bool sixteenBit = m_destImage.sixteenBit();
@@ -235,17 +236,6 @@ void CharcoalFilter::convolveImageMultithreaded(uint start, uint stop, double* n
                          (int)(blue / 257UL), (int)(alpha / 257UL), sixteenBit);
             color.setPixel((ddata + x * ddepth + (width * y * ddepth)));
         }
-
-        progress = (int)( ( (double)y * (80.0 / QThreadPool::globalInstance()->maxThreadCount()) ) / (stop-start));
-
-        if ((progress % 5 == 0) && (progress > oldProgress))
-        {
-            d->lock.lock();
-            oldProgress       = progress;
-            d->globalProgress += 5;
-            postProgress(d->globalProgress);
-            d->lock.unlock();
-        }
     }
 }
 
@@ -290,22 +280,12 @@ bool CharcoalFilter::convolveImage(const unsigned int order, const double* kerne
 
     // --------------------------------------------------------
 
-    QList<int> vals = multithreadedSteps(m_orgImage.height());
-    QList <QFuture<void> > tasks;
+    d->normal_kernel = normal_kernel.data();
+    d->kernelWidth   = kernelWidth;
 
-    for (int j = 0 ; runningFlag() && (j < vals.count()-1) ; ++j)
-    {
-        tasks.append(QtConcurrent::run(this,
-                                       &CharcoalFilter::convolveImageMultithreaded,
-                                       vals[j],
-                                       vals[j+1],
-                                       normal_kernel.data(),
-                                       kernelWidth
-                                      ));
-    }
+    DImgTileFunction<CharcoalFilter>(this, &CharcoalFilter::convolveImageMultithreaded).run(0, m_orgImage.height(), 0, 80);
 
-    foreach(QFuture<void> t, tasks)
-        t.waitForFinished();
+    d->normal_kernel = 0;
 
     return true;
 }
@@ -76,7 +76,7 @@ private:
     void filterImage();
     bool convolveImage(const unsigned int order, const double* kernel);
     int  getOptimalKernelWidth(double radius, double sigma);
-    void convolveImageMultithreaded(uint start, uint stop, double* normal_kernel, double kernelWidth);
+    void convolveImageMultithreaded(uint start, uint stop);
 
 private:
 
@@ -63,13 +63,25 @@ InvertFilter::~InvertFilter()
  */
 void InvertFilter::filterImage()
 {
-    m_destImage.putImageData(m_orgImage.bits());
+    DImgPointFilterChain chain(QList<DImgPointFilter*>() << this, this, m_orgImage, m_destImage);
+}
+
+bool InvertFilter::mapsChannelsIndependently() const
+{
+    return true;
+}
 
-    if (!m_destImage.sixteenBit())        // 8 bits image.
+void InvertFilter::preparePointFilter(const DImg&)
+{
+}
+
+void InvertFilter::processPixels(uchar* const data, uint count, bool sixteenBit) const
+{
+    if (!sixteenBit)        // 8 bits image.
     {
-        uchar* ptr = m_destImage.bits();
+        uchar* ptr = data;
 
-        for (uint i = 0 ; i < m_destImage.numPixels() ; ++i)
+        for (uint i = 0 ; i < count ; ++i)
         {
             ptr[0] = 255 - ptr[0];
             ptr[1] = 255 - ptr[1];
@@ -80,9 +92,9 @@ void InvertFilter::filterImage()
     }
     else               // 16 bits image.
     {
-        unsigned short* ptr = reinterpret_cast<unsigned short*>(m_destImage.bits());
+        unsigned short* ptr = reinterpret_cast<unsigned short*>(data);
 
-        for (uint i = 0 ; i < m_destImage.numPixels() ; ++i)
+        for (uint i = 0 ; i < count ; ++i)
         {
             ptr[0] = 65535 - ptr[0];
             ptr[1] = 65535 - ptr[1];
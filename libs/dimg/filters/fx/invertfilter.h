@@ -29,11 +29,12 @@
 
 #include "digikam_export.h"
 #include "dimgthreadedfilter.h"
+#include "dimgpointfilter.h"
 
 namespace Digikam
 {
 
-class DIGIKAM_EXPORT InvertFilter : public DImgThreadedFilter
+class DIGIKAM_EXPORT InvertFilter : public DImgThreadedFilter, public DImgPointFilter
 {
 
 public:
@@ -77,6 +78,10 @@ public:
 
     virtual FilterAction    filterAction();
 
+    virtual bool            mapsChannelsIndependently() const;
+    virtual void            preparePointFilter(const DImg& image);
+    virtual void            processPixels(uchar* const data, uint count, bool sixteenBit) const;
+
 private:
 
     void filterImage();
@@ -33,14 +33,10 @@
 #include <cmath>
 #include <cstdlib>
 
-// Qt includes
-
-#include <QtConcurrent>
-#include <QMutex>
-
 // Local includes
 
 #include "dimg.h"
+#include "dimgtilescheduler.h"
 
 namespace Digikam
 {
@@ -51,17 +47,12 @@ public:
 
     Private() :
         brushSize(1),
-        smoothness(30),
-        globalProgress(0)
+        smoothness(30)
     {
     }
 
     int    brushSize;
     int    smoothness;
-
-    int    globalProgress;
-
-    QMutex lock;
 };
 
 OilPaintFilter::OilPaintFilter(QObject* const parent)
@@ -105,7 +96,6 @@ void OilPaintFilter::oilPaintImageMultithreaded(uint start, uint stop)
     memset(averageColorG.data(),  0, sizeof(uint)*(d->smoothness + 1));
     memset(averageColorB.data(),  0, sizeof(uint)*(d->smoothness + 1));
 
-    int    oldProgress=0, progress=0;
     DColor mostFrequentColor;
 
     mostFrequentColor.setSixteenBit(m_orgImage.sixteenBit());
@@ -121,36 +111,14 @@ void OilPaintFilter::oilPaintImageMultithreaded(uint start, uint stop)
             dptr              = dest + w2 * m_orgImage.bytesDepth() + (m_orgImage.width() * h2 * m_orgImage.bytesDepth());
             mostFrequentColor.setPixel(dptr);
         }
-
-        progress = (int)( ( (double)h2 * (100.0 / QThreadPool::globalInstance()->maxThreadCount()) ) / (stop-start));
-
-        if ((progress % 5 == 0) && (progress > oldProgress))
-        {
-            d->lock.lock();
-            oldProgress       = progress;
-            d->globalProgress += 5;
-            postProgress(d->globalProgress);
-            d->lock.unlock();
-        }
     }
 }
 
 void OilPaintFilter::filterImage()
 {
-    QList<int> vals = multithreadedSteps(m_orgImage.height());
-    QList <QFuture<void> > tasks;
-
-    for (int j = 0 ; runningFlag() && (j < vals.count()-1) ; ++j)
-    {
-        tasks.append(QtConcurrent::run(this,
-                                       &OilPaintFilter::oilPaintImageMultithreaded,
-                                       vals[j],
-                                       vals[j+1]
-                                      ));
-    }
+    // Rows are shared between the threads in small tiles, and the progress is posted as they are done.
 
-    foreach(QFuture<void> t, tasks)
-        t.waitForFinished();
+    DImgTileFunction<OilPaintFilter>(this, &OilPaintFilter::oilPaintImageMultithreaded).run(0, m_orgImage.height());
 }
 
 /** Function to determine the most frequent color in a matrix
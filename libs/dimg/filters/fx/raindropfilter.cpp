@@ -37,11 +37,12 @@
 #include <QDateTime>
 #include <QRect>
 #include <QtMath>
-#include <QtConcurrent>
+#include <QThreadPool>
 
 // Local includes
 
 #include "dimg.h"
+#include "dimgtilescheduler.h"
 
 namespace Digikam
 {
@@ -65,6 +66,8 @@ public:
 
     QRect                 selection;
 
+    Args                  args;     // the drops in progress
+
     RandomNumberGenerator generator;
 
     QMutex                lock; // RandomNumberGenerator is not re-entrant (dixit Boost lib)
@@ -145,11 +148,11 @@ void RainDropFilter::filterImage()
     }
 }
 
-void RainDropFilter::rainDropsImageMultithreaded(const Args& prm)
+void RainDropFilter::rainDropsImageMultithreaded(uint start, uint stop)
 {
+    const Args& prm = d->args;
     int  nRandSize;
     int  nRandX, nRandY;
-    bool bResp      = false;
     int  nWidth     = prm.orgImage->width();
     int  nHeight    = prm.orgImage->height();
     bool sixteenBit = prm.orgImage->sixteenBit();
@@ -157,16 +160,23 @@ void RainDropFilter::rainDropsImageMultithreaded(const Args& prm)
     uchar* data     = prm.orgImage->bits();
     uchar* pResBits = prm.destImage->bits();
 
-    for (uint nCounter = prm.start ; runningFlag() && (bResp == false) && (nCounter < prm.stop) ; ++nCounter)
+    // Each item tries random places until one drop fits.
+
+    for (uint item = start ; runningFlag() && (item < stop) ; ++item)
     {
-        d->lock.lock();
-        nRandX    = d->generator.number(0, nWidth - 1);
-        nRandY    = d->generator.number(0, nHeight - 1);
-        nRandSize = d->generator.number(prm.MinDropSize, prm.MaxDropSize);
-        d->lock.unlock();
-        bResp     = CreateRainDrop(data, nWidth, nHeight, sixteenBit, bytesDepth,
-                                   pResBits, prm.pStatusBits,
-                                   nRandX, nRandY, nRandSize, prm.Coeff, prm.bLimitRange);
+        bool bResp = false;
+
+        for (uint nCounter = 0 ; runningFlag() && (bResp == false) && (nCounter < prm.attempts) ; ++nCounter)
+        {
+            d->lock.lock();
+            nRandX    = d->generator.number(0, nWidth - 1);
+            nRandY    = d->generator.number(0, nHeight - 1);
+            nRandSize = d->generator.number(prm.MinDropSize, prm.MaxDropSize);
+            d->lock.unlock();
+            bResp     = CreateRainDrop(data, nWidth, nHeight, sixteenBit, bytesDepth,
+                                       pResBits, prm.pStatusBits,
+                                       nRandX, nRandY, nRandSize, prm.Coeff, prm.bLimitRange);
+        }
     }
 }
 
@@ -213,11 +223,13 @@ void RainDropFilter::rainDropsImage(DImg* const orgImage, DImg* const destImage,
 
     destImage->bitBltImage(orgImage, 0, 0);
 
-    // Randomize.
+    // Randomize. Each item is a series of random attempts ending at the first drop, one series
+    // per band and per round as with the former rounds of bands, to keep the density of drops.
 
-    QList<int> vals = multithreadedSteps(10000);
+    const uint bands = qMax(QThreadPool::globalInstance()->maxThreadCount(), 1);
 
-    Args prm;
+    Args& prm       = d->args;
+    prm.attempts    = qMax(10000 / bands, 1U);
     prm.orgImage    = orgImage;
     prm.destImage   = destImage;
     prm.MinDropSize = MinDropSize;
@@ -226,27 +238,7 @@ void RainDropFilter::rainDropsImage(DImg* const orgImage, DImg* const destImage,
     prm.bLimitRange = bLimitRange;
     prm.pStatusBits = pStatusBits.data();
 
-    for (int i = 0; runningFlag() && (i < Amount); ++i)
-    {
-        QList <QFuture<void> > tasks;
-
-        for (int j = 0 ; runningFlag() && (j < vals.count()-1) ; ++j)
-        {
-            prm.start        = vals[j];
-            prm.stop         = vals[j+1];
-
-            tasks.append(QtConcurrent::run(this,
-                                           &RainDropFilter::rainDropsImageMultithreaded,
-                                           prm
-                                          ));
-        }
-
-        foreach(QFuture<void> t, tasks)
-            t.waitForFinished();
-
-        postProgress((int)(progressMin + ((double)(i) *
-                                          (double)(progressMax - progressMin)) / (double)Amount));
-    }
+    DImgTileFunction<RainDropFilter>(this, &RainDropFilter::rainDropsImageMultithreaded).run(0, Amount * bands, progressMin, progressMax);
 }
 
 bool RainDropFilter::CreateRainDrop(uchar* const pBits, int Width, int Height, bool sixteenBit, int bytesDepth,
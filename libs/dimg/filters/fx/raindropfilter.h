@@ -81,8 +81,7 @@ private:
 
     struct Args
     {
-        uint   start;
-        uint   stop;
+        uint   attempts;
         DImg*  orgImage;
         DImg*  destImage;
         int    MinDropSize;
@@ -99,7 +98,7 @@ private:
     void rainDropsImage(DImg* const orgImage, DImg* const destImage, int MinDropSize, int MaxDropSize,
                         int Amount, int Coeff, bool bLimitRange, int progressMin, int progressMax);
 
-    void rainDropsImageMultithreaded(const Args& prm);
+    void rainDropsImageMultithreaded(uint start, uint stop);
 
     bool CreateRainDrop(uchar* const pBits, int Width, int Height, bool sixteenBit, int bytesDepth,
                         uchar* const pResBits, uchar* const pStatusBits,
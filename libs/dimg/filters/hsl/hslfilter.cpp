@@ -79,6 +79,15 @@ HSLFilter::HSLFilter(DImg* const orgImage, QObject* const parent, const HSLConta
     initFilter();
 }
 
+HSLFilter::HSLFilter(const HSLContainer& settings, QObject* const parent)
+    : DImgThreadedFilter(parent, QLatin1String("HSLFilter")),
+      d(new Private)
+{
+    d->settings = settings;
+    reset();
+    initFilter();
+}
+
 HSLFilter::~HSLFilter()
 {
     cancelFilter();
@@ -86,12 +95,16 @@ HSLFilter::~HSLFilter()
 }
 
 void HSLFilter::filterImage()
+{
+    DImgPointFilterChain chain(QList<DImgPointFilter*>() << this, this, m_orgImage, m_orgImage);
+    m_destImage = m_orgImage;
+}
+
+void HSLFilter::preparePointFilter(const DImg&)
 {
     setHue(d->settings.hue);
     setSaturation(d->settings.saturation);
     setLightness(d->settings.lightness);
-    applyHSL(m_orgImage);
-    m_destImage = m_orgImage;
 }
 
 void HSLFilter::reset()
@@ -203,7 +216,7 @@ void HSLFilter::setLightness(double val)
     }
 }
 
-int HSLFilter::vibranceBias(double sat, double hue, double vib, bool sixteenbit)
+int HSLFilter::vibranceBias(double sat, double hue, double vib, bool sixteenbit) const
 {
     double ratio;
     int    localsat;
@@ -230,25 +243,17 @@ int HSLFilter::vibranceBias(double sat, double hue, double vib, bool sixteenbit)
     }
 }
 
-void HSLFilter::applyHSL(DImg& image)
+void HSLFilter::processPixels(uchar* const bits, uint count, bool sixteenBit) const
 {
-    if (image.isNull())
-    {
-        return;
-    }
-
-    bool   sixteenBit     = image.sixteenBit();
-    uint   numberOfPixels = image.numPixels();
-    int    progress;
     int    hue, sat, lig;
     double vib = d->settings.vibrance;
     DColor color;
 
     if (sixteenBit)                   // 16 bits image.
     {
-        unsigned short* data = reinterpret_cast<unsigned short*>(image.bits());
+        unsigned short* data = reinterpret_cast<unsigned short*>(bits);
 
-        for (uint i = 0; runningFlag() && (i < numberOfPixels); ++i)
+        for (uint i = 0; i < count; ++i)
         {
             color = DColor(data[2], data[1], data[0], 0, sixteenBit);
 
@@ -263,20 +268,13 @@ void HSLFilter::applyHSL(DImg& image)
             data[0] = color.blue();
 
             data += 4;
-
-            progress = (int)(((double)i * 100.0) / numberOfPixels);
-
-            if (progress % 5 == 0)
-            {
-                postProgress(progress);
-            }
         }
     }
     else                                      // 8 bits image.
     {
-        uchar* data = image.bits();
+        uchar* data = bits;
 
-        for (uint i = 0; runningFlag() && (i < numberOfPixels); ++i)
+        for (uint i = 0; i < count; ++i)
         {
             color = DColor(data[2], data[1], data[0], 0, sixteenBit);
 
@@ -291,13 +289,6 @@ void HSLFilter::applyHSL(DImg& image)
             data[0] = color.blue();
 
             data += 4;
-
-            progress = (int)(((double)i * 100.0) / numberOfPixels);
-
-            if (progress % 5 == 0)
-            {
-                postProgress(progress);
-            }
         }
     }
 }
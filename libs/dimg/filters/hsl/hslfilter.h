@@ -28,6 +28,7 @@
 
 #include "digikam_export.h"
 #include "dimgthreadedfilter.h"
+#include "dimgpointfilter.h"
 #include "digikam_globals.h"
 
 namespace Digikam
@@ -60,13 +61,14 @@ public:
 
 // -----------------------------------------------------------------------------------------------
 
-class DIGIKAM_EXPORT HSLFilter : public DImgThreadedFilter
+class DIGIKAM_EXPORT HSLFilter : public DImgThreadedFilter, public DImgPointFilter
 {
 
 public:
 
     explicit HSLFilter(QObject* const parent = 0);
     explicit HSLFilter(DImg* const orgImage, QObject* const parent=0, const HSLContainer& settings=HSLContainer());
+    explicit HSLFilter(const HSLContainer& settings, QObject* const parent=0);
     virtual ~HSLFilter();
 
     static QString          FilterIdentifier()
@@ -98,6 +100,9 @@ public:
 
     void                    readParameters(const FilterAction& action);
 
+    virtual void            preparePointFilter(const DImg& image);
+    virtual void            processPixels(uchar* const data, uint count, bool sixteenBit) const;
+
 private:
 
     void filterImage();
@@ -106,8 +111,7 @@ private:
     void setHue(double val);
     void setSaturation(double val);
     void setLightness(double val);
-    void applyHSL(DImg& image);
-    int  vibranceBias(double sat, double hue, double vib, bool sixteenbit);
+    int  vibranceBias(double sat, double hue, double vib, bool sixteenbit) const;
 
 private:
 
@@ -28,10 +28,19 @@
 
 // Qt includes
 
+#include <QCryptographicHash>
 #include <QDataStream>
 #include <QFile>
+#include <QFuture>
 #include <QImage>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPair>
+#include <QSharedPointer>
+#include <QThreadPool>
 #include <QVarLengthArray>
+#include <QtConcurrent>
 
 // KDE includes
 
@@ -57,6 +66,7 @@ public:
         intent         = INTENT_PERCEPTUAL;
         transformFlags = 0;
         proofIntent    = INTENT_ABSOLUTE_COLORIMETRIC;
+        alarmColor     = 0;
     }
 
     bool operator==(const TransformDescription& other) const
@@ -68,7 +78,8 @@ public:
                intent         == other.intent         &&
                transformFlags == other.transformFlags &&
                proofProfile   == other.proofProfile   &&
-               proofIntent    == other.proofIntent;
+               proofIntent    == other.proofIntent    &&
+               alarmColor     == other.alarmColor;
     }
 
 public:
@@ -81,8 +92,279 @@ public:
     int        transformFlags;
     IccProfile proofProfile;
     int        proofIntent;
+    QRgb       alarmColor;      // Gamut check color of proofing transforms
 };
 
+// --------------------------------------------------------------------------------------
+
+/**
+ * A compiled LittleCMS transform. It is created without the 1-pixel cache of LittleCMS,
+ * so that dkCmsDoTransform() can be called on it from several threads at once, without LcmsLock.
+ */
+class IccTransformHandle
+{
+public:
+
+    explicit IccTransformHandle(cmsHTRANSFORM handle)
+        : handle(handle)
+    {
+    }
+
+    ~IccTransformHandle()
+    {
+        LcmsLock lock;
+        dkCmsDeleteTransform(handle);
+    }
+
+public:
+
+    const cmsHTRANSFORM handle;
+};
+
+typedef QSharedPointer<IccTransformHandle> IccTransformHandlePtr;
+
+/**
+ * The transforms recently used by all IccTransform objects: the same conversions come back
+ * for each image, as to sRGB, to the monitor profile or to the working space, and creating
+ * a transform is expensive.
+ */
+class IccTransformCache
+{
+public:
+
+    enum
+    {
+        MaximumTransforms = 8
+    };
+
+public:
+
+    IccTransformHandlePtr transform(const TransformDescription& description, bool proofing)
+    {
+        QMutexLocker locker(&mutex);
+
+        const Key key(description);
+
+        for (int i = 0 ; i < transforms.size() ; ++i)
+        {
+            if (transforms.at(i).first == key)
+            {
+                transforms.move(i, 0);
+                return transforms.first().second;
+            }
+        }
+
+        cmsHTRANSFORM handle = 0;
+
+        {
+            LcmsLock lock;
+
+            if (proofing)
+            {
+                handle = dkCmsCreateProofingTransform(description.inputProfile,
+                                                      description.inputFormat,
+                                                      description.outputProfile,
+                                                      description.outputFormat,
+                                                      description.proofProfile,
+                                                      description.intent,
+                                                      description.proofIntent,
+                                                      description.transformFlags | cmsFLAGS_NOCACHE);
+            }
+            else
+            {
+                handle = dkCmsCreateTransform(description.inputProfile,
+                                              description.inputFormat,
+                                              description.outputProfile,
+                                              description.outputFormat,
+                                              description.intent,
+                                              description.transformFlags | cmsFLAGS_NOCACHE);
+            }
+        }
+
+        if (!handle)
+        {
+            return IccTransformHandlePtr();
+        }
+
+        // Evicted transforms are deleted when their last user has closed them.
+        transforms.prepend(qMakePair(key, IccTransformHandlePtr(new IccTransformHandle(handle))));
+
+        while (transforms.size() > MaximumTransforms)
+        {
+            transforms.removeLast();
+        }
+
+        return transforms.first().second;
+    }
+
+private:
+
+    /**
+     * Identifies a transform by the content of its profiles: IccProfile::operator==() only
+     * compares the file paths, and a profile file can be replaced on disk while digiKam runs.
+     */
+    class Key
+    {
+    public:
+
+        explicit Key(const TransformDescription& description)
+            : inputProfile(checksum(description.inputProfile)),
+              inputFormat(description.inputFormat),
+              outputProfile(checksum(description.outputProfile)),
+              outputFormat(description.outputFormat),
+              intent(description.intent),
+              transformFlags(description.transformFlags),
+              proofProfile(checksum(description.proofProfile)),
+              proofIntent(description.proofIntent),
+              alarmColor(description.alarmColor)
+        {
+        }
+
+        bool operator==(const Key& other) const
+        {
+            return inputProfile   == other.inputProfile   &&
+                   inputFormat    == other.inputFormat    &&
+                   outputProfile  == other.outputProfile  &&
+                   outputFormat   == other.outputFormat   &&
+                   intent         == other.intent         &&
+                   transformFlags == other.transformFlags &&
+                   proofProfile   == other.proofProfile   &&
+                   proofIntent    == other.proofIntent    &&
+                   alarmColor     == other.alarmColor;
+        }
+
+    private:
+
+        static QByteArray checksum(IccProfile profile)
+        {
+            if (profile.isNull())
+            {
+                return QByteArray();
+            }
+
+            return QCryptographicHash::hash(profile.data(), QCryptographicHash::Md5);
+        }
+
+    public:
+
+        QByteArray inputProfile;
+        int        inputFormat;
+        QByteArray outputProfile;
+        int        outputFormat;
+        int        intent;
+        int        transformFlags;
+        QByteArray proofProfile;
+        int        proofIntent;
+        QRgb       alarmColor;
+    };
+
+public:
+
+    QMutex                                  mutex;
+
+    /// Most recently used first
+    QList<QPair<Key, IccTransformHandlePtr> > transforms;
+};
+
+Q_GLOBAL_STATIC(IccTransformCache, transformCache)
+
+// --------------------------------------------------------------------------------------
+
+/** Transforms the pixels of a band of the image.
+ */
+class IccTransformBand
+{
+public:
+
+    IccTransformBand()
+        : handle(0),
+          bytesDepth(4),
+          pixelsPerStep(0),
+          inPlace(true)
+    {
+    }
+
+    void transform(uchar* data, int pixels) const
+    {
+        if (inPlace)
+        {
+            for (int p = pixels ; p > 0 ; p -= pixelsPerStep)
+            {
+                const int pixelsThisStep = qMin(p, pixelsPerStep);
+                dkCmsDoTransform(handle, data, data, pixelsThisStep);
+                data                    += pixelsThisStep * bytesDepth;
+            }
+        }
+        else
+        {
+            QVarLengthArray<uchar> buffer(pixelsPerStep * bytesDepth);
+
+            for (int p = pixels ; p > 0 ; p -= pixelsPerStep)
+            {
+                const int pixelsThisStep = qMin(p, pixelsPerStep);
+                const int size           = pixelsThisStep * bytesDepth;
+                memcpy(buffer.data(), data, size);
+                dkCmsDoTransform(handle, buffer.data(), data, pixelsThisStep);
+                data                    += size;
+            }
+        }
+    }
+
+public:
+
+    cmsHTRANSFORM handle;
+    int           bytesDepth;
+    int           pixelsPerStep;
+    bool          inPlace;
+};
+
+/** Transforms rows of the image, in bands processed in parallel.
+ */
+static void transformRows(const IccTransformBand& band, uchar* const data, int width, int rows)
+{
+    enum
+    {
+        /// Pixels below which a band is not worth a thread
+        MinimumPixelsPerBand = 128 * 1024
+    };
+
+    int threads = DImg::processingThreads();
+
+    if (threads <= 0)
+    {
+        threads = QThreadPool::globalInstance()->maxThreadCount();
+    }
+
+    const int pixels = width * rows;
+    const int bands  = qBound(1, pixels / MinimumPixelsPerBand, threads);
+
+    if (bands == 1)
+    {
+        band.transform(data, pixels);
+        return;
+    }
+
+    QList<QFuture<void> > tasks;
+
+    for (int i = 1 ; i < bands ; ++i)
+    {
+        const int begin = (int)((qlonglong)rows * i       / bands);
+        const int end   = (int)((qlonglong)rows * (i + 1) / bands);
+
+        tasks.append(QtConcurrent::run(&band,
+                                       &IccTransformBand::transform,
+                                       data + (qlonglong)begin * width * band.bytesDepth,
+                                       (end - begin) * width
+                                      ));
+    }
+
+    // The first band is transformed in the calling thread.
+    band.transform(data, (rows / bands) * width);
+
+    foreach(QFuture<void> t, tasks)
+        t.waitForFinished();
+}
+
 class IccTransform::Private : public QSharedData
 {
 public:
@@ -95,13 +377,11 @@ public:
         checkGamut      = false;
         doNotEmbed      = false;
         checkGamutColor = QColor(126, 255, 255);
-        handle          = 0;
     }
 
     Private(const Private& other)
         : QSharedData(other)
     {
-        handle = 0;
         operator=(other);
     }
 
@@ -123,8 +403,6 @@ public:
         builtinProfile     = other.builtinProfile;
 
         close();
-        handle             = 0;
-        currentDescription = TransformDescription();
 
         return *this;
     }
@@ -136,13 +414,8 @@ public:
 
     void close()
     {
-        if (handle)
-        {
-            currentDescription = TransformDescription();
-            LcmsLock lock;
-            dkCmsDeleteTransform(handle);
-            handle = 0;
-        }
+        currentDescription = TransformDescription();
+        handle.clear();
     }
 
     IccProfile& sRGB()
@@ -202,7 +475,7 @@ public:
     IccProfile                    proofProfile;
     IccProfile                    builtinProfile;
 
-    cmsHTRANSFORM                 handle;
+    IccTransformHandlePtr         handle;
     TransformDescription          currentDescription;
 };
 
@@ -506,6 +779,7 @@ TransformDescription IccTransform::getProofingDescription(const DImg& image)
     {
         dkCmsSetAlarmCodes(d->checkGamutColor.red(), d->checkGamutColor.green(), d->checkGamutColor.blue());
         description.transformFlags |= cmsFLAGS_GAMUTCHECK;
+        description.alarmColor      = d->checkGamutColor.rgb();
     }
 
     return description;
@@ -525,15 +799,7 @@ bool IccTransform::open(TransformDescription& description)
         }
     }
 
-    d->currentDescription = description;
-
-    LcmsLock lock;
-    d->handle = dkCmsCreateTransform(description.inputProfile,
-                                     description.inputFormat,
-                                     description.outputProfile,
-                                     description.outputFormat,
-                                     description.intent,
-                                     description.transformFlags);
+    d->handle = transformCache->transform(description, false);
 
     if (!d->handle)
     {
@@ -541,6 +807,8 @@ bool IccTransform::open(TransformDescription& description)
         return false;
     }
 
+    d->currentDescription = description;
+
     return true;
 }
 
@@ -558,17 +826,7 @@ bool IccTransform::openProofing(TransformDescription& description)
         }
     }
 
-    d->currentDescription = description;
-
-    LcmsLock lock;
-    d->handle = dkCmsCreateProofingTransform(description.inputProfile,
-                                             description.inputFormat,
-                                             description.outputProfile,
-                                             description.outputFormat,
-                                             description.proofProfile,
-                                             description.intent,
-                                             description.proofIntent,
-                                             description.transformFlags);
+    d->handle = transformCache->transform(description, true);
 
     if (!d->handle)
     {
@@ -576,6 +834,8 @@ bool IccTransform::openProofing(TransformDescription& description)
         return false;
     }
 
+    d->currentDescription = description;
+
     return true;
 }
 
@@ -696,78 +956,44 @@ bool IccTransform::apply(QImage& qimage)
 
 void IccTransform::transform(DImg& image, const TransformDescription& description, DImgLoaderObserver* const observer)
 {
-    const int bytesDepth    = image.bytesDepth();
-    const int pixels        = image.width() * image.height();
+    IccTransformBand band;
+    band.handle        = d->handle->handle;
+    band.bytesDepth    = image.bytesDepth();
     // convert ten scanlines in a batch
-    const int pixelsPerStep = image.width() * 10;
-    uchar* data             = image.bits();
-
-    // see dimgloader.cpp, granularity().
-    int granularity         = 1;
+    band.pixelsPerStep = image.width() * 10;
+    // it is safe to use the same input and output buffer if the format is the same
+    band.inPlace       = (description.inputFormat == description.outputFormat);
 
-    if (observer)
-    {
-        granularity = (int)((pixels / (20 * 0.9)) / observer->granularity());
-    }
+    const int width    = image.width();
+    const int height   = image.height();
+    uchar* const data  = image.bits();
 
-    int checkPoint = pixels;
+    // The progress is reported from this thread, between parts of the image.
+    const int parts    = observer ? 20 : 1;
 
-    // it is safe to use the same input and output buffer if the format is the same
-    if (description.inputFormat == description.outputFormat)
+    for (int part = 0 ; part < parts ; ++part)
     {
-        for (int p = pixels; p > 0; p -= pixelsPerStep)
-        {
-            int pixelsThisStep =  qMin(p, pixelsPerStep);
-            int size           =  pixelsThisStep * bytesDepth;
-            LcmsLock lock;
-            dkCmsDoTransform(d->handle, data, data, pixelsThisStep);
-            data               += size;
+        const int begin = (int)((qlonglong)height * part       / parts);
+        const int end   = (int)((qlonglong)height * (part + 1) / parts);
 
-            if (observer && p <= checkPoint)
-            {
-                checkPoint -= granularity;
-                observer->progressInfo(&image, 0.1 + 0.9 * (1.0 - float(p) / float(pixels)));
-            }
-        }
-    }
-    else
-    {
-        QVarLengthArray<uchar> buffer(pixelsPerStep * bytesDepth);
+        transformRows(band, data + (qlonglong)begin * width * band.bytesDepth, width, end - begin);
 
-        for (int p = pixels; p > 0; p -= pixelsPerStep)
+        if (observer)
         {
-            int pixelsThisStep  = qMin(p, pixelsPerStep);
-            int size            = pixelsThisStep * bytesDepth;
-            LcmsLock lock;
-            memcpy(buffer.data(), data, size);
-            dkCmsDoTransform(d->handle, buffer.data(), data, pixelsThisStep);
-            data               += size;
-
-            if (observer && p <= checkPoint)
-            {
-                checkPoint -= granularity;
-                observer->progressInfo(&image, 0.1 + 0.9 * (1.0 - float(p) / float(pixels)));
-            }
+            observer->progressInfo(&image, 0.1 + 0.9 * float(part + 1) / float(parts));
         }
     }
 }
 
 void IccTransform::transform(QImage& image, const TransformDescription&)
 {
-    const int bytesDepth    = 4;
-    const int pixels        = image.width() * image.height();
+    IccTransformBand band;
+    band.handle        = d->handle->handle;
+    band.bytesDepth    = 4;
     // convert ten scanlines in a batch
-    const int pixelsPerStep = image.width() * 10;
-    uchar* data             = image.bits();
+    band.pixelsPerStep = image.width() * 10;
 
-    for (int p = pixels; p > 0; p -= pixelsPerStep)
-    {
-        int pixelsThisStep =  qMin(p, pixelsPerStep);
-        int size           =  pixelsThisStep * bytesDepth;
-        LcmsLock lock;
-        dkCmsDoTransform(d->handle, data, data, pixelsThisStep);
-        data               += size;
-    }
+    transformRows(band, image.bits(), image.width(), image.height());
 }
 
 void IccTransform::close()
@@ -36,6 +36,7 @@
 
 #include "digikam_debug.h"
 #include "randomnumbergenerator.h"
+#include "blurkernels.h"
 
 namespace Digikam
 {
@@ -390,75 +391,36 @@ void LocalContrastFilter::inplaceBlurYMultithreaded(const Args& prm)
 {
     for (uint y = prm.start ; runningFlag() && (y < prm.stop) ; ++y)
     {
-        uint pos  = y * prm.sizex;
-        float old = prm.data[pos];
-        ++pos;
-
-        for (int x = 1 ; runningFlag() && (x < prm.sizex) ; ++x)
-        {
-            old           = (prm.data[pos] * (1 - prm.a) + old * prm.a) + prm.denormal_remove;
-            prm.data[pos] = old;
-            ++pos;
-        }
-
-        pos = y * prm.sizex + prm.sizex - 1;
-
-        for (int x = 1 ; runningFlag() && (x < prm.sizex) ; ++x)
-        {
-            old           = (prm.data[pos] * (1 - prm.a) + old * prm.a) + prm.denormal_remove;
-            prm.data[pos] = old;
-            pos--;
-        }
+        RecursiveBlur::blurRow(prm.data + y * prm.sizex, prm.sizex, prm.a);
     }
 }
 
 void LocalContrastFilter::inplaceBlurXMultithreaded(const Args& prm)
 {
-    for (uint x = prm.start ; runningFlag() && (x < prm.stop) ; ++x)
-    {
-        uint pos  = x;
-        float old = prm.data[pos];
+    // Columns are blurred by blocks, walking the rows of the block in memory order.
+    const uint block = 64;
 
-        for (int y = 1 ; runningFlag() && (y < prm.sizey) ; ++y)
-        {
-            old            = (prm.data[pos] * (1 - prm.a) + old * prm.a) + prm.denormal_remove;
-            prm.data[pos]  = old;
-            pos           += prm.sizex;
-        }
-
-        pos = x + prm.sizex * (prm.sizey - 1);
-
-        for (int y = 1 ; runningFlag() && (y < prm.sizey) ; ++y)
-        {
-            old            = (prm.data[pos] * (1 - prm.a) + old * prm.a) + prm.denormal_remove;
-            prm.data[pos]  = old;
-            pos           -= prm.sizex;
-        }
+    for (uint x = prm.start ; runningFlag() && (x < prm.stop) ; x += block)
+    {
+        RecursiveBlur::blurColumns(prm.data, prm.sizex, prm.sizey, prm.a, x, qMin(x + block, prm.stop));
     }
 }
 
 void LocalContrastFilter::inplaceBlur(float* const data, int sizex, int sizey, float blur)
 {
-    if (blur < 0.3)
-    {
-        return;
-    }
-
     Args prm;
 
-    prm.a = (float)(qExp(log(0.25) / blur));
+    prm.a = RecursiveBlur::coefficient(blur);
 
-    if ((prm.a <= 0.0) || (prm.a >= 1.0))
+    if (prm.a == 0.0)
     {
         return;
     }
 
-    prm.a *= prm.a;
-    prm.data            = data;
-    prm.sizex           = sizex;
-    prm.sizey           = sizey;
-    prm.blur            = blur;
-    prm.denormal_remove = (float)(1e-15);
+    prm.data  = data;
+    prm.sizex = sizex;
+    prm.sizey = sizey;
+    prm.blur  = blur;
 
     QList<int> valsx = multithreadedSteps(prm.sizex);
     QList<int> valsy = multithreadedSteps(prm.sizey);
@@ -90,7 +90,6 @@ private:
         int    sizex;
         int    sizey;
         float  blur;
-        float  denormal_remove;
     };
 
 private:
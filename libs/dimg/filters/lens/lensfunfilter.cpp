@@ -25,11 +25,12 @@
 #include <QByteArray>
 #include <QCheckBox>
 #include <QString>
-#include <QtConcurrent>
 
 // Local includes
 
 #include "digikam_debug.h"
+#include "dimgresampler.h"
+#include "dimgtilescheduler.h"
 #include "lensfuniface.h"
 #include "dmetadata.h"
 
@@ -42,18 +43,25 @@ public:
 
     Private()
     {
-        iface    = 0;
-        modifier = 0;
-        loop     = 0;
+        iface     = 0;
+        modifier  = 0;
+        resampler = 0;
+        loop      = 0;
+        version   = LensFunFilter::CurrentVersion();
     }
 
-    DImg          tempImage;
+    DImg           tempImage;
 
-    LensFunIface* iface;
+    LensFunIface*  iface;
 
-    lfModifier*   modifier;
+    lfModifier*    modifier;
 
-    int           loop;
+    DImgResampler* resampler;
+
+    int            loop;
+
+    /// The version of the filter to replay, from readParameters()
+    int            version;
 };
 
 LensFunFilter::LensFunFilter(QObject* const parent)
@@ -133,19 +141,42 @@ void LensFunFilter::filterVIGMultithreaded(uint start, uint stop)
 
 void LensFunFilter::filterDSTMultithreaded(uint start, uint stop)
 {
-    QScopedArrayPointer<float> pos(new float[m_orgImage.width() * 2 * 3]);
+    const int   width  = d->tempImage.width();
+    const float right  = m_destImage.width()  - 1;
+    const float bottom = m_destImage.height() - 1;
+    QScopedArrayPointer<float> pos(new float[width * 2 * 3]);
 
     for (unsigned int y = start; runningFlag() && (y < stop); ++y)
     {
-        if (d->modifier->ApplyGeometryDistortion(0.0, y, d->tempImage.width(), 1, pos.data()))
+        if (d->modifier->ApplyGeometryDistortion(0.0, y, width, 1, pos.data()))
         {
+            if (!d->resampler)
+            {
+                // The Lanczos sampling of the versions before 3.
+
+                float* src = pos.data();
+
+                for (int x = 0 ; runningFlag() && (x < width) ; ++x, ++d->loop)
+                {
+                    d->tempImage.setPixelColor(x, y, m_destImage.getSubPixelColor(src[0], src[1]));
+                    src += 2;
+                }
+
+                continue;
+            }
+
+            // Positions outside of the image take the color of the border, as they always did.
+
             float* src = pos.data();
 
-            for (unsigned int x = 0; runningFlag() && (x < d->tempImage.width()); ++x, ++d->loop)
+            for (int x = 0 ; x < width ; ++x, src += 2)
             {
-                d->tempImage.setPixelColor(x, y, m_destImage.getSubPixelColor(src[0], src[1]));
-                src += 2;
+                src[0] = qBound(0.0f, src[0], right);
+                src[1] = qBound(0.0f, src[1], bottom);
             }
+
+            d->resampler->resampleRow(pos.data(), width, d->tempImage.scanLine(y));
+            ++d->loop;
         }
     }
 }
@@ -233,26 +264,13 @@ void LensFunFilter::filterImage()
                               << m_orgImage.width()  << ", "
                               << m_orgImage.height() << ")";
 
-    QList<int> vals = multithreadedSteps(m_destImage.height());
-
     // Stage 1: Chromatic Aberation Corrections
 
     if (d->iface->settings().filterCCA)
     {
         m_orgImage.prepareSubPixelAccess(); // init lanczos kernel
 
-        QList <QFuture<void> > tasks;
-
-        for (int j = 0 ; runningFlag() && (j < vals.count()-1) ; ++j)
-        {
-            tasks.append(QtConcurrent::run(this,
-                                           &LensFunFilter::filterCCAMultithreaded,
-                                           vals[j],
-                                           vals[j+1]));
-        }
-
-        foreach(QFuture<void> t, tasks)
-            t.waitForFinished();
+        DImgTileFunction<LensFunFilter>(this, &LensFunFilter::filterCCAMultithreaded).run(0, m_destImage.height(), 0, 30);
 
         qCDebug(DIGIKAM_DIMG_LOG) << "Chromatic Aberation Corrections applied.";
     }
@@ -263,18 +281,7 @@ void LensFunFilter::filterImage()
 
     if (d->iface->settings().filterVIG)
     {
-        QList <QFuture<void> > tasks;
-
-        for (int j = 0 ; runningFlag() && (j < vals.count()-1) ; ++j)
-        {
-            tasks.append(QtConcurrent::run(this,
-                                           &LensFunFilter::filterVIGMultithreaded,
-                                           vals[j],
-                                           vals[j+1]));
-        }
-
-        foreach(QFuture<void> t, tasks)
-            t.waitForFinished();
+        DImgTileFunction<LensFunFilter>(this, &LensFunFilter::filterVIGMultithreaded).run(0, m_destImage.height(), 30, 60);
 
         qCDebug(DIGIKAM_DIMG_LOG) << "Vignetting and Color Corrections applied.";
     }
@@ -293,20 +300,23 @@ void LensFunFilter::filterImage()
                             m_destImage.sixteenBit(),
                             m_destImage.hasAlpha());
 
-        m_destImage.prepareSubPixelAccess(); // init lanczos kernel
-
-        QList <QFuture<void> > tasks;
-
-        for (int j = 0 ; runningFlag() && (j < vals.count()-1) ; ++j)
+        if (d->version < 3)
         {
-            tasks.append(QtConcurrent::run(this,
-                                           &LensFunFilter::filterDSTMultithreaded,
-                                           vals[j],
-                                           vals[j+1]));
+            m_destImage.prepareSubPixelAccess(); // init lanczos kernel
+
+            DImgTileFunction<LensFunFilter>(this, &LensFunFilter::filterDSTMultithreaded).run(0, m_destImage.height(), 60, 90);
         }
+        else
+        {
+            // Whole rows are resampled at the positions given by lensfun.
+
+            DImgResampler resampler(m_destImage, DImgResampler::Bicubic);
+            d->resampler = &resampler;
 
-        foreach(QFuture<void> t, tasks)
-            t.waitForFinished();
+            DImgTileFunction<LensFunFilter>(this, &LensFunFilter::filterDSTMultithreaded).run(0, m_destImage.height(), 60, 90);
+
+            d->resampler = 0;
+        }
 
         qCDebug(DIGIKAM_DIMG_LOG) << "Distortion and Geometry Corrections applied.";
 
@@ -356,7 +366,7 @@ bool LensFunFilter::registerSettingsToXmp(MetaEngineData& data) const
 
 FilterAction LensFunFilter::filterAction()
 {
-    FilterAction action(FilterIdentifier(), CurrentVersion());
+    FilterAction action(FilterIdentifier(), d->version);
     action.setDisplayableName(DisplayableName());
 
     LensFunContainer prm = d->iface->settings();
@@ -377,6 +387,8 @@ FilterAction LensFunFilter::filterAction()
 
 void LensFunFilter::readParameters(const Digikam::FilterAction& action)
 {
+    d->version           = action.version();
+
     LensFunContainer prm = d->iface->settings();
     prm.filterCCA        = action.parameter(QLatin1String("ccaCorrection")).toBool();
     prm.filterVIG        = action.parameter(QLatin1String("vigCorrection")).toBool();
@@ -96,12 +96,13 @@ public:
 
     static QList<int>       SupportedVersions()
     {
-        return QList<int>() << 1 << 2;
+        return QList<int>() << 1 << 2 << 3;
     }
 
     static int              CurrentVersion()
     {
-        return 2;
+        // Version 3: distortion resampled by DImgResampler, with the bicubic kernel
+        return 3;
     }
 
     virtual QString         filterIdentifier() const
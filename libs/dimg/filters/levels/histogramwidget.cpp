@@ -229,6 +229,25 @@ void HistogramWidget::updateData(const DImg& img, const DImg& sel, bool showProg
     }
 }
 
+void HistogramWidget::updateRegion(const DImg& img, const QRect& region, bool showProgress)
+{
+    if (!d->imageHistogram              ||
+        !d->imageHistogram->isValid()   ||
+        d->selectionHistogram           ||
+        img.isNull()                    ||
+        img.sixteenBit() != d->sixteenBits)
+    {
+        updateData(img, DImg(), showProgress);
+        return;
+    }
+
+    d->showProgress = showProgress;
+
+    // The update is synchronous: the histogram is valid again when it returns.
+    d->imageHistogram->updateRegion(img, region);
+    update();
+}
+
 void HistogramWidget::updateSelectionData(const DImg& sel, bool showProgress)
 {
     updateData(DImg(), sel, showProgress);
@@ -70,6 +70,12 @@ public:
                     const DImg& sel=DImg(),                 // selection image data
                     bool showProgress=true);
 
+    /** Update the full image histogram when img only differs from the previous image in region.
+     *  The previous image must not have been changed in place. The histogram is computed
+     *  again when there is no computed histogram of an image of the same size and depth.
+     */
+    void updateRegion(const DImg& img, const QRect& region, bool showProgress=true);
+
     /** Update image selection histogram data methods.
      */
     void updateSelectionData(const DImg& sel, bool showProgress=true);
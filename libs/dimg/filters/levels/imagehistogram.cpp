@@ -31,7 +31,13 @@
 
 // Qt includes
 
+#include <QFuture>
+#include <QList>
 #include <QObject>
+#include <QRect>
+#include <QThreadPool>
+#include <QVector>
+#include <QtConcurrent>
 
 // Local includes
 
@@ -59,29 +65,182 @@ public:
         double alpha;
     };
 
+    enum
+    {
+        /// Pixels below which a band of the image is not worth a thread
+        MinimumPixelsPerBand = 256 * 1024
+    };
+
+    /** Positions of the channels in a pixel read at once as a native integer, in channel widths.
+     *  The channels are stored in the B, G, R, A order in memory, each one in native byte order.
+     */
+    enum
+    {
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+        BluePosition  = 3,
+        GreenPosition = 2,
+        RedPosition   = 1,
+        AlphaPosition = 0
+#else
+        BluePosition  = 0,
+        GreenPosition = 1,
+        RedPosition   = 2,
+        AlphaPosition = 3
+#endif
+    };
+
+    /// The integer counts of a band of the image, for the channels value, red, green, blue and alpha
+    typedef QVector<quint32> Counts;
+
 public:
 
-    Private()
+    explicit Private(ImageHistogram* const q)
+        : q(q)
     {
         histogram     = 0;
         histoSegments = 0;
         valid         = false;
+        stoppable     = true;
     }
 
+    Counts countRegion(const DImg& image, const QRect& region) const;
+    void   addCounts(const Counts& counts, double sign);
+    bool   count(const DImg& image, const QRect& region, double sign);
+
 public:
     /** The histogram data.*/
     struct double_packet* histogram;
     bool                  valid;
 
+    /** False while a synchronous update, which cannot be stopped, is counted.*/
+    bool                  stoppable;
+
     /** Image information.*/
     DImg                  img;
 
     /** Numbers of histogram segments depending of image bytes depth*/
     int                   histoSegments;
+
+    ImageHistogram* const q;
 };
 
+ImageHistogram::Private::Counts ImageHistogram::Private::countRegion(const DImg& image, const QRect& region) const
+{
+    Counts counts(5 * histoSegments, 0);
+    quint32* const value = counts.data();
+    quint32* const red   = value + histoSegments;
+    quint32* const green = red   + histoSegments;
+    quint32* const blue  = green + histoSegments;
+    quint32* const alpha = blue  + histoSegments;
+
+    // Each pixel is read at once, its channels are unpacked from the native integer.
+
+    for (int y = region.top() ; (!stoppable || q->runningFlag()) && (y <= region.bottom()) ; ++y)
+    {
+        const uchar* ptr = image.scanLine(y) + region.left() * image.bytesDepth();
+
+        if (image.sixteenBit())         // 16 bits image.
+        {
+            for (int x = 0 ; x < region.width() ; ++x, ptr += 8)
+            {
+                quint64 pixel;
+                memcpy(&pixel, ptr, sizeof(pixel));
+
+                const uint b = (pixel >> (BluePosition  * 16)) & 0xFFFF;
+                const uint g = (pixel >> (GreenPosition * 16)) & 0xFFFF;
+                const uint r = (pixel >> (RedPosition   * 16)) & 0xFFFF;
+
+                blue[b]++;
+                green[g]++;
+                red[r]++;
+                alpha[(pixel >> (AlphaPosition * 16)) & 0xFFFF]++;
+                value[qMax(r, qMax(b, g))]++;
+            }
+        }
+        else                            // 8 bits images.
+        {
+            for (int x = 0 ; x < region.width() ; ++x, ptr += 4)
+            {
+                quint32 pixel;
+                memcpy(&pixel, ptr, sizeof(pixel));
+
+                const uint b = (pixel >> (BluePosition  * 8)) & 0xFF;
+                const uint g = (pixel >> (GreenPosition * 8)) & 0xFF;
+                const uint r = (pixel >> (RedPosition   * 8)) & 0xFF;
+
+                blue[b]++;
+                green[g]++;
+                red[r]++;
+                alpha[(pixel >> (AlphaPosition * 8)) & 0xFF]++;
+                value[qMax(r, qMax(b, g))]++;
+            }
+        }
+    }
+
+    return counts;
+}
+
+void ImageHistogram::Private::addCounts(const Counts& counts, double sign)
+{
+    const quint32* const value = counts.constData();
+    const quint32* const red   = value + histoSegments;
+    const quint32* const green = red   + histoSegments;
+    const quint32* const blue  = green + histoSegments;
+    const quint32* const alpha = blue  + histoSegments;
+
+    for (int i = 0 ; i < histoSegments ; ++i)
+    {
+        histogram[i].value += sign * value[i];
+        histogram[i].red   += sign * red[i];
+        histogram[i].green += sign * green[i];
+        histogram[i].blue  += sign * blue[i];
+        histogram[i].alpha += sign * alpha[i];
+    }
+}
+
+bool ImageHistogram::Private::count(const DImg& image, const QRect& region, double sign)
+{
+    // The bands of the region are counted in parallel in partial histograms, added at the end.
+
+    int threads = DImg::processingThreads();
+
+    if (threads <= 0)
+    {
+        threads = QThreadPool::globalInstance()->maxThreadCount();
+    }
+
+    const int bands = qBound(1,
+                             (int)qMin((qlonglong)region.width() * region.height() / MinimumPixelsPerBand,
+                                       (qlonglong)region.height()),
+                             threads);
+
+    QList<QFuture<Counts> > tasks;
+
+    for (int i = 1 ; i < bands ; ++i)
+    {
+        const int begin = region.top() + region.height() * i       / bands;
+        const int end   = region.top() + region.height() * (i + 1) / bands;
+
+        tasks.append(QtConcurrent::run(this,
+                                       &Private::countRegion,
+                                       image,
+                                       QRect(region.left(), begin, region.width(), end - begin)
+                                      ));
+    }
+
+    // The first band is counted in the calling thread.
+    addCounts(countRegion(image, QRect(region.left(), region.top(), region.width(), region.height() / bands)), sign);
+
+    foreach(QFuture<Counts> t, tasks)
+    {
+        addCounts(t.result(), sign);
+    }
+
+    return (!stoppable || q->runningFlag());
+}
+
 ImageHistogram::ImageHistogram(const DImg& img, QObject* const parent)
-    : DynamicThread(parent), d(new Private)
+    : DynamicThread(parent), d(new Private(this))
 {
     // A simple copy of reference must be enough instead a deep copy. See this BKO comment for details:
     // https://bugs.kde.org/show_bug.cgi?id=274555#c40
@@ -171,9 +330,6 @@ void ImageHistogram::calculate()
         return;
     }
 
-    uint i;
-    int  max;
-
     emit calculationStarted();
 
     if (!d->histogram)
@@ -190,74 +346,54 @@ void ImageHistogram::calculate()
 
     memset(d->histogram, 0, d->histoSegments * sizeof(struct Private::double_packet));
 
-    if (isSixteenBit())         // 16 bits image.
+    if (d->count(d->img, QRect(QPoint(0, 0), d->img.size()), 1.0))
     {
-        unsigned short blue, green, red, alpha;
-        unsigned short* const data = reinterpret_cast<unsigned short*>(d->img.bits());
-
-        // count here instead of inside the loop, because d is not optimized because it's not defined in the header
-        const uint count = d->img.width() * d->img.height() * 4;
-        for (i = 0 ; runningFlag() && (i < count) ; i += 4)
-        {
-            blue  = data[i    ];
-            green = data[i + 1];
-            red   = data[i + 2];
-            alpha = data[i + 3];
+        d->valid = true;
+        emit calculationFinished(true);
+    }
+}
 
-            d->histogram[blue].blue++;
-            d->histogram[green].green++;
-            d->histogram[red].red++;
-            d->histogram[alpha].alpha++;
+void ImageHistogram::updateRegion(const DImg& image, const QRect& region)
+{
+    if (!d->histogram || !d->valid || isRunning()  ||
+        image.isNull()                             ||
+        image.size()       != d->img.size()        ||
+        image.sixteenBit() != d->img.sixteenBit())
+    {
+        // Nothing to update from: compute the histogram of the whole image.
 
-            max = (blue > green) ? blue : green;
+        stopCalculation();
 
-            if (red > max)
-            {
-                d->histogram[red].value++;
-            }
-            else
-            {
-                d->histogram[max].value++;
-            }
+        if (d->histogram && image.sixteenBit() != d->img.sixteenBit())
+        {
+            delete [] d->histogram;
+            d->histogram = 0;
         }
-    }
-    else                                  // 8 bits images.
-    {
-        uchar blue, green, red, alpha;
-        const uchar* const data = d->img.bits();
 
-        // count here instead of inside the loop, because d is not optimized because it's not defined in the header
-        const uint count = d->img.width() * d->img.height() * 4;
-        for (i = 0 ; runningFlag() && (i < count) ; i += 4)
-        {
-            blue  = data[i    ];
-            green = data[i + 1];
-            red   = data[i + 2];
-            alpha = data[i + 3];
+        d->img           = image;
+        d->histoSegments = d->img.sixteenBit() ? NUM_SEGMENTS_16BIT : NUM_SEGMENTS_8BIT;
+        d->valid         = false;
+        d->stoppable     = false;
+        calculate();
+        d->stoppable     = true;
+        return;
+    }
 
-            d->histogram[blue].blue++;
-            d->histogram[green].green++;
-            d->histogram[red].red++;
-            d->histogram[alpha].alpha++;
+    const QRect rect = region & QRect(QPoint(0, 0), image.size());
 
-            max = (blue > green) ? blue : green;
+    if (!rect.isEmpty())
+    {
+        emit calculationStarted();
 
-            if (red > max)
-            {
-                d->histogram[red].value++;
-            }
-            else
-            {
-                d->histogram[max].value++;
-            }
-        }
+        // Remove the counts of the previous pixels, and add the ones of the new pixels.
+        d->stoppable = false;
+        d->valid     = d->count(d->img, rect, -1.0) && d->count(image, rect, 1.0);
+        d->stoppable = true;
     }
 
-    if (runningFlag())
-    {
-        d->valid = true;
-        emit calculationFinished(true);
-    }
+    d->img = image;
+
+    emit calculationFinished(d->valid);
 }
 
 double ImageHistogram::getCount(int channel, int start, int end) const
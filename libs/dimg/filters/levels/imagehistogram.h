@@ -27,6 +27,7 @@
 // Qt includes
 
 #include <QEvent>
+#include <QRect>
 #include <QThread>
 
 // Local includes
@@ -54,6 +55,13 @@ public:
     void calculate();
     void calculateInThread();
 
+    /** Synchronous update of a computed histogram, when the image only changed in a region,
+     *  as the preview of a tool correcting a part of the image. The histogram then describes image.
+     *  The previous pixels of the region are read from the previous image: it must not have
+     *  been changed in place. If image has another size or depth, the histogram is computed again.
+     */
+    void updateRegion(const DImg& image, const QRect& region);
+
     /** Stop threaded computation. */
     void stopCalculation();
     bool isCalculating()  const;
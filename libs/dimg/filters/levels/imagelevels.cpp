@@ -488,7 +488,7 @@ void ImageLevels::levelsLutSetup(int nchannels)
     }
 }
 
-void ImageLevels::levelsLutProcess(uchar* const srcPR, uchar* const destPR, int w, int h)
+void ImageLevels::levelsLutProcess(uchar* const srcPR, uchar* const destPR, int w, int h) const
 {
     unsigned short* lut0 = NULL, *lut1 = NULL, *lut2 = NULL, *lut3 = NULL;
 
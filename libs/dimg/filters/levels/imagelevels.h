@@ -62,7 +62,7 @@ public:
     void   levelsCalculateTransfers();
     float  levelsLutFunc(int nchannels, int channel, float value);
     void   levelsLutSetup(int nchannels);
-    void   levelsLutProcess(uchar* const srcPR, uchar* const destPR, int w, int h);
+    void   levelsLutProcess(uchar* const srcPR, uchar* const destPR, int w, int h) const;
 
     // Methods for to set manually the levels values.
 
@@ -33,13 +33,23 @@ namespace Digikam
 {
 
 LevelsFilter::LevelsFilter(QObject* const parent)
-    : DImgThreadedFilter(parent)
+    : DImgThreadedFilter(parent),
+      m_levels(0)
 {
     initFilter();
 }
 
 LevelsFilter::LevelsFilter(DImg* const orgImage, QObject* const parent, const LevelsContainer& settings)
-    : DImgThreadedFilter(orgImage, parent, QLatin1String("LevelsFilter"))
+    : DImgThreadedFilter(orgImage, parent, QLatin1String("LevelsFilter")),
+      m_levels(0)
+{
+    m_settings = settings;
+    initFilter();
+}
+
+LevelsFilter::LevelsFilter(const LevelsContainer& settings, QObject* const parent)
+    : DImgThreadedFilter(parent, QLatin1String("LevelsFilter")),
+      m_levels(0)
 {
     m_settings = settings;
     initFilter();
@@ -47,7 +57,8 @@ LevelsFilter::LevelsFilter(DImg* const orgImage, QObject* const parent, const Le
 
 LevelsFilter::LevelsFilter(const LevelsContainer& settings, DImgThreadedFilter* const master,
                            const DImg& orgImage, DImg& destImage, int progressBegin, int progressEnd)
-    : DImgThreadedFilter(master, orgImage, destImage, progressBegin, progressEnd, QLatin1String("LevelsFilter"))
+    : DImgThreadedFilter(master, orgImage, destImage, progressBegin, progressEnd, QLatin1String("LevelsFilter")),
+      m_levels(0)
 {
     m_settings = settings;
     initFilter();
@@ -57,36 +68,42 @@ LevelsFilter::LevelsFilter(const LevelsContainer& settings, DImgThreadedFilter*
 LevelsFilter::~LevelsFilter()
 {
     cancelFilter();
+    delete m_levels;
 }
 
 void LevelsFilter::filterImage()
 {
-    ImageLevels levels(m_orgImage.sixteenBit());
+    DImgPointFilterChain chain(QList<DImgPointFilter*>() << this, this, m_orgImage, m_destImage);
+}
+
+bool LevelsFilter::mapsChannelsIndependently() const
+{
+    return true;
+}
+
+void LevelsFilter::preparePointFilter(const DImg& image)
+{
+    delete m_levels;
+    m_levels = new ImageLevels(image.sixteenBit());
 
     for (int i = 0 ; i < 5 ; ++i)
     {
-        postProgress(i * 10);
-        levels.setLevelLowInputValue(i,   m_settings.lInput[i]);
-        levels.setLevelHighInputValue(i,  m_settings.hInput[i]);
-        levels.setLevelLowOutputValue(i,  m_settings.lOutput[i]);
-        levels.setLevelHighOutputValue(i, m_settings.hOutput[i]);
-        levels.setLevelGammaValue(i,      m_settings.gamma[i]);
+        m_levels->setLevelLowInputValue(i,   m_settings.lInput[i]);
+        m_levels->setLevelHighInputValue(i,  m_settings.hInput[i]);
+        m_levels->setLevelLowOutputValue(i,  m_settings.lOutput[i]);
+        m_levels->setLevelHighOutputValue(i, m_settings.hOutput[i]);
+        m_levels->setLevelGammaValue(i,      m_settings.gamma[i]);
     }
 
-    postProgress(50);
-
-    m_destImage = DImg(m_orgImage.width(), m_orgImage.height(), m_orgImage.sixteenBit(), m_orgImage.hasAlpha());
-    postProgress(60);
-
-    levels.levelsCalculateTransfers();
-    postProgress(70);
+    m_levels->levelsCalculateTransfers();
 
     // Process all channels Levels
-    levels.levelsLutSetup(AlphaChannel);
-    postProgress(80);
+    m_levels->levelsLutSetup(AlphaChannel);
+}
 
-    levels.levelsLutProcess(m_orgImage.bits(), m_destImage.bits(), m_orgImage.width(), m_orgImage.height());
-    postProgress(90);
+void LevelsFilter::processPixels(uchar* const data, uint count, bool) const
+{
+    m_levels->levelsLutProcess(data, data, count, 1);
 }
 
 FilterAction LevelsFilter::filterAction()
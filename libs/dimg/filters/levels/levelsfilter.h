@@ -29,12 +29,14 @@
 
 #include "digikam_export.h"
 #include "dimgthreadedfilter.h"
+#include "dimgpointfilter.h"
 #include "digikam_globals.h"
 
 namespace Digikam
 {
 
 class DImg;
+class ImageLevels;
 
 class DIGIKAM_EXPORT LevelsContainer
 {
@@ -67,13 +69,14 @@ public:
 
 // --------------------------------------------------------------------------------
 
-class DIGIKAM_EXPORT LevelsFilter : public DImgThreadedFilter
+class DIGIKAM_EXPORT LevelsFilter : public DImgThreadedFilter, public DImgPointFilter
 {
 
 public:
 
     explicit LevelsFilter(QObject* const parent = 0);
     explicit LevelsFilter(DImg* const orgImage, QObject* const parent=0, const LevelsContainer& settings=LevelsContainer());
+    explicit LevelsFilter(const LevelsContainer& settings, QObject* const parent=0);
     explicit LevelsFilter(const LevelsContainer& settings, DImgThreadedFilter* const master,
                           const DImg& orgImage, DImg& destImage, int progressBegin=0, int progressEnd=100);
     virtual ~LevelsFilter();
@@ -106,6 +109,10 @@ public:
     virtual FilterAction    filterAction();
     void                    readParameters(const FilterAction& action);
 
+    virtual bool            mapsChannelsIndependently() const;
+    virtual void            preparePointFilter(const DImg& image);
+    virtual void            processPixels(uchar* const data, uint count, bool sixteenBit) const;
+
 private:
 
     void filterImage();
@@ -113,6 +120,7 @@ private:
 private:
 
     LevelsContainer m_settings;
+    ImageLevels*    m_levels;
 };
 
 } // namespace Digikam
@@ -55,6 +55,7 @@ public:
     static redeye::ShapePredictor* sp;
 
     RedEyeCorrectionContainer      settings;
+    QRect                          correctedArea;
 };
 
 redeye::ShapePredictor* RedEyeCorrectionFilter::Private::sp = 0;
@@ -97,6 +98,8 @@ RedEyeCorrectionFilter::~RedEyeCorrectionFilter()
 
 void RedEyeCorrectionFilter::filterImage()
 {
+    d->correctedArea = QRect();
+
     if (!d->sp)
     {
         // Loading the shape predictor model
@@ -163,6 +166,9 @@ void RedEyeCorrectionFilter::filterImage()
 
             for (unsigned int j = 0 ; runningFlag() && (j < eyes.size()) ; j++)
             {
+                d->correctedArea |= QRect(eyes[j].x, eyes[j].y, eyes[j].width, eyes[j].height) &
+                                    QRect(QPoint(0, 0), m_orgImage.size());
+
                 correctRedEye(intermediateImage.data,
                               intermediateImage.type(),
                               eyes[j],
@@ -246,6 +252,11 @@ void RedEyeCorrectionFilter::QRectFtocvRect(const QList<QRect>& faces, std::vect
     }
 }
 
+QRect RedEyeCorrectionFilter::correctedArea() const
+{
+    return d->correctedArea;
+}
+
 FilterAction RedEyeCorrectionFilter::filterAction()
 {
     DefaultFilterAction<RedEyeCorrectionFilter> action;
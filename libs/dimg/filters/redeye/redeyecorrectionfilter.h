@@ -79,6 +79,11 @@ public:
 
     virtual FilterAction    filterAction();
 
+    /** The area of the image where eyes were corrected by the last run of the filter,
+     *  null if no eye was found. The other pixels are the ones of the original image.
+     */
+    QRect                   correctedArea() const;
+
 private:
 
     void filterImage();
@@ -33,6 +33,7 @@
 // Local includes
 
 #include "dimg.h"
+#include "dimgresampler.h"
 #include "pixelsaliasfilter.h"
 #include "digikam_globals.h"
 
@@ -45,9 +46,13 @@ public:
 
     Private()
     {
+        version = FreeRotationFilter::CurrentVersion();
     }
 
     FreeRotationContainer settings;
+
+    /// The version of the filter to replay, from readParameters()
+    int                   version;
 };
 
 FreeRotationFilter::FreeRotationFilter(QObject* const parent)
@@ -130,18 +135,13 @@ double FreeRotationFilter::calculateAngle(const QPoint& p1, const QPoint& p2)
 
 void FreeRotationFilter::filterImage()
 {
-    int          progress;
-   int w, h, nw, nh, j, i = 0;
     int          nNewHeight, nNewWidth;
     int          nhdx, nhdy, nhsx, nhsy;
-    double       lfSin, lfCos, lfx, lfy;
+    double       lfSin, lfCos;
 
     int nWidth  = m_orgImage.width();
     int nHeight = m_orgImage.height();
 
-    uchar* pBits            = m_orgImage.bits();
-    unsigned short* pBits16 = reinterpret_cast<unsigned short*>(m_orgImage.bits());
-
     // first of all, we need to calculate the sin and cos of the given angle
 
     lfSin = sin(d->settings.angle * -DEG2RAD);
@@ -182,67 +182,29 @@ void FreeRotationFilter::filterImage()
 
     m_destImage.fill(DColor(d->settings.backgroundColor.rgb(), sixteenBit));
 
-    uchar* pResBits            = m_destImage.bits();
-    unsigned short* pResBits16 = reinterpret_cast<unsigned short*>(m_destImage.bits());
-
-    PixelsAliasFilter alias;
-
-    // main loop
-
-    for (h = 0; runningFlag() && (h < nNewHeight); ++h)
+    if (d->version == 1)
     {
-        nh = h - nhdy;
+        rotateVersion1(lfSin, lfCos, nhdx, nhdy, nhsx, nhsy);
 
-        for (w = 0; runningFlag() && (w < nNewWidth); ++w)
+        if (!runningFlag())
         {
-            nw = w - nhdx;
-
-            i = setPosition(nNewWidth, w, h);
-
-            lfx = (double)nw * lfCos - (double)nh * lfSin + nhsx;
-            lfy = (double)nw * lfSin + (double)nh * lfCos + nhsy;
-
-            if (isInside(nWidth, nHeight, (int)lfx, (int)lfy))
-            {
-                if (d->settings.antiAlias)
-                {
-                    if (!sixteenBit)
-                        alias.pixelAntiAliasing(pBits, nWidth, nHeight, lfx, lfy,
-                                                &pResBits[i + 3], &pResBits[i + 2],
-                                                &pResBits[i + 1], &pResBits[i]);
-                    else
-                        alias.pixelAntiAliasing16(pBits16, nWidth, nHeight, lfx, lfy,
-                                                  &pResBits16[i + 3], &pResBits16[i + 2],
-                                                  &pResBits16[i + 1], &pResBits16[i]);
-                }
-                else
-                {
-                    j = setPosition(nWidth, (int)lfx, (int)lfy);
-
-                    for (int p = 0 ; p < 4 ; ++p)
-                    {
-                        if (!sixteenBit)
-                        {
-                            pResBits[i] = pBits[j];
-                        }
-                        else
-                        {
-                            pResBits16[i] = pBits16[j];
-                        }
-
-                        ++i;
-                        ++j;
-                    }
-                }
-            }
+            return;
         }
+    }
+    else
+    {
+        // The destination pixels are sampled at their position rotated back to the source, around the centers.
 
-        // Update the progress bar in dialog.
-        progress = (int)(((double) h * 100.0) / nNewHeight);
+        QTransform destToSrc(lfCos, lfSin, -lfSin, lfCos,
+                             nhsx - nhdx * lfCos + nhdy * lfSin,
+                             nhsy - nhdx * lfSin - nhdy * lfCos);
 
-        if (progress % 5 == 0)
+        DImgResampler resampler(m_orgImage, d->settings.antiAlias ? DImgResampler::Bilinear
+                                                                  : DImgResampler::NearestNeighbor);
+
+        if (!resampler.transform(m_destImage, destToSrc, this, 0, 100))
         {
-            postProgress(progress);
+            return;
         }
     }
 
@@ -377,6 +339,85 @@ void FreeRotationFilter::filterImage()
     }
 }
 
+void FreeRotationFilter::rotateVersion1(double lfSin, double lfCos, int nhdx, int nhdy, int nhsx, int nhsy)
+{
+    int    progress;
+    int    w, h, nw, nh, j, i = 0;
+    double lfx, lfy;
+
+    int nWidth                 = m_orgImage.width();
+    int nHeight                = m_orgImage.height();
+    int nNewWidth              = m_destImage.width();
+    int nNewHeight             = m_destImage.height();
+    bool sixteenBit            = m_orgImage.sixteenBit();
+
+    uchar* pBits               = m_orgImage.bits();
+    unsigned short* pBits16    = reinterpret_cast<unsigned short*>(m_orgImage.bits());
+    uchar* pResBits            = m_destImage.bits();
+    unsigned short* pResBits16 = reinterpret_cast<unsigned short*>(m_destImage.bits());
+
+    PixelsAliasFilter alias;
+
+    // main loop
+
+    for (h = 0; runningFlag() && (h < nNewHeight); ++h)
+    {
+        nh = h - nhdy;
+
+        for (w = 0; runningFlag() && (w < nNewWidth); ++w)
+        {
+            nw = w - nhdx;
+
+            i = setPosition(nNewWidth, w, h);
+
+            lfx = (double)nw * lfCos - (double)nh * lfSin + nhsx;
+            lfy = (double)nw * lfSin + (double)nh * lfCos + nhsy;
+
+            if (isInside(nWidth, nHeight, (int)lfx, (int)lfy))
+            {
+                if (d->settings.antiAlias)
+                {
+                    if (!sixteenBit)
+                        alias.pixelAntiAliasing(pBits, nWidth, nHeight, lfx, lfy,
+                                                &pResBits[i + 3], &pResBits[i + 2],
+                                                &pResBits[i + 1], &pResBits[i]);
+                    else
+                        alias.pixelAntiAliasing16(pBits16, nWidth, nHeight, lfx, lfy,
+                                                  &pResBits16[i + 3], &pResBits16[i + 2],
+                                                  &pResBits16[i + 1], &pResBits16[i]);
+                }
+                else
+                {
+                    j = setPosition(nWidth, (int)lfx, (int)lfy);
+
+                    for (int p = 0 ; p < 4 ; ++p)
+                    {
+                        if (!sixteenBit)
+                        {
+                            pResBits[i] = pBits[j];
+                        }
+                        else
+                        {
+                            pResBits16[i] = pBits16[j];
+                        }
+
+                        ++i;
+                        ++j;
+                    }
+                }
+            }
+        }
+
+        // Update the progress bar in dialog.
+        progress = (int)(((double) h * 100.0) / nNewHeight);
+
+        if (progress % 5 == 0)
+        {
+            postProgress(progress);
+        }
+    }
+}
+
 int FreeRotationFilter::setPosition(int Width, int X, int Y)
 {
     return (Y * Width * 4 + 4 * X);
@@ -392,7 +433,7 @@ bool FreeRotationFilter::isInside(int Width, int Height, int X, int Y)
 
 FilterAction FreeRotationFilter::filterAction()
 {
-    FilterAction action(FilterIdentifier(), CurrentVersion());
+    FilterAction action(FilterIdentifier(), d->version);
     action.setDisplayableName(DisplayableName());
 
     action.addParameter(QLatin1String("angle"),            d->settings.angle);
@@ -411,6 +452,7 @@ FilterAction FreeRotationFilter::filterAction()
 
 void FreeRotationFilter::readParameters(const FilterAction& action)
 {
+    d->version            = action.version();
     d->settings.angle     = action.parameter(QLatin1String("angle")).toDouble();
     d->settings.antiAlias = action.parameter(QLatin1String("antiAlias")).toBool();
     d->settings.autoCrop  = action.parameter(QLatin1String("autoCrop")).toInt();
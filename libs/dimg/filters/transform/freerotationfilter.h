@@ -109,12 +109,13 @@ public:
 
     static QList<int>       SupportedVersions()
     {
-        return QList<int>() << 1;
+        return QList<int>() << 1 << 2;
     }
 
     static int              CurrentVersion()
     {
-        return 1;
+        // Version 2: pixels sampled by DImgResampler
+        return 2;
     }
 
     virtual QString         filterIdentifier() const
@@ -128,6 +129,10 @@ public:
 private:
 
     void        filterImage();
+
+    /** The sampling of version 1, kept to replay the image histories which use it.
+     */
+    void        rotateVersion1(double lfSin, double lfCos, int nhdx, int nhdy, int nhsx, int nhsy);
     inline int  setPosition (int Width, int X, int Y);
     inline bool isInside (int Width, int Height, int X, int Y);
 
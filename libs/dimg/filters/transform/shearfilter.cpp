@@ -36,6 +36,7 @@
 
 #include "digikam_globals.h"
 #include "dimg.h"
+#include "dimgresampler.h"
 #include "pixelsaliasfilter.h"
 
 namespace Digikam
@@ -53,6 +54,7 @@ public:
         hAngle          = 0;
         vAngle          = 0;
         backgroundColor = Qt::black;
+        version         = ShearFilter::CurrentVersion();
     }
 
     bool   antiAlias;
@@ -66,6 +68,9 @@ public:
     QColor backgroundColor;
 
     QSize  newSize;
+
+    /// The version of the filter to replay, from readParameters()
+    int    version;
 };
 
 ShearFilter::ShearFilter(QObject* const parent)
@@ -102,18 +107,14 @@ QSize ShearFilter::getNewSize() const
 
 void ShearFilter::filterImage()
 {
-    int          progress;
-   int x, y, p = 0, pt;
     int          new_width, new_height;
-    double       nx, ny, dx, dy;
+    double       dx, dy;
     double       horz_factor, vert_factor;
     double       horz_add, vert_add;
     double       horz_beta_angle, vert_beta_angle;
 
     int nWidth              = m_orgImage.width();
     int nHeight             = m_orgImage.height();
-    uchar* pBits            = m_orgImage.bits();
-    unsigned short* pBits16 = reinterpret_cast<unsigned short*>(m_orgImage.bits());
 
     // get beta ( complementary ) angle for horizontal and vertical angles
     horz_beta_angle = (((d->hAngle < 0.0) ? 180.0 : 90.0) - d->hAngle) * DEG2RAD;
@@ -167,6 +168,47 @@ void ShearFilter::filterImage()
     m_destImage     = DImg(new_width, new_height, sixteenBit, m_orgImage.hasAlpha());
     m_destImage.fill(DColor(d->backgroundColor.rgb(), sixteenBit));
 
+    if (d->version == 1)
+    {
+        shearVersion1(dx, dy, horz_factor, vert_factor);
+    }
+    else
+    {
+        // The source position of the destination pixel (x, y) is (x + dx + y * horz_factor, y + dy + x * vert_factor).
+
+        QTransform destToSrc(1.0, vert_factor, horz_factor, 1.0, dx, dy);
+
+        DImgResampler resampler(m_orgImage, d->antiAlias ? DImgResampler::Bilinear
+                                                         : DImgResampler::NearestNeighbor);
+
+        if (!resampler.transform(m_destImage, destToSrc, this, 0, 100))
+        {
+            return;
+        }
+    }
+
+    // To compute the rotated destination image size using original image dimensions.
+    int W = (int)(fabs(d->orgH * ((d->hAngle < 0.0) ? sin(horz_beta_angle) : cos(horz_beta_angle)))) + d->orgW;
+    int H = (int)(fabs(d->orgW * ((d->vAngle < 0.0) ? sin(vert_beta_angle) : cos(vert_beta_angle)))) + d->orgH;
+
+    d->newSize.setWidth(W);
+    d->newSize.setHeight(H);
+}
+
+void ShearFilter::shearVersion1(double dx, double dy, double horz_factor, double vert_factor)
+{
+    int    progress;
+    int    x, y, p = 0, pt;
+    double nx, ny;
+
+    int nWidth                 = m_orgImage.width();
+    int nHeight                = m_orgImage.height();
+    int new_width              = m_destImage.width();
+    int new_height             = m_destImage.height();
+    bool sixteenBit            = m_orgImage.sixteenBit();
+
+    uchar* pBits               = m_orgImage.bits();
+    unsigned short* pBits16    = reinterpret_cast<unsigned short*>(m_orgImage.bits());
     uchar* pResBits            = m_destImage.bits();
     unsigned short* pResBits16 = reinterpret_cast<unsigned short*>(m_destImage.bits());
 
@@ -221,18 +263,11 @@ void ShearFilter::filterImage()
             postProgress(progress);
         }
     }
-
-    // To compute the rotated destination image size using original image dimensions.
-    int W = (int)(fabs(d->orgH * ((d->hAngle < 0.0) ? sin(horz_beta_angle) : cos(horz_beta_angle)))) + d->orgW;
-    int H = (int)(fabs(d->orgW * ((d->vAngle < 0.0) ? sin(vert_beta_angle) : cos(vert_beta_angle)))) + d->orgH;
-
-    d->newSize.setWidth(W);
-    d->newSize.setHeight(H);
 }
 
 FilterAction ShearFilter::filterAction()
 {
-    FilterAction action(FilterIdentifier(), CurrentVersion());
+    FilterAction action(FilterIdentifier(), d->version);
     action.setDisplayableName(DisplayableName());
 
     action.addParameter(QLatin1String("antiAlias"),        d->antiAlias);
@@ -250,6 +285,7 @@ FilterAction ShearFilter::filterAction()
 
 void ShearFilter::readParameters(const FilterAction& action)
 {
+    d->version = action.version();
     d->antiAlias = action.parameter(QLatin1String("antiAlias")).toBool();
     d->hAngle = action.parameter(QLatin1String("hAngle")).toFloat();
     d->orgH = action.parameter(QLatin1String("orgH")).toInt();
@@ -63,12 +63,13 @@ public:
 
     static QList<int>       SupportedVersions()
     {
-        return QList<int>() << 1;
+        return QList<int>() << 1 << 2;
     }
 
     static int              CurrentVersion()
     {
-        return 1;
+        // Version 2: pixels sampled by DImgResampler
+        return 2;
     }
 
     virtual QString         filterIdentifier() const
@@ -83,6 +84,10 @@ private:
 
     void filterImage();
 
+    /** The sampling of version 1, kept to replay the image histories which use it.
+     */
+    void shearVersion1(double dx, double dy, double horz_factor, double vert_factor);
+
     inline int setPosition (int Width, int X, int Y)
     {
         return (Y*Width*4 + 4*X);
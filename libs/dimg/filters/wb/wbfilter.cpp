@@ -94,6 +94,14 @@ WBFilter::WBFilter(DImg* const orgImage, QObject* const parent, const WBContaine
     initFilter();
 }
 
+WBFilter::WBFilter(const WBContainer& settings, QObject* const parent)
+    : DImgThreadedFilter(parent, QLatin1String("WBFilter")),
+      d(new Private)
+{
+    m_settings = settings;
+    initFilter();
+}
+
 WBFilter::WBFilter(const WBContainer& settings, DImgThreadedFilter* const master,
                    const DImg& orgImage, const DImg& destImage, int progressBegin, int progressEnd)
     : DImgThreadedFilter(master, orgImage, destImage, progressBegin, progressEnd, QLatin1String("WBFilter")),
@@ -111,8 +119,20 @@ WBFilter::~WBFilter()
 
 void WBFilter::filterImage()
 {
-    d->WP      = m_orgImage.sixteenBit() ? 65536 : 256;
-    d->rgbMax  = m_orgImage.sixteenBit() ? 65536 : 256;
+    // Apply White balance adjustments.
+    DImgPointFilterChain chain(QList<DImgPointFilter*>() << this, this, m_orgImage, m_orgImage);
+    m_destImage = m_orgImage;
+}
+
+bool WBFilter::needsInputPixels() const
+{
+    return (m_settings.maxr == -1 && m_settings.maxg == -1 && m_settings.maxb == -1);
+}
+
+void WBFilter::preparePointFilter(const DImg& image)
+{
+    d->WP      = image.sixteenBit() ? 65536 : 256;
+    d->rgbMax  = image.sixteenBit() ? 65536 : 256;
 
     // Set final lut.
     setRGBmult();
@@ -129,17 +149,13 @@ void WBFilter::filterImage()
     // See bug #259223 : scaling down the rgb multipliers just enough to prevent clipping
     if (m_settings.maxr == -1 && m_settings.maxg == -1 && m_settings.maxb == -1)
     {
-        findChanelsMax((const DImg*) &m_orgImage,
+        findChanelsMax(&image,
                        m_settings.maxr,
                        m_settings.maxg,
                        m_settings.maxb);
     }
 
     preventAutoExposure(m_settings.maxr, m_settings.maxg, m_settings.maxb);
-
-    // Apply White balance adjustments.
-    adjustWhiteBalance(m_orgImage.bits(), m_orgImage.width(), m_orgImage.height(), m_orgImage.sixteenBit());
-    m_destImage = m_orgImage;
 }
 
 void WBFilter::autoWBAdjustementFromColor(const QColor& tc, double& temperature, double& green)
@@ -417,18 +433,16 @@ void WBFilter::setLUTv()
     }
 }
 
-void WBFilter::adjustWhiteBalance(uchar* const data, int width, int height, bool sixteenBit)
+void WBFilter::processPixels(uchar* const data, uint count, bool sixteenBit) const
 {
-    uint size = (uint)(width * height);
     uint i, j;
-    int  progress;
 
     if (!sixteenBit)        // 8 bits image.
     {
         uchar  red, green, blue;
         uchar* ptr = data;
 
-        for (j = 0 ; runningFlag() && (j < size) ; ++j)
+        for (j = 0 ; j < count ; ++j)
         {
             int v, rv[3];
 
@@ -453,13 +467,6 @@ void WBFilter::adjustWhiteBalance(uchar* const data, int width, int height, bool
             ptr[1] = (uchar)pixelColor(rv[1], i, v);
             ptr[2] = (uchar)pixelColor(rv[2], i, v);
             ptr    += 4;
-
-            progress = (int)(((double)j * 100.0) / size);
-
-            if (progress % 5 == 0)
-            {
-                postProgress(progress);
-            }
         }
     }
     else               // 16 bits image.
@@ -467,7 +474,7 @@ void WBFilter::adjustWhiteBalance(uchar* const data, int width, int height, bool
         unsigned short  red, green, blue;
         unsigned short* ptr = reinterpret_cast<unsigned short*>(data);
 
-        for (j = 0 ; runningFlag() && (j < size) ; ++j)
+        for (j = 0 ; j < count ; ++j)
         {
             int v, rv[3];
 
@@ -492,18 +499,11 @@ void WBFilter::adjustWhiteBalance(uchar* const data, int width, int height, bool
             ptr[1] = pixelColor(rv[1], i, v);
             ptr[2] = pixelColor(rv[2], i, v);
             ptr    += 4;
-
-            progress = (int)(((double)j * 100.0) / size);
-
-            if (progress % 5 == 0)
-            {
-                postProgress(progress);
-            }
         }
     }
 }
 
-unsigned short WBFilter::pixelColor(int colorMult, int index, int value)
+unsigned short WBFilter::pixelColor(int colorMult, int index, int value) const
 {
     int r = (d->clipSat && colorMult > (int)d->rgbMax) ? d->rgbMax : colorMult;
 
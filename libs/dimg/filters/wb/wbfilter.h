@@ -34,6 +34,7 @@
 
 #include "digikam_export.h"
 #include "dimgthreadedfilter.h"
+#include "dimgpointfilter.h"
 #include "digikam_globals.h"
 #include "wbcontainer.h"
 
@@ -42,13 +43,14 @@ namespace Digikam
 
 class DImg;
 
-class DIGIKAM_EXPORT WBFilter : public DImgThreadedFilter
+class DIGIKAM_EXPORT WBFilter : public DImgThreadedFilter, public DImgPointFilter
 {
 
 public:
 
     explicit WBFilter(QObject* const parent = 0);
     explicit WBFilter(DImg* const orgImage, QObject* const parent=0, const WBContainer& settings=WBContainer());
+    explicit WBFilter(const WBContainer& settings, QObject* const parent=0);
     explicit WBFilter(const WBContainer& settings, DImgThreadedFilter* const master, const DImg& orgImage, const DImg& destImage,
                       int progressBegin=0, int progressEnd=100);
     virtual ~WBFilter();
@@ -86,6 +88,13 @@ public:
 
     virtual FilterAction    filterAction();
 
+    /** The white balance needs the maximum values of the channels of its input,
+     *  if they are not given in the settings.
+     */
+    virtual bool            needsInputPixels() const;
+    virtual void            preparePointFilter(const DImg& image);
+    virtual void            processPixels(uchar* const data, uint count, bool sixteenBit) const;
+
 protected:
 
     void filterImage();
@@ -98,8 +107,7 @@ private:
 
     void setRGBmult();
     void setLUTv();
-    void adjustWhiteBalance(uchar* const data, int width, int height, bool sixteenBit);
-    inline unsigned short pixelColor(int colorMult, int index, int value);
+    inline unsigned short pixelColor(int colorMult, int index, int value) const;
 
     static void setRGBmult(double& temperature, double& green, float& mr, float& mg, float& mb);
 
@@ -153,7 +153,7 @@ void DImgLoader::loadingFailed()
 {
     if (m_image->m_priv->data)
     {
-        delete [] m_image->m_priv->data;
+        DImg::Private::releaseData(m_image->m_priv->data);
     }
 
     m_image->m_priv->data   = 0;
@@ -414,6 +414,59 @@ QByteArray DImgLoader::uniqueHash(const QString& filePath, const DImg& img, bool
     return hash;
 }
 
+QByteArray DImgLoader::uniqueHashV2(const QByteArray& fileHead, const QByteArray& fileTail, const DImg* const img)
+{
+    QCryptographicHash md5(QCryptographicHash::Md5);
+
+    // Same parts as read from the file by uniqueHashV2(filePath):
+    // first 100 kB and last 100 kB, limited to file size
+    const int specifiedSize = 100 * 1024; // 100 kB
+    const int size          = qMin(fileTail.size(), specifiedSize);
+
+    if (size)
+    {
+        md5.addData(fileHead.constData(), qMin(fileHead.size(), size));
+        md5.addData(fileTail.constData() + fileTail.size() - size, size);
+    }
+
+    QByteArray hash = md5.result().toHex();
+
+    if (img && !hash.isNull())
+    {
+        const_cast<DImg*>(img)->setAttribute(QString::fromUtf8("uniqueHashV2"), hash);
+    }
+
+    return hash;
+}
+
+QByteArray DImgLoader::uniqueHash(const QByteArray& fileHead, qint64 fileSize, const DImg& img)
+{
+    DMetadata metaDataFromImage(img.getMetadata());
+    QByteArray bv = metaDataFromImage.getExifEncoded();
+
+    // Same as uniqueHash(filePath): Exif data, first 8KB of the file and file size
+
+    QCryptographicHash md5(QCryptographicHash::Md5);
+    md5.addData(bv);
+
+    QByteArray hash;
+
+    if (!fileHead.isEmpty())
+    {
+        QByteArray size = 0;
+        md5.addData(fileHead.constData(), qMin(fileHead.size(), 8192));
+        md5.addData(size.setNum(fileSize));
+        hash = md5.result().toHex();
+    }
+
+    if (!hash.isNull())
+    {
+        const_cast<DImg&>(img).setAttribute(QLatin1String("uniqueHash"), hash);
+    }
+
+    return hash;
+}
+
 unsigned char* DImgLoader::new_failureTolerant(size_t unsecureSize)
 {
     return new_failureTolerant<unsigned char>(unsecureSize);
@@ -434,4 +487,18 @@ unsigned short* DImgLoader::new_short_failureTolerant(quint64 w, quint64 h, uint
     return new_failureTolerant<unsigned short>(w, h, typesPerPixel);
 }
 
+unsigned char* DImgLoader::new_imageData(quint64 w, quint64 h, uint bytesDepth)
+{
+    quint64 requested = w * h * quint64(bytesDepth);
+
+    if (requested > std::numeric_limits<size_t>::max())
+    {
+        qCCritical(DIGIKAM_DIMG_LOG) << "Requested memory of" << requested
+                                     << "is larger than size_t supported by platform.";
+        return 0;
+    }
+
+    return DImgBufferPool::instance()->allocate(requested);
+}
+
 }  // namespace Digikam
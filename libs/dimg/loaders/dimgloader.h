@@ -80,6 +80,13 @@ public:
 
     static QByteArray     uniqueHashV2(const QString& filePath, const DImg* const img = 0);
     static QByteArray     uniqueHash(const QString& filePath, const DImg& img, bool loadMetadata);
+
+    /** Same hashes computed from the parts of the file already read in memory: fileHead starts
+     *  at the beginning of the file, fileTail holds its last 100 kB, or the whole file if smaller.
+     *  uniqueHash() takes the Exif data from the metadata of img.
+     */
+    static QByteArray     uniqueHashV2(const QByteArray& fileHead, const QByteArray& fileTail, const DImg* const img = 0);
+    static QByteArray     uniqueHash(const QByteArray& fileHead, qint64 fileSize, const DImg& img);
     static HistoryImageId createHistoryImageId(const QString& filePath, const DImg& img, const DMetadata& metadata);
 
     static unsigned char*  new_failureTolerant(size_t unsecureSize);
@@ -87,6 +94,12 @@ public:
     static unsigned short* new_short_failureTolerant(size_t unsecureSize);
     static unsigned short* new_short_failureTolerant(quint64 w, quint64 h, uint typesPerPixel);
 
+    /** Allocates the data of an image of w x h pixels from the DImgBufferPool.
+     *  Images larger than the out-of-core threshold are mapped from a scratch file:
+     *  the data must be freed with DImgBufferPool::release(), not delete[].
+     */
+    static unsigned char*  new_imageData(quint64 w, quint64 h, uint bytesDepth);
+
     /** Value returned : -1 : unsupported platform
      *                    0 : parse failure from supported platform
      *                    1 : parse done with success from supported platform
@@ -60,6 +60,7 @@ extern "C"
 #include "dimg.h"
 #include "digikam_debug.h"
 #include "dimgloaderobserver.h"
+#include "dimgbufferpool.h"
 #include "dmetadata.h"
 #include "tiffloader.h"     //krazy:exclude=includes
 
@@ -276,7 +277,7 @@ bool TIFFLoader::load(const QString& filePath, DImgLoaderObserver* const observe
     // -------------------------------------------------------------------
     // Get image data.
 
-    QScopedArrayPointer<uchar> data;
+    QScopedPointer<uchar, DImgBufferPoolCleanup> data;
 
     if (m_loadFlags & LoadImageData)
     {
@@ -290,7 +291,7 @@ bool TIFFLoader::load(const QString& filePath, DImgLoaderObserver* const observe
 
         if (bits_per_sample == 16)          // 16 bits image.
         {
-            data.reset(new_failureTolerant(w, h, 8));
+            data.reset(new_imageData(w, h, 8));
             QScopedArrayPointer<uchar> strip(new_failureTolerant(strip_size));
 
             if (!data || strip.isNull())
@@ -303,6 +304,7 @@ bool TIFFLoader::load(const QString& filePath, DImgLoaderObserver* const observe
 
             long offset    = 0;
             long bytesRead = 0;
+            long released  = 0;
 
             uint checkpoint = 0;
 
@@ -450,11 +452,15 @@ bool TIFFLoader::load(const QString& filePath, DImgLoaderObserver* const observe
 
                     offset += bytesRead / 2 * 8;
                 }
+
+                // The rows done can leave memory if the image is out-of-core.
+                DImgBufferPool::instance()->releasePages(data.data(), released, offset);
+                released = offset;
             }
         }
         else if (bits_per_sample == 32)          // 32 bits image.
         {
-            data.reset(new_failureTolerant(w, h, 8));
+            data.reset(new_imageData(w, h, 8));
             QScopedArrayPointer<uchar> strip(new_failureTolerant(strip_size));
 
             if (!data || strip.isNull())
@@ -467,6 +473,7 @@ bool TIFFLoader::load(const QString& filePath, DImgLoaderObserver* const observe
 
             long  offset     = 0;
             long  bytesRead  = 0;
+            long  released   = 0;
 
             uint  checkpoint = 0;
             float maxValue   = 0.0;
@@ -631,11 +638,15 @@ bool TIFFLoader::load(const QString& filePath, DImgLoaderObserver* const observe
 
                     offset += bytesRead / 4 * 8;
                 }
+
+                // The rows done can leave memory if the image is out-of-core.
+                DImgBufferPool::instance()->releasePages(data.data(), released, offset);
+                released = offset;
             }
         }
         else       // Non 16 or 32 bits images ==> get it on BGRA 8 bits.
         {
-            data.reset(new_failureTolerant(w, h, 4));
+            data.reset(new_imageData(w, h, 4));
             QScopedArrayPointer<uchar> strip(new_failureTolerant(w, rows_per_strip, 4));
 
             if (!data || strip.isNull())
@@ -648,6 +659,7 @@ bool TIFFLoader::load(const QString& filePath, DImgLoaderObserver* const observe
 
             long offset     = 0;
             long pixelsRead = 0;
+            long released   = 0;
 
             // this is inspired by TIFFReadRGBAStrip, tif_getimage.c
             char          emsg[1024] = "";
@@ -731,6 +743,10 @@ bool TIFFLoader::load(const QString& filePath, DImgLoaderObserver* const observe
                 }
 
                 offset += pixelsRead * 4;
+
+                // The rows done can leave memory if the image is out-of-core.
+                DImgBufferPool::instance()->releasePages(data.data(), released, offset);
+                released = offset;
             }
 
             TIFFRGBAImageEnd(&img);
@@ -88,13 +88,18 @@ void DMetadata::setSettings(const MetadataSettingsContainer& settings)
 }
 
 bool DMetadata::load(const QString& filePath) const
+{
+    return load(filePath, QByteArray());
+}
+
+bool DMetadata::load(const QString& filePath, const QByteArray& imgData) const
 {
     // In first, we trying to get metadata using Exiv2,
     // else we will use Raw engine to extract minimal information.
 
     FileReadLocker lock(filePath);
 
-    if (!MetaEngine::load(filePath))
+    if (!MetaEngine::load(filePath, imgData))
     {
         if (!loadUsingRawEngine(filePath))
         {
@@ -63,6 +63,12 @@ public:
     /** Re-implemented from libMetaEngine to use dcraw identify method if Exiv2 failed.
      */
     bool load(const QString& filePath) const;
+
+    /** Same as load(filePath), with the content of the file already read in memory.
+     *  See MetaEngine::load(const QString&, const QByteArray&).
+     */
+    bool load(const QString& filePath, const QByteArray& imgData) const;
+
     bool save(const QString& filePath) const;
     bool applyChanges() const;
 
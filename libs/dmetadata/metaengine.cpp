@@ -265,6 +265,11 @@ bool MetaEngine::loadFromData(const QByteArray& imgData) const
 }
 
 bool MetaEngine::load(const QString& filePath) const
+{
+    return load(filePath, QByteArray());
+}
+
+bool MetaEngine::load(const QString& filePath, const QByteArray& imgData) const
 {
     if (filePath.isEmpty())
     {
@@ -278,7 +283,15 @@ bool MetaEngine::load(const QString& filePath) const
     {
         Exiv2::Image::AutoPtr image;
 
-        image        = Exiv2::ImageFactory::open((const char*)(QFile::encodeName(filePath)).constData());
+        if (imgData.isNull())
+        {
+            image    = Exiv2::ImageFactory::open((const char*)(QFile::encodeName(filePath)).constData());
+        }
+        else
+        {
+            // Exiv2 parses the data in place, it is not copied
+            image    = Exiv2::ImageFactory::open((const Exiv2::byte*)imgData.constData(), imgData.size());
+        }
 
         image->readMetadata();
 
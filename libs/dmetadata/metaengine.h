@@ -227,6 +227,12 @@ public:
      */
     virtual bool load(const QString& filePath) const;
 
+    /** Same as load(filePath), but the content of the file is given in imgData, already read
+        in memory (as the start of a JPEG file up to its image data), and is parsed instead of reading the file again.
+        The XMP sidecar of filePath is still read from disk. If imgData is null, the file is read.
+     */
+    bool load(const QString& filePath, const QByteArray& imgData) const;
+
     /** Save all metadata to a file. This one can be different than original picture to perform
         transfert operation Return true if metadata have been saved into file.
      */
@@ -252,6 +252,151 @@ public:
 
 // ---------------------------------------------------------------------------------------------------
 
+/**
+ * The grayscale image downscaled by the successive powers of a scale step, which is what
+ * cv::CascadeClassifier::detectMultiScale() computes for each call. The levels are built once
+ * per image and scanned by all cascades and regions searched with the same step.
+ *
+ * detectMultiScale() scans the levels downscaled by 2 or more at every pixel, and the others
+ * at every second pixel. A level it is given is scanned at scale 1, so at every second pixel:
+ * only the levels downscaled by less than 2 are built, the smaller ones are left to detectMultiScale().
+ */
+class DetectionPyramid
+{
+public:
+
+    enum
+    {
+        /// Factor from which detectMultiScale() scans every pixel of a level
+        DenseScanFactor = 2
+    };
+
+public:
+
+    DetectionPyramid()
+        : scaleStep(0),
+          remainingFactor(0)
+    {
+    }
+
+    void build(const cv::Mat& image, double step, const cv::Size& minWindowSize)
+    {
+        scaleStep       = step;
+        remainingFactor = 0;
+        factors.clear();
+        levels.clear();
+
+        if (image.empty() || step <= 1.0)
+        {
+            return;
+        }
+
+        // The factors are computed as detectMultiScale() does, by successive products.
+
+        for (double factor = 1.0 ; ; factor *= step)
+        {
+            if (factor >= DenseScanFactor)
+            {
+                remainingFactor = factor;
+                break;
+            }
+
+            const cv::Size levelSize(cvRound(image.cols / factor), cvRound(image.rows / factor));
+
+            if (levelSize.width <= minWindowSize.width || levelSize.height <= minWindowSize.height)
+            {
+                break;
+            }
+
+            cv::Mat level;
+
+            if (factor == 1.0)
+            {
+                level = image;
+            }
+            else
+            {
+                cv::resize(image, level, levelSize, 0, 0, cv::INTER_LINEAR);
+            }
+
+            factors.push_back(factor);
+            levels.push_back(level);
+        }
+    }
+
+    bool isValid() const
+    {
+        return (scaleStep > 1.0);
+    }
+
+public:
+
+    double               scaleStep;
+
+    /// The first factor of the levels which are not built, 0 if the image is too small for them.
+    double               remainingFactor;
+
+    std::vector<double>  factors;
+    std::vector<cv::Mat> levels;
+};
+
+/**
+ * Builds the pyramids of a batch of images in parallel.
+ */
+class DetectionPyramidBuilder : public cv::ParallelLoopBody
+{
+public:
+
+    DetectionPyramidBuilder(const std::vector<cv::Mat>& images, std::vector<DetectionPyramid>& pyramids,
+                            double step, const cv::Size& minWindowSize)
+        : images(images),
+          pyramids(pyramids),
+          step(step),
+          minWindowSize(minWindowSize)
+    {
+    }
+
+    void operator()(const cv::Range& range) const
+    {
+        for (int i = range.start ; i < range.end ; ++i)
+        {
+            pyramids[i].build(images[i], step, minWindowSize);
+        }
+    }
+
+private:
+
+    const std::vector<cv::Mat>&    images;
+    std::vector<DetectionPyramid>& pyramids;
+    double                         step;
+    cv::Size                       minWindowSize;
+};
+
+/**
+ * Returns true if the cascade can scan a DetectionPyramid. This needs the window size of the cascade,
+ * which is only available for cascades in the new format with OpenCV 3.
+ */
+static bool scansPyramid(const Cascade& cascade)
+{
+#if OPENCV_TEST_VERSION(3,0,0)
+    Q_UNUSED(cascade);
+    return false;
+#else
+    return (!cascade.empty() && !cascade.isOldFormatCascade());
+#endif
+}
+
+static cv::Size windowSize(const Cascade& cascade)
+{
+#if OPENCV_TEST_VERSION(3,0,0)
+    return cascade.getOriginalWindowSize();
+#else
+    return cascade.cv::CascadeClassifier::getOriginalWindowSize();
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------------
+
 class OpenCVFaceDetector::Private
 {
 
@@ -263,6 +408,7 @@ public:
         minDuplicates            = 0;
         speedVsAccuracy          = 0.8;
         sensitivityVsSpecificity = 0.8;
+        pyramids                 = true;
     }
 
 public:
@@ -279,7 +425,48 @@ public:
     double                 speedVsAccuracy;
     double                 sensitivityVsSpecificity;
 
+    bool                   pyramids;
+
     QMutex                 mutex;
+
+public:
+
+    bool usesPyramids() const
+    {
+        if (!pyramids)
+        {
+            return false;
+        }
+
+        foreach (const Cascade& cascade, cascades)
+        {
+            if (scansPyramid(cascade))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /// The smallest window of the cascades scanning pyramids: smaller levels are never scanned.
+    cv::Size minimumWindowSize() const
+    {
+        cv::Size minSize;
+
+        foreach (const Cascade& cascade, cascades)
+        {
+            if (scansPyramid(cascade))
+            {
+                const cv::Size size = windowSize(cascade);
+                minSize             = (minSize.area() == 0) ? size
+                                                            : cv::Size(cv::min(minSize.width,  size.width),
+                                                                       cv::min(minSize.height, size.height));
+            }
+        }
+
+        return minSize;
+    }
 };
 
 // --------------------------------------------------------------------------------
@@ -338,6 +525,16 @@ void OpenCVFaceDetector::setSpecificity(double sensitivityVsSpecificity)
     d->sensitivityVsSpecificity = qBound(0.0, sensitivityVsSpecificity, 1.0);
 }
 
+void OpenCVFaceDetector::setUsePyramids(bool usePyramids)
+{
+    d->pyramids = usePyramids;
+}
+
+bool OpenCVFaceDetector::usesPyramids() const
+{
+    return d->pyramids;
+}
+
 void OpenCVFaceDetector::updateParameters(const cv::Size& /*scaledSize*/, const cv::Size& originalSize)
 {
     double origSize = double(cv::max(originalSize.width, originalSize.height)) / 1000;
@@ -475,7 +672,94 @@ QList<QRect> OpenCVFaceDetector::cascadeResult(const cv::Mat& inputImage,
     return results;
 }
 
-bool OpenCVFaceDetector::verifyFace(const cv::Mat& inputImage, const QRect& face) const
+QList<QRect> OpenCVFaceDetector::cascadeResult(const cv::Mat& inputImage,
+                                               const DetectionPyramid& pyramid,
+                                               const cv::Rect& region,
+                                               Cascade& cascade,
+                                               const DetectObjectParameters& params) const
+{
+    const cv::Rect imageRegion = region & cv::Rect(0, 0, inputImage.cols, inputImage.rows);
+
+    if (!pyramid.isValid() || !scansPyramid(cascade) || pyramid.scaleStep != params.searchIncrement)
+    {
+        return cascadeResult(inputImage(imageRegion), cascade, params);
+    }
+
+    // Scan each level of the pyramid at the window size of the cascade, as detectMultiScale()
+    // does with the levels it computes, and group the candidates of all levels afterwards.
+    // The candidates are the ones of detectMultiScale() on the region, but for the pixels
+    // at the border of the region, which are downscaled from the whole image here.
+
+    const cv::Size window = windowSize(cascade);
+    std::vector<cv::Rect> candidates;
+
+    QMutexLocker locker(&d->mutex);
+
+    for (size_t i = 0 ; i < pyramid.levels.size() ; ++i)
+    {
+        const double   factor = pyramid.factors[i];
+        const cv::Mat& level  = pyramid.levels[i];
+        const cv::Size levelWindow(cvRound(window.width * factor), cvRound(window.height * factor));
+
+        const cv::Rect levelRegion = cv::Rect(cvRound(imageRegion.x      / factor),
+                                              cvRound(imageRegion.y      / factor),
+                                              cvRound(imageRegion.width  / factor),
+                                              cvRound(imageRegion.height / factor))
+                                     & cv::Rect(0, 0, level.cols, level.rows);
+
+        if (levelRegion.width <= window.width || levelRegion.height <= window.height)
+        {
+            break;
+        }
+
+        if (levelWindow.width < params.minSize.width || levelWindow.height < params.minSize.height)
+        {
+            continue;
+        }
+
+        std::vector<cv::Rect> found;
+        cascade.detectMultiScale(level(levelRegion), found, 1.1, 0, params.flags, window, window);
+
+        for (std::vector<cv::Rect>::const_iterator it = found.begin() ; it != found.end() ; ++it)
+        {
+            candidates.push_back(cv::Rect(cvRound((levelRegion.x + it->x) * factor) - imageRegion.x,
+                                          cvRound((levelRegion.y + it->y) * factor) - imageRegion.y,
+                                          levelWindow.width, levelWindow.height));
+        }
+    }
+
+    // The smaller levels are scanned at every pixel by detectMultiScale() itself,
+    // from the window size of the first of them.
+
+    if (pyramid.remainingFactor > 0)
+    {
+        const cv::Size minSize(cv::max(cvRound(window.width  * pyramid.remainingFactor), params.minSize.width),
+                               cv::max(cvRound(window.height * pyramid.remainingFactor), params.minSize.height));
+
+        if (imageRegion.width > minSize.width && imageRegion.height > minSize.height)
+        {
+            std::vector<cv::Rect> found;
+            cascade.detectMultiScale(inputImage(imageRegion), found, params.searchIncrement, 0, params.flags, minSize);
+            candidates.insert(candidates.end(), found.begin(), found.end());
+        }
+    }
+
+    if (params.grouping > 0)
+    {
+        cv::groupRectangles(candidates, params.grouping, 0.2);
+    }
+
+    QList<QRect> results;
+
+    for (std::vector<cv::Rect>::const_iterator it = candidates.begin() ; it != candidates.end() ; ++it)
+    {
+        results << toQRect(*it);
+    }
+
+    return results;
+}
+
+bool OpenCVFaceDetector::verifyFace(const cv::Mat& inputImage, const DetectionPyramid& pyramid, const QRect& face) const
 {
     // check if we need to verify
     bool hasVerifyingCascade = false;
@@ -507,9 +791,6 @@ bool OpenCVFaceDetector::verifyFace(const cv::Mat& inputImage, const QRect& face
     extendedRect.height     = cv::min(inputImage.rows - extendedRect.y, extendedRect.height);
 
 
-    // shallow copy by ROI
-    cv::Mat extendedFaceImg = inputImage(extendedRect);
-
     QList<QRect> foundFaces;
     int frontalFaceVotes   = 0;
     int facialFeatureVotes = 0;
@@ -527,9 +808,8 @@ bool OpenCVFaceDetector::verifyFace(const cv::Mat& inputImage, const QRect& face
                 d->verifyingParams.grouping = 2;
 
                 cv::Rect roi      = d->cascades[i].faceROI(faceRect);
-                cv::Mat  feature  = inputImage(roi);
                 qCDebug(DIGIKAM_FACESENGINE_LOG) << "feature " << d->cascades[i].roi << toQRect(faceRect) << toQRect(roi);
-                foundFaces        = cascadeResult(feature, d->cascades[i], d->verifyingParams);
+                foundFaces        = cascadeResult(inputImage, pyramid, roi, d->cascades[i], d->verifyingParams);
 
                 if (!foundFaces.isEmpty())
                     facialFeatureVotes++;
@@ -575,7 +855,7 @@ bool OpenCVFaceDetector::verifyFace(const cv::Mat& inputImage, const QRect& face
             {
                 d->verifyingParams.grouping = 3;
 
-                foundFaces = cascadeResult(extendedFaceImg, d->cascades[i], d->verifyingParams);
+                foundFaces = cascadeResult(inputImage, pyramid, extendedRect, d->cascades[i], d->verifyingParams);
 
                 // We dont need to check the size of found regions, the minSize in verifyingParams is large enough
                 if (!foundFaces.empty())
@@ -791,25 +1071,92 @@ QList<QRect> OpenCVFaceDetector::detectFaces(const cv::Mat& inputImage, const cv
 
     updateParameters(inputImage.size(), originalSize);
 
+    DetectionPyramid pyramid;
+
+    if (d->usesPyramids())
+    {
+        pyramid.build(inputImage, d->primaryParams.searchIncrement, d->minimumWindowSize());
+    }
+
+    return detectFacesInPyramid(inputImage, pyramid);
+}
+
+QList<QList<QRect> > OpenCVFaceDetector::detectFaces(const std::vector<cv::Mat>& inputImages,
+                                                     const std::vector<cv::Size>& originalSizes)
+{
+    QList<QList<QRect> > results;
+
+    if (inputImages.empty())
+    {
+        return results;
+    }
+
+    // The search increment does not depend on the image size: all pyramids can be built beforehand.
+    updateParameters(inputImages.front().size(), originalSizes.empty() ? cv::Size(0, 0) : originalSizes.front());
+
+    std::vector<DetectionPyramid> pyramids(inputImages.size());
+
+    if (d->usesPyramids())
+    {
+        cv::parallel_for_(cv::Range(0, (int)inputImages.size()),
+                          DetectionPyramidBuilder(inputImages, pyramids,
+                                                  d->primaryParams.searchIncrement,
+                                                  d->minimumWindowSize()));
+    }
+
+    for (size_t i = 0 ; i < inputImages.size() ; ++i)
+    {
+        if (inputImages[i].empty())
+        {
+            qCDebug(DIGIKAM_FACESENGINE_LOG) << "Invalid image given, not detecting faces.";
+            results << QList<QRect>();
+            continue;
+        }
+
+        updateParameters(inputImages[i].size(), (i < originalSizes.size()) ? originalSizes[i] : cv::Size(0, 0));
+
+        results << detectFacesInPyramid(inputImages[i], pyramids[i]);
+
+        // Release the levels as soon as the image is done
+        pyramids[i] = DetectionPyramid();
+    }
+
+    return results;
+}
+
+QList<QRect> OpenCVFaceDetector::detectFacesInPyramid(const cv::Mat& inputImage, const DetectionPyramid& pyramid)
+{
     // Now loop through each cascade, apply it, and get back a vector of detected faces
     QList<QList<QRect> > primaryResults;
     QList<QRect> results;
 
+    const cv::Rect imageRect(0, 0, inputImage.cols, inputImage.rows);
+
     for (int i=0; i<d->cascades.size(); ++i)
     {
         if (d->cascades[i].primaryCascade)
         {
-            primaryResults << cascadeResult(inputImage, d->cascades[i], d->primaryParams);
+            primaryResults << cascadeResult(inputImage, pyramid, imageRect, d->cascades[i], d->primaryParams);
         }
     }
 
     // Merge overlaps of face regions by different cascades.
     results = mergeFaces(inputImage, primaryResults);
 
+    // The verifying cascades search with their own increment, usually the same as the primary one.
+    DetectionPyramid verifyingPyramid;
+    const DetectionPyramid* verifying = &pyramid;
+
+    if (!results.isEmpty() && pyramid.isValid() && pyramid.scaleStep != d->verifyingParams.searchIncrement)
+    {
+        verifyingPyramid.build(inputImage, d->verifyingParams.searchIncrement, d->minimumWindowSize());
+        verifying = &verifyingPyramid;
+    }
+
     // Verify faces using other cascades
     for (QList<QRect>::iterator it = results.begin(); it != results.end(); )
     {
-        if (!verifyFace(inputImage, *it))
+        if (!verifyFace(inputImage, *verifying, *it))
             it = results.erase(it);
         else
             ++it;
@@ -50,6 +50,7 @@ namespace Digikam
 {
 
 class Cascade;
+class DetectionPyramid;
 class DetectObjectParameters;
 
 class OpenCVFaceDetector
@@ -63,6 +64,14 @@ public:
     cv::Mat prepareForDetection(const Digikam::DImg& inputImage) const;
     QList<QRect> detectFaces(const cv::Mat& inputImage, const cv::Size& originalSize = cv::Size(0, 0));
 
+    /**
+     * Detects faces in a batch of prepared images. The detection pyramids of the images
+     * are built in parallel, then the images are scanned in turn.
+     * originalSizes may be empty, or give the original size of each image.
+     */
+    QList<QList<QRect> > detectFaces(const std::vector<cv::Mat>& inputImages,
+                                     const std::vector<cv::Size>& originalSizes = std::vector<cv::Size>());
+
     /**
      * Tunes the parameters.
      * There are two orthogonal dimensions to adjust:
@@ -78,6 +87,13 @@ public:
     double accuracy()    const;
     double specificity() const;
 
+    /**
+     * Sets if the cascades scan the downscaled levels of the image shared by all of them,
+     * which is the default, or if each cascade downscales the regions it searches itself.
+     */
+    void setUsePyramids(bool usePyramids);
+    bool usesPyramids() const;
+
     /**
      * Returns the image size (one dimension)
      * recommended for face detection. If the image is considerably larger, it will be rescaled automatically.
@@ -96,7 +112,16 @@ private:
      */
     QList<QRect> cascadeResult(const cv::Mat& inputImage, Cascade& cascade, const DetectObjectParameters& params) const;
 
-    bool verifyFace(const cv::Mat& inputImage, const QRect& face) const;
+    /**
+     *  Same as above on a region of the image, scanning the levels of the image pyramid if the cascade
+     *  supports it. The returned faces are relative to the region.
+     */
+    QList<QRect> cascadeResult(const cv::Mat& inputImage, const DetectionPyramid& pyramid, const cv::Rect& region,
+                               Cascade& cascade, const DetectObjectParameters& params) const;
+
+    bool verifyFace(const cv::Mat& inputImage, const DetectionPyramid& pyramid, const QRect& face) const;
+
+    QList<QRect> detectFacesInPyramid(const cv::Mat& inputImage, const DetectionPyramid& pyramid);
 
     /**
      * Returns the faces from the detection results of multiple cascades
@@ -96,6 +96,10 @@ public:
             {
                 backend()->setSpecificity(1.0 - it.value().toDouble());
             }
+            else if (it.key() == QString::fromLatin1("pyramids"))
+            {
+                backend()->setUsePyramids(it.value().toBool());
+            }
         }
     }
 
@@ -214,6 +218,57 @@ QList<QRectF> FaceDetector::detectFaces(const Digikam::DImg& image, const QSize&
     return result;
 }
 
+QList<QList<QRectF> > FaceDetector::detectFaces(const QList<QImage>& images, const QList<QSize>& originalSizes)
+{
+    QList<QList<QRectF> > result;
+
+    try
+    {
+        std::vector<cv::Mat>  cvImages;
+        std::vector<cv::Size> cvOriginalSizes;
+
+        for (int i = 0 ; i < images.size() ; ++i)
+        {
+            const QImage& image = images.at(i);
+
+            if (i < originalSizes.size() && originalSizes.at(i).isValid())
+            {
+                cvOriginalSizes.push_back(cv::Size(originalSizes.at(i).width(), originalSizes.at(i).height()));
+            }
+            else
+            {
+                cvOriginalSizes.push_back(cv::Size(image.width(), image.height()));
+            }
+
+            // Null images give an empty matrix, for which no face is detected
+            cvImages.push_back(d->backend()->prepareForDetection(image));
+        }
+
+        QList<QList<QRect> > absRects = d->backend()->detectFaces(cvImages, cvOriginalSizes);
+
+        for (int i = 0 ; i < absRects.size() ; ++i)
+        {
+            result << toRelativeRects(absRects.at(i), QSize(cvImages[i].cols, cvImages[i].rows));
+        }
+    }
+    catch (cv::Exception& e)
+    {
+        qCCritical(DIGIKAM_FACESENGINE_LOG) << "cv::Exception:" << e.what();
+    }
+    catch(...)
+    {
+        qCCritical(DIGIKAM_FACESENGINE_LOG) << "Default exception from OpenCV";
+    }
+
+    // One list per image, also if detection failed
+    while (result.size() < images.size())
+    {
+        result << QList<QRectF>();
+    }
+
+    return result;
+}
+
 
 void FaceDetector::setParameter(const QString& parameter, const QVariant& value)
 {
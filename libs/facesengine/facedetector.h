@@ -82,6 +82,14 @@ public:
      */
     QList<QRectF> detectFaces(const Digikam::DImg& image, const QSize& originalSize = QSize());
 
+    /**
+     * Scan a batch of images for faces. Returns, for each image, the same list
+     * as detectFaces() would. The detection of the images shares its setup work,
+     * which is cheaper than detecting faces image by image.
+     * originalSizes may be empty, or give the original size of each image.
+     */
+    QList<QList<QRectF> > detectFaces(const QList<QImage>& images, const QList<QSize>& originalSizes = QList<QSize>());
+
     /**
      * Tunes backend parameters.
      * Available parameters:
@@ -92,6 +100,9 @@ public:
      * For both pairs: a = 1-b, you can set either.
      * The first pair changes the ROC curve in a trade for computing time.
      * The second pair moves on a given ROC curve towards more false positives, or more missed faces.
+     *
+     * "pyramids", bool, true by default: the cascades scan downscaled levels of the image shared by
+     * all of them. If false, each cascade downscales the regions it searches itself, which is slower.
      */
     void        setParameter(const QString& parameter, const QVariant& value);
     void        setParameters(const QVariantMap& parameters);
@@ -34,6 +34,12 @@
 
 #include <set>
 #include <limits>
+#include <cfloat>
+#include <cmath>
+
+// Qt includes
+
+#include <QMutexLocker>
 
 // Local includes
 
@@ -368,23 +374,137 @@ void LBPHFaceRecognizer::train(InputArrayOfArrays _in_src, InputArray _inm_label
         // add to templates
         m_histograms.push_back(p);
     }
+
+    packHistograms();
 }
 
-#if OPENCV_TEST_VERSION(3,1,0)
-void LBPHFaceRecognizer::predict(InputArray _src, int &minClass, double &minDist) const
-#else
-void LBPHFaceRecognizer::predict(cv::InputArray _src, cv::Ptr<cv::face::PredictCollector> collector) const
-#endif
+//------------------------------------------------------------------------------
+
+/** Same result as cv::compareHist(h1, h2, CV_COMP_CHISQR) on rows of floats. The branch-free
+ *  body and the independent sums let the compiler vectorize the loop.
+ */
+static double chiSquare(const float* const h1, const float* const h2, int length)
 {
-    if (m_histograms.empty())
+    double sum[4] = { 0.0, 0.0, 0.0, 0.0 };
+    int i         = 0;
+
+    for ( ; i <= length - 4 ; i += 4)
     {
-        // throw error if no data (or simply return -1?)
-        String error_message = "This LBPH model is not computed yet. Did you call the train method?";
+        for (int k = 0 ; k < 4 ; ++k)
+        {
+            const double a = h1[i + k] - h2[i + k];
+            const double b = h1[i + k];
+            sum[k]        += (fabs(b) > DBL_EPSILON) ? a * a / b : 0.0;
+        }
+    }
+
+    for ( ; i < length ; ++i)
+    {
+        const double a = h1[i] - h2[i];
+        const double b = h1[i];
+        sum[0]        += (fabs(b) > DBL_EPSILON) ? a * a / b : 0.0;
+    }
+
+    return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+}
+
+/** Computes the distances for a range of trained histograms. Each trained histogram
+ *  is compared to all queries while it is in the cache.
+ */
+class ChiSquareDistancesBody : public ParallelLoopBody
+{
+public:
+
+    ChiSquareDistancesBody(const Mat& samples, const Mat& queries, Mat& distances)
+        : m_samples(samples),
+          m_queries(queries),
+          m_distances(distances)
+    {
+    }
+
+    void operator()(const Range& range) const
+    {
+        for (int sampleIdx = range.start ; sampleIdx < range.end ; ++sampleIdx)
+        {
+            const float* const sample = m_samples.ptr<float>(sampleIdx);
+
+            for (int queryIdx = 0 ; queryIdx < m_queries.rows ; ++queryIdx)
+            {
+                m_distances.at<double>(queryIdx, sampleIdx) = chiSquare(sample, m_queries.ptr<float>(queryIdx), m_samples.cols);
+            }
+        }
+    }
+
+private:
+
+    const Mat& m_samples;
+    const Mat& m_queries;
+    Mat&       m_distances;
+};
+
+void LBPHFaceRecognizer::packHistograms() const
+{
+    QMutexLocker lock(&m_packingMutex);
+
+    // Histograms already packed, in the same order, are kept.
+    int packed = 0;
+
+    while (packed < m_packedHistograms.rows && packed < (int)m_histograms.size() &&
+           m_histograms[packed].data == m_packedHistograms.ptr(packed))
+    {
+        packed++;
+    }
+
+    if (packed == (int)m_histograms.size() && packed == m_packedHistograms.rows)
+    {
+        return;
+    }
+
+    if (packed < m_packedHistograms.rows)
+    {
+        // Other histograms may still refer to the rows after the packed ones: do not overwrite them
+        m_packedHistograms = packed ? Mat(m_packedHistograms.rowRange(0, packed).clone()) : Mat();
+    }
+
+    for (size_t sampleIdx = packed; sampleIdx < m_histograms.size(); sampleIdx++)
+    {
+        Mat row = m_histograms[sampleIdx].reshape(1, 1);
+
+        if (row.type() != CV_32FC1)
+        {
+            Mat converted;
+            row.convertTo(converted, CV_32FC1);
+            row = converted;
+        }
+
+        // Grows the matrix by a factor as std::vector does, moving the rows when reallocating
+        m_packedHistograms.push_back(row);
+    }
+
+    for (size_t sampleIdx = 0; sampleIdx < m_histograms.size(); sampleIdx++)
+    {
+        m_histograms[sampleIdx] = m_packedHistograms.row((int)sampleIdx);
+    }
+}
+
+Mat LBPHFaceRecognizer::distances(const Mat& queries) const
+{
+    packHistograms();
+
+    if (queries.cols != m_packedHistograms.cols)
+    {
+        String error_message = format("Wrong histogram size. Expected %d, but was %d.", m_packedHistograms.cols, queries.cols);
         CV_Error(CV_StsBadArg, error_message);
     }
 
-    Mat src = _src.getMat();
+    Mat dists(queries.rows, m_packedHistograms.rows, CV_64FC1);
+    parallel_for_(Range(0, m_packedHistograms.rows), ChiSquareDistancesBody(m_packedHistograms, queries, dists));
 
+    return dists;
+}
+
+Mat LBPHFaceRecognizer::queryHistogram(const Mat& src) const
+{
     // get the spatial histogram from input image
     Mat lbp_image = elbp(src, m_radius, m_neighbors);
     Mat query     = spatial_histogram(lbp_image,                                                         /* lbp_image                   */
@@ -393,11 +513,81 @@ void LBPHFaceRecognizer::predict(cv::InputArray _src, cv::Ptr<cv::face::PredictC
                                       m_grid_y,                                                          /* grid size y                 */
                                       true                                                               /* normed histograms           */
                                      );
+    return query;
+}
+
 #if OPENCV_TEST_VERSION(3,1,0)
-    minDist      = DBL_MAX;
-    minClass     = -1;
+void LBPHFaceRecognizer::predict(InputArray _src, int &minClass, double &minDist) const
+#else
+void LBPHFaceRecognizer::predict(cv::InputArray _src, cv::Ptr<cv::face::PredictCollector> collector) const
+#endif
+{
+    if (m_histograms.empty())
+    {
+        // throw error if no data (or simply return -1?)
+        String error_message = "This LBPH model is not computed yet. Did you call the train method?";
+        CV_Error(CV_StsBadArg, error_message);
+    }
+
+    Mat query = queryHistogram(_src.getMat());
+    Mat dists = distances(query);
+
+#if OPENCV_TEST_VERSION(3,1,0)
+    evaluate(dists.ptr<double>(0), minClass, minDist);
 #else
     collector->init((int)m_histograms.size());
+    evaluate(dists.ptr<double>(0), collector);
+#endif
+}
+
+void LBPHFaceRecognizer::predict(const std::vector<Mat>& src, std::vector<int>& labels, std::vector<double>& dists) const
+{
+    if (m_histograms.empty())
+    {
+        String error_message = "This LBPH model is not computed yet. Did you call the train method?";
+        CV_Error(CV_StsBadArg, error_message);
+    }
+
+    labels.assign(src.size(), -1);
+    dists.assign(src.size(), DBL_MAX);
+
+    if (src.empty())
+    {
+        return;
+    }
+
+    Mat queries;
+
+    for (size_t queryIdx = 0; queryIdx < src.size(); queryIdx++)
+    {
+        queries.push_back(queryHistogram(src[queryIdx]));
+    }
+
+    Mat queryDists = distances(queries);
+
+    for (size_t queryIdx = 0; queryIdx < src.size(); queryIdx++)
+    {
+#if OPENCV_TEST_VERSION(3,1,0)
+        evaluate(queryDists.ptr<double>((int)queryIdx), labels[queryIdx], dists[queryIdx]);
+#else
+        Ptr<cv::face::StandardCollector> collector = cv::face::StandardCollector::create(m_threshold);
+        collector->init((int)m_histograms.size());
+        evaluate(queryDists.ptr<double>((int)queryIdx), collector);
+        labels[queryIdx] = collector->getMinLabel();
+        dists[queryIdx]  = collector->getMinDist();
+#endif
+    }
+}
+
+#if OPENCV_TEST_VERSION(3,1,0)
+void LBPHFaceRecognizer::evaluate(const double* const dists, int& minClass, double& minDist) const
+#else
+bool LBPHFaceRecognizer::evaluate(const double* const dists, cv::Ptr<cv::face::PredictCollector> collector) const
+#endif
+{
+#if OPENCV_TEST_VERSION(3,1,0)
+    minDist      = DBL_MAX;
+    minClass     = -1;
 #endif
 
     // This is the standard method
@@ -407,7 +597,7 @@ void LBPHFaceRecognizer::predict(cv::InputArray _src, cv::Ptr<cv::face::PredictC
         // find 1-nearest neighbor
         for (size_t sampleIdx = 0; sampleIdx < m_histograms.size(); sampleIdx++)
         {
-            double dist = compareHist(m_histograms[sampleIdx], query, CV_COMP_CHISQR);
+            double dist = dists[sampleIdx];
 
 #if OPENCV_TEST_VERSION(3,1,0)
             if ((dist < minDist) && (dist < m_threshold))
@@ -420,7 +610,7 @@ void LBPHFaceRecognizer::predict(cv::InputArray _src, cv::Ptr<cv::face::PredictC
 
             if (!collector->collect(label, dist))
             {
-                return;
+                return false;
             }
 #endif
         }
@@ -436,7 +626,7 @@ void LBPHFaceRecognizer::predict(cv::InputArray _src, cv::Ptr<cv::face::PredictC
 
         for (size_t sampleIdx = 0; sampleIdx < m_histograms.size(); sampleIdx++)
         {
-            double dist                 = compareHist(m_histograms[sampleIdx], query, CV_COMP_CHISQR);
+            double dist                 = dists[sampleIdx];
             std::vector<int>& distances = distancesMap[m_labels.at<int>((int) sampleIdx)];
             distances.push_back(dist);
         }
@@ -466,7 +656,7 @@ void LBPHFaceRecognizer::predict(cv::InputArray _src, cv::Ptr<cv::face::PredictC
 #else
             if (!collector->collect(it->first, mean))
             {
-                return;
+                return false;
             }
 #endif
         }
@@ -484,7 +674,7 @@ void LBPHFaceRecognizer::predict(cv::InputArray _src, cv::Ptr<cv::face::PredictC
         for (size_t sampleIdx = 0; sampleIdx < m_histograms.size(); sampleIdx++)
         {
             int label   = m_labels.at<int>((int) sampleIdx);
-            double dist = compareHist(m_histograms[sampleIdx], query, CV_COMP_CHISQR);
+            double dist = dists[sampleIdx];
             distancesMap.insert(std::pair<double, int>(dist, label));
             countMap[label]++;
         }
@@ -519,13 +709,17 @@ void LBPHFaceRecognizer::predict(cv::InputArray _src, cv::Ptr<cv::face::PredictC
             // large is better thus it is -score.
             if (!collector->collect(it->first, -score))
             {
-                return;
+                return false;
             }
 #endif
         }
 
         qCDebug(DIGIKAM_FACESENGINE_LOG) << s;
     }
+
+#if !OPENCV_TEST_VERSION(3,1,0)
+    return true;
+#endif
 }
 
 #if OPENCV_TEST_VERSION(3,1,0)
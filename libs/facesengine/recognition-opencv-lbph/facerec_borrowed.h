@@ -38,6 +38,10 @@
 
 #include <vector>
 
+// Qt includes
+
+#include <QMutex>
+
 namespace Digikam
 {
 
@@ -158,6 +162,12 @@ public:
     void predict(cv::InputArray src, cv::Ptr<cv::face::PredictCollector> collector) const override;
 #endif
 
+    /**
+     * Predicts the label and distance of each query image in src, as predict() does for one image.
+     * The distances of all queries are computed together, sharing the reads of the trained histograms.
+     */
+    void predict(const std::vector<cv::Mat>& src, std::vector<int>& labels, std::vector<double>& dists) const;
+
     /**
      * See FaceRecognizer::load().
      */
@@ -229,18 +239,44 @@ private:
      */
     void train(cv::InputArrayOfArrays src, cv::InputArray labels, bool preserveData);
 
+    /** Returns the spatial histogram of a query image.
+     */
+    cv::Mat queryHistogram(const cv::Mat& src) const;
+
+    /** Copies the histograms not packed yet to the rows of m_packedHistograms,
+     *  and makes all histograms refer to their row.
+     */
+    void packHistograms() const;
+
+    /** Returns the chi-square distances between the query histograms (rows) and
+     *  all trained histograms (columns), as a CV_64FC1 matrix.
+     */
+    cv::Mat distances(const cv::Mat& queries) const;
+
+    /** Applies the prediction statistics to the distances of a query to all trained histograms.
+     */
+#if OPENCV_TEST_VERSION(3,1,0)
+    void evaluate(const double* const dists, int& minClass, double& minDist) const;
+#else
+    bool evaluate(const double* const dists, cv::Ptr<cv::face::PredictCollector> collector) const;
+#endif
+
 private:
 
     // NOTE: Do not use a d private internal container, this will crash OpenCV in cv::Algorithm::set()
-    int                  m_grid_x;
-    int                  m_grid_y;
-    int                  m_radius;
-    int                  m_neighbors;
-    double               m_threshold;
-    int                  m_statisticsMode;
-
-    std::vector<cv::Mat> m_histograms;
-    cv::Mat              m_labels;
+    int                          m_grid_x;
+    int                          m_grid_y;
+    int                          m_radius;
+    int                          m_neighbors;
+    double                       m_threshold;
+    int                          m_statisticsMode;
+
+    // Once packed, the histograms are rows of m_packedHistograms, which stores them contiguously
+    mutable std::vector<cv::Mat> m_histograms;
+    cv::Mat                      m_labels;
+
+    mutable cv::Mat              m_packedHistograms;
+    mutable QMutex               m_packingMutex;
 };
 
 } // namespace Digikam
@@ -146,6 +146,25 @@ int OpenCVLBPHFaceRecognizer::recognize(const cv::Mat& inputImage)
     return predictedLabel;
 }
 
+std::vector<int> OpenCVLBPHFaceRecognizer::recognize(const std::vector<cv::Mat>& inputImages)
+{
+    std::vector<int>    predictedLabels;
+    std::vector<double> confidences;
+    d->lbph()->predict(inputImages, predictedLabels, confidences);
+
+    for (size_t i = 0 ; i < predictedLabels.size() ; ++i)
+    {
+        qCDebug(DIGIKAM_FACESENGINE_LOG) << predictedLabels[i] << confidences[i];
+
+        if (confidences[i] > d->threshold)
+        {
+            predictedLabels[i] = -1;
+        }
+    }
+
+    return predictedLabels;
+}
+
 void OpenCVLBPHFaceRecognizer::train(const std::vector<cv::Mat>& images, const std::vector<int>& labels, const QString& context)
 {
     if (images.empty() || labels.size() != images.size())
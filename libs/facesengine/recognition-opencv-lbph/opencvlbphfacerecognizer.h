@@ -64,6 +64,12 @@ public:
      */
     int recognize(const cv::Mat& inputImage);
 
+    /**
+     *  Try to recognize the given images, all together.
+     *  Returns the identity ids, with -1 for images which cannot be recognized.
+     */
+    std::vector<int> recognize(const std::vector<cv::Mat>& inputImages);
+
     /**
      *  Trains the given images, representing faces of the given matched identities.
      */
@@ -572,30 +572,47 @@ QList<Identity> RecognitionDatabase::recognizeFaces(ImageListProvider* const ima
 
     QList<Identity> result;
 
-    for (; !images->atEnd(); images->proceed())
+    // The images are recognized together: the trained histograms are read once for all of them.
+    std::vector<cv::Mat> cvImages;
+    QList<int>           imageIndexes;
+
+    for (int index = 0 ; !images->atEnd() ; images->proceed(), ++index)
     {
-        int id = -1;
+        cv::Mat cvImage = d->preprocessingChain(images->image());
+        result << Identity();
 
-        try
-        {
-            id = d->recognizer()->recognize(d->preprocessingChain(images->image()));
-        }
-        catch (cv::Exception& e)
-        {
-            qCCritical(DIGIKAM_FACESENGINE_LOG) << "cv::Exception:" << e.what();
-        }
-        catch(...)
+        if (!cvImage.empty())
         {
-            qCCritical(DIGIKAM_FACESENGINE_LOG) << "Default exception from OpenCV";
+            cvImages.push_back(cvImage);
+            imageIndexes << index;
         }
+    }
 
-        if (id == -1)
-        {
-            result << Identity();
-        }
-        else
+    if (cvImages.empty())
+    {
+        return result;
+    }
+
+    std::vector<int> ids;
+
+    try
+    {
+        ids = d->recognizer()->recognize(cvImages);
+    }
+    catch (cv::Exception& e)
+    {
+        qCCritical(DIGIKAM_FACESENGINE_LOG) << "cv::Exception:" << e.what();
+    }
+    catch(...)
+    {
+        qCCritical(DIGIKAM_FACESENGINE_LOG) << "Default exception from OpenCV";
+    }
+
+    for (size_t i = 0 ; i < ids.size() ; ++i)
+    {
+        if (ids[i] != -1)
         {
-            result << d->identityCache.value(id);
+            result[imageIndexes.at((int)i)] = d->identityCache.value(ids[i]);
         }
     }
 
@@ -252,6 +252,7 @@ void ApplicationSettings::readSettings()
     d->iconTheme                         = group.readEntry(d->configIconThemeEntry,                                   QString());
     d->scanAtStart                       = group.readEntry(d->configScanAtStartEntry,                                 true);
     d->cleanAtStart                      = group.readEntry(d->configCleanAtStartEntry,                                false);
+    d->usePackedThumbnailStore           = group.readEntry(d->configUsePackedThumbnailStoreEntry,                     false);
 
     // ---------------------------------------------------------------------
 
@@ -433,6 +434,7 @@ void ApplicationSettings::saveSettings()
     group.writeEntry(d->configIconThemeEntry,                          d->iconTheme);
     group.writeEntry(d->configScanAtStartEntry,                        d->scanAtStart);
     group.writeEntry(d->configCleanAtStartEntry,                       d->cleanAtStart);
+    group.writeEntry(d->configUsePackedThumbnailStoreEntry,            d->usePackedThumbnailStore);
 
     // ---------------------------------------------------------------------
 
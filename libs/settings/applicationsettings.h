@@ -163,6 +163,9 @@ public:
     void setSyncDigikamToBaloo(bool val);
     bool getSyncDigikamToBaloo() const;
 
+    void setUsePackedThumbnailStore(bool val);
+    bool getUsePackedThumbnailStore() const;
+
     // -- Albums Settings -------------------------------------------------------
 
     void setTreeViewIconSize(int val);
@@ -55,6 +55,16 @@ bool ApplicationSettings::getSyncDigikamToBaloo() const
     return d->syncToBaloo;
 }
 
+void ApplicationSettings::setUsePackedThumbnailStore(bool val)
+{
+    d->usePackedThumbnailStore = val;
+}
+
+bool ApplicationSettings::getUsePackedThumbnailStore() const
+{
+    return d->usePackedThumbnailStore;
+}
+
 DbEngineParameters ApplicationSettings::getDbEngineParameters() const
 {
     return d->databaseParams;
@@ -146,6 +146,7 @@ const QString ApplicationSettings::Private::configApplicationStyleEntry(QLatin1S
 const QString ApplicationSettings::Private::configIconThemeEntry(QLatin1String("Icon Theme"));
 const QString ApplicationSettings::Private::configScanAtStartEntry(QLatin1String("Scan At Start"));
 const QString ApplicationSettings::Private::configCleanAtStartEntry(QLatin1String("Clean core DB At Start"));
+const QString ApplicationSettings::Private::configUsePackedThumbnailStoreEntry(QLatin1String("Use Packed Thumbnail Store"));
 const QString ApplicationSettings::Private::configMinimumSimilarityBound(QLatin1String("Lower bound for minimum similarity"));
 const QString ApplicationSettings::Private::configDuplicatesSearchLastMinSimilarity(QLatin1String("Last minimum similarity"));
 const QString ApplicationSettings::Private::configDuplicatesSearchLastMaxSimilarity(QLatin1String("Last maximum similarity"));
@@ -236,6 +237,7 @@ ApplicationSettings::Private::Private(ApplicationSettings* const qq)
       scanAtStart(true),
       cleanAtStart(true),
       databaseDirSetAtCmd(false),
+      usePackedThumbnailStore(false),
       sidebarTitleStyle(DMultiTabBar::AllIconsText),
       albumSortRole(ApplicationSettings::ByFolder),
       albumSortChanged(false),
@@ -381,6 +383,7 @@ void ApplicationSettings::Private::init()
     scanAtStart                          = true;
     cleanAtStart                         = true;
     databaseDirSetAtCmd                  = false;
+    usePackedThumbnailStore              = false;
     stringComparisonType                 = ApplicationSettings::Natural;
 
     applicationStyle                     = qApp->style()->objectName();
@@ -141,6 +141,7 @@ public:
     static const QString configApplySidebarChangesDirectlyEntry;
     static const QString configScanAtStartEntry;
     static const QString configCleanAtStartEntry;
+    static const QString configUsePackedThumbnailStoreEntry;
     static const QString configSyncBalootoDigikamEntry;
     static const QString configSyncDigikamtoBalooEntry;
     static const QString configStringComparisonTypeEntry;
@@ -253,6 +254,7 @@ public:
     bool                                         scanAtStart;
     bool                                         cleanAtStart;
     bool                                         databaseDirSetAtCmd;
+    bool                                         usePackedThumbnailStore;
 
     // album settings
     QStringList                                  albumCategoryNames;
@@ -27,8 +27,9 @@
 
 #include <QCoreApplication>
 #include <QEvent>
-#include <QCache>
 #include <QHash>
+#include <QPair>
+#include <QQueue>
 
 // Local includes
 
@@ -41,6 +42,413 @@
 namespace Digikam
 {
 
+namespace
+{
+
+enum LoadingCacheTier
+{
+    ImageTier = 0,
+    ThumbnailImageTier,
+    ThumbnailPixmapTier,
+    NumberOfTiers
+};
+
+class LoadingCacheEntry
+{
+public:
+
+    LoadingCacheEntry(int tier, const QString& key, qint64 cost)
+        : tier(tier),
+          key(key),
+          cost(cost),
+          isProtected(false),
+          prev(0),
+          next(0)
+    {
+    }
+
+    virtual ~LoadingCacheEntry()
+    {
+    }
+
+public:
+
+    const int          tier;
+    const QString      key;
+    const qint64       cost;
+    bool               isProtected;
+
+    LoadingCacheEntry* prev;
+    LoadingCacheEntry* next;
+};
+
+template <class T>
+class LoadingCacheObjectEntry : public LoadingCacheEntry
+{
+public:
+
+    LoadingCacheObjectEntry(int tier, const QString& key, T* const object, qint64 cost)
+        : LoadingCacheEntry(tier, key, cost),
+          object(object)
+    {
+    }
+
+    ~LoadingCacheObjectEntry()
+    {
+        delete object;
+    }
+
+public:
+
+    T* const object;
+};
+
+/**
+ * A list of entries ordered from most recently used (first) to least recently used (last).
+ */
+class LoadingCacheSegment
+{
+public:
+
+    LoadingCacheSegment()
+        : first(0),
+          last(0),
+          bytes(0)
+    {
+    }
+
+    void prepend(LoadingCacheEntry* const entry)
+    {
+        entry->prev = 0;
+        entry->next = first;
+
+        if (first)
+        {
+            first->prev = entry;
+        }
+        else
+        {
+            last = entry;
+        }
+
+        first  = entry;
+        bytes += entry->cost;
+    }
+
+    void unlink(LoadingCacheEntry* const entry)
+    {
+        if (entry->prev)
+        {
+            entry->prev->next = entry->next;
+        }
+        else
+        {
+            first = entry->next;
+        }
+
+        if (entry->next)
+        {
+            entry->next->prev = entry->prev;
+        }
+        else
+        {
+            last = entry->prev;
+        }
+
+        entry->prev  = 0;
+        entry->next  = 0;
+        bytes       -= entry->cost;
+    }
+
+public:
+
+    LoadingCacheEntry* first;
+    LoadingCacheEntry* last;
+    qint64             bytes;
+};
+
+typedef QPair<int, QString> LoadingCacheGhostKey;
+
+/**
+ * Segmented LRU with one byte budget for all tiers, see LoadingCache documentation.
+ * Keys of evicted and refused entries are remembered for a while ("ghost" entries),
+ * putting such a key again is taken as proof of reuse and admits it as protected entry.
+ */
+class LoadingCachePolicy
+{
+public:
+
+    LoadingCachePolicy()
+        : budget(0),
+          hits(0),
+          misses(0),
+          insertions(0),
+          rejections(0),
+          evictions(0)
+    {
+        for (int i = 0 ; i < NumberOfTiers ; ++i)
+        {
+            tierBudget[i] = 0;
+        }
+    }
+
+    ~LoadingCachePolicy()
+    {
+        for (int i = 0 ; i < NumberOfTiers ; ++i)
+        {
+            clear(i);
+        }
+    }
+
+    qint64 usedBytes() const
+    {
+        return probation.bytes + protectedSegment.bytes;
+    }
+
+    qint64 protectedBudget() const
+    {
+        return budget * 4 / 5;
+    }
+
+    int size(int tier) const
+    {
+        return entries[tier].size();
+    }
+
+    int count() const
+    {
+        int n = 0;
+
+        for (int i = 0 ; i < NumberOfTiers ; ++i)
+        {
+            n += entries[i].size();
+        }
+
+        return n;
+    }
+
+    QList<QString> keys(int tier) const
+    {
+        return entries[tier].keys();
+    }
+
+    bool contains(int tier, const QString& key) const
+    {
+        return entries[tier].contains(key);
+    }
+
+    qint64 maxCost(int tier) const
+    {
+        return tierBudget[tier];
+    }
+
+    void setMaxCost(int tier, qint64 bytes)
+    {
+        budget           += bytes - tierBudget[tier];
+        tierBudget[tier]  = bytes;
+
+        rebalance();
+        trim();
+    }
+
+    LoadingCacheEntry* find(int tier, const QString& key)
+    {
+        LoadingCacheEntry* const entry = entries[tier].value(key);
+
+        if (!entry)
+        {
+            ++misses;
+            return 0;
+        }
+
+        ++hits;
+
+        if (entry->isProtected)
+        {
+            protectedSegment.unlink(entry);
+            protectedSegment.prepend(entry);
+        }
+        else
+        {
+            // second use: promote from probation
+            probation.unlink(entry);
+            entry->isProtected = true;
+            protectedSegment.prepend(entry);
+            rebalance();
+        }
+
+        return entry;
+    }
+
+    /**
+     * Takes ownership of entry. Returns false and deletes the entry if it was not admitted.
+     */
+    bool insert(LoadingCacheEntry* const entry)
+    {
+        const LoadingCacheGhostKey ghostKey(entry->tier, entry->key);
+
+        if (entry->cost > tierBudget[entry->tier])
+        {
+            ++rejections;
+            delete entry;
+            return false;
+        }
+
+        remove(entry->tier, entry->key);
+
+        const bool reused = forget(ghostKey);
+
+        // Admission control: only entries with a history may push out protected entries
+        if (!reused && usedBytes() + entry->cost - budget > probation.bytes)
+        {
+            ++rejections;
+            remember(ghostKey);
+            delete entry;
+            return false;
+        }
+
+        ++insertions;
+        entries[entry->tier].insert(entry->key, entry);
+
+        if (reused)
+        {
+            entry->isProtected = true;
+            protectedSegment.prepend(entry);
+            rebalance();
+        }
+        else
+        {
+            probation.prepend(entry);
+        }
+
+        trim();
+
+        return true;
+    }
+
+    bool remove(int tier, const QString& key)
+    {
+        LoadingCacheEntry* const entry = entries[tier].take(key);
+
+        if (!entry)
+        {
+            return false;
+        }
+
+        segment(entry).unlink(entry);
+        delete entry;
+
+        return true;
+    }
+
+    void clear(int tier)
+    {
+        foreach(LoadingCacheEntry* const entry, entries[tier])
+        {
+            segment(entry).unlink(entry);
+            delete entry;
+        }
+
+        entries[tier].clear();
+    }
+
+private:
+
+    LoadingCacheSegment& segment(LoadingCacheEntry* const entry)
+    {
+        return (entry->isProtected ? protectedSegment : probation);
+    }
+
+    /// Keeps each ghost key once in the queue, so that an older position never drops a newer ghost
+    void remember(const LoadingCacheGhostKey& key)
+    {
+        const int maxGhosts = qMax(256, 2 * count());
+
+        forget(key);
+        ghosts.insert(key);
+        ghostOrder.enqueue(key);
+
+        while (ghostOrder.size() > maxGhosts)
+        {
+            ghosts.remove(ghostOrder.dequeue());
+        }
+    }
+
+    bool forget(const LoadingCacheGhostKey& key)
+    {
+        if (!ghosts.remove(key))
+        {
+            return false;
+        }
+
+        ghostOrder.removeOne(key);
+
+        return true;
+    }
+
+    /// Moves least recently used protected entries back to probation
+    void rebalance()
+    {
+        while (protectedSegment.bytes > protectedBudget() && protectedSegment.last)
+        {
+            LoadingCacheEntry* const entry = protectedSegment.last;
+            protectedSegment.unlink(entry);
+            entry->isProtected = false;
+            probation.prepend(entry);
+        }
+    }
+
+    /// Evicts entries until the budget is kept, probation first
+    void trim()
+    {
+        while (usedBytes() > budget)
+        {
+            LoadingCacheEntry* const entry = probation.last ? probation.last : protectedSegment.last;
+
+            if (!entry)
+            {
+                break;
+            }
+
+            segment(entry).unlink(entry);
+            entries[entry->tier].remove(entry->key);
+            remember(LoadingCacheGhostKey(entry->tier, entry->key));
+            ++evictions;
+            delete entry;
+        }
+    }
+
+public:
+
+    qint64                              budget;
+    qint64                              tierBudget[NumberOfTiers];
+
+    qint64                              hits;
+    qint64                              misses;
+    qint64                              insertions;
+    qint64                              rejections;
+    qint64                              evictions;
+
+    LoadingCacheSegment                 probation;
+    LoadingCacheSegment                 protectedSegment;
+
+private:
+
+    QHash<QString, LoadingCacheEntry*>  entries[NumberOfTiers];
+    QSet<LoadingCacheGhostKey>          ghosts;
+    QQueue<LoadingCacheGhostKey>        ghostOrder;
+};
+
+template <class T>
+T* cachedObject(LoadingCacheEntry* const entry)
+{
+    return entry ? static_cast<LoadingCacheObjectEntry<T>*>(entry)->object : 0;
+}
+
+} // namespace
+
+// --------------------------------------------------------------------------------------------------------------
+
 class LoadingCache::Private
 {
 public:
@@ -60,9 +468,7 @@ public:
 
 public:
 
-    QCache<QString, DImg>           imageCache;
-    QCache<QString, QImage>         thumbnailImageCache;
-    QCache<QString, QPixmap>        thumbnailPixmapCache;
+    LoadingCachePolicy              cache;
     QMultiHash<QString, QString>    imageFilePathHash;
     QMultiHash<QString, QString>    thumbnailFilePathHash;
     QHash<QString, LoadingProcess*> loadingDict;
@@ -85,7 +491,7 @@ LoadingCacheFileWatch* LoadingCache::Private::fileWatch() const
 
 void LoadingCache::Private::mapImageFilePath(const QString& filePath, const QString& cacheKey)
 {
-    if (imageFilePathHash.size() > 5*imageCache.size())
+    if (imageFilePathHash.size() > 5*cache.size(ImageTier))
     {
         cleanUpImageFilePathHash();
     }
@@ -95,7 +501,7 @@ void LoadingCache::Private::mapImageFilePath(const QString& filePath, const QStr
 
 void LoadingCache::Private::mapThumbnailFilePath(const QString& filePath, const QString& cacheKey)
 {
-    if (thumbnailFilePathHash.size() > 5*(thumbnailImageCache.size() + thumbnailPixmapCache.size()))
+    if (thumbnailFilePathHash.size() > 5*(cache.size(ThumbnailImageTier) + cache.size(ThumbnailPixmapTier)))
     {
         cleanUpThumbnailFilePathHash();
     }
@@ -106,7 +512,7 @@ void LoadingCache::Private::mapThumbnailFilePath(const QString& filePath, const
 void LoadingCache::Private::cleanUpImageFilePathHash()
 {
     // Remove all entries from hash whose value is no longer a key in the cache
-    QSet<QString> keys = imageCache.keys().toSet();
+    QSet<QString> keys = cache.keys(ImageTier).toSet();
     QMultiHash<QString, QString>::iterator it;
 
     for (it = imageFilePathHash.begin(); it != imageFilePathHash.end(); )
@@ -125,8 +531,8 @@ void LoadingCache::Private::cleanUpImageFilePathHash()
 void LoadingCache::Private::cleanUpThumbnailFilePathHash()
 {
     QSet<QString> keys;
-    keys += thumbnailImageCache.keys().toSet();
-    keys += thumbnailPixmapCache.keys().toSet();
+    keys += cache.keys(ThumbnailImageTier).toSet();
+    keys += cache.keys(ThumbnailPixmapTier).toSet();
     QMultiHash<QString, QString>::iterator it;
 
     for (it = thumbnailFilePathHash.begin(); it != thumbnailFilePathHash.end(); )
@@ -142,6 +548,28 @@ void LoadingCache::Private::cleanUpThumbnailFilePathHash()
     }
 }
 
+LoadingCacheStatistics::LoadingCacheStatistics()
+    : hits(0),
+      misses(0),
+      insertions(0),
+      rejections(0),
+      evictions(0),
+      usedBytes(0),
+      protectedBytes(0),
+      budgetBytes(0),
+      entries(0)
+{
+}
+
+double LoadingCacheStatistics::hitRatio() const
+{
+    const qint64 lookups = hits + misses;
+
+    return lookups ? double(hits) / lookups : 0.0;
+}
+
+//---------------------------------------------------------------------------------------------------
+
 LoadingCache* LoadingCache::m_instance = 0;
 
 LoadingCache* LoadingCache::cache()
@@ -156,6 +584,14 @@ LoadingCache* LoadingCache::cache()
 
 void LoadingCache::cleanUp()
 {
+    if (m_instance)
+    {
+        LoadingCacheStatistics stats = m_instance->statistics();
+
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Loading cache statistics: hits" << stats.hits << "misses" << stats.misses
+                                     << "rejected" << stats.rejections << "evicted" << stats.evictions;
+    }
+
     delete m_instance;
 }
 
@@ -184,16 +620,16 @@ LoadingCache::~LoadingCache()
 
 DImg* LoadingCache::retrieveImage(const QString& cacheKey) const
 {
-    return d->imageCache[cacheKey];
+    return cachedObject<DImg>(d->cache.find(ImageTier, cacheKey));
 }
 
 bool LoadingCache::putImage(const QString& cacheKey, DImg* img, const QString& filePath) const
 {
     bool successfulyInserted;
 
-    int cost = img->numBytes();
+    qint64 cost = img->numBytes();
 
-    successfulyInserted = d->imageCache.insert(cacheKey, img, cost);
+    successfulyInserted = d->cache.insert(new LoadingCacheObjectEntry<DImg>(ImageTier, cacheKey, img, cost));
 
     if (successfulyInserted && !filePath.isEmpty())
     {
@@ -206,18 +642,18 @@ bool LoadingCache::putImage(const QString& cacheKey, DImg* img, const QString& f
 
 void LoadingCache::removeImage(const QString& cacheKey)
 {
-    d->imageCache.remove(cacheKey);
+    d->cache.remove(ImageTier, cacheKey);
 }
 
 void LoadingCache::removeImages()
 {
-    d->imageCache.clear();
+    d->cache.clear(ImageTier);
 }
 
 bool LoadingCache::isCacheable(const DImg* img) const
 {
     // return whether image fits in cache
-    return (uint)d->imageCache.maxCost() >= img->numBytes();
+    return (quint64)d->cache.maxCost(ImageTier) >= img->numBytes();
 }
 
 void LoadingCache::addLoadingProcess(LoadingProcess* process)
@@ -247,31 +683,31 @@ void LoadingCache::notifyNewLoadingProcess(LoadingProcess* process, const Loadin
 void LoadingCache::setCacheSize(int megabytes)
 {
     qCDebug(DIGIKAM_GENERAL_LOG) << "Allowing a cache size of" << megabytes << "MB";
-    d->imageCache.setMaxCost(megabytes * 1024 * 1024);
+    d->cache.setMaxCost(ImageTier, (qint64)megabytes * 1024 * 1024);
 }
 
 // --- Thumbnails ----
 
 const QImage* LoadingCache::retrieveThumbnail(const QString& cacheKey) const
 {
-    return d->thumbnailImageCache[cacheKey];
+    return cachedObject<QImage>(d->cache.find(ThumbnailImageTier, cacheKey));
 }
 
 const QPixmap* LoadingCache::retrieveThumbnailPixmap(const QString& cacheKey) const
 {
-    return d->thumbnailPixmapCache[cacheKey];
+    return cachedObject<QPixmap>(d->cache.find(ThumbnailPixmapTier, cacheKey));
 }
 
 bool LoadingCache::hasThumbnailPixmap(const QString& cacheKey) const
 {
-    return d->thumbnailPixmapCache.contains(cacheKey);
+    return d->cache.contains(ThumbnailPixmapTier, cacheKey);
 }
 
 void LoadingCache::putThumbnail(const QString& cacheKey, const QImage& thumb, const QString& filePath)
 {
     int cost = thumb.byteCount();
 
-    if (d->thumbnailImageCache.insert(cacheKey, new QImage(thumb), cost))
+    if (d->cache.insert(new LoadingCacheObjectEntry<QImage>(ThumbnailImageTier, cacheKey, new QImage(thumb), cost)))
     {
         d->mapThumbnailFilePath(filePath, cacheKey);
         d->fileWatch()->addedThumbnail(filePath);
@@ -282,7 +718,7 @@ void LoadingCache::putThumbnail(const QString& cacheKey, const QPixmap& thumb, c
 {
     int cost = thumb.width() * thumb.height() * thumb.depth() / 8;
 
-    if (d->thumbnailPixmapCache.insert(cacheKey, new QPixmap(thumb), cost))
+    if (d->cache.insert(new LoadingCacheObjectEntry<QPixmap>(ThumbnailPixmapTier, cacheKey, new QPixmap(thumb), cost)))
     {
         d->mapThumbnailFilePath(filePath, cacheKey);
         d->fileWatch()->addedThumbnail(filePath);
@@ -291,20 +727,45 @@ void LoadingCache::putThumbnail(const QString& cacheKey, const QPixmap& thumb, c
 
 void LoadingCache::removeThumbnail(const QString& cacheKey)
 {
-    d->thumbnailImageCache.remove(cacheKey);
-    d->thumbnailPixmapCache.remove(cacheKey);
+    d->cache.remove(ThumbnailImageTier, cacheKey);
+    d->cache.remove(ThumbnailPixmapTier, cacheKey);
 }
 
 void LoadingCache::removeThumbnails()
 {
-    d->thumbnailImageCache.clear();
-    d->thumbnailPixmapCache.clear();
+    d->cache.clear(ThumbnailImageTier);
+    d->cache.clear(ThumbnailPixmapTier);
 }
 
 void LoadingCache::setThumbnailCacheSize(int numberOfQImages, int numberOfQPixmaps)
 {
-    d->thumbnailImageCache.setMaxCost(numberOfQImages * ThumbnailSize::maxThumbsSize() * ThumbnailSize::maxThumbsSize() * 4);
-    d->thumbnailPixmapCache.setMaxCost(numberOfQPixmaps * ThumbnailSize::maxThumbsSize() * ThumbnailSize::maxThumbsSize() * QPixmap::defaultDepth() / 8);
+    d->cache.setMaxCost(ThumbnailImageTier, (qint64)numberOfQImages * ThumbnailSize::maxThumbsSize() * ThumbnailSize::maxThumbsSize() * 4);
+    d->cache.setMaxCost(ThumbnailPixmapTier, (qint64)numberOfQPixmaps * ThumbnailSize::maxThumbsSize() * ThumbnailSize::maxThumbsSize() * QPixmap::defaultDepth() / 8);
+}
+
+LoadingCacheStatistics LoadingCache::statistics() const
+{
+    LoadingCacheStatistics stats;
+    stats.hits           = d->cache.hits;
+    stats.misses         = d->cache.misses;
+    stats.insertions     = d->cache.insertions;
+    stats.rejections     = d->cache.rejections;
+    stats.evictions      = d->cache.evictions;
+    stats.usedBytes      = d->cache.usedBytes();
+    stats.protectedBytes = d->cache.protectedSegment.bytes;
+    stats.budgetBytes    = d->cache.budget;
+    stats.entries        = d->cache.count();
+
+    return stats;
+}
+
+void LoadingCache::resetStatistics()
+{
+    d->cache.hits       = 0;
+    d->cache.misses     = 0;
+    d->cache.insertions = 0;
+    d->cache.rejections = 0;
+    d->cache.evictions  = 0;
 }
 
 void LoadingCache::setFileWatch(LoadingCacheFileWatch* watch)
@@ -332,7 +793,7 @@ void LoadingCache::notifyFileChanged(const QString& filePath)
 
     foreach(const QString& cacheKey, keys)
     {
-        if (d->imageCache.remove(cacheKey))
+        if (d->cache.remove(ImageTier, cacheKey))
         {
             emit fileChanged(filePath, cacheKey);
         }
@@ -342,8 +803,8 @@ void LoadingCache::notifyFileChanged(const QString& filePath)
 
     foreach(const QString& cacheKey, keys)
     {
-        bool removedImage  = d->thumbnailImageCache.remove(cacheKey);
-        bool removedPixmap = d->thumbnailPixmapCache.remove(cacheKey);
+        bool removedImage  = d->cache.remove(ThumbnailImageTier, cacheKey);
+        bool removedPixmap = d->cache.remove(ThumbnailPixmapTier, cacheKey);
 
         if (removedImage || removedPixmap)
         {
@@ -127,6 +127,41 @@ protected:
 
 // --------------------------------------------------------------------------------------------------------------
 
+class DIGIKAM_EXPORT LoadingCacheStatistics
+{
+public:
+
+    LoadingCacheStatistics();
+
+    /// Returns the ratio of lookups which found an entry, between 0 and 1
+    double hitRatio() const;
+
+public:
+
+    qint64 hits;
+    qint64 misses;
+    qint64 insertions;
+    qint64 rejections;      // new entries refused by admission control
+    qint64 evictions;
+
+    qint64 usedBytes;
+    qint64 protectedBytes;  // bytes held by entries which were used more than once
+    qint64 budgetBytes;     // shared budget of images, thumbnails and thumbnail pixmaps
+    int    entries;
+};
+
+// --------------------------------------------------------------------------------------------------------------
+
+/**
+ * Images, thumbnail images and thumbnail pixmaps share one byte budget,
+ * which is the sum of the sizes given to setCacheSize() and setThumbnailCacheSize().
+ * The budget is managed as a segmented LRU: new entries go to a probation segment,
+ * entries which are used again move to a protected segment. Eviction takes the
+ * least recently used probation entries first, so one sweep through a large album
+ * or a maintenance run does not flush the entries which are in active use.
+ * A new entry which could only be stored by evicting protected entries is refused
+ * the first time; if it is put again shortly after, it is admitted as protected entry.
+ */
 class DIGIKAM_EXPORT LoadingCache : public QObject
 {
     Q_OBJECT
@@ -253,6 +288,15 @@ public:
      */
     void setThumbnailCacheSize(int numberOfQImages, int numberOfQPixmaps);
 
+    // ------- Statistics -----------------------------------
+
+    /**
+     * Returns the hit, miss and eviction counters and the current memory usage
+     * of all cache tiers.
+     */
+    LoadingCacheStatistics statistics() const;
+    void resetStatistics();
+
     // ------- File Watch Management -----------------------------------
 
     /**
@@ -98,4 +98,11 @@ void LoadingCacheInterface::setCacheOptions(int cacheSize)
     cache->setCacheSize(cacheSize);
 }
 
+LoadingCacheStatistics LoadingCacheInterface::statistics()
+{
+    LoadingCache* cache = LoadingCache::cache();
+    LoadingCache::CacheLock lock(cache);
+    return cache->statistics();
+}
+
 }   // namespace Digikam
@@ -36,6 +36,8 @@
 namespace Digikam
 {
 
+class LoadingCacheStatistics;
+
 class DIGIKAM_EXPORT LoadingCacheInterface
 {
 public:
@@ -80,6 +82,11 @@ public:
      * Set to 0 to disable caching.
      */
     static void setCacheOptions(int cacheSize);
+
+    /**
+     * Returns the hit, miss and eviction counters and memory usage of the cache.
+     */
+    static LoadingCacheStatistics statistics();
 };
 
 }   // namespace Digikam
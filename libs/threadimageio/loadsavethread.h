@@ -219,6 +219,12 @@ protected:
 
     LoadSaveTask*        m_currentTask;
 
+    /**
+     * Tasks taken from m_todo and currently executed by additional pool workers
+     * (see ThumbnailLoadThread::setPoolSize()). Protected by threadMutex().
+     */
+    QList<LoadSaveTask*> m_poolTasks;
+
     NotificationPolicy   m_notificationPolicy;
 
 private:
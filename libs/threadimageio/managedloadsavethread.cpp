@@ -60,6 +60,7 @@ void ManagedLoadSaveThread::shutDown()
                 loadingTask->setStatus(LoadingTask::LoadingTaskStatusStopping);
             }
 
+            stopPoolTasks(LoadingDescription(QString()), LoadingTaskFilterAll);
             removeLoadingTasks(LoadingDescription(QString()), LoadingTaskFilterAll);
             break;
         }
@@ -74,6 +75,7 @@ void ManagedLoadSaveThread::shutDown()
                 loadingTask->setStatus(LoadingTask::LoadingTaskStatusStopping);
             }
 
+            stopPoolTasks(LoadingDescription(QString()), LoadingTaskFilterPreloading);
             removeLoadingTasks(LoadingDescription(QString()), LoadingTaskFilterPreloading);
             break;
         }
@@ -131,6 +133,19 @@ LoadingTask* ManagedLoadSaveThread::findExistingTask(const LoadingDescription& l
         }
     }
 
+    foreach(LoadSaveTask* const task, m_poolTasks)
+    {
+        if (task->type() == LoadSaveTask::TaskTypeLoading)
+        {
+            loadingTask = static_cast<LoadingTask*>(task);
+
+            if (loadingTask->loadingDescription() == loadingDescription)
+            {
+                return loadingTask;
+            }
+        }
+    }
+
     for (int i = 0; i < m_todo.size(); ++i)
     {
         LoadSaveTask* const task = m_todo[i];
@@ -149,6 +164,24 @@ LoadingTask* ManagedLoadSaveThread::findExistingTask(const LoadingDescription& l
     return 0;
 }
 
+void ManagedLoadSaveThread::stopPoolTasks(const LoadingDescription& description, LoadingTaskFilter filter)
+{
+    // Tasks executed by pool workers are owned by the worker, we can only ask them to stop.
+
+    LoadingTask* loadingTask = 0;
+
+    foreach(LoadSaveTask* const task, m_poolTasks)
+    {
+        if ((loadingTask = checkLoadingTask(task, filter)))
+        {
+            if (description.filePath.isNull() || loadingTask->loadingDescription() == description)
+            {
+                loadingTask->setStatus(LoadingTask::LoadingTaskStatusStopping);
+            }
+        }
+    }
+}
+
 void ManagedLoadSaveThread::setTerminationPolicy(TerminationPolicy terminationPolicy)
 {
     m_terminationPolicy = terminationPolicy;
@@ -433,7 +466,7 @@ void ManagedLoadSaveThread::prependThumbnailGroup(const QList<LoadingDescription
         // remove task, if not the current task
         if (existingTask)
         {
-            if (existingTask == m_currentTask)
+            if (existingTask == m_currentTask || m_poolTasks.contains(existingTask))
             {
                 continue;
             }
@@ -510,6 +543,8 @@ void ManagedLoadSaveThread::stopAllTasks()
         }
     }
 
+    stopPoolTasks(LoadingDescription(QString()), LoadingTaskFilterAll);
+
     foreach(LoadSaveTask* const task, m_todo)
     {
         delete task;
@@ -563,6 +598,8 @@ void ManagedLoadSaveThread::removeLoadingTasks(const LoadingDescription& descrip
         }
     }
 
+    stopPoolTasks(description, filter);
+
     // remove relevant tasks from list
     QList<LoadSaveTask*>::iterator it;
 
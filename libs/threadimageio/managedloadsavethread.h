@@ -167,6 +167,7 @@ private:
                                    LoadingMode loadingMode, AccessMode accessMode);
 
     void removeLoadingTasks(const LoadingDescription& description, LoadingTaskFilter filter);
+    void stopPoolTasks(const LoadingDescription& description, LoadingTaskFilter filter);
 };
 
 }  // namespace Digikam
@@ -62,6 +62,7 @@
 #include "thumbsdb.h"
 #include "thumbsdbbackend.h"
 #include "thumbnailsize.h"
+#include "thumbnailpackedstore.h"
 
 #ifdef Q_OS_WIN
 #include "windows.h"
@@ -197,6 +198,62 @@ void ThumbnailCreator::pregenerate(const ThumbnailIdentifier& identifier) const
     load(identifier, QRect(), true);
 }
 
+void ThumbnailCreator::pregenerate(const ThumbnailIdentifier& identifier, const DImg& image) const
+{
+    if (image.isNull())
+    {
+        pregenerate(identifier);
+        return;
+    }
+
+    if (d->storageSize() <= 0)
+    {
+        d->error = i18n("No or invalid size specified");
+        qCWarning(DIGIKAM_GENERAL_LOG) << "No or invalid size specified";
+        return;
+    }
+
+    ThumbnailInfo info = makeThumbnailInfo(identifier, QRect());
+    DImg img           = image;
+
+    if (img.width() > (uint)d->storageSize() || img.height() > (uint)d->storageSize())
+    {
+        img = img.smoothScale(d->storageSize(), d->storageSize(), Qt::KeepAspectRatio);
+    }
+
+    ThumbnailImage thumb;
+    thumb.exifOrientation = LoadSaveThread::exifOrientation(image, info.filePath);
+
+    // previews are usually exif-rotated, thumbnails are stored unrotated
+    DImg source = image;
+
+    if (LoadSaveThread::wasExifRotated(source))
+    {
+        img.reverseRotateAndFlip(thumb.exifOrientation);
+    }
+
+    thumb.qimage = img.copyQImage();
+
+    switch (d->thumbnailStorage)
+    {
+        case ThumbnailDatabase:
+            // sets d->dbIdForReplacement, an existing thumbnail is replaced
+            loadThumbsDbInfo(info);
+            storeInDatabase(info, thumb);
+            break;
+        case FreeDesktopStandard:
+
+            // image is stored rotated
+            if (d->exifRotate)
+            {
+                thumb.qimage = exifRotate(thumb.qimage, thumb.exifOrientation);
+            }
+
+            storeFreedesktop(info, thumb);
+            break;
+    }
+}
+
 void ThumbnailCreator::pregenerateDetail(const ThumbnailIdentifier& identifier, const QRect& rect) const
 {
     if (!rect.isValid())
@@ -863,6 +920,12 @@ void ThumbnailCreator::storeInDatabase(const ThumbnailInfo& info, const Thumbnai
         }
 
     }
+
+    if (lastQueryState == BdEngineBackend::NoErrors && usePackedStore(info))
+    {
+        ThumbnailPackedStore::instance()->store(info.uniqueHash, info.fileSize, dbInfo.modificationDate,
+                                                image.qimage, image.exifOrientation);
+    }
 }
 
 ThumbsDbInfo ThumbnailCreator::loadThumbsDbInfo(const ThumbnailInfo& info) const
@@ -912,10 +975,30 @@ bool ThumbnailCreator::isInDatabase(const ThumbnailInfo& info) const
     return true;
 }
 
+bool ThumbnailCreator::usePackedStore(const ThumbnailInfo& info) const
+{
+    // The packed store is keyed by content only, and may hold thumbnails smaller than the stored size
+    return (info.customIdentifier.isNull() && !info.uniqueHash.isEmpty() &&
+            ThumbnailPackedStore::instance()->isOpen()                    &&
+            d->thumbnailSize <= ThumbnailPackedStore::instance()->recordSide());
+}
+
 ThumbnailImage ThumbnailCreator::loadFromDatabase(const ThumbnailInfo& info) const
 {
-    ThumbsDbInfo dbInfo = loadThumbsDbInfo(info);
     ThumbnailImage image;
+    int            storedOrientation = DMetadata::ORIENTATION_UNSPECIFIED;
+
+    // Fast path: already decoded thumbnail, no query and no PGF decoding needed
+
+    if (usePackedStore(info) &&
+        ThumbnailPackedStore::instance()->load(info.uniqueHash, info.fileSize, info.modificationDate,
+                                               image.qimage, storedOrientation))
+    {
+        image.exifOrientation = orientationFromInfo(info, storedOrientation);
+        return image;
+    }
+
+    ThumbsDbInfo dbInfo = loadThumbsDbInfo(info);
 
     if (dbInfo.data.isNull())
     {
@@ -974,22 +1057,35 @@ ThumbnailImage ThumbnailCreator::loadFromDatabase(const ThumbnailInfo& info) con
         }
     }
 
+    if (usePackedStore(info))
+    {
+        ThumbnailPackedStore::instance()->store(info.uniqueHash, info.fileSize, dbInfo.modificationDate,
+                                                image.qimage, dbInfo.orientationHint);
+    }
+
+    image.exifOrientation = orientationFromInfo(info, dbInfo.orientationHint);
+
+    return image;
+}
+
+int ThumbnailCreator::orientationFromInfo(const ThumbnailInfo& info, int storedOrientation) const
+{
     // Give priority to main database's rotation flag
     // NOTE: Breaks rotation of RAWs which do not contain JPEG previews
-    image.exifOrientation = info.orientationHint;
+    int orientation = info.orientationHint;
 
-    if (image.exifOrientation == DMetadata::ORIENTATION_UNSPECIFIED &&
+    if (orientation == DMetadata::ORIENTATION_UNSPECIFIED &&
         !info.filePath.isEmpty() && LoadSaveThread::infoProvider())
     {
-        image.exifOrientation = LoadSaveThread::infoProvider()->orientationHint(info.filePath);
+        orientation = LoadSaveThread::infoProvider()->orientationHint(info.filePath);
     }
 
-    if (image.exifOrientation == DMetadata::ORIENTATION_UNSPECIFIED)
+    if (orientation == DMetadata::ORIENTATION_UNSPECIFIED)
     {
-        image.exifOrientation = dbInfo.orientationHint;
+        orientation = storedOrientation;
     }
 
-    return image;
+    return orientation;
 }
 
 void ThumbnailCreator::deleteFromDatabase(const ThumbnailInfo& info) const
@@ -1008,6 +1104,7 @@ void ThumbnailCreator::deleteFromDatabase(const ThumbnailInfo& info) const
 
         if (!info.uniqueHash.isNull())
         {
+            ThumbnailPackedStore::instance()->remove(info.uniqueHash, info.fileSize);
             lastQueryState=access.db()->removeByUniqueHash(info.uniqueHash, info.fileSize);
 
             if (BdEngineBackend::NoErrors!=lastQueryState)
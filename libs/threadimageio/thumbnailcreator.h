@@ -42,6 +42,7 @@ namespace Digikam
 {
 
 class IccProfile;
+class DImg;
 class DImgLoaderObserver;
 class DMetadata;
 class ThumbnailImage;
@@ -88,6 +89,14 @@ public:
     void pregenerate(const ThumbnailIdentifier& identifier) const;
     void pregenerateDetail(const ThumbnailIdentifier& identifier, const QRect& detailRect) const;
 
+    /**
+     * Generates the thumbnail from an image of the file which was already decoded elsewhere,
+     * typically a preview, and stores it in the database, replacing an existing thumbnail.
+     * The image may be exif-rotated; it is stored unrotated as all other thumbnails.
+     * If the image is null, this is the same as pregenerate(identifier).
+     */
+    void pregenerate(const ThumbnailIdentifier& identifier, const DImg& image) const;
+
     /**
      * Sets the thumbnail size. This is the maximum size of the QImage
      * returned by load.
@@ -196,6 +205,8 @@ private:
     void storeInDatabase(const ThumbnailInfo& info, const ThumbnailImage& image) const;
     ThumbsDbInfo loadThumbsDbInfo(const ThumbnailInfo& info) const;
     ThumbnailImage loadFromDatabase(const ThumbnailInfo& info) const;
+    bool usePackedStore(const ThumbnailInfo& info) const;
+    int  orientationFromInfo(const ThumbnailInfo& info, int storedOrientation) const;
     bool isInDatabase(const ThumbnailInfo& info) const;
     void deleteFromDatabase(const ThumbnailInfo& info) const;
 
@@ -35,6 +35,7 @@
 #include <QIcon>
 #include <QMimeType>
 #include <QMimeDatabase>
+#include <QThread>
 
 // KDE includes
 
@@ -108,6 +109,59 @@ Q_GLOBAL_STATIC(ThumbnailLoadThreadStaticPriv, static_d)
 
 // -------------------------------------------------------------------
 
+class ThumbnailLoadWorker : public DynamicThread
+{
+public:
+
+    ThumbnailLoadWorker(ThumbnailLoadThread* const thread, ThumbnailCreator* const creator)
+        : thread(thread),
+          creator(creator)
+    {
+    }
+
+    ~ThumbnailLoadWorker()
+    {
+        shutDown();
+        delete creator;
+    }
+
+public:
+
+    ThumbnailLoadThread* const thread;
+    ThumbnailCreator* const    creator;
+
+protected:
+
+    virtual void run();
+};
+
+void ThumbnailLoadWorker::run()
+{
+    while (runningFlag())
+    {
+        ThumbnailLoadingTask* const task = thread->takePoolTask(creator);
+
+        if (!task)
+        {
+            QMutexLocker lock(threadMutex());
+            stop(lock);
+            break;
+        }
+
+        task->execute();
+
+        {
+            // The task may have returned without calling taskHasFinished(), if stopped early.
+            QMutexLocker lock(thread->threadMutex());
+            thread->m_poolTasks.removeAll(task);
+        }
+
+        delete task;
+    }
+}
+
+// -------------------------------------------------------------------
+
 class ThumbnailLoadThread::Private
 {
 
@@ -136,6 +190,9 @@ public:
 
     ThumbnailCreator*                  creator;
 
+    QList<ThumbnailLoadWorker*>        workers;
+    QMutex                             poolMutex;
+
     QHash<QString, ThumbnailResult>    collectedResults;
     QMutex                             resultsMutex;
 
@@ -149,6 +206,7 @@ public:
 
 public:
 
+    ThumbnailCreator*         createThumbnailCreator() const;
     LoadingDescription        createLoadingDescription(const ThumbnailIdentifier& identifier, int size, bool setLastDescription = true);
     LoadingDescription        createLoadingDescription(const ThumbnailIdentifier& identifier, int size,
                                                        const QRect& detailRect, bool setLastDescription = true);
@@ -169,15 +227,7 @@ ThumbnailLoadThread::ThumbnailLoadThread(QObject* const parent)
       d(new Private)
 {
     static_d->firstThreadCreated = true;
-    d->creator                   = new ThumbnailCreator(static_d->storageMethod);
-
-    if (static_d->provider)
-    {
-        d->creator->setThumbnailInfoProvider(static_d->provider);
-    }
-
-    d->creator->setOnlyLargeThumbnails(true);
-    d->creator->setRemoveAlphaChannel(true);
+    d->creator                   = d->createThumbnailCreator();
 
     connect(this, SIGNAL(thumbnailsAvailable()),
             this, SLOT(slotThumbnailsAvailable()));
@@ -203,6 +253,9 @@ ThumbnailLoadThread::~ThumbnailLoadThread()
 {
     shutDown();
 
+    // the workers wait for their current task, which is already told to stop
+    qDeleteAll(d->workers);
+
 #ifdef HAVE_MEDIAPLAYER
     delete d->videoThumbs;
 #endif
@@ -271,6 +324,13 @@ void ThumbnailLoadThread::setThumbnailSize(int size, bool forFace)
     if (forFace)
     {
         d->creator->setThumbnailSize(size);
+
+        QMutexLocker lock(&d->poolMutex);
+
+        foreach(ThumbnailLoadWorker* const worker, d->workers)
+        {
+            worker->creator->setThumbnailSize(size);
+        }
     }
 }
 
@@ -311,6 +371,91 @@ ThumbnailCreator* ThumbnailLoadThread::thumbnailCreator() const
     return d->creator;
 }
 
+void ThumbnailLoadThread::setPoolSize(int size)
+{
+    if (size <= 0)
+    {
+        size = QThread::idealThreadCount();
+    }
+
+    // this thread is the first member of the pool
+    int workerCount = qMax(size, 1) - 1;
+
+    QList<ThumbnailLoadWorker*> removedWorkers;
+    {
+        QMutexLocker lock(&d->poolMutex);
+
+        while (d->workers.size() < workerCount)
+        {
+            ThumbnailLoadWorker* const worker = new ThumbnailLoadWorker(this, d->createThumbnailCreator());
+            worker->creator->setThumbnailSize(d->creator->thumbnailSize());
+            d->workers << worker;
+        }
+
+        while (d->workers.size() > workerCount)
+        {
+            removedWorkers << d->workers.takeLast();
+        }
+    }
+
+    // waits until the current task of each removed worker has finished
+    qDeleteAll(removedWorkers);
+
+    startPool();
+}
+
+int ThumbnailLoadThread::poolSize() const
+{
+    QMutexLocker lock(&d->poolMutex);
+
+    return d->workers.size() + 1;
+}
+
+void ThumbnailLoadThread::startPool()
+{
+    QMutexLocker lock(&d->poolMutex);
+
+    foreach(ThumbnailLoadWorker* const worker, d->workers)
+    {
+        worker->start();
+    }
+}
+
+ThumbnailLoadingTask* ThumbnailLoadThread::takePoolTask(ThumbnailCreator* const creator)
+{
+    QMutexLocker lock(threadMutex());
+
+    // Tasks are handed out in queue order, so that the priority given by
+    // the views is respected. Other kinds of tasks are left to this thread.
+
+    if (m_todo.isEmpty())
+    {
+        return 0;
+    }
+
+    ThumbnailLoadingTask* const task = dynamic_cast<ThumbnailLoadingTask*>(m_todo.first());
+
+    if (!task)
+    {
+        return 0;
+    }
+
+    m_todo.removeFirst();
+    task->setPoolCreator(creator);
+    m_poolTasks << task;
+
+    return task;
+}
+
+void ThumbnailLoadThread::poolTaskHasFinished(ThumbnailLoadingTask* const task)
+{
+    // See LoadSaveThread::taskHasFinished(): called before the final message is sent,
+    // so that a new task for the same description is not rejected as already running.
+    // The task itself is deleted by the worker.
+    QMutexLocker lock(threadMutex());
+    m_poolTasks.removeAll(task);
+}
+
 int ThumbnailLoadThread::thumbnailToPixmapSize(int size) const
 {
     return d->pixmapSizeForThumbnailSize(size);
@@ -357,6 +502,21 @@ int ThumbnailLoadThread::Private::thumbnailSizeForPixmapSize(int pixmapSize) con
     return pixmapSize;
 }
 
+ThumbnailCreator* ThumbnailLoadThread::Private::createThumbnailCreator() const
+{
+    ThumbnailCreator* const thumbCreator = new ThumbnailCreator(static_d->storageMethod);
+
+    if (static_d->provider)
+    {
+        thumbCreator->setThumbnailInfoProvider(static_d->provider);
+    }
+
+    thumbCreator->setOnlyLargeThumbnails(true);
+    thumbCreator->setRemoveAlphaChannel(true);
+
+    return thumbCreator;
+}
+
 // --- Creating loading descriptions ---
 
 LoadingDescription ThumbnailLoadThread::Private::createLoadingDescription(const ThumbnailIdentifier& identifier, int size,
@@ -578,6 +738,7 @@ void ThumbnailLoadThread::findGroup(QList<ThumbnailIdentifier>& identifiers, int
 
     QList<LoadingDescription> descriptions = d->makeDescriptions(identifiers, size);
     ManagedLoadSaveThread::prependThumbnailGroup(descriptions);
+    startPool();
 }
 
 // --- Detail thumbnails ---
@@ -616,6 +777,7 @@ void ThumbnailLoadThread::findGroup(const QList<QPair<ThumbnailIdentifier, QRect
 
     QList<LoadingDescription> descriptions = d->makeDescriptions(idsAndRects, size);
     ManagedLoadSaveThread::prependThumbnailGroup(descriptions);
+    startPool();
 }
 
 // --- Preloading ---
@@ -649,6 +811,7 @@ void ThumbnailLoadThread::preloadGroup(QList<ThumbnailIdentifier>& identifiers,
 
     QList<LoadingDescription> descriptions = d->makeDescriptions(identifiers, size);
     ManagedLoadSaveThread::preloadThumbnailGroup(descriptions);
+    startPool();
 }
 
 void ThumbnailLoadThread::pregenerateGroup(const QList<ThumbnailIdentifier>& identifiers)
@@ -671,6 +834,7 @@ void ThumbnailLoadThread::pregenerateGroup(const QList<ThumbnailIdentifier>& ide
     }
 
     ManagedLoadSaveThread::preloadThumbnailGroup(descriptions);
+    startPool();
 }
 
 // --- Basic load() ---
@@ -695,6 +859,8 @@ void ThumbnailLoadThread::load(const LoadingDescription& description, bool prelo
     {
         ManagedLoadSaveThread::loadThumbnail(description);
     }
+
+    startPool();
 }
 
 QList<LoadingDescription> ThumbnailLoadThread::lastDescriptions() const
@@ -937,6 +1103,30 @@ void ThumbnailLoadThread::deleteThumbnail(const QString& filePath)
     creator.deleteThumbnailsFromDisk(filePath);
 }
 
+void ThumbnailLoadThread::pregenerateThumbnail(const QString& filePath, const DImg& image)
+{
+    {
+        LoadingCache* const cache = LoadingCache::cache();
+        LoadingCache::CacheLock lock(cache);
+        QStringList possibleKeys  = LoadingDescription::possibleThumbnailCacheKeys(filePath);
+
+        foreach(const QString& cacheKey, possibleKeys)
+        {
+            cache->removeThumbnail(cacheKey);
+        }
+    }
+
+    ThumbnailCreator creator(static_d->storageMethod);
+
+    if (static_d->provider)
+    {
+        creator.setThumbnailInfoProvider(static_d->provider);
+    }
+
+    creator.setOnlyLargeThumbnails(true);
+    creator.pregenerate(ThumbnailIdentifier(filePath), image);
+}
+
 // --- ThumbnailImageCatcher ---------------------------------------------------------
 
 class ThumbnailImageCatcher::Private
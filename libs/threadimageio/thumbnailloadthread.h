@@ -41,6 +41,7 @@ namespace Digikam
 class DbEngineParameters;
 class ThumbnailCreator;
 class ThumbnailInfoProvider;
+class ThumbnailLoadingTask;
 
 class DIGIKAM_EXPORT ThumbnailLoadThread : public ManagedLoadSaveThread
 {
@@ -211,6 +212,16 @@ public:
      */
     void setSendSurrogatePixmap(bool send);
 
+    /**
+     * Enable the thumbnail generation pool.
+     * In pool mode, size - 1 additional workers, each with its own ThumbnailCreator,
+     * take loading tasks from the same queue as this thread, in the same order.
+     * Tasks for the same image are still shared through the LoadingCache.
+     * A size of 0 uses QThread::idealThreadCount(), a size of 1 (default) disables the pool.
+     */
+    void setPoolSize(int size);
+    int  poolSize() const;
+
     /**
      * Stores the given detail thumbnail on disk.
      * Use this if possible because generation of detail thumbnails
@@ -229,6 +240,14 @@ public:
      */
     static void deleteThumbnail(const QString& filePath);
 
+    /**
+     * Regenerates the thumbnail of the given file from an image which was already decoded,
+     * e.g. by a maintenance pass sharing one decode between several consumers,
+     * see ThumbnailCreator::pregenerate(). Cached instances are removed.
+     * Like deleteThumbnail(), this works independently from the multithreaded thumbnail loading.
+     */
+    static void pregenerateThumbnail(const QString& filePath, const DImg& image);
+
 Q_SIGNALS:
 
     // See LoadSaveThread for a QImage-based thumbnailLoaded() signal.
@@ -239,6 +258,9 @@ public:
     // For internal use - may only be used from the thread
     ThumbnailCreator* thumbnailCreator() const;
 
+    // For internal use - called by a ThumbnailLoadingTask executed by a pool worker
+    void poolTaskHasFinished(ThumbnailLoadingTask* const task);
+
 protected:
 
     virtual void thumbnailLoaded(const LoadingDescription& loadingDescription, const QImage& img);
@@ -250,6 +272,8 @@ private:
     void loadVideoThumbnail(const LoadingDescription& description);
     bool checkSize(int size);
     QPixmap surrogatePixmap(const LoadingDescription& loadingDescription);
+    ThumbnailLoadingTask* takePoolTask(ThumbnailCreator* const creator);
+    void startPool();
 
 Q_SIGNALS:
 
@@ -267,6 +291,8 @@ private Q_SLOTS:
 
 private:
 
+    friend class ThumbnailLoadWorker;
+
     class Private;
     Private* const d;
 };
@@ -0,0 +1,628 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-03-12
+ * Description : memory-mapped store of decoded thumbnails,
+ *               used as fast tier in front of the thumbnails database
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "thumbnailpackedstore.h"
+
+// C++ includes
+
+#include <cstring>
+
+// C ANSI includes
+
+#if defined(Q_OS_LINUX) || defined(Q_OS_FREEBSD)
+#   include <fcntl.h>
+#endif
+
+// Qt includes
+
+#include <QFile>
+#include <QHash>
+#include <QPair>
+#include <QReadWriteLock>
+#include <QVector>
+
+// Local includes
+
+#include "digikam_debug.h"
+
+namespace Digikam
+{
+
+namespace
+{
+
+static const char    packedStoreMagic[8]  = { 'D', 'K', 'T', 'H', 'P', 'A', 'C', 'K' };
+static const quint32 packedStoreVersion   = 1;
+static const qint64  packedStoreGrowth    = 256;       // records added each time the file is grown
+static const int     packedStoreHashSize  = 32;
+
+enum PackedStoreRecordFlags
+{
+    RecordValid = 0x01
+};
+
+struct PackedStoreFileHeader
+{
+    char    magic[8];
+    quint32 version;
+    quint32 recordSide;
+    quint32 recordCount;
+    char    reserved[44];
+};
+
+struct PackedStoreRecordHeader
+{
+    quint32 flags;
+    quint16 width;
+    quint16 height;
+    qint32  format;
+    qint32  orientation;
+    qint64  fileSize;
+    qint64  modificationDate;
+    char    uniqueHash[packedStoreHashSize];
+};
+
+Q_STATIC_ASSERT(sizeof(PackedStoreFileHeader)   == 64);
+Q_STATIC_ASSERT(sizeof(PackedStoreRecordHeader) == 64);
+
+typedef QPair<QString, qlonglong> PackedStoreKey;
+
+qint64 packedStoreDate(const QDateTime& date)
+{
+    return date.isValid() ? date.toMSecsSinceEpoch() : 0;
+}
+
+bool isPackedStoreFormat(qint32 format)
+{
+    return (format == QImage::Format_RGB32  ||
+            format == QImage::Format_ARGB32 ||
+            format == QImage::Format_ARGB32_Premultiplied);
+}
+
+/**
+ * Grows the file to size bytes with its blocks allocated on disk: writing to a hole
+ * of a sparse file through the mapping would crash the application if the disk is full.
+ */
+bool reserveFile(QFile& file, qint64 size)
+{
+    const qint64 oldSize = file.size();
+
+    if (oldSize >= size)
+    {
+        return true;
+    }
+
+#if defined(Q_OS_LINUX) || defined(Q_OS_FREEBSD)
+
+    if (posix_fallocate(file.handle(), oldSize, size - oldSize) == 0)
+    {
+        return true;
+    }
+
+    file.resize(oldSize);
+    return false;
+
+#else
+
+    static const char zeros[65536] = { 0 };
+
+    if (!file.seek(oldSize))
+    {
+        return false;
+    }
+
+    for (qint64 left = size - oldSize ; left > 0 ; )
+    {
+        const qint64 written = file.write(zeros, qMin(left, (qint64)sizeof(zeros)));
+
+        if (written <= 0)
+        {
+            file.resize(oldSize);
+            return false;
+        }
+
+        left -= written;
+    }
+
+    return file.flush();
+
+#endif
+}
+
+} // namespace
+
+class ThumbnailPackedStore::Private
+{
+public:
+
+    Private()
+    {
+        data         = 0;
+        capacity     = 0;
+        fileSize     = 0;
+        recordSide   = 0;
+        recordSize   = 0;
+        maxRecords   = 0;
+        nextEviction = 0;
+    }
+
+    PackedStoreFileHeader* fileHeader() const
+    {
+        return reinterpret_cast<PackedStoreFileHeader*>(data);
+    }
+
+    PackedStoreRecordHeader* recordHeader(qint64 record) const
+    {
+        return reinterpret_cast<PackedStoreRecordHeader*>(data + sizeof(PackedStoreFileHeader) + record * recordSize);
+    }
+
+    uchar* recordBits(qint64 record) const
+    {
+        return data + sizeof(PackedStoreFileHeader) + record * recordSize + sizeof(PackedStoreRecordHeader);
+    }
+
+    /**
+     * Returns true if the record is marked valid and its header is consistent with the
+     * record size. The record must lie in the file as it was mapped, before its header is
+     * read: reading a mapped page past the end of the file would crash. The file may also
+     * be damaged, the header is checked then.
+     */
+    bool isValidRecord(qint64 record) const
+    {
+        if (record < 0 || record >= capacity ||
+            fileSize < (qint64)sizeof(PackedStoreFileHeader) + (record + 1) * recordSize)
+        {
+            return false;
+        }
+
+        const PackedStoreRecordHeader* const header = recordHeader(record);
+
+        return ((header->flags & RecordValid)                       &&
+                header->width  != 0 && header->width  <= recordSide &&
+                header->height != 0 && header->height <= recordSide &&
+                isPackedStoreFormat(header->format));
+    }
+
+    PackedStoreKey recordKey(qint64 record) const
+    {
+        const PackedStoreRecordHeader* const header = recordHeader(record);
+
+        return PackedStoreKey(QString::fromLatin1(header->uniqueHash, qstrnlen(header->uniqueHash, packedStoreHashSize)),
+                              header->fileSize);
+    }
+
+    /**
+     * Returns a record to write a new thumbnail to: a free record, a new one at the end of the
+     * file while below the maximum size, else the next record in turn, which is dropped.
+     * Returns -1 if the file cannot grow.
+     */
+    qint64 takeRecord(ThumbnailPackedStore* const q)
+    {
+        if (!freeRecords.isEmpty())
+        {
+            return freeRecords.takeLast();
+        }
+
+        const qint64 count = fileHeader()->recordCount;
+
+        if (count < maxRecords)
+        {
+            if (count >= capacity && !q->remap(qMin(capacity + packedStoreGrowth, maxRecords)))
+            {
+                return -1;
+            }
+
+            fileHeader()->recordCount = count + 1;
+
+            return count;
+        }
+
+        const qint64 record = nextEviction;
+        nextEviction        = (nextEviction + 1) % count;
+
+        if (recordHeader(record)->flags & RecordValid)
+        {
+            index.remove(recordKey(record));
+        }
+
+        return record;
+    }
+
+    void unmap()
+    {
+        if (data)
+        {
+            file.unmap(data);
+            data = 0;
+        }
+
+        capacity = 0;
+        fileSize = 0;
+    }
+
+public:
+
+    QFile                         file;
+    uchar*                        data;
+    qint64                        capacity;
+
+    /// Size of the file when it was last mapped, read under the write lock
+    qint64                        fileSize;
+
+    int                           recordSide;
+    qint64                        recordSize;
+    qint64                        maxRecords;
+    qint64                        nextEviction;
+
+    QHash<PackedStoreKey, qint64> index;
+    QVector<qint64>               freeRecords;
+
+    mutable QReadWriteLock        lock;
+};
+
+class ThumbnailPackedStoreCreator
+{
+public:
+
+    ThumbnailPackedStore object;
+};
+
+Q_GLOBAL_STATIC(ThumbnailPackedStoreCreator, creator)
+
+// -----------------------------------------------------------------------------------------------
+
+ThumbnailPackedStore* ThumbnailPackedStore::instance()
+{
+    return &creator->object;
+}
+
+ThumbnailPackedStore::ThumbnailPackedStore()
+    : d(new Private)
+{
+}
+
+ThumbnailPackedStore::~ThumbnailPackedStore()
+{
+    close();
+    delete d;
+}
+
+bool ThumbnailPackedStore::open(const QString& filePath, int recordSide, qint64 maximumSize)
+{
+    close();
+
+    QWriteLocker locker(&d->lock);
+
+    d->file.setFileName(filePath);
+
+    if (!d->file.open(QIODevice::ReadWrite))
+    {
+        qCWarning(DIGIKAM_GENERAL_LOG) << "Cannot open packed thumbnail store" << filePath;
+        return false;
+    }
+
+    d->recordSide   = recordSide;
+    d->recordSize   = sizeof(PackedStoreRecordHeader) + (qint64)recordSide * recordSide * 4;
+    d->maxRecords   = qMax((qint64)1, (maximumSize - (qint64)sizeof(PackedStoreFileHeader)) / d->recordSize);
+    d->nextEviction = 0;
+
+    PackedStoreFileHeader header;
+    bool valid = (d->file.read(reinterpret_cast<char*>(&header), sizeof(header)) == sizeof(header));
+
+    valid      = valid                                                              &&
+                 memcmp(header.magic, packedStoreMagic, sizeof(packedStoreMagic)) == 0 &&
+                 header.version    == packedStoreVersion                            &&
+                 header.recordSide == (quint32)recordSide                           &&
+                 d->file.size()    >= (qint64)sizeof(header) + header.recordCount * d->recordSize;
+
+    if (!valid)
+    {
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Creating new packed thumbnail store" << filePath;
+
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, packedStoreMagic, sizeof(packedStoreMagic));
+        header.version    = packedStoreVersion;
+        header.recordSide = recordSide;
+
+        if (!d->file.resize(0) || !d->file.seek(0) ||
+            d->file.write(reinterpret_cast<const char*>(&header), sizeof(header)) != sizeof(header))
+        {
+            qCWarning(DIGIKAM_GENERAL_LOG) << "Cannot initialize packed thumbnail store" << filePath;
+            d->file.close();
+            return false;
+        }
+    }
+
+    // Records past the maximum size are dropped, and the file shrunk to it.
+
+    const qint64 count    = qMin((qint64)header.recordCount, d->maxRecords);
+    qint64       capacity = (d->file.size() - (qint64)sizeof(header)) / d->recordSize;
+
+    if (capacity > d->maxRecords)
+    {
+        capacity = d->maxRecords;
+        d->file.resize(sizeof(header) + capacity * d->recordSize);
+    }
+
+    if (!remap(qMin(qMax(capacity, count + packedStoreGrowth), d->maxRecords)))
+    {
+        d->file.close();
+        return false;
+    }
+
+    d->fileHeader()->recordCount = count;
+
+    // Rebuild the index. A later record for the same key supersedes an earlier one.
+    // Invalid and superseded records are reused for new thumbnails.
+
+    for (qint64 i = 0 ; i < count ; ++i)
+    {
+        if (!d->isValidRecord(i))
+        {
+            d->recordHeader(i)->flags &= ~RecordValid;
+            d->freeRecords << i;
+            continue;
+        }
+
+        QHash<PackedStoreKey, qint64>::iterator it = d->index.find(d->recordKey(i));
+
+        if (it != d->index.end())
+        {
+            d->recordHeader(it.value())->flags &= ~RecordValid;
+            d->freeRecords << it.value();
+            it.value() = i;
+        }
+        else
+        {
+            d->index.insert(d->recordKey(i), i);
+        }
+    }
+
+    qCDebug(DIGIKAM_GENERAL_LOG) << "Packed thumbnail store" << filePath << "opened with" << d->index.size() << "thumbnails";
+
+    return true;
+}
+
+void ThumbnailPackedStore::close()
+{
+    QWriteLocker locker(&d->lock);
+
+    d->unmap();
+    d->index.clear();
+    d->freeRecords.clear();
+
+    if (d->file.isOpen())
+    {
+        d->file.close();
+    }
+}
+
+bool ThumbnailPackedStore::isOpen() const
+{
+    QReadLocker locker(&d->lock);
+
+    return d->data;
+}
+
+QString ThumbnailPackedStore::filePath() const
+{
+    QReadLocker locker(&d->lock);
+
+    return d->file.fileName();
+}
+
+int ThumbnailPackedStore::recordSide() const
+{
+    QReadLocker locker(&d->lock);
+
+    return d->recordSide;
+}
+
+int ThumbnailPackedStore::count() const
+{
+    QReadLocker locker(&d->lock);
+
+    return d->index.size();
+}
+
+bool ThumbnailPackedStore::remap(qint64 recordCapacity)
+{
+    // Called with write lock held
+
+    d->unmap();
+
+    const qint64 size = sizeof(PackedStoreFileHeader) + recordCapacity * d->recordSize;
+
+    if (!reserveFile(d->file, size))
+    {
+        qCWarning(DIGIKAM_GENERAL_LOG) << "Cannot grow packed thumbnail store to" << size << "bytes";
+        return false;
+    }
+
+    d->data = d->file.map(0, size);
+
+    if (!d->data)
+    {
+        qCWarning(DIGIKAM_GENERAL_LOG) << "Cannot map packed thumbnail store:" << d->file.errorString();
+        return false;
+    }
+
+    d->capacity = recordCapacity;
+    d->fileSize = d->file.size();
+
+    return true;
+}
+
+bool ThumbnailPackedStore::load(const QString& uniqueHash, qlonglong fileSize, const QDateTime& modificationDate,
+                                QImage& image, int& orientation) const
+{
+    QReadLocker locker(&d->lock);
+
+    if (!d->data)
+    {
+        return false;
+    }
+
+    QHash<PackedStoreKey, qint64>::const_iterator it = d->index.constFind(PackedStoreKey(uniqueHash, fileSize));
+
+    if (it == d->index.constEnd())
+    {
+        return false;
+    }
+
+    if (!d->isValidRecord(it.value()))
+    {
+        return false;
+    }
+
+    const PackedStoreRecordHeader* const record = d->recordHeader(it.value());
+
+    // same rule as for the database: the thumbnail must not be older than the file
+    if (record->modificationDate < packedStoreDate(modificationDate))
+    {
+        return false;
+    }
+
+    image = QImage(record->width, record->height, (QImage::Format)record->format);
+
+    if (image.isNull())
+    {
+        return false;
+    }
+
+    const uchar* const bits = d->recordBits(it.value());
+    const int lineSize      = record->width * 4;
+
+    for (int y = 0 ; y < record->height ; ++y)
+    {
+        memcpy(image.scanLine(y), bits + y * lineSize, lineSize);
+    }
+
+    orientation = record->orientation;
+
+    return true;
+}
+
+bool ThumbnailPackedStore::store(const QString& uniqueHash, qlonglong fileSize, const QDateTime& modificationDate,
+                                 const QImage& image, int orientation)
+{
+    if (uniqueHash.isEmpty() || uniqueHash.size() > packedStoreHashSize || image.isNull())
+    {
+        return false;
+    }
+
+    const int side = recordSide();
+    QImage qimage  = image;
+
+    if (side <= 0)
+    {
+        return false;
+    }
+
+    if (qimage.width() > side || qimage.height() > side)
+    {
+        qimage = qimage.scaled(side, side, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+
+    if (!isPackedStoreFormat(qimage.format()))
+    {
+        qimage = qimage.convertToFormat(qimage.hasAlphaChannel() ? QImage::Format_ARGB32 : QImage::Format_RGB32);
+    }
+
+    QWriteLocker locker(&d->lock);
+
+    if (!d->data || qimage.width() > d->recordSide || qimage.height() > d->recordSide)
+    {
+        return false;
+    }
+
+    // A thumbnail replacing an older one for the same key is written to its record.
+
+    const PackedStoreKey key(uniqueHash, fileSize);
+    QHash<PackedStoreKey, qint64>::iterator it = d->index.find(key);
+    qint64 record;
+
+    if (it != d->index.end())
+    {
+        record = it.value();
+        d->index.erase(it);
+    }
+    else
+    {
+        record = d->takeRecord(this);
+
+        if (record < 0)
+        {
+            return false;
+        }
+    }
+
+    // pixel data first, the header flags mark the record as valid when complete
+
+    PackedStoreRecordHeader* const header = d->recordHeader(record);
+    header->flags      = 0;
+
+    uchar* const bits  = d->recordBits(record);
+    const int lineSize = qimage.width() * 4;
+
+    for (int y = 0 ; y < qimage.height() ; ++y)
+    {
+        memcpy(bits + y * lineSize, qimage.constScanLine(y), lineSize);
+    }
+
+    memset(header, 0, sizeof(PackedStoreRecordHeader));
+    memcpy(header->uniqueHash, uniqueHash.toLatin1().constData(), uniqueHash.size());
+    header->width            = qimage.width();
+    header->height           = qimage.height();
+    header->format           = qimage.format();
+    header->orientation      = orientation;
+    header->fileSize         = fileSize;
+    header->modificationDate = packedStoreDate(modificationDate);
+    header->flags            = RecordValid;
+
+    d->index.insert(key, record);
+
+    return true;
+}
+
+void ThumbnailPackedStore::remove(const QString& uniqueHash, qlonglong fileSize)
+{
+    QWriteLocker locker(&d->lock);
+
+    if (!d->data)
+    {
+        return;
+    }
+
+    QHash<PackedStoreKey, qint64>::iterator it = d->index.find(PackedStoreKey(uniqueHash, fileSize));
+
+    if (it != d->index.end())
+    {
+        d->recordHeader(it.value())->flags &= ~RecordValid;
+        d->freeRecords << it.value();
+        d->index.erase(it);
+    }
+}
+
+} // namespace Digikam
@@ -0,0 +1,117 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-03-12
+ * Description : memory-mapped store of decoded thumbnails,
+ *               used as fast tier in front of the thumbnails database
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef THUMBNAIL_PACKED_STORE_H
+#define THUMBNAIL_PACKED_STORE_H
+
+// Qt includes
+
+#include <QString>
+#include <QDateTime>
+#include <QImage>
+
+// Local includes
+
+#include "digikam_export.h"
+
+namespace Digikam
+{
+
+class DIGIKAM_EXPORT ThumbnailPackedStore
+{
+public:
+
+    /**
+     * The packed store is a single file holding one fixed-size record per thumbnail.
+     * Each record contains the thumbnail already decoded to the display pixel format,
+     * so that a hit costs a memcpy from the mapped file instead of an SQL query and
+     * a PGF decode. Records are looked up by uniqueHash + fileSize. A replaced thumbnail
+     * is written over its record, and removed records are reused for new thumbnails.
+     * The file does not grow past a maximum size: when it is full, records are reused
+     * in turn from the start of the file.
+     *
+     * The thumbnails database stays the source of truth: the store can be deleted
+     * at any time and will be refilled when thumbnails are loaded again.
+     * All methods are thread-safe.
+     */
+    static ThumbnailPackedStore* instance();
+
+    /**
+     * Open (or create) the store file. Records are images of at most recordSide x recordSide pixels.
+     * If an existing file uses a different record size or format version, it is recreated.
+     * The file does not grow larger than maximumSize bytes, and is shrunk to it if needed.
+     */
+    bool open(const QString& filePath, int recordSide = 256, qint64 maximumSize = 512 * 1024 * 1024);
+    void close();
+    bool isOpen() const;
+
+    QString filePath() const;
+
+    /**
+     * Returns the maximum width and height of a stored thumbnail.
+     */
+    int recordSide() const;
+
+    /**
+     * Returns true and sets image and orientation if a valid record for the given
+     * key exists which is not older than modificationDate.
+     */
+    bool load(const QString& uniqueHash, qlonglong fileSize, const QDateTime& modificationDate,
+              QImage& image, int& orientation) const;
+
+    /**
+     * Stores a record for the given key, replacing an existing record for this key.
+     * Images larger than the record size are scaled down.
+     */
+    bool store(const QString& uniqueHash, qlonglong fileSize, const QDateTime& modificationDate,
+               const QImage& image, int orientation);
+
+    /**
+     * Invalidates the record for the given key.
+     */
+    void remove(const QString& uniqueHash, qlonglong fileSize);
+
+    /**
+     * Returns the number of valid records.
+     */
+    int count() const;
+
+private:
+
+    ThumbnailPackedStore();
+    ~ThumbnailPackedStore();
+
+    bool remap(qint64 recordCapacity);
+
+private:
+
+    friend class ThumbnailPackedStoreCreator;
+
+    class Private;
+    Private* const d;
+};
+
+} // namespace Digikam
+
+#endif // THUMBNAIL_PACKED_STORE_H
@@ -57,6 +57,25 @@ ThumbnailLoadingTask::ThumbnailLoadingTask(LoadSaveThread* const thread, const L
     // Not a clean but pragmatic solution.
     ThumbnailLoadThread* const thumbThread = static_cast<ThumbnailLoadThread*>(thread);
     m_creator                              = thumbThread->thumbnailCreator();
+    m_poolTask                             = false;
+}
+
+void ThumbnailLoadingTask::setPoolCreator(ThumbnailCreator* const creator)
+{
+    m_creator  = creator;
+    m_poolTask = true;
+}
+
+void ThumbnailLoadingTask::taskHasFinished()
+{
+    if (m_poolTask)
+    {
+        static_cast<ThumbnailLoadThread*>(m_thread)->poolTaskHasFinished(this);
+    }
+    else
+    {
+        m_thread->taskHasFinished();
+    }
 }
 
 void ThumbnailLoadingTask::execute()
@@ -66,6 +85,9 @@ void ThumbnailLoadingTask::execute()
         return;
     }
 
+    // Thumbnails are created in parallel already.
+    DImg::setProcessingThreads(1);
+
     if (m_loadingDescription.previewParameters.onlyPregenerate())
     {
         setupCreator();
@@ -83,7 +105,7 @@ void ThumbnailLoadingTask::execute()
                 break;
         }
 
-        m_thread->taskHasFinished();
+        taskHasFinished();
         // do not emit any signal
         return;
     }
@@ -152,7 +174,7 @@ void ThumbnailLoadingTask::execute()
     {
         // following the golden rule to avoid deadlocks, do this when CacheLock is not held
         postProcess();
-        m_thread->taskHasFinished();
+        taskHasFinished();
         m_thread->thumbnailLoaded(m_loadingDescription, m_qimage);
         return;
     }
@@ -219,7 +241,7 @@ void ThumbnailLoadingTask::execute()
 
     // again: following the golden rule to avoid deadlocks, do this when CacheLock is not held
     postProcess();
-    m_thread->taskHasFinished();
+    taskHasFinished();
     m_thread->thumbnailLoaded(m_loadingDescription, m_qimage);
 }
 
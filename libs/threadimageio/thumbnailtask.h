@@ -48,15 +48,23 @@ public:
     virtual void setResult(const LoadingDescription& loadingDescription, const QImage& qimage);
     virtual void postProcess();
 
+    /**
+     * Called by a pool worker of the ThumbnailLoadThread before executing the task:
+     * the task will use the worker's own creator instead of the one of the thread.
+     */
+    void setPoolCreator(ThumbnailCreator* const creator);
+
 private:
 
     virtual void setResult(const LoadingDescription&, const DImg&) {};
     void setupCreator();
+    void taskHasFinished();
 
 private:
 
     QImage            m_qimage;
     ThumbnailCreator* m_creator;
+    bool              m_poolTask;
 };
 
 } // namespace Digikam
@@ -73,6 +73,14 @@ protected:
 
 class DIGIKAM_EXPORT GraphicsDImgItem::GraphicsDImgItemPrivate
 {
+public:
+
+    /// The largest side of the proxy of out-of-core images
+    enum
+    {
+        ProxySize = 4096
+    };
+
 public:
 
     GraphicsDImgItemPrivate()
@@ -81,9 +89,26 @@ public:
 
     void init(GraphicsDImgItem* const q);
 
+    /** Returns the image to scale to draw the whole image at the given size: the proxy if it
+     *  is large enough, otherwise the image. Zoomed out views of an out-of-core image do not
+     *  read it all for each paint.
+     */
+    const DImg& displayImage(const QSize& completeSize) const
+    {
+        if (!proxy.isNull()                               &&
+            completeSize.width()  <= (int)proxy.width()  &&
+            completeSize.height() <= (int)proxy.height())
+        {
+            return proxy;
+        }
+
+        return image;
+    }
+
 public:
 
     DImg                  image;
+    DImg                  proxy;
     ImageZoomSettings     zoomSettings;
     mutable CachedPixmaps cachedPixmaps;
 };
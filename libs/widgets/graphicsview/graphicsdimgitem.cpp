@@ -149,6 +149,10 @@ void GraphicsDImgItem::setImage(const DImg& img)
 {
     Q_D(GraphicsDImgItem);
     d->image = img;
+    d->proxy = img.isOutOfCore() ? img.smoothScale(GraphicsDImgItemPrivate::ProxySize,
+                                                   GraphicsDImgItemPrivate::ProxySize,
+                                                   Qt::KeepAspectRatio)
+                                 : DImg();
     d->zoomSettings.setImageSize(img.size(), img.originalSize());
     d->cachedPixmaps.clear();
     sizeHasChanged();
@@ -249,9 +253,10 @@ void GraphicsDImgItem::paint(QPainter* painter, const QStyleOptionGraphicsItem*
     {
         // scale "as if" scaling to whole image, but clip output to our exposed region
         QSize scaledCompleteSize = QSizeF(ratio*completeSize.width(), ratio*completeSize.height()).toSize();
-        DImg scaledImage   = d->image.smoothScaleClipped(scaledCompleteSize.width(), scaledCompleteSize.height(),
-                                                         scaledDrawRect.x(), scaledDrawRect.y(),
-                                                         scaledDrawRect.width(), scaledDrawRect.height());
+        const DImg& source = d->displayImage(scaledCompleteSize);
+        DImg scaledImage   = source.smoothScaleClipped(scaledCompleteSize.width(), scaledCompleteSize.height(),
+                                                       scaledDrawRect.x(), scaledDrawRect.y(),
+                                                       scaledDrawRect.width(), scaledDrawRect.height());
         pix                = scaledImage.convertToPixmap();
         d->cachedPixmaps.insert(scaledDrawRect, pix);
         painter->drawPixmap(drawRect, pix);
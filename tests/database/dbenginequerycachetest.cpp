@@ -0,0 +1,120 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-04-08
+ * Description : Test the cache of prepared statements of the database backend
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "dbenginequerycachetest.h"
+
+// Qt includes
+
+#include <QTest>
+#include <QList>
+#include <QVariant>
+
+// Local includes
+
+#include "dbengineparameters.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(DbEngineQueryCacheTest)
+
+void DbEngineQueryCacheTest::init()
+{
+    QVERIFY(m_dir.isValid());
+
+    m_backend = new BdEngineBackend(QLatin1String("dbenginequerycachetest"), &m_locking);
+
+    QVERIFY(m_backend->open(DbEngineParameters::parametersForSQLite(m_dir.filePath(QLatin1String("querycache.db")))));
+    QVERIFY(m_backend->execSql(QLatin1String("DROP TABLE IF EXISTS Items;")));
+    QVERIFY(m_backend->execSql(QLatin1String("DROP TABLE IF EXISTS ItemsV1;")));
+    QVERIFY(m_backend->execSql(QLatin1String("CREATE TABLE Items (id INTEGER PRIMARY KEY, name TEXT);")));
+    QVERIFY(m_backend->execSql(QLatin1String("INSERT INTO Items (name) VALUES (?);"), QLatin1String("first")));
+}
+
+void DbEngineQueryCacheTest::cleanup()
+{
+    delete m_backend;
+    m_backend = 0;
+}
+
+void DbEngineQueryCacheTest::testHitsAndMisses()
+{
+    const QString select = QLatin1String("SELECT name FROM Items WHERE id=?;");
+    const int hits       = m_backend->cachedQueryHits();
+    const int misses     = m_backend->cachedQueryMisses();
+    QList<QVariant> values;
+
+    QVERIFY(m_backend->execSql(select, 1, &values));
+    QCOMPARE(m_backend->cachedQueryHits(),   hits);
+    QCOMPARE(m_backend->cachedQueryMisses(), misses + 1);
+
+    values.clear();
+    QVERIFY(m_backend->execSql(select, 1, &values));
+    QCOMPARE(m_backend->cachedQueryHits(),   hits + 1);
+    QCOMPARE(m_backend->cachedQueryMisses(), misses + 1);
+    QCOMPARE(values, QList<QVariant>() << QVariant(QLatin1String("first")));
+}
+
+void DbEngineQueryCacheTest::testSchemaStatementsNotCached()
+{
+    const QString create = QLatin1String("CREATE INDEX IF NOT EXISTS name_index ON Items (name);");
+    const QString drop   = QLatin1String("  drop INDEX IF EXISTS name_index;");
+    const int hits       = m_backend->cachedQueryHits();
+    const int misses     = m_backend->cachedQueryMisses();
+
+    QVERIFY(m_backend->execSql(create));
+    QVERIFY(m_backend->execSql(drop));
+    QVERIFY(m_backend->execSql(create));
+    QVERIFY(m_backend->execSql(drop));
+
+    QCOMPARE(m_backend->cachedQueryHits(),   hits);
+    QCOMPARE(m_backend->cachedQueryMisses(), misses);
+}
+
+void DbEngineQueryCacheTest::testSchemaChangeInvalidates()
+{
+    const QString select = QLatin1String("SELECT name FROM Items;");
+    QList<QVariant> values;
+
+    QVERIFY(m_backend->execSql(select, &values));
+    QVERIFY(m_backend->execSql(select, &values));
+
+    // As done by the schema updater: the old table is renamed, a new one takes its name.
+
+    QVERIFY(m_backend->execSql(QLatin1String("ALTER TABLE Items RENAME TO ItemsV1;")));
+    QVERIFY(m_backend->execSql(QLatin1String("CREATE TABLE Items (id INTEGER PRIMARY KEY, name TEXT);")));
+    QVERIFY(m_backend->execSql(QLatin1String("INSERT INTO Items (name) VALUES (?);"), QLatin1String("second")));
+
+    const int hits   = m_backend->cachedQueryHits();
+    const int misses = m_backend->cachedQueryMisses();
+
+    values.clear();
+    QVERIFY(m_backend->execSql(select, &values));
+    QCOMPARE(m_backend->cachedQueryHits(),   hits);
+    QCOMPARE(m_backend->cachedQueryMisses(), misses + 1);
+    QCOMPARE(values, QList<QVariant>() << QVariant(QLatin1String("second")));
+
+    values.clear();
+    QVERIFY(m_backend->execSql(select, &values));
+    QCOMPARE(m_backend->cachedQueryHits(),   hits + 1);
+    QCOMPARE(values, QList<QVariant>() << QVariant(QLatin1String("second")));
+}
@@ -0,0 +1,56 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-04-08
+ * Description : Test the cache of prepared statements of the database backend
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DBENGINEQUERYCACHETEST_H
+#define DBENGINEQUERYCACHETEST_H
+
+// Qt includes
+
+#include <QtTest>
+#include <QTemporaryDir>
+
+// Local includes
+
+#include "dbenginebackend.h"
+
+class DbEngineQueryCacheTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void testHitsAndMisses();
+    void testSchemaStatementsNotCached();
+    void testSchemaChangeInvalidates();
+
+    void init();
+    void cleanup();
+
+private:
+
+    QTemporaryDir                     m_dir;
+    Digikam::DbEngineLocking          m_locking;
+    Digikam::BdEngineBackend*         m_backend;
+};
+
+#endif // DBENGINEQUERYCACHETEST_H
@@ -0,0 +1,169 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-04-08
+ * Description : Test the sort keys of the image sort settings against compare()
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "imagesortsettingstest.h"
+
+// Qt includes
+
+#include <QTest>
+#include <QDateTime>
+#include <QSize>
+
+// Local includes
+
+#include "coredbaccess.h"
+#include "dbengineparameters.h"
+#include "imagelisterrecord.h"
+#include "imagesortsettings.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(ImageSortSettingsTest)
+
+/**
+ * All fields read by the sort roles are cached from the record: the infos are never read from the database.
+ */
+static ImageInfo createInfo(qlonglong id, const QDateTime& date, int fileSize, int rating,
+                            const QSize& size, double similarity, qlonglong referenceImage)
+{
+    ImageListerRecord record;
+    record.imageID                          = id;
+    record.albumID                          = 1;
+    record.albumRootID                      = 1;
+    record.name                             = QString::fromLatin1("image%1.jpg").arg(id);
+    record.creationDate                     = date;
+    record.modificationDate                 = date.isValid() ? date.addSecs(60) : date;
+    record.fileSize                         = fileSize;
+    record.rating                           = rating;
+    record.imageSize                        = size;
+    record.currentSimilarity                = similarity;
+    record.currentFuzzySearchReferenceImage = referenceImage;
+
+    return ImageInfo(record);
+}
+
+void ImageSortSettingsTest::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+
+    // Creates the cache of the image infos, the database is not opened.
+    CoreDbAccess::setParameters(DbEngineParameters::parametersForSQLite(m_dir.filePath(QLatin1String("digikam4.db"))));
+
+    const QDateTime local(QDate(2018, 3, 25), QTime(10, 0), Qt::LocalTime);
+    const QDateTime utc(QDate(2018, 3, 25), QTime(10, 0), Qt::UTC);
+    const QDateTime beforeEpoch(QDate(1965, 7, 1), QTime(12, 0), Qt::LocalTime);
+    const QDateTime later = local.addMSecs(1);
+
+    m_infos << createInfo(1, local,       2000000, 3,  QSize(4000, 3000), 0.5,  -1)
+            << createInfo(2, local,       2000000, 3,  QSize(4000, 3000), 0.5,  -1)     // all keys equal to the first
+            << createInfo(3, QDateTime(), 1000,    -1, QSize(640, 480),   0.25, -1)     // invalid dates
+            << createInfo(4, QDateTime(), 1000,    0,  QSize(480, 640),   0.0,  -1)     // invalid dates
+            << createInfo(5, beforeEpoch, 0,       5,  QSize(100, 100),   0.75, 5)      // reference image
+            << createInfo(6, utc,         3000000, 1,  QSize(3000, 4000), 0.9,  -1)     // same time in UTC
+            << createInfo(7, later,       2000001, 2,  QSize(4000, 3001), 0.5,  -1);
+}
+
+void ImageSortSettingsTest::cleanupTestCase()
+{
+    m_infos.clear();
+    CoreDbAccess::cleanUpDatabase();
+}
+
+void ImageSortSettingsTest::testSortKeysMatchCompare()
+{
+    ImageSortSettings settings;
+    QList<ImageSortSettings::SortOrder> orders;
+    orders << ImageSortSettings::AscendingOrder
+           << ImageSortSettings::DescendingOrder
+           << ImageSortSettings::DefaultOrder;
+
+    for (int role = ImageSortSettings::SortByFileName ; role <= ImageSortSettings::SortBySimilarity ; ++role)
+    {
+        settings.setSortRole((ImageSortSettings::SortRole)role);
+
+        if (!settings.hasSortKey())
+        {
+            continue;
+        }
+
+        foreach (ImageSortSettings::SortOrder order, orders)
+        {
+            settings.setSortOrder(order);
+
+            foreach (const ImageInfo& left, m_infos)
+            {
+                foreach (const ImageInfo& right, m_infos)
+                {
+                    QCOMPARE(settings.compareSortKeys(settings.sortKey(left), settings.sortKey(right)),
+                             settings.compare(left, right));
+                }
+            }
+        }
+    }
+}
+
+void ImageSortSettingsTest::testInvalidDates()
+{
+    ImageSortSettings settings;
+    settings.setSortOrder(ImageSortSettings::AscendingOrder);
+
+    const ImageInfo& valid        = m_infos.at(0);
+    const ImageInfo& invalid      = m_infos.at(2);
+    const ImageInfo& otherInvalid = m_infos.at(3);
+    const ImageInfo& beforeEpoch  = m_infos.at(4);
+
+    settings.setSortRole(ImageSortSettings::SortByCreationDate);
+
+    // Invalid dates are older than all valid dates, the dates before 1970 too.
+    QCOMPARE(settings.compare(invalid, valid),        -1);
+    QCOMPARE(settings.compare(invalid, beforeEpoch),  -1);
+    QCOMPARE(settings.compare(beforeEpoch, valid),    -1);
+    QCOMPARE(settings.compare(invalid, otherInvalid), 0);
+
+    settings.setSortRole(ImageSortSettings::SortByModificationDate);
+
+    QCOMPARE(settings.compare(invalid, beforeEpoch),  -1);
+    QCOMPARE(settings.compare(invalid, otherInvalid), 0);
+    QCOMPARE(settings.compareSortKeys(settings.sortKey(invalid), settings.sortKey(otherInvalid)), 0);
+}
+
+void ImageSortSettingsTest::testEqualKeys()
+{
+    ImageSortSettings settings;
+
+    const ImageInfo& first  = m_infos.at(0);
+    const ImageInfo& second = m_infos.at(1);
+
+    for (int role = ImageSortSettings::SortByCreationDate ; role <= ImageSortSettings::SortBySimilarity ; ++role)
+    {
+        settings.setSortRole((ImageSortSettings::SortRole)role);
+
+        QCOMPARE(settings.sortKey(first), settings.sortKey(second));
+        QCOMPARE(settings.compare(first, second), 0);
+        QCOMPARE(settings.compareSortKeys(settings.sortKey(first), settings.sortKey(second)), 0);
+    }
+
+    // Equal for the sort role, the images are still ordered by the other roles.
+    settings.setSortRole(ImageSortSettings::SortByRating);
+    QVERIFY(settings.lessThan(first, second) != settings.lessThan(second, first));
+}
@@ -0,0 +1,345 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-04-03
+ * Description : a test of the blur kernels against the former blur code
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "blurkernelstest.h"
+
+// C++ includes
+
+#include <cmath>
+#include <cstring>
+
+// Qt includes
+
+#include <QByteArray>
+#include <QString>
+#include <QTest>
+#include <QVector>
+#include <QtMath>
+
+// Local includes
+
+#include "blurkernels.h"
+#include "dimg.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(BlurKernelsTest)
+
+static DImg randomImage(int width, int height, bool sixteenBit)
+{
+    DImg img(width, height, sixteenBit, true);
+    uchar* const data = img.bits();
+
+    qsrand(width * height);
+
+    for (quint64 i = 0 ; i < img.numBytes() ; ++i)
+    {
+        data[i] = qrand() & 0xFF;
+    }
+
+    return img;
+}
+
+static QByteArray imageData(const DImg& img)
+{
+    return QByteArray((const char*)img.bits(), img.numBytes());
+}
+
+/**
+ * The box blur of BlurFilter before BoxBlur, which summed the window of each pixel again.
+ */
+static void formerBoxBlur(const DImg& orgImage, DImg& destImage, int radius)
+{
+    const bool sixteenBit = orgImage.sixteenBit();
+    const int  height     = orgImage.height();
+    const int  width      = orgImage.width();
+    QVector<int> as(width);
+    QVector<int> rs(width);
+    QVector<int> gs(width);
+    QVector<int> bs(width);
+
+    for (int y = 0 ; y < height ; ++y)
+    {
+        int my = y - radius;
+        int mh = (radius << 1) + 1;
+
+        if (my < 0)
+        {
+            mh += my;
+            my  = 0;
+        }
+
+        if ((my + mh) > height)
+        {
+            mh = height - my;
+        }
+
+        uchar* pDst8           = destImage.scanLine(y);
+        unsigned short* pDst16 = reinterpret_cast<unsigned short*>(destImage.scanLine(y));
+
+        as.fill(0);
+        rs.fill(0);
+        gs.fill(0);
+        bs.fill(0);
+
+        for (int yy = 0 ; yy < mh ; ++yy)
+        {
+            uchar* pSrc8           = orgImage.scanLine(yy + my);
+            unsigned short* pSrc16 = reinterpret_cast<unsigned short*>(orgImage.scanLine(yy + my));
+
+            for (int x = 0 ; x < width ; ++x)
+            {
+                if (sixteenBit)
+                {
+                    bs[x]  += pSrc16[0];
+                    gs[x]  += pSrc16[1];
+                    rs[x]  += pSrc16[2];
+                    as[x]  += pSrc16[3];
+                    pSrc16 += 4;
+                }
+                else
+                {
+                    bs[x] += pSrc8[0];
+                    gs[x] += pSrc8[1];
+                    rs[x] += pSrc8[2];
+                    as[x] += pSrc8[3];
+                    pSrc8 += 4;
+                }
+            }
+        }
+
+        for (int x = 0 ; x < width ; ++x)
+        {
+            uint a = 0, r = 0, g = 0, b = 0;
+            int mx = x - radius;
+            int mw = (radius << 1) + 1;
+
+            if (mx < 0)
+            {
+                mw += mx;
+                mx  = 0;
+            }
+
+            if ((mx + mw) > width)
+            {
+                mw = width - mx;
+            }
+
+            const int mt = mw * mh;
+
+            for (int xx = mx ; xx < (mw + mx) ; ++xx)
+            {
+                a += as[xx];
+                r += rs[xx];
+                g += gs[xx];
+                b += bs[xx];
+            }
+
+            a = a / mt;
+            r = r / mt;
+            g = g / mt;
+            b = b / mt;
+
+            if (sixteenBit)
+            {
+                pDst16[0] = b;
+                pDst16[1] = g;
+                pDst16[2] = r;
+                pDst16[3] = a;
+                pDst16   += 4;
+            }
+            else
+            {
+                pDst8[0] = b;
+                pDst8[1] = g;
+                pDst8[2] = r;
+                pDst8[3] = a;
+                pDst8   += 4;
+            }
+        }
+    }
+}
+
+/**
+ * The recursive blur of LocalContrastFilter before RecursiveBlur, which walked down each column.
+ */
+static void formerRecursiveBlur(float* const data, int sizex, int sizey, float blur)
+{
+    if (blur < 0.3)
+    {
+        return;
+    }
+
+    float a = (float)(qExp(log(0.25) / blur));
+
+    if ((a <= 0.0) || (a >= 1.0))
+    {
+        return;
+    }
+
+    a *= a;
+
+    const float denormal_remove = (float)(1e-15);
+
+    for (int y = 0 ; y < sizey ; ++y)
+    {
+        int pos   = y * sizex;
+        float old = data[pos];
+        ++pos;
+
+        for (int x = 1 ; x < sizex ; ++x)
+        {
+            old       = (data[pos] * (1 - a) + old * a) + denormal_remove;
+            data[pos] = old;
+            ++pos;
+        }
+
+        pos = y * sizex + sizex - 1;
+
+        for (int x = 1 ; x < sizex ; ++x)
+        {
+            old       = (data[pos] * (1 - a) + old * a) + denormal_remove;
+            data[pos] = old;
+            pos--;
+        }
+    }
+
+    for (int x = 0 ; x < sizex ; ++x)
+    {
+        int pos   = x;
+        float old = data[pos];
+
+        for (int y = 1 ; y < sizey ; ++y)
+        {
+            old        = (data[pos] * (1 - a) + old * a) + denormal_remove;
+            data[pos]  = old;
+            pos       += sizex;
+        }
+
+        pos = x + sizex * (sizey - 1);
+
+        for (int y = 1 ; y < sizey ; ++y)
+        {
+            old        = (data[pos] * (1 - a) + old * a) + denormal_remove;
+            data[pos]  = old;
+            pos       -= sizex;
+        }
+    }
+}
+
+void BlurKernelsTest::testBoxBlur_data()
+{
+    QTest::addColumn<bool>("sixteenBit");
+    QTest::addColumn<int>("radius");
+
+    // The former code only wrote the rows of images wider than the window,
+    // and summed 16 bits windows in 32 bits integers: radius 100 is within both limits.
+
+    const int radii[] = { 1, 2, 5, 17, 100 };
+
+    for (int depth = 0 ; depth < 2 ; ++depth)
+    {
+        for (uint i = 0 ; i < sizeof(radii) / sizeof(radii[0]) ; ++i)
+        {
+            QTest::newRow(qPrintable(QString::fromLatin1("%1 bits, radius %2").arg(depth ? 16 : 8).arg(radii[i])))
+                << (bool)depth << radii[i];
+        }
+    }
+}
+
+void BlurKernelsTest::testBoxBlur()
+{
+    QFETCH(bool, sixteenBit);
+    QFETCH(int, radius);
+
+    const DImg src = randomImage(211, 97, sixteenBit);
+
+    DImg former(src.width(), src.height(), sixteenBit, true);
+    formerBoxBlur(src, former, radius);
+
+    // The rows are blurred in bands, as BlurFilter does in parallel.
+
+    DImg blurred(src.width(), src.height(), sixteenBit, true);
+    const int bands[] = { 0, 1, 30, 64, (int)src.height() };
+
+    for (uint i = 0 ; i < sizeof(bands) / sizeof(bands[0]) - 1 ; ++i)
+    {
+        BoxBlur box(src, radius);
+        box.startAt(bands[i]);
+
+        for (int y = bands[i] ; y < bands[i + 1] ; ++y)
+        {
+            box.blurRow(y, blurred.scanLine(y));
+        }
+    }
+
+    QVERIFY(imageData(blurred) == imageData(former));
+}
+
+void BlurKernelsTest::testRecursiveBlur_data()
+{
+    QTest::addColumn<float>("blur");
+
+    QTest::newRow("0.2") << 0.2F;
+    QTest::newRow("0.5") << 0.5F;
+    QTest::newRow("3")   << 3.0F;
+    QTest::newRow("40")  << 40.0F;
+}
+
+void BlurKernelsTest::testRecursiveBlur()
+{
+    QFETCH(float, blur);
+
+    // Wider than a block of columns, and not a multiple of it.
+
+    const int sizex = 150;
+    const int sizey = 83;
+    QVector<float> former(sizex * sizey);
+
+    qsrand(sizex * sizey);
+
+    for (int i = 0 ; i < former.size() ; ++i)
+    {
+        former[i] = (float)(qrand() & 0xFFFF) / 65535.0F;
+    }
+
+    QVector<float> blurred = former;
+
+    formerRecursiveBlur(former.data(), sizex, sizey, blur);
+
+    const float a = RecursiveBlur::coefficient(blur);
+
+    if (a != 0.0)
+    {
+        for (int y = 0 ; y < sizey ; ++y)
+        {
+            RecursiveBlur::blurRow(blurred.data() + y * sizex, sizex, a);
+        }
+
+        // The columns are blurred in two bands, as LocalContrastFilter does in parallel.
+        RecursiveBlur::blurColumns(blurred.data(), sizex, sizey, a, 0, 70);
+        RecursiveBlur::blurColumns(blurred.data(), sizex, sizey, a, 70, sizex);
+    }
+
+    QVERIFY(memcmp(blurred.constData(), former.constData(), former.size() * sizeof(float)) == 0);
+}
@@ -0,0 +1,192 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-04-02
+ * Description : a test for the parallel histogram count
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "dimghistogramtest.h"
+
+// Qt includes
+
+#include <QRect>
+#include <QSize>
+#include <QString>
+#include <QTest>
+#include <QVector>
+
+// Local includes
+
+#include "dcolor.h"
+#include "digikam_globals.h"
+#include "dimg.h"
+#include "imagehistogram.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(DImgHistogramTest)
+
+static DImg randomImage(int width, int height, bool sixteenBit)
+{
+    DImg img(width, height, sixteenBit, true);
+    uchar* const data = img.bits();
+
+    qsrand(width * height);
+
+    for (quint64 i = 0 ; i < img.numBytes() ; ++i)
+    {
+        data[i] = qrand() & 0xFF;
+    }
+
+    return img;
+}
+
+void DImgHistogramTest::cleanupTestCase()
+{
+    DImg::setProcessingThreads(0);
+}
+
+void DImgHistogramTest::testCount_data()
+{
+    QTest::addColumn<bool>("sixteenBit");
+    QTest::addColumn<QSize>("size");
+    QTest::addColumn<int>("threads");
+
+    // The large images are counted in several bands, the small one in the calling thread.
+
+    QTest::newRow("8 bits, small")     << false << QSize(61, 37)     << 0;
+    QTest::newRow("8 bits, bands")     << false << QSize(1031, 1597) << 0;
+    QTest::newRow("8 bits, 1 thread")  << false << QSize(1031, 1597) << 1;
+    QTest::newRow("16 bits, small")    << true  << QSize(61, 37)     << 0;
+    QTest::newRow("16 bits, bands")    << true  << QSize(1031, 1597) << 0;
+    QTest::newRow("16 bits, 1 thread") << true  << QSize(1031, 1597) << 1;
+}
+
+void DImgHistogramTest::testCount()
+{
+    QFETCH(bool, sixteenBit);
+    QFETCH(QSize, size);
+    QFETCH(int, threads);
+
+    const DImg img = randomImage(size.width(), size.height(), sixteenBit);
+
+    // The reference is counted pixel per pixel, from the colors.
+
+    const int segments = sixteenBit ? 65536 : 256;
+    QVector<double> expected(ColorChannels * segments, 0.0);
+
+    for (int y = 0 ; y < size.height() ; ++y)
+    {
+        for (int x = 0 ; x < size.width() ; ++x)
+        {
+            const DColor color = img.getPixelColor(x, y);
+
+            expected[LuminosityChannel * segments + qMax(color.red(), qMax(color.green(), color.blue()))]++;
+            expected[RedChannel        * segments + color.red()]++;
+            expected[GreenChannel      * segments + color.green()]++;
+            expected[BlueChannel       * segments + color.blue()]++;
+            expected[AlphaChannel      * segments + color.alpha()]++;
+        }
+    }
+
+    DImg::setProcessingThreads(threads);
+
+    ImageHistogram histogram(img);
+    histogram.calculate();
+
+    QVERIFY(histogram.isValid());
+    QCOMPARE(histogram.getHistogramSegments(), segments);
+
+    for (int channel = LuminosityChannel ; channel < ColorChannels ; ++channel)
+    {
+        for (int bin = 0 ; bin < segments ; ++bin)
+        {
+            if (histogram.getValue(channel, bin) != expected.at(channel * segments + bin))
+            {
+                QFAIL(qPrintable(QString::fromLatin1("Channel %1, bin %2: %3 instead of %4")
+                                 .arg(channel).arg(bin)
+                                 .arg(histogram.getValue(channel, bin))
+                                 .arg(expected.at(channel * segments + bin))));
+            }
+        }
+    }
+
+    QCOMPARE(histogram.getCount(RedChannel, 0, segments - 1), (double)size.width() * size.height());
+}
+
+void DImgHistogramTest::testUpdateRegion_data()
+{
+    QTest::addColumn<bool>("sixteenBit");
+    QTest::addColumn<QRect>("region");
+
+    QTest::newRow("8 bits, inside")    << false << QRect(100, 200, 300, 400);
+    QTest::newRow("8 bits, clipped")   << false << QRect(900, 1500, 300, 400);
+    QTest::newRow("16 bits, inside")   << true  << QRect(100, 200, 300, 400);
+    QTest::newRow("16 bits, clipped")  << true  << QRect(900, 1500, 300, 400);
+}
+
+void DImgHistogramTest::testUpdateRegion()
+{
+    QFETCH(bool, sixteenBit);
+    QFETCH(QRect, region);
+
+    const DImg img = randomImage(1031, 1597, sixteenBit);
+
+    ImageHistogram histogram(img);
+    histogram.calculate();
+    QVERIFY(histogram.isValid());
+
+    // A tool stops the computations before each preview: the update must still be done.
+    histogram.stopCalculation();
+
+    // The region of a copy is changed, the previous image is left untouched.
+
+    DImg changed     = img.copy();
+    const QRect rect = region & QRect(QPoint(0, 0), changed.size());
+
+    for (int y = rect.top() ; y <= rect.bottom() ; ++y)
+    {
+        uchar* const line = changed.scanLine(y) + rect.left() * changed.bytesDepth();
+
+        for (int i = 0 ; i < rect.width() * changed.bytesDepth() ; ++i)
+        {
+            line[i] = 255 - line[i];
+        }
+    }
+
+    histogram.updateRegion(changed, region);
+    QVERIFY(histogram.isValid());
+
+    ImageHistogram expected(changed);
+    expected.calculate();
+
+    for (int channel = LuminosityChannel ; channel < ColorChannels ; ++channel)
+    {
+        for (int bin = 0 ; bin < histogram.getHistogramSegments() ; ++bin)
+        {
+            if (histogram.getValue(channel, bin) != expected.getValue(channel, bin))
+            {
+                QFAIL(qPrintable(QString::fromLatin1("Channel %1, bin %2: %3 instead of %4")
+                                 .arg(channel).arg(bin)
+                                 .arg(histogram.getValue(channel, bin))
+                                 .arg(expected.getValue(channel, bin))));
+            }
+        }
+    }
+}
@@ -0,0 +1,151 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-03-28
+ * Description : a test for the smooth scale kernels and threads
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "dimgscaletest.h"
+
+// Qt includes
+
+#include <QByteArray>
+#include <QRect>
+#include <QSize>
+#include <QString>
+#include <QTest>
+
+// Local includes
+
+#include "dimg.h"
+#include "dimgscalekernels.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(DImgScaleTest)
+
+static DImg randomImage(int width, int height, bool sixteenBit, bool alpha)
+{
+    DImg img(width, height, sixteenBit, alpha);
+    uchar* const data = img.bits();
+
+    qsrand(width * height);
+
+    for (quint64 i = 0 ; i < img.numBytes() ; ++i)
+    {
+        data[i] = qrand() & 0xFF;
+    }
+
+    return img;
+}
+
+static QByteArray imageData(const DImg& img)
+{
+    return QByteArray((const char*)img.bits(), img.numBytes());
+}
+
+void DImgScaleTest::cleanupTestCase()
+{
+    DImgScaleKernels::setMaximumInstructions(DImgScaleKernels::AVX2);
+    DImg::setProcessingThreads(0);
+}
+
+void DImgScaleTest::testSmoothScale_data()
+{
+    QTest::addColumn<bool>("sixteenBit");
+    QTest::addColumn<bool>("alpha");
+    QTest::addColumn<QSize>("sourceSize");
+    QTest::addColumn<QSize>("destSize");
+
+    for (int depth = 0 ; depth < 2 ; ++depth)
+    {
+        for (int alpha = 0 ; alpha < 2 ; ++alpha)
+        {
+            const QString name = QString::fromLatin1("%1 bits%2").arg(depth ? 16 : 8)
+                                                                 .arg(alpha ? QLatin1String(" alpha") : QLatin1String(""));
+
+            QTest::newRow(qPrintable(name + QLatin1String(" thumbnail")))
+                    << (bool)depth << (bool)alpha << QSize(1201, 803) << QSize(256, 171);
+
+            QTest::newRow(qPrintable(name + QLatin1String(" odd ratio")))
+                    << (bool)depth << (bool)alpha << QSize(333, 517) << QSize(331, 13);
+
+            QTest::newRow(qPrintable(name + QLatin1String(" huge ratio")))
+                    << (bool)depth << (bool)alpha << QSize(2000, 1500) << QSize(3, 2);
+        }
+    }
+}
+
+void DImgScaleTest::testSmoothScale()
+{
+    QFETCH(bool,  sixteenBit);
+    QFETCH(bool,  alpha);
+    QFETCH(QSize, sourceSize);
+    QFETCH(QSize, destSize);
+
+    const DImg img  = randomImage(sourceSize.width(), sourceSize.height(), sixteenBit, alpha);
+    const QRect clip(destSize.width() / 3, destSize.height() / 4, destSize.width() / 2, destSize.height() / 2);
+
+    // The scalar kernels are the reference.
+
+    DImgScaleKernels::setMaximumInstructions(DImgScaleKernels::Scalar);
+    const QByteArray scaled  = imageData(img.smoothScale(destSize));
+    const QByteArray clipped = imageData(img.smoothScaleClipped(destSize, clip));
+
+    QCOMPARE(scaled.size(), destSize.width() * destSize.height() * (sixteenBit ? 8 : 4));
+
+    const DImgScaleKernels::Instructions instructions[] = { DImgScaleKernels::SSE2, DImgScaleKernels::AVX2 };
+
+    for (uint i = 0 ; i < sizeof(instructions) / sizeof(instructions[0]) ; ++i)
+    {
+        if (DImgScaleKernels::kernels(instructions[i]).instructions != instructions[i])
+        {
+            // The instruction sets are ordered, the next ones are not supported either.
+            QSKIP(qPrintable(QString::fromLatin1("%1 is not supported by this CPU")
+                             .arg(DImgScaleKernels::instructionsName(instructions[i]))));
+        }
+
+        DImgScaleKernels::setMaximumInstructions(instructions[i]);
+
+        QVERIFY2(imageData(img.smoothScale(destSize)) == scaled,
+                 qPrintable(DImgScaleKernels::instructionsName(instructions[i])));
+
+        QVERIFY2(imageData(img.smoothScaleClipped(destSize, clip)) == clipped,
+                 qPrintable(DImgScaleKernels::instructionsName(instructions[i])));
+    }
+}
+
+void DImgScaleTest::testSmoothScaleProcessingThreads()
+{
+    const DImg img  = randomImage(2401, 1603, true, false);
+    const QSize destSize(1199, 797);
+    const QRect clip(101, 53, 640, 480);
+
+    DImg::setProcessingThreads(1);
+    const QByteArray scaled  = imageData(img.smoothScale(destSize));
+    const QByteArray clipped = imageData(img.smoothScaleClipped(destSize, clip));
+    const QByteArray section = imageData(img.smoothScaleSection(QRect(300, 200, 1500, 1000), destSize));
+
+    // The bands of rows scaled in parallel give the same result.
+
+    DImg::setProcessingThreads(7);
+    QVERIFY(imageData(img.smoothScale(destSize)) == scaled);
+    QVERIFY(imageData(img.smoothScaleClipped(destSize, clip)) == clipped);
+    QVERIFY(imageData(img.smoothScaleSection(QRect(300, 200, 1500, 1000), destSize)) == section);
+}
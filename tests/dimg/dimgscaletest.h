@@ -0,0 +1,45 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-03-28
+ * Description : a test for the smooth scale kernels and threads
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIMGSCALETEST_H
+#define DIMGSCALETEST_H
+
+// Qt includes
+
+#include <QObject>
+
+class DImgScaleTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void cleanupTestCase();
+
+    void testSmoothScale();
+    void testSmoothScale_data();
+
+    void testSmoothScaleProcessingThreads();
+};
+
+#endif /* DIMGSCALETEST_H */
@@ -0,0 +1,158 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-04-08
+ * Description : a test for the face detection on shared image pyramids
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "facedetectiontest.h"
+
+// Qt includes
+
+#include <QDebug>
+#include <QDir>
+#include <QImage>
+#include <QList>
+#include <QRect>
+#include <QTest>
+
+// Local includes
+
+#include "libopencv.h"
+#include "opencvfacedetector.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(FaceDetectionTest)
+
+/**
+ * Returns true if both rectangles cover nearly the same area: the detections on the
+ * pyramid only differ from the ones on the regions by the rounding of their position.
+ */
+static bool sameFace(const QRect& a, const QRect& b)
+{
+    const QRect common      = a & b;
+    const double commonArea = (double)common.width() * common.height();
+    const double unionArea  = (double)a.width() * a.height() + (double)b.width() * b.height() - commonArea;
+
+    return (unionArea > 0 && commonArea / unionArea >= 0.8);
+}
+
+void FaceDetectionTest::initTestCase()
+{
+#if OPENCV_TEST_VERSION(3,0,0)
+    cascadeDirs << QFINDTESTDATA("../../data/facesengine/opencv2/");
+#else
+    cascadeDirs << QFINDTESTDATA("../../data/facesengine/opencv3/");
+#endif
+
+    imagesDir = QFINDTESTDATA("data/");
+
+    QVERIFY(!cascadeDirs.first().isEmpty());
+    QVERIFY(!imagesDir.isEmpty());
+}
+
+void FaceDetectionTest::testPyramidsMatchRegions_data()
+{
+    QTest::addColumn<QString>("file");
+    QTest::addColumn<double>("accuracy");
+
+    // The accuracy sets the search increment: 1.1, 1.3 and 1.5.
+
+    foreach (const QString& file, QDir(imagesDir).entryList(QStringList() << QLatin1String("*.jpg"), QDir::Files))
+    {
+        QTest::newRow(qPrintable(file + QLatin1String(", accurate"))) << file << 0.8;
+        QTest::newRow(qPrintable(file + QLatin1String(", medium")))   << file << 0.4;
+        QTest::newRow(qPrintable(file + QLatin1String(", fast")))     << file << 0.1;
+    }
+}
+
+void FaceDetectionTest::testPyramidsMatchRegions()
+{
+    QFETCH(QString, file);
+    QFETCH(double, accuracy);
+
+    QImage image(imagesDir + file);
+    QVERIFY(!image.isNull());
+
+    // The reference is the detection with detectMultiScale() on each searched region.
+
+    OpenCVFaceDetector regionDetector(cascadeDirs);
+    regionDetector.setAccuracy(accuracy);
+    regionDetector.setUsePyramids(false);
+
+    OpenCVFaceDetector pyramidDetector(cascadeDirs);
+    pyramidDetector.setAccuracy(accuracy);
+
+    const cv::Mat cvImage       = regionDetector.prepareForDetection(image);
+    const cv::Size originalSize = cv::Size(image.width(), image.height());
+    const QList<QRect> expected = regionDetector.detectFaces(cvImage, originalSize);
+    const QList<QRect> faces    = pyramidDetector.detectFaces(cvImage, originalSize);
+
+    qDebug() << file << "faces on regions:" << expected << "faces on pyramid:" << faces;
+
+    QCOMPARE(faces.size(), expected.size());
+
+    foreach (const QRect& face, faces)
+    {
+        bool found = false;
+
+        foreach (const QRect& other, expected)
+        {
+            if (sameFace(face, other))
+            {
+                found = true;
+                break;
+            }
+        }
+
+        QVERIFY2(found, qPrintable(QString::fromLatin1("Face (%1, %2) %3x%4 not detected on the regions")
+                                   .arg(face.x()).arg(face.y()).arg(face.width()).arg(face.height())));
+    }
+}
+
+void FaceDetectionTest::testBatchMatchesSingleImages()
+{
+    OpenCVFaceDetector detector(cascadeDirs);
+
+    std::vector<cv::Mat>  images;
+    std::vector<cv::Size> originalSizes;
+
+    foreach (const QString& file, QDir(imagesDir).entryList(QStringList() << QLatin1String("*.jpg"), QDir::Files))
+    {
+        QImage image(imagesDir + file);
+        QVERIFY(!image.isNull());
+
+        images.push_back(detector.prepareForDetection(image));
+        originalSizes.push_back(cv::Size(image.width(), image.height()));
+    }
+
+    // An empty image in the batch gives an empty list.
+    images.push_back(cv::Mat());
+    originalSizes.push_back(cv::Size(0, 0));
+
+    const QList<QList<QRect> > batch = detector.detectFaces(images, originalSizes);
+
+    QCOMPARE(batch.size(), (int)images.size());
+
+    for (size_t i = 0 ; i < images.size() ; ++i)
+    {
+        QCOMPARE(batch.at(i), detector.detectFaces(images[i], originalSizes[i]));
+    }
+}
@@ -0,0 +1,50 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-04-08
+ * Description : a test for the face detection on shared image pyramids
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef FACEDETECTIONTEST_H
+#define FACEDETECTIONTEST_H
+
+// Qt includes
+
+#include <QObject>
+#include <QStringList>
+
+class FaceDetectionTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void initTestCase();
+
+    void testPyramidsMatchRegions();
+    void testPyramidsMatchRegions_data();
+    void testBatchMatchesSingleImages();
+
+private:
+
+    QStringList cascadeDirs;
+    QString     imagesDir;
+};
+
+#endif /* FACEDETECTIONTEST_H */
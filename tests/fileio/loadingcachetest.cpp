@@ -0,0 +1,253 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-03-14
+ * Description : a test for the byte budget and the eviction order of the loading cache
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "loadingcachetest.h"
+
+// Qt includes
+
+#include <QImage>
+#include <QSet>
+#include <QStringList>
+#include <QTest>
+
+// Local includes
+
+#include "loadingcache.h"
+#include "thumbnailsize.h"
+
+using namespace Digikam;
+
+QTEST_MAIN(LoadingCacheTest)
+
+/// The cost of a thumbnail image of the maximum size: the budget is counted in these units.
+static qint64 unit()
+{
+    return (qint64)ThumbnailSize::maxThumbsSize() * ThumbnailSize::maxThumbsSize() * 4;
+}
+
+/// Puts a thumbnail image costing units budget units, with its key as file path
+static void put(LoadingCache* const cache, const QString& key, int units = 1)
+{
+    const int side = ThumbnailSize::maxThumbsSize();
+    cache->putThumbnail(key, QImage(side, side * units, QImage::Format_ARGB32), key);
+}
+
+/// Returns the keys in the cache, without counting it as use as retrieveThumbnail() does
+static QSet<QString> cachedKeys(LoadingCache* const cache)
+{
+    return cache->thumbnailFilePathsInCache().toSet();
+}
+
+static QSet<QString> keys(const QString& list)
+{
+    return list.split(QLatin1Char(' ')).toSet();
+}
+
+void LoadingCacheTest::init()
+{
+    LoadingCache* const cache = LoadingCache::cache();
+    LoadingCache::CacheLock lock(cache);
+
+    // A budget of four thumbnail images: no image, no pixmap.
+
+    cache->removeImages();
+    cache->removeThumbnails();
+    cache->setCacheSize(0);
+    cache->setThumbnailCacheSize(4, 0);
+    cache->resetStatistics();
+}
+
+void LoadingCacheTest::cleanupTestCase()
+{
+    LoadingCache::cleanUp();
+}
+
+void LoadingCacheTest::testByteBudget()
+{
+    LoadingCache* const cache = LoadingCache::cache();
+    LoadingCache::CacheLock lock(cache);
+
+    QCOMPARE(cache->statistics().budgetBytes, 4 * unit());
+
+    put(cache, QLatin1String("budget1"));
+    put(cache, QLatin1String("budget2"));
+    put(cache, QLatin1String("budget3"));
+    put(cache, QLatin1String("budget4"));
+
+    LoadingCacheStatistics stats = cache->statistics();
+    QCOMPARE(stats.usedBytes,  4 * unit());
+    QCOMPARE(stats.entries,    4);
+    QCOMPARE(stats.evictions,  (qint64)0);
+
+    // The budget is full: the least recently used entry makes room.
+
+    put(cache, QLatin1String("budget5"));
+
+    stats = cache->statistics();
+    QCOMPARE(stats.usedBytes,  4 * unit());
+    QCOMPARE(stats.entries,    4);
+    QCOMPARE(stats.evictions,  (qint64)1);
+    QCOMPARE(cachedKeys(cache), keys(QLatin1String("budget2 budget3 budget4 budget5")));
+
+    // An entry larger than the budget is never stored.
+
+    put(cache, QLatin1String("budgetLarge"), 5);
+
+    stats = cache->statistics();
+    QCOMPARE(stats.rejections, (qint64)1);
+    QCOMPARE(stats.usedBytes,  4 * unit());
+    QVERIFY(!cachedKeys(cache).contains(QLatin1String("budgetLarge")));
+}
+
+void LoadingCacheTest::testEvictionOrder()
+{
+    LoadingCache* const cache = LoadingCache::cache();
+    LoadingCache::CacheLock lock(cache);
+
+    put(cache, QLatin1String("order1"));
+    put(cache, QLatin1String("order2"));
+    put(cache, QLatin1String("order3"));
+    put(cache, QLatin1String("order4"));
+
+    // Used again: order1 and order3 move to the protected segment.
+
+    QVERIFY(cache->retrieveThumbnail(QLatin1String("order1")));
+    QVERIFY(cache->retrieveThumbnail(QLatin1String("order3")));
+    QVERIFY(!cache->retrieveThumbnail(QLatin1String("order5")));
+
+    LoadingCacheStatistics stats = cache->statistics();
+    QCOMPARE(stats.hits,           (qint64)2);
+    QCOMPARE(stats.misses,         (qint64)1);
+    QCOMPARE(stats.protectedBytes, 2 * unit());
+
+    // A sweep of new entries evicts the probation entries, least recently used first,
+    // and then its own entries, but never the protected ones.
+
+    put(cache, QLatin1String("order5"));
+    QCOMPARE(cachedKeys(cache), keys(QLatin1String("order1 order3 order4 order5")));
+
+    put(cache, QLatin1String("order6"));
+    QCOMPARE(cachedKeys(cache), keys(QLatin1String("order1 order3 order5 order6")));
+
+    put(cache, QLatin1String("order7"));
+    put(cache, QLatin1String("order8"));
+    QCOMPARE(cachedKeys(cache), keys(QLatin1String("order1 order3 order7 order8")));
+
+    stats = cache->statistics();
+    QCOMPARE(stats.evictions,      (qint64)4);
+    QCOMPARE(stats.usedBytes,      4 * unit());
+    QCOMPARE(stats.protectedBytes, 2 * unit());
+}
+
+void LoadingCacheTest::testAdmission()
+{
+    LoadingCache* const cache = LoadingCache::cache();
+    LoadingCache::CacheLock lock(cache);
+
+    put(cache, QLatin1String("admission1"));
+    put(cache, QLatin1String("admission2"));
+    put(cache, QLatin1String("admission3"));
+    put(cache, QLatin1String("admission4"));
+
+    QVERIFY(cache->retrieveThumbnail(QLatin1String("admission1")));
+    QVERIFY(cache->retrieveThumbnail(QLatin1String("admission2")));
+    QVERIFY(cache->retrieveThumbnail(QLatin1String("admission3")));
+
+    // Storing a new entry of two units would evict a protected entry: it is refused.
+
+    put(cache, QLatin1String("admissionLarge"), 2);
+
+    LoadingCacheStatistics stats = cache->statistics();
+    QCOMPARE(stats.rejections, (qint64)1);
+    QCOMPARE(stats.evictions,  (qint64)0);
+    QCOMPARE(cachedKeys(cache), keys(QLatin1String("admission1 admission2 admission3 admission4")));
+
+    // Put again, it has proven reuse and is admitted as protected entry. The least recently
+    // used protected entries go back to probation, and the probation entries are evicted first.
+
+    put(cache, QLatin1String("admissionLarge"), 2);
+
+    stats = cache->statistics();
+    QCOMPARE(stats.rejections, (qint64)1);
+    QCOMPARE(stats.evictions,  (qint64)2);
+    QCOMPARE(stats.usedBytes,  4 * unit());
+    QVERIFY(stats.protectedBytes <= stats.budgetBytes * 4 / 5);
+    QCOMPARE(cachedKeys(cache), keys(QLatin1String("admission2 admission3 admissionLarge")));
+}
+
+void LoadingCacheTest::testGhostRequeued()
+{
+    LoadingCache* const cache = LoadingCache::cache();
+    LoadingCache::CacheLock lock(cache);
+    const QString ghost       = QLatin1String("ghostKey");
+
+    // Evict enough entries to fill the queue of remembered keys (256 keys for a small cache).
+
+    for (int i = 0 ; i < 260 ; ++i)
+    {
+        put(cache, QLatin1String("ghostFill") + QString::number(i));
+    }
+
+    // The key is evicted, admitted again as proven reuse, and evicted a second time.
+
+    put(cache, ghost);
+
+    for (int i = 0 ; i < 4 ; ++i)
+    {
+        put(cache, QLatin1String("ghostSweep") + QString::number(i));
+    }
+
+    QVERIFY(!cachedKeys(cache).contains(ghost));
+
+    put(cache, ghost);
+    QCOMPARE(cache->statistics().protectedBytes, unit());
+
+    for (int i = 0 ; i < 8 ; ++i)
+    {
+        put(cache, QLatin1String("ghostMid") + QString::number(i));
+    }
+
+    // Promoting three entries moves the key back to probation, the next entry evicts it.
+
+    QVERIFY(cache->retrieveThumbnail(QLatin1String("ghostMid5")));
+    QVERIFY(cache->retrieveThumbnail(QLatin1String("ghostMid6")));
+    QVERIFY(cache->retrieveThumbnail(QLatin1String("ghostMid7")));
+
+    put(cache, QLatin1String("ghostLast"));
+    QVERIFY(!cachedKeys(cache).contains(ghost));
+
+    // Fewer evictions than the queue holds: the key is still remembered, not dropped
+    // at the position of its first eviction, and is admitted although it is too large.
+
+    for (int i = 0 ; i < 250 ; ++i)
+    {
+        put(cache, QLatin1String("ghostAfter") + QString::number(i));
+    }
+
+    const qint64 rejections = cache->statistics().rejections;
+
+    put(cache, ghost, 2);
+
+    QCOMPARE(cache->statistics().rejections, rejections);
+    QVERIFY(cachedKeys(cache).contains(ghost));
+}
@@ -0,0 +1,46 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-03-14
+ * Description : a test for the byte budget and the eviction order of the loading cache
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef LOADINGCACHETEST_H
+#define LOADINGCACHETEST_H
+
+// Qt includes
+
+#include <QObject>
+
+class LoadingCacheTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void init();
+    void cleanupTestCase();
+
+    void testByteBudget();
+    void testEvictionOrder();
+    void testAdmission();
+    void testGhostRequeued();
+};
+
+#endif /* LOADINGCACHETEST_H */
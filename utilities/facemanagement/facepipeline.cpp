@@ -154,7 +154,6 @@ FacePipelineExtendedPackage::Ptr PackageLoadingDescriptionList::take(const Loadi
 // ----------------------------------------------------------------------------------------
 
 ParallelPipes::ParallelPipes()
-    : m_currentIndex(0)
 {
 }
 
@@ -180,6 +179,12 @@ void ParallelPipes::deactivate(WorkerObject::DeactivatingMode mode)
     {
         object->deactivate(mode);
     }
+
+    // Waiting packages are dropped
+    for (int i = 0 ; i < m_pending.size() ; ++i)
+    {
+        m_pending[i] = 0;
+    }
 }
 
 void ParallelPipes::wait()
@@ -211,21 +216,44 @@ void ParallelPipes::add(WorkerObject* const worker)
 
     m_workers << worker;
     m_methods << worker->metaObject()->method(methodIndex);
+    m_pending << 0;
 
     // collect the worker's signals and bundle them to our single signal, which is further connected
     connect(worker, SIGNAL(processed(FacePipelineExtendedPackage::Ptr)),
             this, SIGNAL(processed(FacePipelineExtendedPackage::Ptr)));
+
+    connect(worker, SIGNAL(processed(FacePipelineExtendedPackage::Ptr)),
+            this, SLOT(slotWorkerProcessed()));
 }
 
 void ParallelPipes::process(FacePipelineExtendedPackage::Ptr package)
 {
-    // Here, we send the package to one of the workers, in turn
-    m_methods.at(m_currentIndex).invoke(m_workers.at(m_currentIndex), Qt::QueuedConnection,
-                                        Q_ARG(FacePipelineExtendedPackage::Ptr, package));
+    // Here, we send the package to the worker with the fewest packages sent and not yet processed.
+    // Images take very different times to process: sending packages in turn would queue
+    // new packages behind a slow image while other workers are idle.
+    int index = 0;
+
+    for (int i = 1 ; i < m_workers.size() ; ++i)
+    {
+        if (m_pending.at(i) < m_pending.at(index))
+        {
+            index = i;
+        }
+    }
+
+    ++m_pending[index];
+
+    m_methods.at(index).invoke(m_workers.at(index), Qt::QueuedConnection,
+                               Q_ARG(FacePipelineExtendedPackage::Ptr, package));
+}
+
+void ParallelPipes::slotWorkerProcessed()
+{
+    const int index = m_workers.indexOf(static_cast<WorkerObject*>(sender()));
 
-    if (++m_currentIndex == m_workers.size())
+    if (index != -1 && m_pending.at(index) > 0)
     {
-        m_currentIndex = 0;
+        --m_pending[index];
     }
 }
 
@@ -483,15 +511,62 @@ DetectionWorker::DetectionWorker(FacePipeline::Private* const d)
 
 void DetectionWorker::process(FacePipelineExtendedPackage::Ptr package)
 {
-    QImage detectionImage  = scaleForDetection(package->image);
-    package->detectedFaces = detector.detectFaces(detectionImage, package->image.originalSize());
+    // The packages queued for this worker while it detected faces are collected here,
+    // and detected as one batch by the first processBatch() call queued after them.
+    QMutexLocker lock(&batchMutex);
+    batch << package;
 
-    qCDebug(DIGIKAM_GENERAL_LOG) << "Found" << package->detectedFaces.size() << "faces in" << package->info.name()
-                                 << package->image.size() << package->image.originalSize();
+    QMetaObject::invokeMethod(this, "processBatch", Qt::QueuedConnection);
+}
 
-    package->processFlags |= FacePipelinePackage::ProcessedByDetector;
+void DetectionWorker::processBatch()
+{
+    QList<FacePipelineExtendedPackage::Ptr> packages;
 
-    emit processed(package);
+    {
+        // The pyramids of a batch are built in parallel, one image per thread.
+        const int maxBatchSize = qMax(1, QThread::idealThreadCount());
+
+        QMutexLocker lock(&batchMutex);
+        packages = batch.mid(0, maxBatchSize);
+        batch    = batch.mid(maxBatchSize);
+    }
+
+    if (packages.isEmpty())
+    {
+        return;
+    }
+
+    QList<QImage> detectionImages;
+    QList<QSize>  originalSizes;
+
+    foreach (const FacePipelineExtendedPackage::Ptr& package, packages)
+    {
+        detectionImages << scaleForDetection(package->image);
+        originalSizes   << package->image.originalSize();
+    }
+
+    QList<QList<QRectF> > detectedFaces = detector.detectFaces(detectionImages, originalSizes);
+
+    for (int i = 0 ; i < packages.size() ; ++i)
+    {
+        FacePipelineExtendedPackage::Ptr package = packages.at(i);
+        package->detectedFaces                   = detectedFaces.at(i);
+
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Found" << package->detectedFaces.size() << "faces in" << package->info.name()
+                                     << package->image.size() << package->image.originalSize();
+
+        package->processFlags |= FacePipelinePackage::ProcessedByDetector;
+
+        emit processed(package);
+    }
+}
+
+void DetectionWorker::aboutToDeactivate()
+{
+    // The pipeline deactivates its workers flushing their queued packages: drop the collected ones too.
+    QMutexLocker lock(&batchMutex);
+    batch.clear();
 }
 
 QImage DetectionWorker::scaleForDetection(const DImg& image) const
@@ -105,10 +105,16 @@ Q_SIGNALS:
 
     void processed(FacePipelineExtendedPackage::Ptr package);
 
+protected Q_SLOTS:
+
+    void slotWorkerProcessed();
+
 protected:
 
     QList<QMetaMethod> m_methods;
-    int                m_currentIndex;
+
+    /// Packages sent to each worker and not yet processed
+    QList<int>         m_pending;
 };
 
 // ----------------------------------------------------------------------------------------
@@ -206,10 +212,24 @@ Q_SIGNALS:
 
     void processed(FacePipelineExtendedPackage::Ptr package);
 
+protected Q_SLOTS:
+
+    /// Detects the faces of the packages received and not yet processed, as one batch
+    void processBatch();
+
 protected:
 
-    FaceDetector     detector;
-    FacePipeline::Private* const d;
+    virtual void aboutToDeactivate();
+
+protected:
+
+    FaceDetector                            detector;
+
+    /// Packages received and not yet processed
+    QList<FacePipelineExtendedPackage::Ptr> batch;
+    QMutex                                  batchMutex;
+
+    FacePipeline::Private* const            d;
 };
 
 // ----------------------------------------------------------------------------------------
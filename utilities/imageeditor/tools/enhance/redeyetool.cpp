@@ -77,6 +77,10 @@ public:
     RedEyeCorrectionSettings* settingsView;
     ImageRegionWidget*        previewWidget;
     EditorToolSettings*       gboxSettings;
+
+    /// The region of the original image of the last preview, and the eyes corrected in it.
+    QRect                     previewRegion;
+    QRect                     previewCorrectedArea;
 };
 
 const QString RedEyeTool::Private::configGroupName(QLatin1String("redeye Tool"));
@@ -164,12 +168,28 @@ void RedEyeTool::preparePreview()
 
 void RedEyeTool::setPreviewImage()
 {
-    DImg preview = filter()->getTargetImage().copy(d->previewWidget->getOriginalImageRegionToRender());
+    QRect region = d->previewWidget->getOriginalImageRegionToRender();
+    DImg preview = filter()->getTargetImage().copy(region);
     d->previewWidget->setPreviewImage(preview);
 
-    // Update histogram.
+    // Update histogram. If the same region is previewed again, only the pixels
+    // of the eyes corrected before and now differ from the previous preview.
+
+    RedEyeCorrectionFilter* const redEyeFilter = dynamic_cast<RedEyeCorrectionFilter*>(filter());
+    QRect correctedArea                        = redEyeFilter ? redEyeFilter->correctedArea() : region;
+
+    if (region == d->previewRegion)
+    {
+        QRect changedArea = (d->previewCorrectedArea | correctedArea).translated(-region.topLeft());
+        d->gboxSettings->histogramBox()->histogram()->updateRegion(preview.copy(), changedArea, false);
+    }
+    else
+    {
+        d->gboxSettings->histogramBox()->histogram()->updateData(preview.copy(), DImg(), false);
+    }
 
-    d->gboxSettings->histogramBox()->histogram()->updateData(preview.copy(), DImg(), false);
+    d->previewRegion        = region;
+    d->previewCorrectedArea = correctedArea;
 }
 
 void RedEyeTool::prepareFinal()
@@ -94,9 +94,10 @@ void ImagePreviewItem::paint(QPainter* painter, const QStyleOptionGraphicsItem*
 
     // scale "as if" scaling to whole image, but clip output to our exposed region
     QSize scaledCompleteSize = QSizeF(ratio*completeSize.width(), ratio*completeSize.height()).toSize();
-    DImg scaledImage   = d->image.smoothScaleClipped(scaledCompleteSize.width(), scaledCompleteSize.height(),
-                                                     scaledDrawRect.x(), scaledDrawRect.y(),
-                                                     scaledDrawRect.width(), scaledDrawRect.height());
+    const DImg& source = d->displayImage(scaledCompleteSize);
+    DImg scaledImage   = source.smoothScaleClipped(scaledCompleteSize.width(), scaledCompleteSize.height(),
+                                                   scaledDrawRect.x(), scaledDrawRect.y(),
+                                                   scaledDrawRect.width(), scaledDrawRect.height());
 
     if (d->cachedPixmaps.find(scaledDrawRect, &pix, &pixSourceRect))
     {
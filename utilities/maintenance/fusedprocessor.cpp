@@ -0,0 +1,303 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-03-20
+ * Description : maintenance tool generating thumbnails, finger-prints,
+ *               quality labels and faces with one decoding per item.
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "fusedprocessor.h"
+
+// Qt includes
+
+#include <QIcon>
+#include <QImage>
+#include <QPixmap>
+#include <QSemaphore>
+#include <QSet>
+#include <QThread>
+
+// KDE includes
+
+#include <kconfiggroup.h>
+#include <ksharedconfig.h>
+#include <klocalizedstring.h>
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "coredb.h"
+#include "coredbaccess.h"
+#include "albummanager.h"
+#include "tagscache.h"
+#include "thumbsdbaccess.h"
+#include "thumbsdb.h"
+#include "facepipeline.h"
+#include "fusedtask.h"
+#include "maintenancethread.h"
+
+namespace Digikam
+{
+
+class FusedProcessor::Private
+{
+public:
+
+    Private() :
+        faceSlots(0),
+        threadCompleted(false),
+        thread(0)
+    {
+    }
+
+    MaintenanceSettings settings;
+
+    QStringList         allPicturesPath;
+    FusedTaskSettings   taskSettings;
+
+    FacePipeline        pipeline;
+    QSemaphore          faceSlots;
+    bool                threadCompleted;
+
+    MaintenanceThread*  thread;
+};
+
+FusedProcessor::FusedProcessor(const MaintenanceSettings& settings, ProgressItem* const parent)
+    : MaintenanceTool(QLatin1String("FusedProcessor"), parent),
+      d(new Private)
+{
+    setLabel(i18n("Thumbs, Finger-prints, Quality and Faces"));
+    ProgressManager::addProgressItem(this);
+
+    d->settings = settings;
+    d->thread   = new MaintenanceThread(this);
+
+    if (d->settings.faceManagement && canProcessFaces(d->settings))
+    {
+        // Images are passed with the packages: no database filter and no preview loader
+        d->pipeline.plugFaceDetector();
+
+        if (d->settings.faceSettings.task == FaceScanSettings::DetectAndRecognize)
+        {
+            d->pipeline.plugFaceRecognizer();
+        }
+
+        d->pipeline.plugDatabaseWriter(d->settings.faceSettings.alreadyScannedHandling == FaceScanSettings::Rescan ?
+                                       FacePipeline::OverwriteUnconfirmed : FacePipeline::NormalWrite);
+        d->pipeline.setDetectionAccuracy(d->settings.faceSettings.accuracy);
+        d->pipeline.construct();
+
+        connect(&d->pipeline, SIGNAL(processed(FacePipelinePackage)),
+                this, SLOT(slotFaceProcessed(FacePipelinePackage)));
+
+        connect(&d->pipeline, SIGNAL(finished()),
+                this, SLOT(slotDone()));
+    }
+
+    connect(d->thread, SIGNAL(signalCompleted()),
+            this, SLOT(slotThreadCompleted()));
+
+    connect(d->thread, SIGNAL(signalAdvance(QImage)),
+            this, SLOT(slotAdvance(QImage)));
+
+    connect(d->thread, SIGNAL(signalFaceImage(ImageInfo,DImg)),
+            this, SLOT(slotFaceImage(ImageInfo,DImg)));
+}
+
+FusedProcessor::~FusedProcessor()
+{
+    delete d;
+}
+
+bool FusedProcessor::canProcessFaces(const MaintenanceSettings& settings)
+{
+    // Only these tasks decode the images, the others work on stored face regions
+    return (settings.faceSettings.task == FaceScanSettings::Detect ||
+            settings.faceSettings.task == FaceScanSettings::DetectAndRecognize);
+}
+
+void FusedProcessor::setUseMultiCoreCPU(bool b)
+{
+    d->thread->setUseMultiCore(b);
+}
+
+void FusedProcessor::slotCancel()
+{
+    d->thread->cancel();
+    d->pipeline.cancel();
+    MaintenanceTool::slotCancel();
+}
+
+void FusedProcessor::slotStart()
+{
+    MaintenanceTool::slotStart();
+
+    AlbumList albumList;
+    albumList << d->settings.albums;
+    albumList << d->settings.tags;
+
+    if (albumList.isEmpty())
+    {
+        albumList = AlbumManager::instance()->allPAlbums();
+    }
+
+    // Items which need each stage, in the same way as the separate tools select them.
+
+    const bool thumbs    = d->settings.thumbnails;
+    const bool prints    = d->settings.fingerPrints;
+    const bool quality   = d->settings.qualitySort && d->settings.quality.enableSorter;
+    const bool faces     = d->settings.faceManagement && canProcessFaces(d->settings);
+
+    QSet<QString> existingThumbs;
+    QSet<QString> dirtyPrints;
+    QSet<QString> noPickLabel;
+
+    if (thumbs && d->settings.scanThumbs)
+    {
+        existingThumbs = ThumbsDbAccess().db()->getFilePathsWithThumbnail().keys().toSet();
+    }
+
+    if (prints && d->settings.scanFingerPrints)
+    {
+        dirtyPrints = CoreDbAccess().db()->getDirtyOrMissingFingerprintURLs().toSet();
+    }
+
+    if (quality && d->settings.qualityScanMode == ImageQualitySorter::NonAssignedItems)
+    {
+        noPickLabel = CoreDbAccess().db()->getItemsURLsWithTag(TagsCache::instance()->tagForPickLabel(NoPickLabel)).toSet();
+    }
+
+    for (AlbumList::const_iterator it = albumList.constBegin();
+         !canceled() && (it != albumList.constEnd()); ++it)
+    {
+        if (!(*it))
+        {
+            continue;
+        }
+
+        QStringList aPaths;
+
+        if ((*it)->type() == Album::PHYSICAL)
+        {
+            aPaths = CoreDbAccess().db()->getItemURLsInAlbum((*it)->id());
+        }
+        else if ((*it)->type() == Album::TAG)
+        {
+            aPaths = CoreDbAccess().db()->getItemURLsInTag((*it)->id());
+        }
+
+        foreach(const QString& path, aPaths)
+        {
+            if (d->taskSettings.stages.contains(path))
+            {
+                continue;
+            }
+
+            int stages = 0;
+
+            if (thumbs && !existingThumbs.contains(path))
+            {
+                stages |= FusedTaskSettings::Thumbnails;
+            }
+
+            if (prints && (!d->settings.scanFingerPrints || dirtyPrints.contains(path)))
+            {
+                stages |= FusedTaskSettings::FingerPrints;
+            }
+
+            if (quality && (d->settings.qualityScanMode != ImageQualitySorter::NonAssignedItems || noPickLabel.contains(path)))
+            {
+                stages |= FusedTaskSettings::ImageQuality;
+            }
+
+            if (faces)
+            {
+                stages |= FusedTaskSettings::Faces;
+            }
+
+            if (stages)
+            {
+                d->taskSettings.stages.insert(path, stages);
+                d->allPicturesPath << path;
+            }
+        }
+    }
+
+    if (d->allPicturesPath.isEmpty())
+    {
+        MaintenanceTool::slotDone();
+        return;
+    }
+
+    // Two decoded images per face detection thread may wait in the pipeline
+    d->faceSlots.release(2 * QThread::idealThreadCount());
+
+    d->taskSettings.quality     = d->settings.quality;
+    d->taskSettings.rescanFaces = (d->settings.faceSettings.alreadyScannedHandling != FaceScanSettings::Skip);
+    d->taskSettings.faceSlots   = &d->faceSlots;
+
+    setTotalItems(d->allPicturesPath.count());
+
+    d->thread->processFused(d->allPicturesPath, d->taskSettings);
+    d->thread->start();
+}
+
+void FusedProcessor::slotAdvance(const QImage& img)
+{
+    setThumbnail(QIcon(QPixmap::fromImage(img)));
+    advance(1);
+}
+
+void FusedProcessor::slotFaceImage(const ImageInfo& info, const DImg& image)
+{
+    if (canceled() || !d->pipeline.process(info, image))
+    {
+        d->faceSlots.release();
+    }
+}
+
+void FusedProcessor::slotFaceProcessed(const FacePipelinePackage&)
+{
+    d->faceSlots.release();
+}
+
+void FusedProcessor::slotThreadCompleted()
+{
+    d->threadCompleted = true;
+    slotDone();
+}
+
+void FusedProcessor::slotDone()
+{
+    // We get here when the thread or the face pipeline has finished, we want both to have finished
+    if (!d->threadCompleted || !d->pipeline.hasFinished())
+    {
+        return;
+    }
+
+    if (d->settings.fingerPrints)
+    {
+        // Switch on scanned for finger-prints flag on digiKam config file.
+        KSharedConfig::openConfig()->group(QLatin1String("General Settings")).writeEntry(QLatin1String("Finger Prints Generator First Run"), true);
+    }
+
+    MaintenanceTool::slotDone();
+}
+
+}  // namespace Digikam
@@ -0,0 +1,83 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-03-20
+ * Description : maintenance tool generating thumbnails, finger-prints,
+ *               quality labels and faces with one decoding per item.
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef FUSEDPROCESSOR_H
+#define FUSEDPROCESSOR_H
+
+// Qt includes
+
+#include <QObject>
+
+// Local includes
+
+#include "maintenancetool.h"
+#include "maintenancesettings.h"
+
+class QImage;
+
+namespace Digikam
+{
+
+class DImg;
+class FacePipelinePackage;
+class ImageInfo;
+
+class FusedProcessor : public MaintenanceTool
+{
+    Q_OBJECT
+
+public:
+
+    /** Constructor using the maintenance settings. The thumbnails, finger-prints, image quality
+     *  and face detection stages enabled there are processed together: each item is decoded once,
+     *  at the largest size needed, and the image is passed to all stages.
+     */
+    explicit FusedProcessor(const MaintenanceSettings& settings, ProgressItem* const parent = 0);
+    ~FusedProcessor();
+
+    void setUseMultiCoreCPU(bool b);
+
+    /** Returns true if the face scan task of these settings can be processed by this tool.
+     */
+    static bool canProcessFaces(const MaintenanceSettings& settings);
+
+private Q_SLOTS:
+
+    void slotStart();
+    void slotDone();
+    void slotCancel();
+    void slotAdvance(const QImage&);
+    void slotFaceImage(const ImageInfo&, const DImg&);
+    void slotFaceProcessed(const FacePipelinePackage&);
+    void slotThreadCompleted();
+
+private:
+
+    class Private;
+    Private* const d;
+};
+
+}  // namespace Digikam
+
+#endif /* FUSEDPROCESSOR_H */
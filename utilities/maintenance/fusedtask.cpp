@@ -0,0 +1,238 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-03-20
+ * Description : Thread actions task decoding each item once
+ *               for several maintenance tools.
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "fusedtask.h"
+
+// Qt includes
+
+#include <QSemaphore>
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "dimg.h"
+#include "haariface.h"
+#include "imageinfo.h"
+#include "imgqsort.h"
+#include "faceutils.h"
+#include "previewloadthread.h"
+#include "thumbnailloadthread.h"
+#include "maintenancedata.h"
+
+namespace Digikam
+{
+
+namespace
+{
+
+// Same sizes as used by the separate tools
+static const int qualityDecodingSize = 1024;
+static const int facesDecodingSize   = 1600;
+
+}
+
+class FusedTask::Private
+{
+public:
+
+    Private()
+        : imgqsort(0),
+          data(0)
+    {
+    }
+
+    FusedTaskSettings settings;
+    ImgQSort*         imgqsort;
+
+    MaintenanceData*  data;
+};
+
+// -------------------------------------------------------
+
+FusedTask::FusedTask()
+    : ActionJob(),
+      d(new Private)
+{
+}
+
+FusedTask::~FusedTask()
+{
+    slotCancel();
+    cancel();
+    delete d;
+}
+
+void FusedTask::setSettings(const FusedTaskSettings& settings)
+{
+    d->settings = settings;
+}
+
+void FusedTask::setMaintenanceData(MaintenanceData* const data)
+{
+    d->data = data;
+}
+
+int FusedTask::decodingSize(int stages)
+{
+    int size = 0;
+
+    if (stages & FusedTaskSettings::Thumbnails)
+    {
+        size = qMax(size, ThumbnailLoadThread::maximumThumbnailSize());
+    }
+
+    if (stages & FusedTaskSettings::FingerPrints)
+    {
+        size = qMax(size, HaarIface::preferredSize());
+    }
+
+    if (stages & FusedTaskSettings::ImageQuality)
+    {
+        size = qMax(size, qualityDecodingSize);
+    }
+
+    if (stages & FusedTaskSettings::Faces)
+    {
+        size = qMax(size, facesDecodingSize);
+    }
+
+    return size;
+}
+
+void FusedTask::slotCancel()
+{
+    if (d->imgqsort)
+    {
+        d->imgqsort->cancelAnalyse();
+    }
+}
+
+void FusedTask::run()
+{
+    // While we have data (using this as check for non-null)
+    while (d->data)
+    {
+        if (m_cancel)
+        {
+            return;
+        }
+
+        QString path = d->data->getImagePath();
+
+        if (path.isEmpty())
+        {
+            break;
+        }
+
+        ImageInfo info = ImageInfo::fromLocalFile(path);
+        int stages     = d->settings.stages.value(path);
+
+        if ((stages & FusedTaskSettings::Faces) && !d->settings.rescanFaces && FaceUtils().hasBeenScanned(info))
+        {
+            stages &= ~FusedTaskSettings::Faces;
+        }
+
+        // Decode once, at the largest size needed by the stages of this item.
+        // Videos and other non-image items only get their thumbnail, from the usual thumbnail creator.
+
+        DImg dimg;
+
+        if (info.category() == DatabaseItem::Image && stages)
+        {
+            qCDebug(DIGIKAM_GENERAL_LOG) << "Decoding once for maintenance stages" << stages << ":" << path;
+
+            if (stages & FusedTaskSettings::Faces)
+            {
+                dimg = PreviewLoadThread::loadFastButLargeSynchronously(path, decodingSize(stages));
+            }
+            else
+            {
+                dimg = PreviewLoadThread::loadFastSynchronously(path, decodingSize(stages));
+            }
+        }
+
+        if (m_cancel)
+        {
+            return;
+        }
+
+        if (stages & FusedTaskSettings::Thumbnails)
+        {
+            if (dimg.isNull())
+            {
+                ThumbnailLoadThread::deleteThumbnail(path);
+            }
+
+            ThumbnailLoadThread::pregenerateThumbnail(path, dimg);
+        }
+
+        if (!dimg.isNull() && (stages & FusedTaskSettings::FingerPrints))
+        {
+            // compute Haar fingerprint and store it to DB
+            HaarIface haarIface;
+            haarIface.indexImage(info.id(), dimg);
+        }
+
+        if (!dimg.isNull() && (stages & FusedTaskSettings::ImageQuality) && !m_cancel)
+        {
+            DImg qualityImage = dimg;
+
+            if (qMax(dimg.width(), dimg.height()) > (uint)qualityDecodingSize)
+            {
+                qualityImage = dimg.smoothScale(qualityDecodingSize, qualityDecodingSize, Qt::KeepAspectRatio);
+            }
+
+            PickLabel pick;
+            d->imgqsort = new ImgQSort(qualityImage, d->settings.quality, &pick);
+            d->imgqsort->startAnalyse();
+
+            info.setPickLabel(pick);
+
+            delete d->imgqsort; //delete image data after setting label
+            d->imgqsort = 0;
+        }
+
+        if (!dimg.isNull() && (stages & FusedTaskSettings::Faces) && d->settings.faceSlots)
+        {
+            // Wait until the face pipeline is ready to accept one more image
+            while (!d->settings.faceSlots->tryAcquire(1, 100))
+            {
+                if (m_cancel)
+                {
+                    return;
+                }
+            }
+
+            emit signalFaceImage(info, dimg);
+        }
+
+        // Dispatch progress to Progress Manager
+        QImage qimg = dimg.smoothScale(22, 22, Qt::KeepAspectRatio).copyQImage();
+        emit signalFinished(qimg);
+    }
+
+    emit signalDone();
+}
+
+}  // namespace Digikam
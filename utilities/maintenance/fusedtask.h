@@ -0,0 +1,124 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-03-20
+ * Description : Thread actions task decoding each item once
+ *               for several maintenance tools.
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef FUSEDTASK_H
+#define FUSEDTASK_H
+
+// Qt includes
+
+#include <QImage>
+#include <QHash>
+#include <QString>
+
+// Local includes
+
+#include "actionthreadbase.h"
+#include "dimg.h"
+#include "imageinfo.h"
+#include "imagequalitysettings.h"
+
+class QSemaphore;
+
+namespace Digikam
+{
+
+class MaintenanceData;
+
+class FusedTaskSettings
+{
+public:
+
+    enum Stage
+    {
+        Thumbnails   = 0x01,
+        FingerPrints = 0x02,
+        ImageQuality = 0x04,
+        Faces        = 0x08
+    };
+
+public:
+
+    FusedTaskSettings()
+        : rescanFaces(false),
+          faceSlots(0)
+    {
+    }
+
+    /// Stage flags to process for each file path.
+    QHash<QString, int>  stages;
+
+    /// Image Quality Sorting settings.
+    ImageQualitySettings quality;
+
+    /// If false, items already scanned for faces are skipped.
+    bool                 rescanFaces;
+
+    /// Limits the number of decoded images waiting for the face pipeline.
+    QSemaphore*          faceSlots;
+};
+
+// -------------------------------------------------------------------------------
+
+class FusedTask : public ActionJob
+{
+    Q_OBJECT
+
+public:
+
+    FusedTask();
+    ~FusedTask();
+
+    void setSettings(const FusedTaskSettings& settings);
+    void setMaintenanceData(MaintenanceData* const data=0);
+
+    /**
+     * Returns the size an item is decoded with when the given stages need it.
+     */
+    static int decodingSize(int stages);
+
+Q_SIGNALS:
+
+    void signalFinished(const QImage&);
+
+    /** Emitted for items to scan for faces, with a slot of FusedTaskSettings::faceSlots acquired.
+     */
+    void signalFaceImage(const ImageInfo&, const DImg&);
+
+public Q_SLOTS:
+
+    void slotCancel();
+
+protected:
+
+    void run();
+
+private:
+
+    class Private;
+    Private* const d;
+};
+
+}  // namespace Digikam
+
+#endif /* FUSEDTASK_H */
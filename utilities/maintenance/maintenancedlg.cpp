@@ -86,6 +86,7 @@ public:
         scanThumbs(0),
         scanFingerPrints(0),
         useMutiCoreCPU(0),
+        fusedPass(0),
         cleanThumbsDb(0),
         cleanFacesDb(0),
         shrinkDatabases(0),
@@ -110,6 +111,7 @@ public:
 
     static const QString configGroupName;
     static const QString configUseMutiCoreCPU;
+    static const QString configFusedPass;
     static const QString configNewItems;
     static const QString configThumbnails;
     static const QString configScanThumbs;
@@ -136,6 +138,7 @@ public:
     QCheckBox*           scanThumbs;
     QCheckBox*           scanFingerPrints;
     QCheckBox*           useMutiCoreCPU;
+    QCheckBox*           fusedPass;
     QCheckBox*           cleanThumbsDb;
     QCheckBox*           cleanFacesDb;
     QCheckBox*           shrinkDatabases;
@@ -159,6 +162,7 @@ public:
 
 const QString MaintenanceDlg::Private::configGroupName(QLatin1String("MaintenanceDlg Settings"));
 const QString MaintenanceDlg::Private::configUseMutiCoreCPU(QLatin1String("UseMutiCoreCPU"));
+const QString MaintenanceDlg::Private::configFusedPass(QLatin1String("FusedPass"));
 const QString MaintenanceDlg::Private::configNewItems(QLatin1String("NewItems"));
 const QString MaintenanceDlg::Private::configThumbnails(QLatin1String("Thumbnails"));
 const QString MaintenanceDlg::Private::configScanThumbs(QLatin1String("ScanThumbs"));
@@ -205,6 +209,9 @@ MaintenanceDlg::MaintenanceDlg(QWidget* const parent)
     DVBox* const options       = new DVBox;
     d->albumSelectors          = new AlbumSelectors(i18nc("@label", "Process items from:"), d->configGroupName, options);
     d->useMutiCoreCPU          = new QCheckBox(i18nc("@option:check", "Work on all processor cores (when it possible)"), options);
+    d->fusedPass               = new QCheckBox(i18nc("@option:check", "Load each item only once for thumbnails, finger-prints, faces and quality"), options);
+    d->fusedPass->setToolTip(i18n("The selected thumbnails, finger-prints, faces detection and image quality operations "
+                                  "are processed together, which is faster on large collections."));
     d->expanderBox->insertItem(Private::Options, options, QIcon::fromTheme(QLatin1String("configure")), i18n("Common Options"), QLatin1String("Options"), true);
 
     // --------------------------------------------------------------------------------------
@@ -408,6 +415,7 @@ MaintenanceSettings MaintenanceDlg::settings() const
     prm.albums                              = d->albumSelectors->selectedAlbums();
     prm.tags                                = d->albumSelectors->selectedTags();
     prm.useMutiCoreCPU                      = d->useMutiCoreCPU->isChecked();
+    prm.fusedPass                           = d->fusedPass->isChecked();
     prm.newItems                            = d->expanderBox->isChecked(Private::NewItems);
     prm.databaseCleanup                     = d->expanderBox->isChecked(Private::DbCleanup);
     prm.cleanThumbDb                        = d->cleanThumbsDb->isChecked();
@@ -444,6 +452,7 @@ void MaintenanceDlg::readSettings()
     MaintenanceSettings prm;
 
     d->useMutiCoreCPU->setChecked(group.readEntry(d->configUseMutiCoreCPU,                               prm.useMutiCoreCPU));
+    d->fusedPass->setChecked(group.readEntry(d->configFusedPass,                                         prm.fusedPass));
     d->expanderBox->setChecked(Private::NewItems,           group.readEntry(d->configNewItems,           prm.newItems));
 
     d->expanderBox->setChecked(Private::DbCleanup,          group.readEntry(d->configCleanupDatabase,       prm.databaseCleanup));
@@ -493,6 +502,7 @@ void MaintenanceDlg::writeSettings()
     MaintenanceSettings prm   = settings();
 
     group.writeEntry(d->configUseMutiCoreCPU,        prm.useMutiCoreCPU);
+    group.writeEntry(d->configFusedPass,             prm.fusedPass);
     group.writeEntry(d->configNewItems,              prm.newItems);
     group.writeEntry(d->configCleanupDatabase,       prm.databaseCleanup);
     group.writeEntry(d->configCleanupThumbDatabase,  prm.cleanThumbDb);
@@ -49,6 +49,7 @@
 #include "progressmanager.h"
 #include "facesdetector.h"
 #include "dbcleaner.h"
+#include "fusedprocessor.h"
 
 namespace Digikam
 {
@@ -68,6 +69,8 @@ public:
         imageQualitySorter    = 0;
         facesDetector         = 0;
         databaseCleaner       = 0;
+        fusedProcessor        = 0;
+        fused                 = false;
     }
 
     bool                   running;
@@ -84,6 +87,10 @@ public:
     ImageQualitySorter*    imageQualitySorter;
     FacesDetector*         facesDetector;
     DbCleaner*             databaseCleaner;
+    FusedProcessor*        fusedProcessor;
+
+    /// True when thumbnails, finger-prints, faces and quality are processed by fusedProcessor.
+    bool                   fused;
 };
 
 MaintenanceMngr::MaintenanceMngr(QObject* const parent)
@@ -137,6 +144,11 @@ void MaintenanceMngr::slotToolCompleted(ProgressItem* tool)
         d->thumbsGenerator = 0;
         stage4();
     }
+    else if (tool == dynamic_cast<ProgressItem*>(d->fusedProcessor))
+    {
+        d->fusedProcessor = 0;
+        stage4();
+    }
     else if (tool == dynamic_cast<ProgressItem*>(d->fingerPrintsGenerator))
     {
         d->fingerPrintsGenerator = 0;
@@ -173,7 +185,8 @@ void MaintenanceMngr::slotToolCanceled(ProgressItem* tool)
         tool == dynamic_cast<ProgressItem*>(d->databaseCleaner)       ||
         tool == dynamic_cast<ProgressItem*>(d->facesDetector)         ||
         tool == dynamic_cast<ProgressItem*>(d->imageQualitySorter)    ||
-        tool == dynamic_cast<ProgressItem*>(d->metadataSynchronizer))
+        tool == dynamic_cast<ProgressItem*>(d->metadataSynchronizer)  ||
+        tool == dynamic_cast<ProgressItem*>(d->fusedProcessor))
     {
         cancel();
     }
@@ -235,7 +248,21 @@ void MaintenanceMngr::stage3()
 {
     qCDebug(DIGIKAM_GENERAL_LOG) << "stage3";
 
-    if (d->settings.thumbnails)
+    d->fused = d->settings.fusedPass                                                          &&
+               (d->settings.thumbnails                                                        ||
+                d->settings.fingerPrints                                                      ||
+                (d->settings.faceManagement && FusedProcessor::canProcessFaces(d->settings)) ||
+                (d->settings.qualitySort    && d->settings.quality.enableSorter));
+
+    if (d->fused)
+    {
+        // Thumbnails, finger-prints, faces and quality are done in one pass, each item is decoded once
+        d->fusedProcessor = new FusedProcessor(d->settings);
+        d->fusedProcessor->setNotificationEnabled(false);
+        d->fusedProcessor->setUseMultiCoreCPU(d->settings.useMutiCoreCPU);
+        d->fusedProcessor->start();
+    }
+    else if (d->settings.thumbnails)
     {
         bool rebuildAll = (d->settings.scanThumbs == false);
         AlbumList list;
@@ -257,7 +284,7 @@ void MaintenanceMngr::stage4()
 {
     qCDebug(DIGIKAM_GENERAL_LOG) << "stage4";
 
-    if (d->settings.fingerPrints)
+    if (d->settings.fingerPrints && !d->fused)
     {
         bool rebuildAll = (d->settings.scanFingerPrints == false);
         AlbumList list;
@@ -296,7 +323,7 @@ void MaintenanceMngr::stage6()
 {
     qCDebug(DIGIKAM_GENERAL_LOG) << "stage6";
 
-    if (d->settings.faceManagement)
+    if (d->settings.faceManagement && !(d->fused && FusedProcessor::canProcessFaces(d->settings)))
     {
         // NOTE : Use multi-core CPU option is passed through FaceScanSettings
         d->settings.faceSettings.useFullCpu = d->settings.useMutiCoreCPU;
@@ -314,7 +341,7 @@ void MaintenanceMngr::stage7()
 {
     qCDebug(DIGIKAM_GENERAL_LOG) << "stage7";
 
-    if (d->settings.qualitySort && d->settings.quality.enableSorter)
+    if (d->settings.qualitySort && d->settings.quality.enableSorter && !d->fused)
     {
         AlbumList list;
         list << d->settings.albums;
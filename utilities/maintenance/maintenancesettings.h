@@ -59,6 +59,9 @@ public:
     /// Use Multi-core CPU to process items.
     bool                                    useMutiCoreCPU;
 
+    /// Decode each item once for thumbnails, finger-prints, faces detection and quality sorting.
+    bool                                    fusedPass;
+
     /// Find new items on whole collection.
     bool                                    newItems;
 
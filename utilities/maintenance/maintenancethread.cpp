@@ -35,6 +35,7 @@
 #include "thumbstask.h"
 #include "fingerprintstask.h"
 #include "imagequalitytask.h"
+#include "fusedtask.h"
 #include "imagequalitysettings.h"
 #include "databasetask.h"
 #include "maintenancedata.h"
@@ -166,6 +167,35 @@ void MaintenanceThread::sortByImageQuality(const QStringList& paths, const Image
     appendJobs(collection);
 }
 
+void MaintenanceThread::processFused(const QStringList& paths, const FusedTaskSettings& settings)
+{
+    ActionJobCollection collection;
+
+    data->setImagePaths(paths);
+
+    for (int i = 1; i <= maximumNumberOfThreads(); i++)
+    {
+        FusedTask* const t = new FusedTask();
+        t->setSettings(settings);
+        t->setMaintenanceData(data);
+
+        connect(t, SIGNAL(signalFinished(QImage)),
+                this, SIGNAL(signalAdvance(QImage)));
+
+        connect(t, SIGNAL(signalFaceImage(ImageInfo,DImg)),
+                this, SIGNAL(signalFaceImage(ImageInfo,DImg)));
+
+        connect(this, SIGNAL(signalCanceled()),
+                t, SLOT(slotCancel()), Qt::QueuedConnection);
+
+        collection.insert(t, 0);
+
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Creating a fused task for processing items with a single decoding.";
+    }
+
+    appendJobs(collection);
+}
+
 void MaintenanceThread::computeDatabaseJunk(bool thumbsDb, bool facesDb)
 {
     ActionJobCollection collection;
@@ -30,6 +30,7 @@
 #include "metadatasynchronizer.h"
 #include "imageinfo.h"
 #include "identity.h"
+#include "dimg.h"
 
 class QImage;
 
@@ -37,6 +38,7 @@ namespace Digikam
 {
 
 class ImageQualitySettings;
+class FusedTaskSettings;
 class MaintenanceData;
 
 class MaintenanceThread : public ActionThreadBase
@@ -54,6 +56,7 @@ public:
     void generateThumbs(const QStringList& paths);
     void generateFingerprints(const QStringList& paths);
     void sortByImageQuality(const QStringList& paths, const ImageQualitySettings& quality);
+    void processFused(const QStringList& paths, const FusedTaskSettings& settings);
 
     void computeDatabaseJunk(bool thumbsDb=false, bool facesDb=false);
     void cleanCoreDb(const QList<qlonglong>& imageIds);
@@ -79,6 +82,10 @@ Q_SIGNALS:
      */
     void signalAdvance();
 
+    /** Emit when a fused task has decoded an item to scan for faces.
+     */
+    void signalFaceImage(const ImageInfo&, const DImg&);
+
     /** Emit when a items list have been fully processed.
      */
     void signalCompleted();
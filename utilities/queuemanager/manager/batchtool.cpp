@@ -32,6 +32,8 @@
 #include <QTemporaryFile>
 #include <QWidget>
 #include <QLabel>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QUuid>
 
 // KDE includes
@@ -44,6 +46,7 @@
 #include "digikam_debug.h"
 #include "dimgbuiltinfilter.h"
 #include "dimgloaderobserver.h"
+#include "dimgpointfilter.h"
 #include "dimgthreadedfilter.h"
 #include "filereadwritelock.h"
 #include "batchtoolutils.h"
@@ -68,6 +71,7 @@ public:
         cancel(false),
         last(false),
         observer(0),
+        pointFilterChain(0),
         toolGroup(BaseTool),
         rawLoadingRule(QueueSettings::DEMOSAICING)
     {
@@ -98,8 +102,13 @@ public:
 
     BatchToolSettings             settings;
 
+    QList<DImgThreadedFilter*>    pointFilters;       // Point filters to apply to the image, owned.
+
     BatchToolObserver*            observer;
 
+    DImgThreadedFilter*           pointFilterChain;   // Fused chain while it runs, guarded by chainMutex.
+    QMutex                        chainMutex;
+
     BatchTool::BatchToolGroup     toolGroup;
 
     QueueSettings::RawLoadingRule rawLoadingRule;
@@ -146,6 +155,7 @@ BatchTool::~BatchTool()
     // Owner is passed to ToolSettingsView, which will delete instance,
     // even if Valgrind report a memory leak.
 
+    qDeleteAll(d->pointFilters);
     delete d->observer;
     delete d;
 }
@@ -324,7 +334,14 @@ QUrl BatchTool::workingUrl() const
 
 void BatchTool::cancel()
 {
+    QMutexLocker lock(&d->chainMutex);
+
     d->cancel = true;
+
+    if (d->pointFilterChain)
+    {
+        d->pointFilterChain->cancelFilter();
+    }
 }
 
 bool BatchTool::isCancelled() const
@@ -495,6 +512,31 @@ bool BatchTool::apply()
         }
     }
 
+    if (!d->pointFilters.isEmpty())
+    {
+        // Point filters of the previous tools are applied with the one of this tool,
+        // or before the operations of this tool.
+
+        DImgThreadedFilter* const filter = createPointFilter();
+
+        if (filter)
+        {
+            d->pointFilters << filter;
+        }
+
+        if (!loadToDImg())
+        {
+            return false;
+        }
+
+        applyPointFilters();
+
+        if (filter)
+        {
+            return (savefromDImg());
+        }
+    }
+
     return toolOperations();
 }
 
@@ -531,6 +573,79 @@ void BatchTool::applyFilter(DImgBuiltinFilter* const filter)
     d->image.addFilterAction(filter->filterAction());
 }
 
+DImgThreadedFilter* BatchTool::createPointFilter() const
+{
+    return 0;
+}
+
+void BatchTool::setPointFilters(const QList<DImgThreadedFilter*>& filters)
+{
+    qDeleteAll(d->pointFilters);
+    d->pointFilters = filters;
+}
+
+bool BatchTool::applyPointFilter()
+{
+    if (!loadToDImg())
+    {
+        return false;
+    }
+
+    DImgThreadedFilter* const filter = createPointFilter();
+
+    if (filter)
+    {
+        d->pointFilters << filter;
+    }
+
+    applyPointFilters();
+
+    return (savefromDImg());
+}
+
+void BatchTool::applyPointFilters()
+{
+    QList<DImgPointFilter*> filters;
+
+    foreach (DImgThreadedFilter* const filter, d->pointFilters)
+    {
+        filters << DImgPointFilterChain::pointFilter(filter);
+    }
+
+    // The image is processed in place, without copy.
+    DImgPointFilterChain chain(filters, 0, d->image, d->image);
+
+    {
+        QMutexLocker lock(&d->chainMutex);
+
+        if (!d->cancel)
+        {
+            d->pointFilterChain = &chain;
+        }
+    }
+
+    if (!isCancelled())
+    {
+        chain.startFilterDirectly();
+    }
+
+    {
+        QMutexLocker lock(&d->chainMutex);
+        d->pointFilterChain = 0;
+    }
+
+    if (!isCancelled())
+    {
+        foreach (DImgThreadedFilter* const filter, d->pointFilters)
+        {
+            d->image.addFilterAction(filter->filterAction());
+        }
+    }
+
+    qDeleteAll(d->pointFilters);
+    d->pointFilters.clear();
+}
+
 // -- Settings Widgets methods ---------------------------------------------------------------------------
 
 QWidget* BatchTool::settingsWidget() const
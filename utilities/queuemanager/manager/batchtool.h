@@ -211,6 +211,18 @@ public:
      */
     virtual void cancel();
 
+    /** Re-implement this method if tool only applies a point filter to the image (see DImgPointFilter),
+        as colors adjustments tools. Return a new filter set with the tool settings, without image.
+        Point filters of consecutive tools are applied together in one pass over the image.
+        This method return 0 by default.
+     */
+    virtual DImgThreadedFilter* createPointFilter() const;
+
+    /** Set point filters of the previous tools, to apply before or with the operations of this tool.
+        The tool takes the ownership of the filters.
+     */
+    void setPointFilters(const QList<DImgThreadedFilter*>& filters);
+
     /** Re-implement this method if tool change file extension during batch process (ex: "png").
         Typically, this is used with tool which convert to new file format.
         This method return and empty string by default.
@@ -261,6 +273,12 @@ protected:
     void applyFilterChangedProperties(DImgThreadedFilter* const filter);
     void applyFilter(DImgBuiltinFilter* const filter);
 
+    /** Use this in toolOperations() if you re-implement createPointFilter().
+     *  Will apply the filter of this tool with the point filters of the previous tools to image(),
+     *  and save the result.
+     */
+    bool applyPointFilter();
+
     /** Re-implement this method to customize all batch operations done by this tool.
         This method is called by apply().
      */
@@ -310,6 +328,10 @@ public:
     // Declared as public due to BatchToolObserver class.
     class Private;
 
+private:
+
+    void applyPointFilters();
+
 private:
 
     Private* const d;
@@ -113,6 +113,9 @@ void Task::run()
         return;
     }
 
+    // Items are processed in parallel already.
+    DImg::setProcessingThreads(1);
+
     emitActionData(ActionData::BatchStarted);
 
     // Loop with all batch tools operations to apply on item.
@@ -127,6 +130,9 @@ void Task::run()
     DImg        tmpImage;
     QString     errMsg;
 
+    // Point filters of the previous tools, applied by the next one together with its own.
+    QList<DImgThreadedFilter*> pointFilters;
+
     // ImageInfo must be tread-safe.
     ImageInfo source = ImageInfo::fromUrl(d->tools.m_itemUrl);
     bool timeAdjust  = false;
@@ -168,6 +174,24 @@ void Task::run()
             d->tool->setLastChainedTool(false);
         }
 
+        if (!d->tool->isLastChainedTool())
+        {
+            DImgThreadedFilter* const pointFilter = d->tool->createPointFilter();
+
+            if (pointFilter)
+            {
+                qCDebug(DIGIKAM_GENERAL_LOG) << "Point filter of tool" << set.name << "applied with the next tool";
+
+                pointFilters << pointFilter;
+                delete d->tool;
+                d->tool = 0;
+                continue;
+            }
+        }
+
+        d->tool->setPointFilters(pointFilters);
+        pointFilters.clear();
+
         d->tool->setOutputUrlFromInputUrl();
         d->tool->setBranchHistory(true);
 
@@ -97,22 +97,19 @@ void BCGCorrection::slotSettingsChanged()
     BatchTool::slotSettingsChanged(prm);
 }
 
-bool BCGCorrection::toolOperations()
+DImgThreadedFilter* BCGCorrection::createPointFilter() const
 {
-    if (!loadToDImg())
-    {
-        return false;
-    }
-
     BCGContainer prm;
     prm.brightness = settings()[QLatin1String("Brightness")].toDouble();
     prm.contrast   = settings()[QLatin1String("Contrast")].toDouble();
     prm.gamma      = settings()[QLatin1String("Gamma")].toDouble();
 
-    BCGFilter bcg(&image(), 0L, prm);
-    applyFilter(&bcg);
+    return (new BCGFilter(prm));
+}
 
-    return (savefromDImg());
+bool BCGCorrection::toolOperations()
+{
+    return (applyPointFilter());
 }
 
 }  // namespace Digikam
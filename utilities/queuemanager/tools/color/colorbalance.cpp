@@ -98,22 +98,19 @@ void ColorBalance::slotSettingsChanged()
     BatchTool::slotSettingsChanged(prm);
 }
 
-bool ColorBalance::toolOperations()
+DImgThreadedFilter* ColorBalance::createPointFilter() const
 {
-    if (!loadToDImg())
-    {
-        return false;
-    }
-
     CBContainer prm;
     prm.red   = settings()[QLatin1String("Red")].toDouble();
     prm.green = settings()[QLatin1String("Green")].toDouble();
     prm.blue  = settings()[QLatin1String("Blue")].toDouble();
 
-    CBFilter cb(&image(), 0L, prm);
-    applyFilter(&cb);
+    return (new CBFilter(prm));
+}
 
-    return (savefromDImg());
+bool ColorBalance::toolOperations()
+{
+    return (applyPointFilter());
 }
 
 }  // namespace Digikam
@@ -169,13 +169,8 @@ void CurvesAdjust::slotSettingsLoad()
     slotSettingsChanged();
 }
 
-bool CurvesAdjust::toolOperations()
+DImgThreadedFilter* CurvesAdjust::createPointFilter() const
 {
-    if (!loadToDImg())
-    {
-        return false;
-    }
-
     CurvesContainer prm((ImageCurves::CurveType)settings()[QLatin1String("curvesType")].toInt(),
                         settings()[QLatin1String("curvesDepth")].toBool());
     prm.initialize();
@@ -185,10 +180,12 @@ bool CurvesAdjust::toolOperations()
     prm.values[BlueChannel]       = settings()[QLatin1String("values[BlueChannel]")].value<QPolygon>();
     prm.values[AlphaChannel]      = settings()[QLatin1String("values[AlphaChannel]")].value<QPolygon>();
 
-    CurvesFilter curves(&image(), 0L, prm);
-    applyFilter(&curves);
+    return (new CurvesFilter(prm));
+}
 
-    return (savefromDImg());
+bool CurvesAdjust::toolOperations()
+{
+    return (applyPointFilter());
 }
 
 }  // namespace Digikam
@@ -48,6 +48,8 @@ public:
 
     BatchTool* clone(QObject* const parent=0) const { return new CurvesAdjust(parent); };
 
+    DImgThreadedFilter* createPointFilter() const;
+
     void registerSettingsWidget();
 
 public Q_SLOTS:
@@ -100,23 +100,20 @@ void HSLCorrection::slotSettingsChanged()
     BatchTool::slotSettingsChanged(prm);
 }
 
-bool HSLCorrection::toolOperations()
+DImgThreadedFilter* HSLCorrection::createPointFilter() const
 {
-    if (!loadToDImg())
-    {
-        return false;
-    }
-
     HSLContainer prm;
     prm.hue        = settings()[QLatin1String("Hue")].toDouble();
     prm.saturation = settings()[QLatin1String("Saturation")].toDouble();
     prm.lightness  = settings()[QLatin1String("Lightness")].toDouble();
     prm.vibrance   = settings()[QLatin1String("Vibrance")].toDouble();
 
-    HSLFilter hsl(&image(), 0L, prm);
-    applyFilter(&hsl);
+    return (new HSLFilter(prm));
+}
 
-    return (savefromDImg());
+bool HSLCorrection::toolOperations()
+{
+    return (applyPointFilter());
 }
 
 }  // namespace Digikam
@@ -51,17 +51,14 @@ Invert::~Invert()
 {
 }
 
-bool Invert::toolOperations()
+DImgThreadedFilter* Invert::createPointFilter() const
 {
-    if (!loadToDImg())
-    {
-        return false;
-    }
-
-    InvertFilter inv(&image(), 0L);
-    applyFilter(&inv);
+    return (new InvertFilter);
+}
 
-    return (savefromDImg());
+bool Invert::toolOperations()
+{
+    return (applyPointFilter());
 }
 
 }  // namespace Digikam
@@ -47,6 +47,8 @@ public:
 
     BatchTool* clone(QObject* const parent=0) const { return new Invert(parent); };
 
+    DImgThreadedFilter* createPointFilter() const;
+
 private:
 
     bool toolOperations();
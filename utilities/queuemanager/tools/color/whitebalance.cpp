@@ -116,13 +116,8 @@ void WhiteBalance::slotSettingsChanged()
     BatchTool::slotSettingsChanged(prm);
 }
 
-bool WhiteBalance::toolOperations()
+DImgThreadedFilter* WhiteBalance::createPointFilter() const
 {
-    if (!loadToDImg())
-    {
-        return false;
-    }
-
     WBContainer prm;
 
     prm.black          = settings()[QLatin1String("black")].toDouble();
@@ -134,10 +129,12 @@ bool WhiteBalance::toolOperations()
     prm.expositionMain = settings()[QLatin1String("expositionMain")].toDouble();
     prm.expositionFine = settings()[QLatin1String("expositionFine")].toDouble();
 
-    WBFilter wb(&image(), 0L, prm);
-    applyFilter(&wb);
+    return (new WBFilter(prm));
+}
 
-    return (savefromDImg());
+bool WhiteBalance::toolOperations()
+{
+    return (applyPointFilter());
 }
 
 }  // namespace Digikam
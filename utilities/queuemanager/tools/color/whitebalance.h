@@ -46,6 +46,8 @@ public:
 
     BatchTool* clone(QObject* const parent=0) const { return new WhiteBalance(parent); };
 
+    DImgThreadedFilter* createPointFilter() const;
+
     void registerSettingsWidget();
 
 private: